@@ -0,0 +1,91 @@
+#ifndef BENCH_DATA_H
+#define BENCH_DATA_H
+
+/**
+ * Inputs shared by the benchmarks
+ */
+
+#include <math.h>
+#include <stddef.h>
+
+#include <vector>
+
+#include "src/spatial/attitude-utils.hpp"
+#include "src/style/points.hpp"
+#include "src/style/style.hpp"
+
+namespace found {
+
+/// The seed of every pseudorandom input, so that runs are comparable
+const unsigned int kBenchSeed = 12345;
+
+/**
+ * Makes pseudorandom scalars in [-1, 1]
+ *
+ * @param count The number of scalars
+ * @param seed Picks the sequence of scalars
+ *
+ * @return The scalars, the same for the same count and seed
+ */
+inline std::vector<decimal> MakeBenchScalars(size_t count, unsigned int seed = kBenchSeed) {
+    std::vector<decimal> scalars(count);
+    unsigned int state = seed;
+    for (size_t i = 0; i < count; i++) {
+        // A linear congruential generator, which is the same on every platform (unlike rand)
+        state = state * 1664525u + 1013904223u;
+        scalars[i] = static_cast<decimal>(state >> 8) / (1 << 23) - 1;
+    }
+    return scalars;
+}
+
+/// The intensity of Earth in synthetic images
+const unsigned char kBenchEarth = 200;
+/// The intensity of space in synthetic images
+const unsigned char kBenchSpace = 20;
+
+/**
+ * Makes a synthetic image of Earth's limb: a bright disk on a dark
+ * background, whose center may be outside the image (so that only an
+ * arc of the horizon is in view)
+ *
+ * @param pixels The place to store the pixels (resized to fit)
+ * @param size The width and height of the image
+ * @param radius The radius of the disk, in pixels
+ * @param centerX,centerY The center of the disk, in pixels
+ *
+ * @return The image, which borrows pixels
+ */
+inline Image MakeLimbImage(std::vector<unsigned char> &pixels, int size, decimal radius,
+                           decimal centerX, decimal centerY) {
+    pixels.assign(static_cast<size_t>(size) * size, kBenchSpace);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            decimal dx = x + 0.5f - centerX, dy = y + 0.5f - centerY;
+            if (dx * dx + dy * dy <= radius * radius) pixels[static_cast<size_t>(y) * size + x] = kBenchEarth;
+        }
+    }
+    Image image = {pixels.data(), {size, size, 1}};
+    return image;
+}
+
+/**
+ * Makes points on a circle, as the horizon of Earth seen straight ahead
+ *
+ * @param count The number of points
+ * @param size The width and height of the image the points are in
+ *
+ * @return The points, spread evenly around a circle of radius size / 4 about the center of the image
+ */
+inline Points MakeCirclePoints(size_t count, int size) {
+    Points points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        decimal angle = static_cast<decimal>(2 * M_PI * i / count);
+        points.push_back(size / 2.0f + size / 4.0f * cos(angle), size / 2.0f + size / 4.0f * sin(angle));
+    }
+    return points;
+}
+
+}  // namespace found
+
+#endif
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <vector>
+
+#include "src/distance/distance.hpp"
+#include "src/distance/edge.hpp"
+#include "src/pipeline/pipeline.hpp"
+#include "src/spatial/camera.hpp"
+
+#include "benchmark/common/bench-data.hpp"
+
+namespace found {
+
+/// The radius of Earth, in km
+const decimal kBenchEarthRadius = 6378.137;
+/// The threshold between Earth and space in the synthetic images
+const unsigned char kBenchThreshold = (kBenchEarth + kBenchSpace) / 2;
+
+/**
+ * Makes the synthetic image of a benchmark
+ *
+ * @param pixels The place to store the pixels
+ * @param size The width and height of the image
+ * @param limb 0 for the whole of Earth in view (a disk), and 1 for a close up of its limb (an arc
+ * across the image)
+ *
+ * @return The image
+ */
+static Image MakeBenchImage(std::vector<unsigned char> &pixels, int size, int64_t limb) {
+    if (limb == 0) return MakeLimbImage(pixels, size, size / 4.0f, size / 2.0f, size / 2.0f);
+    // The horizon crosses the top quarter of the image, curving down at the edges
+    decimal radius = 1.5f * size;
+    return MakeLimbImage(pixels, size, radius, size / 2.0f, size / 4.0f + radius);
+}
+
+/**
+ * Adds the sizes and layouts of the synthetic images to a benchmark
+ *
+ * @param benchmark The benchmark
+ */
+static void ImageArguments(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgNames({"size", "limb"});
+    for (int size : {256, 512, 1024, 2048}) {
+        for (int limb : {0, 1}) benchmark->Args({size, limb});
+    }
+}
+
+/**
+ * Benchmarks finding the horizon in an image
+ */
+static void BM_SimpleEdgeDetection(benchmark::State &state) {
+    std::vector<unsigned char> pixels;
+    Image image = MakeBenchImage(pixels, state.range(0), state.range(1));
+    SimpleEdgeDetectionAlgorithm edge(kBenchThreshold);
+    Points points;
+    for (auto _ : state) {
+        edge.RunInto(image, points);
+        benchmark::DoNotOptimize(points.x());
+    }
+    state.counters["points"] = points.size();
+    state.SetBytesProcessed(state.iterations() * pixels.size());
+}
+BENCHMARK(BM_SimpleEdgeDetection)->Apply(ImageArguments);
+
+/**
+ * Benchmarks finding the distance to a spherical Earth from points on its horizon
+ */
+static void BM_SphericalDistance(benchmark::State &state) {
+    const int size = 1024;
+    Points points = MakeCirclePoints(state.range(0), size);
+    SphericalDistanceDeterminationAlgorithm distance(kBenchEarthRadius, Camera(size, size, size));
+    for (auto _ : state) benchmark::DoNotOptimize(distance.Run(points));
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_SphericalDistance)->RangeMultiplier(4)->Range(16, 1 << 14);
+
+/**
+ * Benchmarks finding the position of the camera relative to an ellipsoidal Earth from points on its
+ * horizon, cold (every run from scratch) or warm (from the last position)
+ */
+static void BM_EllipticDistance(benchmark::State &state) {
+    const int size = 1024;
+    Points points = MakeCirclePoints(state.range(0), size);
+    EllipticDistanceDeterminationAlgorithm distance(kBenchEarthRadius, 6356.752, Camera(size, size, size),
+                                                    Attitude(Quaternion(1, 0, 0, 0)));
+    bool warm = state.range(1) != 0;
+    for (auto _ : state) {
+        if (!warm) distance.Reset();
+        benchmark::DoNotOptimize(distance.Run(points));
+    }
+    state.counters["iterations"] = distance.Iterations();
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_EllipticDistance)->ArgNames({"points", "warm"})->RangeMultiplier(4)->Ranges({{16, 1 << 14}, {0, 1}});
+
+/**
+ * Benchmarks Pipeline::Run from an image to the distance to Earth
+ */
+static void BM_PipelineRun(benchmark::State &state) {
+    std::vector<unsigned char> pixels;
+    int size = state.range(0);
+    Image image = MakeBenchImage(pixels, size, state.range(1));
+    SimpleEdgeDetectionAlgorithm edge(kBenchThreshold);
+    SphericalDistanceDeterminationAlgorithm distance(kBenchEarthRadius, Camera(size, size, size));
+    std::vector<std::reference_wrapper<Action>> stages;
+    Pipeline<Image, distFromEarth> pipeline(stages);
+    pipeline.AddStage(edge).Complete(distance);
+
+    for (auto _ : state) benchmark::DoNotOptimize(pipeline.Run(image));
+    state.counters["points"] = edge.Run(image).size();
+    state.SetBytesProcessed(state.iterations() * pixels.size());
+}
+BENCHMARK(BM_PipelineRun)->Apply(ImageArguments)->Unit(benchmark::kMicrosecond);
+
+}  // namespace found
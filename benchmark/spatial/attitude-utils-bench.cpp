@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "src/spatial/attitude-utils.hpp"
+
+#include "benchmark/common/bench-data.hpp"
+
+namespace found {
+
+/// A rotation that is not about any axis
+static const Quaternion benchQuaternion = SphericalToQuaternion(DegToRad(40), DegToRad(25), DegToRad(70));
+/// The matrix of benchQuaternion
+static const Mat3 benchMatrix = QuaternionToDCM(benchQuaternion);
+
+/**
+ * Benchmarks cross products
+ */
+static void BM_Vec3CrossProduct(benchmark::State &state) {
+    Vec3 a(1, 2, 3), b(-0.5, 0.25, 4);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a.CrossProduct(b));
+    }
+}
+BENCHMARK(BM_Vec3CrossProduct);
+
+/**
+ * Benchmarks normalizing vectors
+ */
+static void BM_Vec3Normalize(benchmark::State &state) {
+    Vec3 a(1, 2, 3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a.Normalize());
+    }
+}
+BENCHMARK(BM_Vec3Normalize);
+
+/**
+ * Benchmarks multiplying matrices
+ */
+static void BM_Mat3Multiply(benchmark::State &state) {
+    Mat3 a = benchMatrix, b = benchMatrix.Transpose();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a * b);
+    }
+}
+BENCHMARK(BM_Mat3Multiply);
+
+/**
+ * Benchmarks inverting matrices
+ */
+static void BM_Mat3Inverse(benchmark::State &state) {
+    Mat3 a = benchMatrix;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a.Inverse());
+    }
+}
+BENCHMARK(BM_Mat3Inverse);
+
+/**
+ * Benchmarks multiplying one vector at a time by a matrix
+ */
+static void BM_Mat3MultiplyVec3(benchmark::State &state) {
+    size_t count = state.range(0);
+    std::vector<decimal> x = MakeBenchScalars(count, 1), y = MakeBenchScalars(count, 2);
+    std::vector<decimal> z = MakeBenchScalars(count, 3);
+    std::vector<Vec3> out(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) out[i] = benchMatrix * Vec3(x[i], y[i], z[i]);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Mat3MultiplyVec3)->Range(64, 1 << 16);
+
+/**
+ * Benchmarks multiplying a batch of vectors by a matrix
+ */
+static void BM_Mat3MultiplyBatch(benchmark::State &state) {
+    size_t count = state.range(0);
+    std::vector<decimal> x = MakeBenchScalars(count, 1), y = MakeBenchScalars(count, 2);
+    std::vector<decimal> z = MakeBenchScalars(count, 3);
+    std::vector<decimal> outX(count), outY(count), outZ(count);
+    for (auto _ : state) {
+        benchMatrix.Multiply(x.data(), y.data(), z.data(), count, outX.data(), outY.data(), outZ.data());
+        benchmark::DoNotOptimize(outX.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Mat3MultiplyBatch)->Range(64, 1 << 16);
+
+/**
+ * Benchmarks multiplying quaternions
+ */
+static void BM_QuaternionMultiply(benchmark::State &state) {
+    Quaternion a = benchQuaternion, b = benchQuaternion.Conjugate();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a * b);
+    }
+}
+BENCHMARK(BM_QuaternionMultiply);
+
+/**
+ * Benchmarks rotating one vector at a time by a quaternion
+ */
+static void BM_QuaternionRotate(benchmark::State &state) {
+    size_t count = state.range(0);
+    std::vector<decimal> x = MakeBenchScalars(count, 1), y = MakeBenchScalars(count, 2);
+    std::vector<decimal> z = MakeBenchScalars(count, 3);
+    std::vector<Vec3> out(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) out[i] = benchQuaternion.Rotate(Vec3(x[i], y[i], z[i]));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_QuaternionRotate)->Range(64, 1 << 16);
+
+/**
+ * Benchmarks rotating a batch of vectors by a quaternion
+ */
+static void BM_QuaternionRotateBatch(benchmark::State &state) {
+    size_t count = state.range(0);
+    std::vector<decimal> x = MakeBenchScalars(count, 1), y = MakeBenchScalars(count, 2);
+    std::vector<decimal> z = MakeBenchScalars(count, 3);
+    std::vector<decimal> outX(count), outY(count), outZ(count);
+    for (auto _ : state) {
+        benchQuaternion.Rotate(x.data(), y.data(), z.data(), count, outX.data(), outY.data(), outZ.data());
+        benchmark::DoNotOptimize(outX.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_QuaternionRotateBatch)->Range(64, 1 << 16);
+
+/**
+ * Benchmarks converting quaternions to matrices and back
+ */
+static void BM_QuaternionDCMConversion(benchmark::State &state) {
+    Quaternion q = benchQuaternion;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(q);
+        benchmark::DoNotOptimize(DCMToQuaternion(QuaternionToDCM(q)));
+    }
+}
+BENCHMARK(BM_QuaternionDCMConversion);
+
+}  // namespace found
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "src/spatial/camera.hpp"
+
+#include "benchmark/common/bench-data.hpp"
+
+namespace found {
+
+/// The camera of the camera benchmarks
+static const Camera benchCamera(0.012, 1024, 1024);
+
+/**
+ * Benchmarks projecting vectors into the image
+ */
+static void BM_CameraSpatialToCamera(benchmark::State &state) {
+    size_t count = state.range(0);
+    std::vector<decimal> y = MakeBenchScalars(count, 1), z = MakeBenchScalars(count, 2);
+    for (auto _ : state) {
+        // Vec2s cannot be assigned, so their coordinates are summed instead of stored
+        decimal sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            Vec2 pixel = benchCamera.SpatialToCamera(Vec3(1, y[i], z[i]));
+            sum += pixel.x + pixel.y;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CameraSpatialToCamera)->Range(64, 1 << 16);
+
+/**
+ * Benchmarks projecting pixels into space, one at a time
+ */
+static void BM_CameraCameraToSpatial(benchmark::State &state) {
+    size_t count = state.range(0);
+    std::vector<decimal> x = MakeBenchScalars(count, 1), y = MakeBenchScalars(count, 2);
+    std::vector<Vec3> out(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) {
+            Vec2 pixel = {512 + 512 * x[i], 512 + 512 * y[i]};
+            out[i] = benchCamera.CameraToSpatial(pixel);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CameraCameraToSpatial)->Range(64, 1 << 16);
+
+/**
+ * Benchmarks projecting a batch of pixels into space
+ */
+static void BM_CameraPixelsToRays(benchmark::State &state) {
+    size_t count = state.range(0);
+    std::vector<decimal> x = MakeBenchScalars(count, 1), y = MakeBenchScalars(count, 2);
+    for (size_t i = 0; i < count; i++) {
+        x[i] = 512 + 512 * x[i];
+        y[i] = 512 + 512 * y[i];
+    }
+    std::vector<decimal> rayX(count), rayY(count), rayZ(count);
+    for (auto _ : state) {
+        benchCamera.PixelsToRays(x.data(), y.data(), count, rayX.data(), rayY.data(), rayZ.data());
+        benchmark::DoNotOptimize(rayX.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CameraPixelsToRays)->Range(64, 1 << 16);
+
+}  // namespace found
@@ -0,0 +1,151 @@
+#include "command-line/batch.hpp"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "io/image.hpp"
+#include "io/manifest.hpp"
+#include "pipeline/batch.hpp"
+#include "pipeline/pipeline.hpp"
+
+namespace found {
+
+void CheckEdgeOptions(const Options &options) {
+    if (options.edgeAlgorithm != "simple" && options.edgeAlgorithm != "loc") {
+        throw std::invalid_argument("Unknown edge detection algorithm: " + options.edgeAlgorithm);
+    }
+    if (options.locSigma <= 0) throw std::invalid_argument("The LoC sigma must be positive");
+    if (options.subpixelRadius < 0) throw std::invalid_argument("The sub-pixel radius must not be negative");
+}
+
+void ConfigureEdgeDetectionAlgorithm(EdgeDetectionAlgorithm &algorithm, const Options &options) {
+    if (options.subpixelRadius > 0 || options.maxPoints > 0) {
+        SubpixelOptions subpixel;
+        subpixel.radius = options.subpixelRadius;
+        subpixel.maxPoints = options.maxPoints;
+        algorithm.SetSubpixelRefinement(subpixel);
+    } else {
+        algorithm.ClearSubpixelRefinement();
+    }
+}
+
+std::unique_ptr<EdgeDetectionAlgorithm> MakeEdgeDetectionAlgorithm(const Options &options) {
+    CheckEdgeOptions(options);
+    std::unique_ptr<EdgeDetectionAlgorithm> algorithm;
+    if (options.edgeAlgorithm == "simple") {
+        algorithm.reset(new SimpleEdgeDetectionAlgorithm(static_cast<unsigned char>(options.edgeThreshold)));
+    } else {
+        algorithm.reset(new LoCEdgeDetectionAlgorithm(options.locSigma, options.edgeThreshold));
+    }
+    ConfigureEdgeDetectionAlgorithm(*algorithm, options);
+    return algorithm;
+}
+
+EdgeVariants::EdgeVariants(const Options &options)
+    : simple(static_cast<unsigned char>(options.edgeThreshold)),
+      // A bad sigma is only reported by Configure, like every other bad option
+      loc(options.locSigma > 0 ? options.locSigma : 1, options.edgeThreshold),
+      simplePipeline(stages), locPipeline(stages), selected(&simplePipeline) {
+    this->simplePipeline.Complete(this->simple);
+    this->locPipeline.Complete(this->loc);
+    this->Configure(options);
+}
+
+void EdgeVariants::Configure(const Options &options) {
+    CheckEdgeOptions(options);
+    this->simple.SetThreshold(static_cast<unsigned char>(options.edgeThreshold));
+    this->loc.SetParameters(options.locSigma, options.edgeThreshold);
+    ConfigureEdgeDetectionAlgorithm(this->simple, options);
+    ConfigureEdgeDetectionAlgorithm(this->loc, options);
+    this->selected = &this->Variant(options.edgeAlgorithm);
+}
+
+int BatchCommand(const Options &options, std::ostream &out, ConfigReloader *reloader) {
+    std::vector<std::string> frames;
+    if (!options.manifest.empty()) {
+        frames = ReadManifest(options.manifest);
+    } else if (!options.directory.empty()) {
+        frames = ListDirectory(options.directory);
+    } else if (!options.image.empty()) {
+        frames.push_back(options.image);
+    } else {
+        throw std::invalid_argument("The batch command needs a --manifest, a --directory or an --image");
+    }
+    if (options.threads < 0) throw std::invalid_argument("The number of threads must not be negative");
+    if (!options.profile.empty() && !kInstrumentationEnabled) {
+        throw std::invalid_argument("--profile needs a build with instrumentation (make INSTRUMENTATION=1)");
+    }
+    // Fails early (instead of once per frame) on a bad algorithm
+    CheckEdgeOptions(options);
+
+    size_t threads = options.threads > 0 ? options.threads : TaskScheduler::Default().Workers();
+    std::atomic<bool> failed(false);
+    // The variants of every worker, whose profiles are merged at the end
+    std::vector<std::shared_ptr<EdgeVariants>> workers;
+    std::mutex workersMutex;
+
+    std::function<std::function<std::string(size_t)>()> makeProcessor = [&]() {
+        // Each worker owns its algorithms, so that their buffers are never shared
+        std::shared_ptr<Options> current = std::make_shared<Options>(options);
+        uint64_t generation = 0;
+        if (reloader != nullptr) generation = reloader->Current(*current);
+        std::shared_ptr<EdgeVariants> variants = std::make_shared<EdgeVariants>(*current);
+        {
+            std::lock_guard<std::mutex> lock(workersMutex);
+            workers.push_back(variants);
+        }
+        std::shared_ptr<Points> points = std::make_shared<Points>();
+        return std::function<std::string(size_t)>([&, current, generation, variants, points](size_t index) mutable {
+            std::ostringstream line;
+            line << frames[index] << '\t';
+            try {
+                if (reloader != nullptr && reloader->Poll() != generation) {
+                    generation = reloader->Current(*current);
+                    variants->Configure(*current);
+                }
+                Image image = MapImage(frames[index], current->imageWidth, current->imageHeight,
+                                       current->imageChannels, current->imageOffset);
+                variants->Selected().RunInto(image, *points);
+                line << points->size() << '\t';
+                for (size_t i = 0; i < points->size(); i++) {
+                    line << (i == 0 ? "" : " ") << points->x()[i] << ' ' << points->y()[i];
+                }
+            } catch (const std::exception &exception) {
+                failed = true;
+                line << "error\t" << exception.what();
+            }
+            return line.str();
+        });
+    };
+    std::function<void(size_t, std::string &)> emit = [&](size_t, std::string &line) {
+        out << line << '\n';
+    };
+    RunBatch<std::string>(frames.size(), threads, makeProcessor, emit);
+    out.flush();
+
+    if (!options.profile.empty() && !workers.empty()) {
+        // The profile is of the algorithm of the final options
+        Options last = options;
+        if (reloader != nullptr) reloader->Current(last);
+        PipelineProfile profile = workers[0]->Variant(last.edgeAlgorithm).GetProfile();
+        for (size_t i = 1; i < workers.size(); i++) profile.Merge(workers[i]->Variant(last.edgeAlgorithm).GetProfile());
+        std::ofstream file(options.profile);
+        if (!file) throw std::runtime_error("Could not write " + options.profile);
+        profile.WriteJson(file);
+    }
+
+    return failed ? 1 : 0;
+}
+
+}  // namespace found
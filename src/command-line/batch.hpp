@@ -0,0 +1,144 @@
+#ifndef BATCH_COMMAND_H
+#define BATCH_COMMAND_H
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "command-line/config.hpp"
+#include "command-line/other.hpp"
+#include "distance/edge.hpp"
+#include "pipeline/pipeline.hpp"
+
+namespace found {
+
+/**
+ * Checks the options of the edge detection algorithms
+ *
+ * @param options The options of the command line (edgeAlgorithm, locSigma and subpixelRadius)
+ *
+ * @throws invalid_argument iff edgeAlgorithm is neither "simple" nor "loc", locSigma is not
+ * positive, or subpixelRadius is negative
+ */
+void CheckEdgeOptions(const Options &options);
+
+/**
+ * Makes an edge detection algorithm refine or thin out its points, as the command line chose
+ *
+ * @param algorithm The algorithm
+ * @param options The options of the command line (subpixelRadius and maxPoints, see SubpixelOptions)
+ */
+void ConfigureEdgeDetectionAlgorithm(EdgeDetectionAlgorithm &algorithm, const Options &options);
+
+/**
+ * Makes the edge detection algorithm chosen by the command line
+ *
+ * @param options The options of the command line (edgeAlgorithm, edgeThreshold and locSigma, and
+ * subpixelRadius and maxPoints to refine or thin out the points, see SubpixelOptions)
+ *
+ * @return A new edge detection algorithm
+ *
+ * @throws invalid_argument iff the options are invalid (see CheckEdgeOptions)
+ */
+std::unique_ptr<EdgeDetectionAlgorithm> MakeEdgeDetectionAlgorithm(const Options &options);
+
+/**
+ * EdgeVariants holds a Pipeline for every edge detection algorithm,
+ * built once, so that a change of options (e.g. a new configuration
+ * file) only changes the parameters of its stages, and which one runs,
+ * instead of making new ones. The stages keep their buffers (and
+ * kernels, unless sigma changes) from one configuration to the next.
+ */
+class EdgeVariants {
+ public:
+    /**
+     * Builds the pipelines
+     *
+     * @param options The first options (see Configure)
+     *
+     * @throws invalid_argument iff the options are invalid (see CheckEdgeOptions)
+     */
+    explicit EdgeVariants(const Options &options);
+
+    EdgeVariants(const EdgeVariants &) = delete;
+    EdgeVariants &operator=(const EdgeVariants &) = delete;
+
+    /**
+     * Sets the parameters of every pipeline, and chooses the one to run
+     *
+     * @param options The options of the command line (edgeAlgorithm, edgeThreshold, locSigma,
+     * subpixelRadius and maxPoints)
+     *
+     * @throws invalid_argument iff the options are invalid (see CheckEdgeOptions),
+     * in which case this is not changed
+     */
+    void Configure(const Options &options);
+
+    /// Returns the pipeline of the edge detection algorithm that was chosen
+    Pipeline<Image, Points> &Selected() { return *this->selected; }
+
+    /**
+     * Provides the pipeline of an edge detection algorithm
+     *
+     * @param algorithm The name of the algorithm ("simple" or "loc", like edgeAlgorithm)
+     *
+     * @return The pipeline of the LoC algorithm iff algorithm is "loc", and of the simple one otherwise
+     */
+    Pipeline<Image, Points> &Variant(const std::string &algorithm) {
+        return algorithm == "loc" ? this->locPipeline : this->simplePipeline;
+    }
+
+ private:
+    /// The simple edge detection algorithm
+    SimpleEdgeDetectionAlgorithm simple;
+    /// The LoC edge detection algorithm
+    LoCEdgeDetectionAlgorithm loc;
+    /// The (empty) list of stages that the pipelines start from
+    std::vector<std::reference_wrapper<Action>> stages;
+    /// The pipeline that runs simple
+    Pipeline<Image, Points> simplePipeline;
+    /// The pipeline that runs loc
+    Pipeline<Image, Points> locPipeline;
+    /// The pipeline that was chosen
+    Pipeline<Image, Points> *selected;
+};
+
+/**
+ * Runs the batch command, which processes every frame of a manifest or directory
+ * (or a single image) in one invocation. Frames are spread across worker threads (each with its own
+ * algorithms), and one line is written per frame, in input order:
+ *
+ *     <path>\t<number of points>\t<x0> <y0> <x1> <y1> ...
+ *
+ * or, for frames that could not be processed:
+ *
+ *     <path>\terror\t<reason>
+ *
+ * Every worker builds the pipelines of its EdgeVariants once. Given a
+ * reloader, each worker polls it before every frame, and moves to new
+ * options between frames, without rebuilding its pipelines. Only the
+ * options of the edge detection algorithms and of the image format
+ * can change this way; the frames, threads and outputs are those of options.
+ *
+ * @param options The options of the command line, which must give a manifest,
+ * a directory or an image, and may give the number of threads (0 for one per core), the
+ * image format, the edge detection algorithm and a file to write the timings
+ * and counters of every stage to (as JSON, see PipelineProfile::WriteJson, for
+ * the edge detection algorithm chosen at the end)
+ * @param out The stream to write the results to
+ * @param reloader Where the options of the next frame come from (nullptr to keep options)
+ *
+ * @return 0 iff every frame was processed, and 1 otherwise
+ *
+ * @throws invalid_argument iff no manifest, directory or image is given, or the
+ * options are invalid (including a profile, in a build without instrumentation)
+ * @throws runtime_error iff the manifest or directory cannot be read, or the
+ * profile cannot be written
+ */
+int BatchCommand(const Options &options, std::ostream &out, ConfigReloader *reloader = nullptr);
+
+}  // namespace found
+
+#endif
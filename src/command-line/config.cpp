@@ -0,0 +1,179 @@
+#include "command-line/config.hpp"
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace found {
+
+void ApplyOption(const std::string &name, const std::string &value, Options &options) {
+    // The converters of options.hpp read their argument from optarg, as they do under getopt
+    const char *optarg = value.empty() ? nullptr : value.c_str();
+#define FOUND_CLI_OPTION(option, type, prop, defaultVal, converter, defaultArg)           \
+    if (name == option) {                                                                 \
+        if (optarg != nullptr) {                                                          \
+            options.prop = converter;                                                     \
+        } else if (defaultArg != 0) {                                                     \
+            options.prop = defaultArg;                                                    \
+        } else {                                                                          \
+            throw std::invalid_argument("The option " + name + " needs a value");         \
+        }                                                                                 \
+        return;                                                                           \
+    }
+#include "command-line/options.hpp"  // NOLINT
+#undef FOUND_CLI_OPTION
+    throw std::invalid_argument("Unknown option: " + name);
+}
+
+/// For command-line processing
+#define LOST_OPTIONAL_OPTARG()                                   \
+    ((optarg == NULL && optind < argc && argv[optind][0] != '-') \
+        ? static_cast<bool>(optarg = argv[optind++])             \
+        : (optarg != NULL))
+
+void ParseCommandLine(int argc, char **argv, Options &options, OptionOverrides &overrides) {
+    enum class DatabaseCliOption {
+        #define FOUND_CLI_OPTION(name, type, prop, defaultVal, converter, defaultArg) prop,
+        #include "command-line/options.hpp"
+        #undef FOUND_CLI_OPTION
+    };
+
+    static struct option long_options[] = {
+        #define FOUND_CLI_OPTION(name, type, prop, defaultVal, converter, defaultArg) \
+                    {name,                                                            \
+                    defaultArg == 0 ? required_argument : optional_argument,          \
+                    0,                                                                \
+                    static_cast<int>(DatabaseCliOption::prop)},
+        #include "command-line/options.hpp"  // NOLINT
+        #undef FOUND_CLI_OPTION
+                        {0}
+    };
+
+    int index;
+    int option;
+
+    // Starts getopt over, so that every call scans all of argv (the command in argv[1] is not an option)
+    optind = 0;
+    while ((option = getopt_long(argc, argv, "", long_options, &index)) != -1) {
+        switch (option) {
+#define FOUND_CLI_OPTION(name, type, prop, defaultVal, converter, defaultArg) \
+            case static_cast<int>(DatabaseCliOption::prop) :                  \
+                if (defaultArg == 0) {                                        \
+                    options.prop = converter;                                 \
+                } else {                                                      \
+                    if (LOST_OPTIONAL_OPTARG()) {                             \
+                        options.prop = converter;                             \
+                    } else {                                                  \
+                        options.prop = defaultArg;                            \
+                    }                                                         \
+                }                                                             \
+                overrides.emplace_back(name, optarg ? optarg : "");           \
+        break;
+#include "command-line/options.hpp"  // NOLINT
+#undef FOUND_CLI_OPTION
+            default :
+                throw std::invalid_argument("Illegal flag");
+        }
+    }
+}
+
+/**
+ * Removes the whitespace around some text
+ *
+ * @param text The text
+ *
+ * @return text, without leading or trailing whitespace
+ */
+static std::string Trim(const std::string &text) {
+    const char *whitespace = " \t\r";
+    size_t first = text.find_first_not_of(whitespace);
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+}
+
+void ReadConfig(const std::string &path, Options &options) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Could not read " + path);
+    std::string line;
+    for (size_t number = 1; std::getline(file, line); number++) {
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        size_t equals = line.find('=');
+        std::string name = Trim(line.substr(0, equals));
+        std::string value = equals == std::string::npos ? "" : Trim(line.substr(equals + 1));
+        try {
+            if (name == "config") throw std::invalid_argument("A configuration file cannot name another one");
+            ApplyOption(name, value, options);
+        } catch (const std::invalid_argument &error) {
+            throw std::invalid_argument(path + ":" + std::to_string(number) + ": " + error.what());
+        }
+    }
+}
+
+ConfigReloader::ConfigReloader(const std::string &path, const OptionOverrides &overrides,
+                               std::function<void(const Options &)> validate,
+                               std::function<void(const std::string &)> report,
+                               std::chrono::milliseconds interval)
+    : path(path), overrides(overrides), validate(validate), report(report), interval(interval), generation(0) {
+    this->stamp = this->ReadStamp();
+    this->options = this->Load();
+    this->checked = std::chrono::steady_clock::now();
+}
+
+uint64_t ConfigReloader::Poll() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - this->checked < this->interval) return this->generation;
+    this->checked = now;
+
+    Stamp latest = this->ReadStamp();
+    if (latest == this->stamp) return this->generation;
+    // A rejected version is not read again until it changes
+    this->stamp = latest;
+    try {
+        this->options = this->Load();
+        this->generation++;
+    } catch (const std::exception &error) {
+        if (this->report) this->report(error.what());
+    }
+    return this->generation;
+}
+
+uint64_t ConfigReloader::Current(Options &options) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    options = this->options;
+    return this->generation;
+}
+
+ConfigReloader::Stamp ConfigReloader::ReadStamp() const {
+    Stamp result = {0, 0, 0};
+    struct stat status;
+    if (stat(this->path.c_str(), &status) != 0) return result;
+    result.seconds = status.st_mtime;
+#ifdef __linux__
+    result.nanoseconds = status.st_mtim.tv_nsec;
+#endif
+    result.size = status.st_size;
+    return result;
+}
+
+Options ConfigReloader::Load() const {
+    Options loaded;
+    ReadConfig(this->path, loaded);
+    for (const std::pair<std::string, std::string> &option : this->overrides) {
+        if (option.first != "config") ApplyOption(option.first, option.second, loaded);
+    }
+    loaded.config = this->path;
+    if (this->validate) this->validate(loaded);
+    return loaded;
+}
+
+}  // namespace found
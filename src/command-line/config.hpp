@@ -0,0 +1,176 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "command-line/other.hpp"
+
+namespace found {
+
+/// Options given on the command line, as (name, value) pairs, in the order they were given
+typedef std::vector<std::pair<std::string, std::string>> OptionOverrides;
+
+/**
+ * Sets one option, the way the command line would
+ *
+ * @param name The name of the option (e.g. "edge-threshold")
+ * @param value The value of the option, or empty for the default
+ * argument of an option that takes an optional one
+ * @param options The options to set it in
+ *
+ * @throws invalid_argument iff no option is called name, or value is
+ * empty for an option that needs one
+ */
+void ApplyOption(const std::string &name, const std::string &value, Options &options);
+
+/**
+ * Reads the options of the command line
+ *
+ * An option whose argument is optional takes the next argument as its value
+ * too (e.g. --subpixel-radius 5), unless that is another option.
+ *
+ * @param argc The number of arguments
+ * @param argv The arguments, where argv[1] is the command
+ * @param options The options to set
+ * @param overrides Given every option, as (name, value), in order
+ *
+ * @throws invalid_argument iff an argument is not an option
+ */
+void ParseCommandLine(int argc, char **argv, Options &options, OptionOverrides &overrides);
+
+/**
+ * Reads a configuration file into options. Every line of the file is
+ *
+ *     <name> = <value>
+ *
+ * where the names are those of the command line (without the --), or
+ * just <name> for an option whose argument is optional. Blank lines,
+ * and everything after a #, are ignored.
+ *
+ * @param path The path to the file
+ * @param options The options to set
+ *
+ * @throws runtime_error iff the file cannot be read
+ * @throws invalid_argument iff a line is not an option (the message
+ * gives the line), or the file names another configuration file
+ */
+void ReadConfig(const std::string &path, Options &options);
+
+/**
+ * A ConfigReloader keeps the options of a configuration file up to
+ * date while a long run (e.g. of the batch command) goes on, so that
+ * parameters can change between frames without a restart.
+ *
+ * The options are the defaults, then the file, then the options of
+ * the command line, which always win. The file is checked again (by its
+ * modification time and size) at most once an interval, and a new
+ * version only replaces the options once it is read and validated, so
+ * a bad edit keeps the last good options.
+ *
+ * @note Every method of this is thread safe
+ */
+class ConfigReloader {
+ public:
+    /**
+     * Creates a ConfigReloader, and reads the file
+     *
+     * @param path The path to the configuration file
+     * @param overrides The options of the command line
+     * @param validate Throws iff the options it is given cannot be used (nullptr to take them all)
+     * @param report Told why a new version of the file was rejected (nullptr not to be told)
+     * @param interval The least time between two checks of the file
+     *
+     * @throws runtime_error iff the file cannot be read
+     * @throws invalid_argument iff the file or the overrides are not options,
+     * or whatever validate throws
+     */
+    ConfigReloader(const std::string &path, const OptionOverrides &overrides,
+                   std::function<void(const Options &)> validate = nullptr,
+                   std::function<void(const std::string &)> report = nullptr,
+                   std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+
+    /**
+     * Reads the file again iff it changed, and its last check is at least an interval ago
+     *
+     * @return The generation of the options, which goes up every time they change
+     */
+    uint64_t Poll();
+
+    /**
+     * Provides the current options
+     *
+     * @param options Set to the options
+     *
+     * @return The generation of options
+     */
+    uint64_t Current(Options &options) const;
+
+ private:
+    /**
+     * Identifies a version of the file
+     */
+    struct Stamp {
+        /// The modification time, in seconds
+        time_t seconds;
+        /// The fraction of a second of the modification time, in nanoseconds
+        long nanoseconds;  // NOLINT
+        /// The size, in bytes
+        off_t size;
+
+        /// Returns true iff this and other are the same version
+        bool operator==(const Stamp &other) const {
+            return this->seconds == other.seconds && this->nanoseconds == other.nanoseconds &&
+                   this->size == other.size;
+        }
+    };
+
+    /**
+     * Provides the version of the file
+     *
+     * @return The stamp of the file (all zeroes if it does not exist)
+     */
+    Stamp ReadStamp() const;
+
+    /**
+     * Reads and validates the options
+     *
+     * @return The options
+     *
+     * @throws Whatever ReadConfig, ApplyOption or validate throws
+     */
+    Options Load() const;
+
+    /// The path to the configuration file
+    std::string path;
+    /// The options of the command line
+    OptionOverrides overrides;
+    /// Validates the options of a new version
+    std::function<void(const Options &)> validate;
+    /// Told why a new version was rejected
+    std::function<void(const std::string &)> report;
+    /// The least time between two checks of the file
+    std::chrono::milliseconds interval;
+    /// The current options
+    Options options;
+    /// The generation of options
+    uint64_t generation;
+    /// The version of the file that was last read
+    Stamp stamp;
+    /// The time of the last check
+    std::chrono::steady_clock::time_point checked;
+    /// The lock guarding everything above
+    mutable std::mutex mutex;
+};
+
+}  // namespace found
+
+#endif
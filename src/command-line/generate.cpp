@@ -0,0 +1,182 @@
+#include "command-line/generate.hpp"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "io/image.hpp"
+#include "io/serialization.hpp"
+#include "pipeline/batch.hpp"
+
+namespace found {
+
+/// The size of a generated image, if the command line does not give one
+const int kGeneratedResolution = 1024;
+/// The number of points the horizon of each frame is sampled at, for the truth file
+const size_t kTruthSamples = 4096;
+/// Spreads the seeds of consecutive frames across the sequences of the noise
+const uint64_t kFrameSeedStride = 0xD1B54A32D192ED03ull;
+
+void GenerateViewpoint(const Options &options, size_t index, PositionVector &position, Attitude &attitude) {
+    preciseDecimal radius = options.equatorialRadius + options.altitude;
+    // Wrapped before the conversion, so that angles far along the orbit stay precise
+    preciseDecimal angle = DegToRad(fmod(static_cast<preciseDecimal>(options.orbitStep) * index, 360));
+    preciseDecimal inclination = DegToRad(options.inclination);
+    PreciseVec3 outward(cos(angle), sin(angle) * cos(inclination), sin(angle) * sin(inclination));
+    PreciseVec3 ahead(-sin(angle), cos(angle) * cos(inclination), cos(angle) * sin(inclination));
+
+    // The horizon of a sphere is asin(R / r) from nadir
+    preciseDecimal elevation = asin(std::min(options.equatorialRadius / radius, static_cast<preciseDecimal>(1))) +
+                               DegToRad(options.pitch);
+    PreciseVec3 forward = outward * -cos(elevation) + ahead * sin(elevation);
+    // Up in the image is away from Earth, so the horizon is level
+    PreciseVec3 up = (outward - forward * (outward * forward)).Normalize();
+    PreciseVec3 left = up.CrossProduct(forward);
+
+    position = PrecisionCast<decimal>(outward * radius);
+    attitude = Attitude(PrecisionCast<decimal>(PreciseMat3{{forward.x, forward.y, forward.z,
+                                                           left.x, left.y, left.z,
+                                                           up.x, up.y, up.z}}));
+}
+
+LensDistortion ParseDistortion(const std::string &text) {
+    std::vector<decimal> coefficients;
+    const char *cursor = text.c_str();
+    while (*cursor != '\0') {
+        char *end;
+        coefficients.push_back(static_cast<decimal>(strtod(cursor, &end)));
+        // A comma must be followed by another number
+        if (end == cursor || (*end != ',' && *end != '\0') || (*end == ',' && end[1] == '\0') ||
+            coefficients.size() > 5) {
+            throw std::invalid_argument("The distortion must be up to 5 comma separated numbers");
+        }
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    coefficients.resize(5, 0);
+    LensDistortion distortion = {coefficients[0], coefficients[1], coefficients[4], coefficients[2], coefficients[3]};
+    return distortion;
+}
+
+/**
+ * Gives the camera of the generate command its table of rays
+ *
+ * @param options The options of the command line
+ * @param camera The camera, which is given the table
+ *
+ * @throws invalid_argument iff the step of the table is not positive
+ * @throws runtime_error iff the table cannot be written
+ */
+static void SetUpRayTable(const Options &options, Camera &camera) {
+    if (options.rayTable.empty()) {
+        if (camera.Distorted()) camera.BuildRayTable(options.rayTableStep);
+        return;
+    }
+    try {
+        std::shared_ptr<const RayTable> table = ReadRayTable(options.rayTable);
+        if (table->Step() == options.rayTableStep) {
+            camera.SetRayTable(table);
+            return;
+        }
+    } catch (const std::exception &) {
+        // There is no table for this camera yet, so it is made below
+    }
+    camera.BuildRayTable(options.rayTableStep);
+    std::vector<unsigned char> buffer;
+    SerializeRayTable(*camera.Table(), buffer);
+    WriteRecords(options.rayTable, buffer);
+}
+
+int GenerateCommand(const Options &options, std::ostream &out) {
+    if (options.output.empty()) throw std::invalid_argument("The generate command needs an --output directory");
+    if (options.frames < 0) throw std::invalid_argument("The number of frames must not be negative");
+    if (options.threads < 0) throw std::invalid_argument("The number of threads must not be negative");
+    if (!(options.altitude > 0)) throw std::invalid_argument("The altitude must be positive");
+    if (options.imageWidth < 0 || options.imageHeight < 0 || options.focalLength < 0) {
+        throw std::invalid_argument("The camera must have a positive size and focal length");
+    }
+    int width = options.imageWidth > 0 ? options.imageWidth : kGeneratedResolution;
+    int height = options.imageHeight > 0 ? options.imageHeight : kGeneratedResolution;
+    Camera camera(options.focalLength > 0 ? options.focalLength : width, width, height);
+    camera.SetDistortion(ParseDistortion(options.distortion));
+    SetUpRayTable(options, camera);
+
+    RenderOptions render;
+    render.equatorialRadius = options.equatorialRadius;
+    render.polarRadius = options.polarRadius;
+    render.supersample = options.supersample;
+    render.blurSigma = options.blur;
+    render.noiseSigma = options.noise;
+    render.terminator = options.terminator;
+    preciseDecimal sunLongitude = DegToRad(options.sunLongitude);
+    render.sunDirection = PreciseVec3(cos(sunLongitude), sin(sunLongitude), 0);
+    // Fails early (instead of on a worker) on bad options
+    PositionVector position;
+    Attitude attitude;
+    GenerateViewpoint(options, 0, position, attitude);
+    RenderHorizon(camera, position, attitude, render, 0);
+
+    if (mkdir(options.output.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Could not make " + options.output);
+    }
+    std::ofstream truth;
+    if (!options.truth.empty()) {
+        truth.open(options.truth);
+        if (!truth) throw std::runtime_error("Could not write " + options.truth);
+    }
+
+    size_t frames = static_cast<size_t>(options.frames);
+    size_t threads = options.threads > 0 ? options.threads : TaskScheduler::Default().Workers();
+    std::function<std::function<std::string(size_t)>()> makeProcessor = [&]() {
+        return std::function<std::string(size_t)>([&](size_t index) {
+            std::ostringstream path;
+            path << options.output << "/frame-" << std::setw(6) << std::setfill('0') << index << ".pgm";
+            PositionVector position;
+            Attitude attitude;
+            GenerateViewpoint(options, index, position, attitude);
+            RenderOptions frame = render;
+            frame.seed = options.seed + index * kFrameSeedStride;
+            WriteNetpbmImage(path.str(), RenderEarth(camera, position, attitude, frame));
+
+            std::ostringstream line;
+            line << path.str();
+            if (!options.truth.empty()) {
+                Points points = RenderHorizon(camera, position, attitude, frame, kTruthSamples);
+                line << '\t' << std::setprecision(9) << position.Magnitude() << '\t' << points.size() << '\t';
+                for (size_t i = 0; i < points.size(); i++) {
+                    line << (i == 0 ? "" : " ") << points.x()[i] << ' ' << points.y()[i];
+                }
+            }
+            return line.str();
+        });
+    };
+    std::function<void(size_t, std::string &)> emit = [&](size_t, std::string &line) {
+        if (options.truth.empty()) {
+            out << line << '\n';
+        } else {
+            out << line.substr(0, line.find('\t')) << '\n';
+            truth << line << '\n';
+        }
+    };
+    RunBatch<std::string>(frames, threads, makeProcessor, emit);
+    out.flush();
+    if (truth.is_open()) {
+        truth.flush();
+        if (!truth) throw std::runtime_error("Could not write " + options.truth);  // GCOVR_EXCL_LINE
+    }
+    return 0;
+}
+
+}  // namespace found
@@ -0,0 +1,75 @@
+#ifndef GENERATE_COMMAND_H
+#define GENERATE_COMMAND_H
+
+#include <stddef.h>
+
+#include <ostream>
+#include <string>
+
+#include "command-line/other.hpp"
+#include "io/render.hpp"
+
+namespace found {
+
+/**
+ * Provides where the generate command takes a frame from
+ *
+ * The camera is on a circular orbit altitude above the equator (inclined by
+ * inclination), orbitStep further along it every frame. It looks ahead along
+ * its orbit, at the horizon, tilted up by pitch.
+ *
+ * @param options The options of the command line (altitude, inclination, orbitStep,
+ * pitch and equatorialRadius, in km and degrees)
+ * @param index The index of the frame
+ * @param position Set to the position of the camera, relative to Earth's center
+ * @param attitude Set to the attitude of the camera
+ */
+void GenerateViewpoint(const Options &options, size_t index, PositionVector &position, Attitude &attitude);
+
+/**
+ * Reads the distortion of a lens off the command line
+ *
+ * @param text Up to five comma separated coefficients, in the order OpenCV gives
+ * them (k1, k2, p1, p2, k3), where missing ones are 0
+ *
+ * @return The distortion (none if text is empty)
+ *
+ * @throws invalid_argument iff text is not a list of up to five numbers
+ */
+LensDistortion ParseDistortion(const std::string &text);
+
+/**
+ * Runs the generate command, which renders a synthetic Earth limb into each
+ * frame of a corpus (see RenderEarth), across worker threads. Frame i is
+ * written to <output>/frame-<i>.pgm, and its path to out, in order, so that out
+ * is a manifest of the corpus. With --truth, one line per frame is also written
+ * to the truth file:
+ *
+ *     <path>\t<distance>\t<number of points>\t<x0> <y0> <x1> <y1> ...
+ *
+ * where distance is from the camera to Earth's center, and the points are the
+ * horizon in the frame (see RenderHorizon). Every frame is seeded by its index,
+ * so a corpus is the same for any number of threads.
+ *
+ * A distorted camera looks its rays up in a RayTable, with an entry every
+ * ray-table-step pixels. With --ray-table, the table is read from that file if it
+ * was made for the same camera, and made and written there otherwise, so later
+ * runs skip making it.
+ *
+ * @param options The options of the command line, which must give the output directory,
+ * and may give the number of frames and threads (0 for one per core), the camera
+ * (image-width, image-height, focal-length, distortion, ray-table, ray-table-step), the
+ * orbit (see GenerateViewpoint), the Earth (equatorial-radius, polar-radius), the effects
+ * (noise, blur, terminator and sun-longitude, supersample, seed) and the truth file
+ * @param out The stream to write the manifest to
+ *
+ * @return 0
+ *
+ * @throws invalid_argument iff the options are invalid
+ * @throws runtime_error iff a frame or the truth file cannot be written
+ */
+int GenerateCommand(const Options &options, std::ostream &out);
+
+}  // namespace found
+
+#endif
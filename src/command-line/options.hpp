@@ -14,4 +14,39 @@
 
 #include <string>
 
-FOUND_CLI_OPTION("png", std::string, png, "", optarg, kNoDefaultArgument)
+FOUND_CLI_OPTION("config"           , std::string   , config          , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("png"              , std::string   , png             , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("image"            , std::string   , image           , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("image-width"      , int           , imageWidth      , 0       , atoi(optarg)                 , kNoDefaultArgument)
+FOUND_CLI_OPTION("image-height"     , int           , imageHeight     , 0       , atoi(optarg)                 , kNoDefaultArgument)
+FOUND_CLI_OPTION("image-channels"   , int           , imageChannels   , 1       , atoi(optarg)                 , kNoDefaultArgument)
+FOUND_CLI_OPTION("image-offset"     , size_t        , imageOffset     , 0       , strtoul(optarg, nullptr, 10) , kNoDefaultArgument)
+FOUND_CLI_OPTION("manifest"         , std::string   , manifest        , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("directory"        , std::string   , directory       , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("output"           , std::string   , output          , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("threads"          , int           , threads         , 0       , atoi(optarg)                 , kNoDefaultArgument)
+FOUND_CLI_OPTION("pin-threads"      , bool          , pinThreads      , false   , atoi(optarg) != 0            , true)
+FOUND_CLI_OPTION("edge-algorithm"   , std::string   , edgeAlgorithm   , "simple", optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("edge-threshold"   , found::decimal, edgeThreshold   , 100     , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("loc-sigma"        , found::decimal, locSigma        , 1.5     , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("subpixel-radius"  , int           , subpixelRadius  , 0       , atoi(optarg)                 , 3)
+FOUND_CLI_OPTION("max-points"       , size_t        , maxPoints       , 0       , strtoul(optarg, nullptr, 10) , kNoDefaultArgument)
+FOUND_CLI_OPTION("profile"          , std::string   , profile         , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("frames"           , int           , frames          , 1       , atoi(optarg)                 , kNoDefaultArgument)
+FOUND_CLI_OPTION("focal-length"     , found::decimal, focalLength     , 0       , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("distortion"       , std::string   , distortion      , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("ray-table"        , std::string   , rayTable        , ""      , optarg                       , kNoDefaultArgument)
+FOUND_CLI_OPTION("ray-table-step"   , int           , rayTableStep    , 8       , atoi(optarg)                 , kNoDefaultArgument)
+FOUND_CLI_OPTION("altitude"         , found::decimal, altitude        , 500     , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("inclination"      , found::decimal, inclination     , 45      , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("orbit-step"       , found::decimal, orbitStep       , 1       , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("pitch"            , found::decimal, pitch           , 0       , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("equatorial-radius", found::decimal, equatorialRadius, 6378.137, strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("polar-radius"     , found::decimal, polarRadius     , 6356.752, strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("noise"            , found::decimal, noise           , 0       , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("blur"             , found::decimal, blur            , 0       , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("terminator"       , bool          , terminator      , false   , atoi(optarg) != 0            , true)
+FOUND_CLI_OPTION("sun-longitude"    , found::decimal, sunLongitude    , 0       , strtof(optarg, nullptr)      , kNoDefaultArgument)
+FOUND_CLI_OPTION("seed"             , uint64_t      , seed            , 0       , strtoull(optarg, nullptr, 10), kNoDefaultArgument)
+FOUND_CLI_OPTION("supersample"      , int           , supersample     , 4       , atoi(optarg)                 , kNoDefaultArgument)
+FOUND_CLI_OPTION("truth"            , std::string   , truth           , ""      , optarg                       , kNoDefaultArgument)
@@ -1,3 +1,20 @@
+#ifndef OTHER_H
+#define OTHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "spatial/attitude-utils.hpp"
+
+namespace found {
+
+/// For macro processing
+const char kNoDefaultArgument = 0;
+
+}  // namespace found
+
 class Options {
  public:
 #define FOUND_CLI_OPTION(name, type, prop, defaultVal, converter, defaultArg) \
@@ -5,3 +22,5 @@ class Options {
 #include "options.hpp"  // NOLINT
 #undef FOUND_CLI_OPTION
 };
+
+#endif
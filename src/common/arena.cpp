@@ -0,0 +1,79 @@
+#include "common/arena.hpp"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+namespace found {
+
+/**
+ * Allocates aligned memory from the heap
+ *
+ * @param bytes The number of bytes to allocate
+ * @param alignment The alignment of the memory (a power of 2, at least kVectorAlignment)
+ *
+ * @return The memory
+ *
+ * @throws bad_alloc iff the memory cannot be allocated
+ */
+static void *AllocateAligned(size_t bytes, size_t alignment) {
+    void *memory = nullptr;
+    if (posix_memalign(&memory, alignment, std::max(bytes, static_cast<size_t>(1))) != 0) throw std::bad_alloc();
+    return memory;
+}
+
+Arena::Arena(size_t capacity)
+    : block(nullptr), capacity(0), used(0), overflowBytes(0), highWater(0), heapAllocations(0) {
+    if (capacity > 0) this->Grow(capacity);
+}
+
+Arena::Arena(const Arena &other) : Arena(other.capacity) {}
+
+Arena::~Arena() {
+    for (void *memory : this->overflow) free(memory);
+    free(this->block);
+}
+
+void *Arena::Allocate(size_t bytes, size_t alignment) {
+    if (this->block != nullptr) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(this->block);
+        size_t start = ((base + this->used + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+        if (start <= this->capacity && bytes <= this->capacity - start) {
+            this->used = start + bytes;
+            this->highWater = std::max(this->highWater, this->Used());
+            return this->block + start;
+        }
+    }
+    // Too big for the block, until it grows
+    void *memory = AllocateAligned(bytes, std::max(alignment, kVectorAlignment));
+    this->overflow.push_back(memory);
+    this->overflowBytes += bytes + alignment;
+    this->heapAllocations++;
+    this->highWater = std::max(this->highWater, this->Used());
+    return memory;
+}
+
+void Arena::Rewind(const ArenaMark &mark) {
+    while (this->overflow.size() > mark.overflows) {
+        free(this->overflow.back());
+        this->overflow.pop_back();
+    }
+    this->used = mark.used;
+    this->overflowBytes = mark.overflowBytes;
+    if (this->used == 0 && this->overflow.empty() && this->highWater > this->capacity) this->Grow(this->highWater);
+}
+
+void Arena::Grow(size_t size) {
+    // Grows by at least half, so that slowly growing frames do not reallocate every time
+    size_t grown = std::max(size, this->capacity + this->capacity / 2);
+    unsigned char *larger = static_cast<unsigned char *>(AllocateAligned(grown, kVectorAlignment));
+    free(this->block);
+    this->block = larger;
+    this->capacity = grown;
+    this->heapAllocations++;
+}
+
+}  // namespace found
@@ -0,0 +1,269 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "common/memory.hpp"
+
+namespace found {
+
+/**
+ * An ArenaMark is a point in the history of an Arena, that it can be
+ * rewound to
+ */
+struct ArenaMark {
+    /// The number of bytes of the block in use
+    size_t used;
+    /// The number of overflow allocations
+    size_t overflows;
+    /// The number of bytes of the overflow allocations
+    size_t overflowBytes;
+};
+
+/**
+ * An Arena is a bump allocator for scratch memory that lives for one
+ * frame (i.e. one run of a Pipeline). Allocating moves a pointer through
+ * one block, and freeing everything at once (Reset) moves it back, so
+ * neither touches the heap.
+ *
+ * When a frame needs more than the block holds, the rest is allocated
+ * from the heap, and the block is grown to the most any frame needed once
+ * the arena is next emptied. After the first frames, an arena therefore
+ * never calls the heap.
+ *
+ * @note An Arena is not thread safe, so each thread needs its own. Copying
+ * an Arena makes an empty one, since scratch memory is never shared.
+ */
+class Arena {
+ public:
+    /**
+     * Creates an Arena
+     *
+     * @param capacity The size of the first block, in bytes (0 to allocate it on first use)
+     */
+    explicit Arena(size_t capacity = 0);
+
+    /**
+     * Creates an empty Arena, with the capacity of another
+     *
+     * @param other The other Arena
+     */
+    Arena(const Arena &other);
+
+    /**
+     * Keeps this as it is (scratch memory is never copied)
+     *
+     * @return this
+     */
+    Arena &operator=(const Arena &) { return *this; }
+
+    /**
+     * Destroys this, freeing all of its memory
+     */
+    ~Arena();
+
+    /**
+     * Allocates memory, which lives until this is rewound past it or reset
+     *
+     * @param bytes The number of bytes to allocate
+     * @param alignment The alignment of the memory (a power of 2)
+     *
+     * @return The memory
+     *
+     * @throws bad_alloc iff the memory cannot be allocated
+     */
+    void *Allocate(size_t bytes, size_t alignment = kVectorAlignment);
+
+    /**
+     * Allocates memory for items, aligned for vectorized loops
+     *
+     * @param T The type of item
+     *
+     * @param count The number of items
+     *
+     * @return The (uninitialized) memory for the items
+     *
+     * @throws bad_alloc iff the memory cannot be allocated
+     */
+    template<typename T>
+    T *Allocate(size_t count) {
+        size_t alignment = alignof(T) > kVectorAlignment ? alignof(T) : kVectorAlignment;
+        return static_cast<T *>(this->Allocate(count * sizeof(T), alignment));
+    }
+
+    /**
+     * Provides the current point in the history of this
+     *
+     * @return A mark to rewind this to
+     */
+    ArenaMark Mark() const { return {this->used, this->overflow.size(), this->overflowBytes}; }
+
+    /**
+     * Frees everything allocated since a mark
+     *
+     * @param mark The mark, from Mark
+     *
+     * @note If this is emptied and a frame has outgrown the block, the block is grown
+     */
+    void Rewind(const ArenaMark &mark);
+
+    /**
+     * Frees everything, in constant time (unless the block must grow)
+     */
+    void Reset() { this->Rewind({0, 0, 0}); }
+
+    /// Returns the number of bytes in use
+    size_t Used() const { return this->used + this->overflowBytes; }
+    /// Returns the size of the block, in bytes
+    size_t Capacity() const { return this->capacity; }
+    /// Returns the most bytes that were ever in use at once
+    size_t HighWater() const { return this->highWater; }
+    /// Returns the number of times this has called the heap
+    uint64_t HeapAllocations() const { return this->heapAllocations; }
+
+ private:
+    /**
+     * Replaces the block with a larger one
+     *
+     * @param size The least size of the new block, in bytes
+     *
+     * @pre Nothing is in use
+     */
+    void Grow(size_t size);
+
+    /// The block that memory is bumped through (aligned to kVectorAlignment)
+    unsigned char *block;
+    /// The size of block
+    size_t capacity;
+    /// The number of bytes of block in use
+    size_t used;
+    /// The allocations that did not fit in block, from the heap
+    std::vector<void *> overflow;
+    /// The number of bytes of the overflow allocations (with their alignment)
+    size_t overflowBytes;
+    /// The most bytes that were ever in use at once
+    size_t highWater;
+    /// The number of times this has called the heap
+    uint64_t heapAllocations;
+};
+
+/**
+ * An ArenaScope frees everything allocated from an Arena while it
+ * exists, once it is destroyed
+ */
+class ArenaScope {
+ public:
+    /**
+     * Creates an ArenaScope
+     *
+     * @param arena The arena to rewind
+     */
+    explicit ArenaScope(Arena &arena) : arena(arena), mark(arena.Mark()) {}
+
+    /**
+     * Rewinds the arena to where it was when this was created
+     */
+    ~ArenaScope() { this->arena.Rewind(this->mark); }
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+ private:
+    /// The arena to rewind
+    Arena &arena;
+    /// Where to rewind arena to
+    ArenaMark mark;
+};
+
+/**
+ * An ArenaAllocator is an allocator for standard containers that takes
+ * their storage from an Arena, so that containers of a frame never call
+ * the heap. Without an arena, it allocates like an AlignedAllocator.
+ *
+ * @param T The type of item to allocate
+ *
+ * @note Freeing storage from an arena does nothing, so a container that
+ * keeps growing wastes the storage it outgrows until the arena is reset
+ */
+template<typename T>
+class ArenaAllocator {
+ public:
+    /// The type of item allocated
+    typedef T value_type;
+
+    /**
+     * The same allocator, for another type of item
+     */
+    template<typename U>
+    struct rebind {
+        /// The allocator for U
+        typedef ArenaAllocator<U> other;
+    };
+
+    /**
+     * Creates an ArenaAllocator
+     *
+     * @param arena The arena to allocate from (nullptr for the heap)
+     */
+    explicit ArenaAllocator(Arena *arena = nullptr) : arena(arena) {}
+
+    /**
+     * Creates an ArenaAllocator from one of another type of item
+     */
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.GetArena()) {}  // NOLINT
+
+    /**
+     * Allocates storage
+     *
+     * @param count The number of items to allocate storage for
+     *
+     * @return The start of the storage, aligned to kVectorAlignment
+     *
+     * @throws bad_alloc iff the storage cannot be allocated
+     */
+    T *allocate(size_t count) {
+        if (this->arena != nullptr) return this->arena->template Allocate<T>(count);
+        return AlignedAllocator<T>().allocate(count);
+    }
+
+    /**
+     * Frees storage (if it is from the heap)
+     *
+     * @param storage The storage, from allocate
+     * @param count The number of items of the storage
+     */
+    void deallocate(T *storage, size_t count) {
+        if (this->arena == nullptr) AlignedAllocator<T>().deallocate(storage, count);
+    }
+
+    /// Returns the arena this allocates from (nullptr for the heap)
+    Arena *GetArena() const { return this->arena; }
+
+ private:
+    /// The arena this allocates from (nullptr for the heap)
+    Arena *arena;
+};
+
+/**
+ * Compares two ArenaAllocators, which are interchangeable iff they allocate from the same arena
+ */
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.GetArena() == b.GetArena();
+}
+
+/**
+ * Compares two ArenaAllocators, which are interchangeable iff they allocate from the same arena
+ */
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.GetArena() != b.GetArena();
+}
+
+}  // namespace found
+
+#endif
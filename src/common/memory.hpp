@@ -0,0 +1,92 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stdlib.h>
+#include <stddef.h>
+
+#include <new>
+
+namespace found {
+
+/// The alignment of buffers that vectorized loops run over (enough for AVX)
+const size_t kVectorAlignment = 32;
+
+/**
+ * An AlignedAllocator is an allocator for standard containers whose
+ * storage starts at a multiple of an alignment, so that vectorized
+ * loops over it can use aligned loads and stores.
+ *
+ * @param T The type of item to allocate
+ * @param Alignment The alignment of each allocation, in bytes (a power
+ * of 2, and a multiple of sizeof(void *))
+ */
+template<typename T, size_t Alignment = kVectorAlignment>
+class AlignedAllocator {
+ public:
+    /// The type of item allocated
+    typedef T value_type;
+
+    /**
+     * The same allocator, for another type of item
+     */
+    template<typename U>
+    struct rebind {
+        /// The allocator for U
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    /**
+     * Creates an AlignedAllocator
+     */
+    AlignedAllocator() {}
+
+    /**
+     * Creates an AlignedAllocator from one of another type of item
+     */
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}  // NOLINT
+
+    /**
+     * Allocates storage
+     *
+     * @param count The number of items to allocate storage for
+     *
+     * @return The start of the storage, aligned to Alignment
+     *
+     * @throws bad_alloc iff the storage cannot be allocated
+     */
+    T *allocate(size_t count) {
+        void *storage = nullptr;
+        if (posix_memalign(&storage, Alignment, count * sizeof(T)) != 0) throw std::bad_alloc();
+        return static_cast<T *>(storage);
+    }
+
+    /**
+     * Frees storage
+     *
+     * @param storage The storage, from allocate
+     */
+    void deallocate(T *storage, size_t) {
+        free(storage);
+    }
+};
+
+/**
+ * Compares two AlignedAllocators, which are always interchangeable
+ */
+template<typename T, typename U, size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &) {
+    return true;
+}
+
+/**
+ * Compares two AlignedAllocators, which are always interchangeable
+ */
+template<typename T, typename U, size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &) {
+    return false;
+}
+
+}  // namespace found
+
+#endif
@@ -0,0 +1,551 @@
+#include "distance/distance.hpp"
+
+#include <math.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "common/memory.hpp"
+
+namespace found {
+
+/// The number of rays made at once by distance algorithms
+const size_t kRayBatchSize = 256;
+
+/// The cutoff of Tukey's biweight, in inlier thresholds
+const double kTukeyCutoff = 2;
+
+DistanceDeterminationAlgorithm::~DistanceDeterminationAlgorithm() {}
+
+/**
+ * ConeSums accumulates the (weighted) normal equations of fitting
+ * u . n = 1 over unit rays u
+ */
+struct ConeSums {
+    /// The sums of the products of the components of the rays
+    double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
+    /// The sums of the components of the rays
+    double sx = 0, sy = 0, sz = 0;
+    /// The sum of the weights of the rays
+    double sw = 0;
+
+    /**
+     * Adds a ray
+     *
+     * @param x,y,z The ray
+     * @param weight The weight of the ray
+     */
+    void Add(double x, double y, double z, double weight) {
+        double wx = weight * x, wy = weight * y, wz = weight * z;
+        xx += wx * x; xy += wx * y; xz += wx * z;
+        yy += wy * y; yz += wy * z; zz += wz * z;
+        sx += wx; sy += wy; sz += wz;
+        sw += weight;
+    }
+};
+
+/**
+ * Solves a symmetric 3x3 linear system with its adjugate
+ *
+ * @param a The upper triangle of the matrix {a00, a01, a02, a11, a12, a22}
+ * @param b The right hand side
+ * @param x The output, i.e. the solution
+ *
+ * @return true iff the matrix is not (nearly) singular
+ */
+static bool SolveSymmetric3(const double a[6], const double b[3], double x[3]) {
+    double c00 = a[3] * a[5] - a[4] * a[4];
+    double c01 = a[2] * a[4] - a[1] * a[5];
+    double c02 = a[1] * a[4] - a[2] * a[3];
+    double c11 = a[0] * a[5] - a[2] * a[2];
+    double c12 = a[1] * a[2] - a[0] * a[4];
+    double c22 = a[0] * a[3] - a[1] * a[1];
+    double determinant = a[0] * c00 + a[1] * c01 + a[2] * c02;
+    double trace = a[0] + a[3] + a[5];
+    if (!(fabs(determinant) > 1e-12 * trace * trace * trace)) return false;
+    x[0] = (c00 * b[0] + c01 * b[1] + c02 * b[2]) / determinant;
+    x[1] = (c01 * b[0] + c11 * b[1] + c12 * b[2]) / determinant;
+    x[2] = (c02 * b[0] + c12 * b[1] + c22 * b[2]) / determinant;
+    return true;
+}
+
+/**
+ * Solves the normal equations of a cone fit
+ *
+ * @param sums The normal equations
+ * @param n The output, i.e. c / cos(theta) of the fit cone
+ *
+ * @return true iff the rays determine a cone
+ */
+static bool SolveCone(const ConeSums &sums, double n[3]) {
+    double a[6] = {sums.xx, sums.xy, sums.xz, sums.yy, sums.yz, sums.zz};
+    double b[3] = {sums.sx, sums.sy, sums.sz};
+    // Well fit unit rays always give |n| > 1
+    return SolveSymmetric3(a, b, n) && n[0] * n[0] + n[1] * n[1] + n[2] * n[2] > 1;
+}
+
+/**
+ * A Cone is the cone of a fit horizon, set up to measure how far rays are from it
+ */
+struct Cone {
+    /**
+     * Creates a Cone
+     *
+     * @param n c / cos(theta) of the cone
+     */
+    explicit Cone(const double n[3]) {
+        double norm = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        cx = n[0] / norm; cy = n[1] / norm; cz = n[2] / norm;
+        cosine = 1 / norm;
+        inverseSine = 1 / sqrt(1 - cosine * cosine);
+    }
+
+    /**
+     * Measures how far a ray is from this
+     *
+     * @param x,y,z The unit ray
+     *
+     * @return The angle between the ray and this, to first order
+     */
+    double Residual(double x, double y, double z) const {
+        return fabs(cx * x + cy * y + cz * z - cosine) * inverseSine;
+    }
+
+    /// The direction of the axis of the cone
+    double cx, cy, cz;
+    /// The cosine of the half angle of the cone
+    double cosine;
+    /// The inverse of the sine of the half angle of the cone
+    double inverseSine;
+};
+
+/**
+ * Measures how far the rays of a cone fit are from it, from its normal equations alone
+ *
+ * @param sums The normal equations of the fit
+ * @param n c / cos(theta) of the fit cone
+ *
+ * @return The root mean square angle between the rays and the cone, to first order
+ */
+static double ConeResidual(const ConeSums &sums, const double n[3]) {
+    if (!(sums.sw > 0)) return 0;
+    // The sum of (u . n - 1)^2 = n^T (sum of u u^T) n - 2 n . (sum of u) + sum of 1
+    double squares = sums.xx * n[0] * n[0] + sums.yy * n[1] * n[1] + sums.zz * n[2] * n[2] +
+                     2 * (sums.xy * n[0] * n[1] + sums.xz * n[0] * n[2] + sums.yz * n[1] * n[2]) -
+                     2 * (sums.sx * n[0] + sums.sy * n[1] + sums.sz * n[2]) + sums.sw;
+    // An angle from the cone is (u . n - 1) cos(theta) / sin(theta) = (u . n - 1) / sqrt(|n|^2 - 1)
+    double norm2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+    return sqrt(std::max(squares, 0.0) / sums.sw / (norm2 - 1));
+}
+
+/**
+ * Measures how far rays are from a cone
+ *
+ * @param x,y,z The unit rays
+ * @param size The number of rays
+ * @param n c / cos(theta) of the cone
+ * @param cutoff The furthest a ray may be from the cone to be measured (an angle)
+ *
+ * @return The root mean square angle between the measured rays and the cone, to first order
+ * (0 if no ray is measured)
+ */
+static double RaysResidual(const decimal *x, const decimal *y, const decimal *z, size_t size,
+                           const double n[3], double cutoff) {
+    Cone cone(n);
+    double squares = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < size; i++) {
+        double residual = cone.Residual(x[i], y[i], z[i]);
+        if (residual > cutoff) continue;
+        squares += residual * residual;
+        count++;
+    }
+    return count > 0 ? sqrt(squares / count) : 0;
+}
+
+/**
+ * Checks the options of a robust fit, and draws the random numbers its samples are made with
+ *
+ * @param robust How to reject outliers
+ *
+ * @return The uniform random numbers in [0, 1) to draw samples with (3 per iteration)
+ *
+ * @throws invalid_argument iff robust is invalid
+ */
+static std::vector<decimal> MakeSamplePool(const RobustFitOptions &robust) {
+    if (robust.inlierThreshold <= 0) throw std::invalid_argument("The inlier threshold must be positive");
+    if (robust.confidence <= 0 || robust.confidence >= 1) throw std::invalid_argument("The confidence must be in (0, 1)");
+    if (robust.targetInlierRatio <= 0 || robust.targetInlierRatio > 1) {
+        throw std::invalid_argument("The target inlier ratio must be in (0, 1]");
+    }
+    if (robust.maxIterations <= 0 || robust.refinementIterations < 0) {
+        throw std::invalid_argument("The number of iterations must be positive");
+    }
+    std::mt19937 generator(robust.seed);
+    std::uniform_real_distribution<decimal> uniform(0, 1);
+    std::vector<decimal> pool(3 * robust.maxIterations);
+    for (decimal &sample : pool) sample = uniform(generator);
+    return pool;
+}
+
+/**
+ * Finds the cone that the most rays are close to, by RANSAC over minimal samples (3 rays)
+ *
+ * @param x,y,z The unit rays
+ * @param size The number of rays
+ * @param threshold The furthest an inlier can be from a cone (an angle)
+ * @param options How many samples to take
+ * @param pool The random numbers to draw the samples with (see MakeSamplePool)
+ * @param inFront true to only take cones whose axis is in front of the camera
+ * @param best The output, i.e. c / cos(theta) of the cone with the most inliers
+ *
+ * @return The number of inliers of best (less than 3 iff no sample determines a cone)
+ */
+static size_t SampleCone(const decimal *x, const decimal *y, const decimal *z, size_t size, double threshold,
+                         const RobustFitOptions &options, const std::vector<decimal> &pool, bool inFront,
+                         double best[3]) {
+    size_t bestInliers = 0;
+    double required = options.maxIterations;
+    for (int iteration = 0; iteration < required; iteration++) {
+        size_t sample[3];
+        for (int k = 0; k < 3; k++) {
+            sample[k] = std::min(static_cast<size_t>(pool[3 * iteration + k] * size), size - 1);
+        }
+        if (sample[0] == sample[1] || sample[0] == sample[2] || sample[1] == sample[2]) continue;
+
+        ConeSums sums;
+        for (size_t index : sample) sums.Add(x[index], y[index], z[index], 1);
+        double candidate[3];
+        if (!SolveCone(sums, candidate) || (inFront && candidate[0] <= 0)) continue;
+
+        Cone cone(candidate);
+        size_t inliers = 0;
+        for (size_t i = 0; i < size; i++) {
+            if (cone.Residual(x[i], y[i], z[i]) <= threshold) inliers++;
+        }
+        if (inliers <= bestInliers) continue;
+        bestInliers = inliers;
+        std::copy(candidate, candidate + 3, best);
+
+        // Stops early once enough points agree, and otherwise takes only as
+        // many samples as needed to have sampled only inliers once
+        double ratio = static_cast<double>(inliers) / size;
+        if (ratio >= options.targetInlierRatio) break;
+        double allInliers = ratio * ratio * ratio;
+        required = std::min<double>(options.maxIterations, ceil(log(1 - options.confidence) / log(1 - allInliers)));
+    }
+    return bestInliers;
+}
+
+/**
+ * Copies the rays that are close to a cone
+ *
+ * @param x,y,z The unit rays
+ * @param size The number of rays
+ * @param n c / cos(theta) of the cone
+ * @param threshold The furthest an inlier can be from the cone (an angle)
+ * @param inlierX,inlierY,inlierZ The output, i.e. the rays that are inliers (room for size rays)
+ *
+ * @return The number of inliers
+ */
+static size_t SelectInliers(const decimal *x, const decimal *y, const decimal *z, size_t size, const double n[3],
+                            double threshold, decimal *inlierX, decimal *inlierY, decimal *inlierZ) {
+    Cone cone(n);
+    size_t count = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (cone.Residual(x[i], y[i], z[i]) > threshold) continue;
+        inlierX[count] = x[i];
+        inlierY[count] = y[i];
+        inlierZ[count] = z[i];
+        count++;
+    }
+    return count;
+}
+
+SphericalDistanceDeterminationAlgorithm::SphericalDistanceDeterminationAlgorithm(decimal radius, const Camera &camera)
+    : radius(radius), camera(camera), robust(false) {
+    if (radius <= 0) throw std::invalid_argument("The radius of Earth must be positive");
+}
+
+SphericalDistanceDeterminationAlgorithm::SphericalDistanceDeterminationAlgorithm(decimal radius, const Camera &camera,
+                                                                                 const RobustFitOptions &robust)
+    : SphericalDistanceDeterminationAlgorithm(radius, camera) {
+    this->samplePool = MakeSamplePool(robust);
+    this->robust = true;
+    this->options = robust;
+}
+
+SphericalDistanceDeterminationAlgorithm::~SphericalDistanceDeterminationAlgorithm() {}
+
+distFromEarth SphericalDistanceDeterminationAlgorithm::Run(const Points &p) {
+    if (p.size() < 3) throw std::invalid_argument("At least 3 points are needed to find a sphere");
+
+    double n[3];
+    if (this->robust) {
+        this->FitRobust(p, n);
+    } else {
+        // Accumulates the normal equations (sum of u u^T) n = sum of u, one batch of rays at a time.
+        // Sums are kept in double, since the system gets poorly conditioned when Earth is small in the image
+        ConeSums sums;
+        alignas(kVectorAlignment) decimal rayX[kRayBatchSize];
+        alignas(kVectorAlignment) decimal rayY[kRayBatchSize];
+        alignas(kVectorAlignment) decimal rayZ[kRayBatchSize];
+        for (size_t start = 0; start < p.size(); start += kRayBatchSize) {
+            size_t count = std::min(kRayBatchSize, p.size() - start);
+            this->camera.PixelsToRays(p.x() + start, p.y() + start, count, rayX, rayY, rayZ);
+            for (size_t i = 0; i < count; i++) sums.Add(rayX[i], rayY[i], rayZ[i], 1);
+        }
+        // Earth must also be in front of the camera
+        if (!SolveCone(sums, n) || n[0] <= 0) throw std::invalid_argument("The points do not determine a sphere");
+        this->residual = ConeResidual(sums, n);
+    }
+
+    // n is along the axis of the cone, i.e. towards Earth's center
+    double norm2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+    double inverseNorm = 1 / sqrt(norm2);
+    this->center = Vec3(n[0] * inverseNorm, n[1] * inverseNorm, n[2] * inverseNorm);
+
+    // |n| = 1 / cos(theta), so the distance is radius / sin(theta) = radius |n| / sqrt(|n|^2 - 1)
+    return static_cast<distFromEarth>(this->radius * sqrt(norm2 / (norm2 - 1)));
+}
+
+void SphericalDistanceDeterminationAlgorithm::FitRobust(const Points &p, double n[3]) {
+    size_t size = p.size();
+    ArenaScope scope(this->Scratch());
+    decimal *rayX = this->Scratch().Allocate<decimal>(size);
+    decimal *rayY = this->Scratch().Allocate<decimal>(size);
+    decimal *rayZ = this->Scratch().Allocate<decimal>(size);
+    this->camera.PixelsToRays(p.x(), p.y(), size, rayX, rayY, rayZ);
+    const decimal *x = rayX;
+    const decimal *y = rayY;
+    const decimal *z = rayZ;
+
+    // The inlier threshold, as an angle
+    double threshold = this->options.inlierThreshold / this->camera.FocalLength();
+
+    // 1. RANSAC over minimal samples (3 rays), drawn from the pool
+    if (SampleCone(x, y, z, size, threshold, this->options, this->samplePool, true, n) < 3) {
+        throw std::invalid_argument("No sample of the points determines a sphere");
+    }
+
+    // 2. IRLS with Tukey's biweight, starting from the best sample
+    double cutoff = kTukeyCutoff * threshold;
+    for (int iteration = 0; iteration < this->options.refinementIterations; iteration++) {
+        Cone cone(n);
+        ConeSums sums;
+        for (size_t i = 0; i < size; i++) {
+            double u = cone.Residual(x[i], y[i], z[i]) / cutoff;
+            if (u < 1) sums.Add(x[i], y[i], z[i], (1 - u * u) * (1 - u * u));
+        }
+        double refined[3];
+        // Keeps the last fit if the inliers stop determining a cone
+        if (!SolveCone(sums, refined)) break;
+        double change = fabs(refined[0] - n[0]) + fabs(refined[1] - n[1]) + fabs(refined[2] - n[2]);
+        std::copy(refined, refined + 3, n);
+        if (change <= 1e-12 * (fabs(n[0]) + fabs(n[1]) + fabs(n[2]))) break;
+    }
+    // Outliers say nothing of how well the horizon was fit
+    this->residual = RaysResidual(x, y, z, size, n, threshold);
+}
+
+EllipticDistanceDeterminationAlgorithm::EllipticDistanceDeterminationAlgorithm(decimal equatorialRadius,
+                                                                               decimal polarRadius,
+                                                                               const Camera &camera,
+                                                                               const Attitude &attitude,
+                                                                               int maxIterations, double tolerance)
+    : equatorialRadius(equatorialRadius), polarRadius(polarRadius), camera(camera),
+      maxIterations(maxIterations), tolerance(tolerance), solved(false), iterations(0), warmStarted(false),
+      robust(false) {
+    if (equatorialRadius <= 0 || polarRadius <= 0) throw std::invalid_argument("The radii of Earth must be positive");
+    if (maxIterations <= 0) throw std::invalid_argument("The number of iterations must be positive");
+    this->SetAttitude(attitude);
+}
+
+EllipticDistanceDeterminationAlgorithm::EllipticDistanceDeterminationAlgorithm(decimal equatorialRadius,
+                                                                               decimal polarRadius,
+                                                                               const Camera &camera,
+                                                                               const Attitude &attitude,
+                                                                               const RobustFitOptions &robust,
+                                                                               int maxIterations, double tolerance)
+    : EllipticDistanceDeterminationAlgorithm(equatorialRadius, polarRadius, camera, attitude,
+                                             maxIterations, tolerance) {
+    this->samplePool = MakeSamplePool(robust);
+    this->robust = true;
+    this->options = robust;
+}
+
+EllipticDistanceDeterminationAlgorithm::~EllipticDistanceDeterminationAlgorithm() {}
+
+void EllipticDistanceDeterminationAlgorithm::SetAttitude(const Attitude &attitude) {
+    // A camera ray u is R^T u in the reference frame, and D R^T u in the scaled frame
+    Mat3 dcm = attitude.GetDCM();
+    this->toCamera = dcm;
+    double inverseRadii[3] = {1 / this->equatorialRadius, 1 / this->equatorialRadius, 1 / this->polarRadius};
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            this->scaling.x[3 * i + j] = static_cast<decimal>(inverseRadii[i] * dcm.At(j, i));
+        }
+    }
+}
+
+PositionVector EllipticDistanceDeterminationAlgorithm::GetPosition() const {
+    return PositionVector(this->position[0], this->position[1], this->position[2]);
+}
+
+distFromEarth EllipticDistanceDeterminationAlgorithm::Run(const Points &p) {
+    if (p.size() < 3) throw std::invalid_argument("At least 3 points are needed to find an ellipsoid");
+
+    // 1. Make the unit rays in the scaled frame
+    size_t size = p.size();
+    ArenaScope scope(this->Scratch());
+    decimal *x = this->Scratch().Allocate<decimal>(size);
+    decimal *y = this->Scratch().Allocate<decimal>(size);
+    decimal *z = this->Scratch().Allocate<decimal>(size);
+    this->camera.PixelsToRays(p.x(), p.y(), size, x, y, z);
+    this->scaling.Multiply(x, y, z, size, x, y, z);
+    for (size_t i = 0; i < size; i++) {
+        double scale = 1 / sqrt(static_cast<double>(x[i]) * x[i] + static_cast<double>(y[i]) * y[i] +
+                                static_cast<double>(z[i]) * z[i]);
+        x[i] *= scale;
+        y[i] *= scale;
+        z[i] *= scale;
+    }
+
+    // The rays that are refined: every ray, or only the inliers of the first cone
+    const decimal *refinedX = x, *refinedY = y, *refinedZ = z;
+    size_t refinedSize = size;
+    decimal *inlierX = nullptr, *inlierY = nullptr, *inlierZ = nullptr;
+    // The inlier threshold, as an angle (to first order, since the radii are nearly equal)
+    double threshold = HUGE_VAL;
+    if (this->robust) {
+        inlierX = this->Scratch().Allocate<decimal>(size);
+        inlierY = this->Scratch().Allocate<decimal>(size);
+        inlierZ = this->Scratch().Allocate<decimal>(size);
+        refinedX = inlierX;
+        refinedY = inlierY;
+        refinedZ = inlierZ;
+        threshold = this->options.inlierThreshold / this->camera.FocalLength();
+    }
+
+    // 2. Warm start from the last position q (scaled): n = -q / sqrt(|q|^2 - 1)
+    double n[3];
+    this->iterations = 0;
+    this->warmStarted = false;
+    if (this->solved) {
+        double q[3] = {this->position[0] / this->equatorialRadius,
+                       this->position[1] / this->equatorialRadius,
+                       this->position[2] / this->polarRadius};
+        double norm2 = q[0] * q[0] + q[1] * q[1] + q[2] * q[2];
+        if (norm2 > 1) {
+            double scale = -1 / sqrt(norm2 - 1);
+            for (int k = 0; k < 3; k++) n[k] = q[k] * scale;
+            if (this->robust) refinedSize = SelectInliers(x, y, z, size, n, threshold, inlierX, inlierY, inlierZ);
+            if (refinedSize >= 3) this->warmStarted = this->Refine(refinedX, refinedY, refinedZ, refinedSize, n);
+        }
+    }
+
+    // 3. Otherwise, start cold from the closed-form fit (of the best sample, when rejecting outliers)
+    if (!this->warmStarted) {
+        this->solved = false;
+        if (this->robust) {
+            if (SampleCone(x, y, z, size, threshold, this->options, this->samplePool, false, n) < 3) {
+                throw std::invalid_argument("No sample of the points determines an ellipsoid");
+            }
+            refinedSize = SelectInliers(x, y, z, size, n, threshold, inlierX, inlierY, inlierZ);
+        } else {
+            ConeSums sums;
+            for (size_t i = 0; i < size; i++) sums.Add(x[i], y[i], z[i], 1);
+            if (!SolveCone(sums, n)) throw std::invalid_argument("The points do not determine an ellipsoid");
+        }
+        this->iterations = 0;
+        // Without convergence, the last iterate of the budget is still the best fit found
+        this->Refine(refinedX, refinedY, refinedZ, refinedSize, n);
+    }
+    // Outliers say nothing of how well the horizon was fit
+    this->residual = RaysResidual(x, y, z, size, n, threshold);
+
+    // 4. Unscale the position q = -n / sqrt(|n|^2 - 1)
+    double norm2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+    double scale = -1 / sqrt(norm2 - 1);
+    this->position[0] = n[0] * scale * this->equatorialRadius;
+    this->position[1] = n[1] * scale * this->equatorialRadius;
+    this->position[2] = n[2] * scale * this->polarRadius;
+    this->solved = true;
+    this->center = (this->toCamera * (this->GetPosition() * -1)).Normalize();
+    return static_cast<distFromEarth>(sqrt(this->position[0] * this->position[0] +
+                                           this->position[1] * this->position[1] +
+                                           this->position[2] * this->position[2]));
+}
+
+bool EllipticDistanceDeterminationAlgorithm::Refine(const decimal *x, const decimal *y, const decimal *z,
+                                                    size_t size, double n[3]) {
+    while (this->iterations < this->maxIterations) {
+        this->iterations++;
+        // The residual of a ray s is r = (s . n - 1) / |n|, i.e. cos(angle to the axis) - cos(theta),
+        // whose gradient is s / |n| - r n / |n|^2
+        double norm2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+        double inverseNorm = 1 / sqrt(norm2);
+        double normal[6] = {0, 0, 0, 0, 0, 0};
+        double gradient[3] = {0, 0, 0};
+        for (size_t i = 0; i < size; i++) {
+            double r = (x[i] * n[0] + y[i] * n[1] + z[i] * n[2] - 1) * inverseNorm;
+            double scale = r * inverseNorm * inverseNorm;
+            double jx = x[i] * inverseNorm - scale * n[0];
+            double jy = y[i] * inverseNorm - scale * n[1];
+            double jz = z[i] * inverseNorm - scale * n[2];
+            normal[0] += jx * jx; normal[1] += jx * jy; normal[2] += jx * jz;
+            normal[3] += jy * jy; normal[4] += jy * jz; normal[5] += jz * jz;
+            gradient[0] -= jx * r; gradient[1] -= jy * r; gradient[2] -= jz * r;
+        }
+        double step[3];
+        if (!SolveSymmetric3(normal, gradient, step)) return false;
+        // A step past |n| = 1 is no cone at all, so n keeps its last one
+        double next[3] = {n[0] + step[0], n[1] + step[1], n[2] + step[2]};
+        if (!(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] > 1)) return false;
+        for (int k = 0; k < 3; k++) n[k] = next[k];
+        double change = step[0] * step[0] + step[1] * step[1] + step[2] * step[2];
+        if (change <= this->tolerance * this->tolerance * norm2) return true;
+    }
+    return false;
+}
+
+DistanceFusionAlgorithm::DistanceFusionAlgorithm(
+    const std::vector<std::reference_wrapper<DistanceDeterminationAlgorithm>> &algorithms,
+    FusionMethod method, const std::vector<decimal> &weights)
+    : algorithms(algorithms), method(method), weights(weights), chosen(0) {
+    if (algorithms.empty()) throw std::invalid_argument("At least one distance algorithm is needed to fuse");
+    if (this->weights.empty()) this->weights.assign(algorithms.size(), 1);
+    if (this->weights.size() != algorithms.size()) throw std::invalid_argument("Each distance needs a weight");
+    decimal total = 0;
+    for (decimal weight : this->weights) {
+        if (weight < 0) throw std::invalid_argument("The weights must not be negative");
+        total += weight;
+    }
+    if (!(total > 0)) throw std::invalid_argument("At least one weight must be positive");
+}
+
+distFromEarth DistanceFusionAlgorithm::Run(const std::vector<distFromEarth> &distances) {
+    if (distances.size() != this->algorithms.size()) {
+        throw std::invalid_argument("Each distance algorithm must give one distance");
+    }
+    if (this->method == FusionMethod::kLowestResidual) {
+        this->chosen = 0;
+        for (size_t i = 1; i < distances.size(); i++) {
+            if (this->algorithms[i].get().Residual() < this->algorithms[this->chosen].get().Residual()) {
+                this->chosen = i;
+            }
+        }
+        return distances[this->chosen];
+    }
+    double sum = 0, total = 0;
+    for (size_t i = 0; i < distances.size(); i++) {
+        sum += static_cast<double>(this->weights[i]) * distances[i];
+        total += this->weights[i];
+    }
+    return static_cast<distFromEarth>(sum / total);
+}
+
+}  // namespace found
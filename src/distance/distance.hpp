@@ -1,8 +1,12 @@
 #ifndef DISTANCE_H
 #define DISTANCE_H
 
+#include <functional>
+#include <vector>
+
 #include "style/style.hpp"
 #include "pipeline/pipeline.hpp"
+#include "spatial/camera.hpp"
 
 namespace found {
 
@@ -16,11 +20,64 @@ class DistanceDeterminationAlgorithm : public Stage<Points, distFromEarth> {
     DistanceDeterminationAlgorithm() = default;
     // Destroys this
     virtual ~DistanceDeterminationAlgorithm();
+
+    /**
+     * Provides how well the last run fit its points, so that the results of several
+     * algorithms can be compared (see DistanceFusionAlgorithm)
+     *
+     * @return The root mean square angle between the rays towards the points and the
+     * fit horizon, in radians (0 before the first run)
+     */
+    decimal Residual() const { return this->residual; }
+
+    /**
+     * Provides the direction towards Earth's center found by the last run, so that a
+     * VectorGenerationAlgorithm can turn the distance into a position
+     *
+     * @return The unit vector towards the center of Earth, in the camera frame (the
+     * boresight, (1, 0, 0), before the first run)
+     */
+    Vec3 Center() const { return this->center; }
+
+ protected:
+    /// The residual of the last run
+    decimal residual = 0;
+    /// The direction towards Earth's center found by the last run
+    Vec3 center = {1, 0, 0};
+};
+
+/**
+ * RobustFitOptions controls the outlier-rejecting fit of distance algorithms, for horizons
+ * with stray points on them (clouds, the terminator, lens flare, ...).
+ *
+ * The fit first runs RANSAC: it fits minimal samples of the points, and keeps the fit with the
+ * most inliers. The number of samples adapts to the best inlier ratio found so far, and sampling
+ * stops as soon as enough of the points are inliers. The fit is then refined by iteratively
+ * reweighted least squares (IRLS) with Tukey's biweight, which ignores points far from the fit.
+ */
+struct RobustFitOptions {
+    /// The furthest an inlier can be from the fit horizon, in pixels
+    decimal inlierThreshold = 2;
+    /// The probability of sampling at least once with only inliers
+    decimal confidence = 0.99;
+    /// The inlier ratio at which sampling stops early
+    decimal targetInlierRatio = 0.9;
+    /// The most samples to fit
+    int maxIterations = 200;
+    /// The number of reweighting passes after sampling
+    int refinementIterations = 5;
+    /// The seed of the samples (so that results are repeatable)
+    unsigned int seed = 0;
 };
 
 /**
  * The DistanceDeterminationAlgorithm class houses the Distance Determination Algorithm. This 
  * algorithm calculates the distance from Earth based on the pixels of Earth's Edge found in the image.
+ *
+ * The horizon of a sphere is seen along a cone: every unit ray u towards it satisfies u . c = cos(theta),
+ * where c is the direction to Earth's center and theta the half angle of the cone. Writing n = c / cos(theta),
+ * this is fit in closed form by least squares over u . n = 1 (a 3x3 linear system), and the distance is
+ * radius / sin(theta). Rays are made in fixed-size batches on the stack, so no memory is allocated.
  * 
  * @note This class assumes that Earth is a perfect sphere
 */
@@ -30,21 +87,72 @@ class SphericalDistanceDeterminationAlgorithm : public DistanceDeterminationAlgo
     * Initializes this SphericalDistanceDeterminationAlgorithm
     * 
     * @param radius The radius of Earth to use
+    * @param camera The camera that took the images the points are from
+    *
+    * @throws invalid_argument iff radius is not positive
     */
-    explicit SphericalDistanceDeterminationAlgorithm(float radius);
+    SphericalDistanceDeterminationAlgorithm(decimal radius, const Camera &camera);
+
+   /**
+    * Initializes this SphericalDistanceDeterminationAlgorithm to reject outliers
+    * 
+    * @param radius The radius of Earth to use
+    * @param camera The camera that took the images the points are from
+    * @param robust How to reject outliers
+    *
+    * @throws invalid_argument iff radius is not positive, or robust is invalid (a threshold
+    * that is not positive, a probability or ratio not in (0, 1), or no iterations)
+    */
+    SphericalDistanceDeterminationAlgorithm(decimal radius, const Camera &camera, const RobustFitOptions &robust);
+
     ~SphericalDistanceDeterminationAlgorithm();
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
+     * Finds the distance to Earth from points on its horizon
+     *
+     * @param p The points on the horizon, in image coordinates
+     *
+     * @return The distance to the center of Earth, in the units of the radius
+     *
+     * @throws invalid_argument iff p has less than 3 points, or the points do not lie on the horizon of
+     * a sphere in front of the camera (e.g. they are all on a line), or (when rejecting outliers) no
+     * sample has 3 inliers
      * */
     distFromEarth Run(const Points &p) override;
+
  private:
-    // Fields specific to this algorithm, and helper methods
+    /**
+     * Fits the horizon while rejecting outliers
+     *
+     * @param p The points on the horizon
+     * @param n The output, i.e. c / cos(theta) of the fit cone
+     *
+     * @throws invalid_argument iff no sample has 3 inliers
+     */
+    void FitRobust(const Points &p, double n[3]);
+
+    /// The radius of Earth
+    decimal radius;
+    /// The camera that took the images
+    Camera camera;
+    /// Whether outliers are rejected
+    bool robust;
+    /// How outliers are rejected
+    RobustFitOptions options;
+    /// The uniform random numbers that samples are drawn with (3 per iteration)
+    std::vector<decimal> samplePool;
 };
 
 /**
  * The DistanceDeterminationAlgorithm class houses the Distance Determination Algorithm. This 
  * algorithm calculates the distance from Earth based on the pixels of Earth's Edge found in the image.
+ *
+ * Scaling the reference frame by the inverse radii of Earth turns it into a unit sphere, so the horizon
+ * is again a cone there: every scaled unit ray s satisfies s . n = 1. The cone is refined by Gauss-Newton
+ * on the (scaled) angular distance of each ray from it. Successive frames are close together, so each run
+ * starts from the position found by the last one, and only falls back to the closed-form (cold) fit when
+ * there is no such position or the refinement does not converge within its budget. The scaling and
+ * rotation into the scaled frame is cached until the attitude changes.
  * 
  * @note This class assumes that Earth is a perfect ellipse
 */
@@ -53,17 +161,192 @@ class EllipticDistanceDeterminationAlgorithm : public DistanceDeterminationAlgor
     /**
      * Initializes an EllipticDistanceDeterminationAlgorithm
      * 
-     * @param radius The distance from Earth to use
+     * @param equatorialRadius The equatorial radius of Earth
+     * @param polarRadius The polar radius of Earth
+     * @param camera The camera that took the images the points are from
+     * @param attitude The attitude of the camera, rotating the reference frame (whose z axis is
+     * Earth's axis) into the camera frame
+     * @param maxIterations The most Gauss-Newton iterations of a run
+     * @param tolerance The relative change of the solution at which iterations stop
+     *
+     * @throws invalid_argument iff a radius or maxIterations is not positive
+     */
+    EllipticDistanceDeterminationAlgorithm(decimal equatorialRadius, decimal polarRadius,
+                                           const Camera &camera, const Attitude &attitude,
+                                           int maxIterations = 10, double tolerance = 1e-10);
+
+    /**
+     * Initializes an EllipticDistanceDeterminationAlgorithm to reject outliers
+     *
+     * Cold starts take their first cone from RANSAC (see RobustFitOptions), and warm starts
+     * from the last position. Either way, only the rays within inlierThreshold of that cone
+     * are refined by Gauss-Newton, which takes the place of reweighting (so refinementIterations
+     * is not used).
+     *
+     * @param equatorialRadius The equatorial radius of Earth
+     * @param polarRadius The polar radius of Earth
+     * @param camera The camera that took the images the points are from
+     * @param attitude The attitude of the camera
+     * @param robust How to reject outliers
+     * @param maxIterations The most Gauss-Newton iterations of a run
+     * @param tolerance The relative change of the solution at which iterations stop
+     *
+     * @throws invalid_argument iff a radius or maxIterations is not positive, or robust is
+     * invalid (see SphericalDistanceDeterminationAlgorithm)
      */
-    explicit EllipticDistanceDeterminationAlgorithm(distFromEarth radius);
+    EllipticDistanceDeterminationAlgorithm(decimal equatorialRadius, decimal polarRadius,
+                                           const Camera &camera, const Attitude &attitude,
+                                           const RobustFitOptions &robust,
+                                           int maxIterations = 10, double tolerance = 1e-10);
     ~EllipticDistanceDeterminationAlgorithm();
 
     /**
-    * Place documentation here. Press enter to automatically make a new line
-    * */
+     * Finds the distance to Earth from points on its horizon
+     *
+     * @param p The points on the horizon, in image coordinates
+     *
+     * @return The distance to the center of Earth, in the units of the radii
+     *
+     * @throws invalid_argument iff p has less than 3 points, or the points do not lie on the
+     * horizon of an ellipsoid, or (when rejecting outliers) no sample has 3 inliers
+     */
     distFromEarth Run(const Points &p) override;
+
+    /**
+     * Changes the attitude of the camera (i.e. for the next frame)
+     *
+     * @param attitude The attitude of the camera
+     */
+    void SetAttitude(const Attitude &attitude);
+
+    /**
+     * Forgets the last position found, so that the next run starts cold
+     */
+    void Reset() { this->solved = false; }
+
+    /**
+     * Provides the position found by the last run
+     *
+     * @return The position of the camera relative to Earth's center, in the reference frame
+     */
+    PositionVector GetPosition() const;
+
+    /// Returns the number of Gauss-Newton iterations of the last run
+    int Iterations() const { return this->iterations; }
+    /// Returns true iff the last run started from the position of the run before it
+    bool WarmStarted() const { return this->warmStarted; }
+
+    /**
+     * Records the Gauss-Newton iterations of the last run, and whether it was warm started
+     *
+     * @param counters The counters to record into
+     */
+    void Count(CounterSet &counters) const override {
+        DistanceDeterminationAlgorithm::Count(counters);
+        counters.Record("iterations", this->iterations);
+        counters.Record("warm_starts", this->warmStarted ? 1 : 0);
+    }
+
+ private:
+    /**
+     * Refines the cone of the horizon by Gauss-Newton
+     *
+     * @param x,y,z The (scaled) unit rays towards each point
+     * @param size The number of rays
+     * @param n The cone to refine, i.e. s . n = 1 for every scaled ray s,
+     * which is only ever moved to another cone (|n| > 1)
+     *
+     * @return true iff the cone converged within the iteration budget, and
+     * false if it did not, or a step would have left the cones (in which
+     * case n is its last iterate)
+     */
+    bool Refine(const decimal *x, const decimal *y, const decimal *z, size_t size, double n[3]);
+
+    /// The equatorial radius of Earth
+    double equatorialRadius;
+    /// The polar radius of Earth
+    double polarRadius;
+    /// The camera that took the images
+    Camera camera;
+    /// The most Gauss-Newton iterations of a run
+    int maxIterations;
+    /// The relative change at which iterations stop
+    double tolerance;
+    /// The map from the camera frame to the scaled reference frame
+    Mat3 scaling;
+    /// The map from the reference frame to the camera frame
+    Mat3 toCamera;
+    /// Whether position holds the solution of a run
+    bool solved;
+    /// The position found by the last run, in the reference frame
+    double position[3];
+    /// The number of iterations of the last run
+    int iterations;
+    /// Whether the last run was warm started
+    bool warmStarted;
+    /// Whether outliers are rejected
+    bool robust;
+    /// How outliers are rejected
+    RobustFitOptions options;
+    /// The uniform random numbers that samples are drawn with (3 per iteration)
+    std::vector<decimal> samplePool;
+};
+
+/**
+ * How a DistanceFusionAlgorithm combines several distances
+ */
+enum class FusionMethod {
+    /// The weighted average of every distance
+    kWeightedAverage,
+    /// The distance of the algorithm whose fit has the lowest residual
+    kLowestResidual
+};
+
+/**
+ * The DistanceFusionAlgorithm class combines the distances that several distance algorithms
+ * found from the same points (e.g. in the branches of a ParallelStage) into one.
+ *
+ * @note The distances must be in the order of the algorithms given to this, and the
+ * algorithms must have found them, since their residuals are read from the last run
+ */
+class DistanceFusionAlgorithm : public Stage<std::vector<distFromEarth>, distFromEarth> {
+ public:
+    /**
+     * Initializes a DistanceFusionAlgorithm
+     *
+     * @param algorithms The algorithms that found the distances, in order
+     * @param method How to combine the distances
+     * @param weights The weight of each distance, for kWeightedAverage (all equal if empty)
+     *
+     * @throws invalid_argument iff algorithms is empty, or weights does not have a
+     * weight per algorithm, or a weight is negative, or no weight is positive
+     */
+    DistanceFusionAlgorithm(const std::vector<std::reference_wrapper<DistanceDeterminationAlgorithm>> &algorithms,
+                            FusionMethod method, const std::vector<decimal> &weights = {});
+
+    /**
+     * Combines distances
+     *
+     * @param distances The distance found by each algorithm
+     *
+     * @return The combined distance
+     *
+     * @throws invalid_argument iff distances does not have a distance per algorithm
+     */
+    distFromEarth Run(const std::vector<distFromEarth> &distances) override;
+
+    /// Returns the index of the distance chosen by the last run, for kLowestResidual
+    size_t Chosen() const { return this->chosen; }
+
  private:
-    // Fields specific to this algorithm, and helper methods
+    /// The algorithms that found the distances
+    std::vector<std::reference_wrapper<DistanceDeterminationAlgorithm>> algorithms;
+    /// How distances are combined
+    FusionMethod method;
+    /// The weight of each distance
+    std::vector<decimal> weights;
+    /// The index of the distance chosen by the last run
+    size_t chosen;
 };
 
 }  // namespace found
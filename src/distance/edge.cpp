@@ -0,0 +1,1032 @@
+#include "distance/edge.hpp"
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FOUND_X86_KERNELS
+#endif
+
+namespace found {
+
+///////////////////////////////////
+///////// SCALAR KERNELS //////////
+///////////////////////////////////
+
+/**
+ * Thresholds a part of a row of pixels without vectorization
+ *
+ * @param row The first pixel to threshold
+ * @param width The number of pixels to threshold
+ * @param channels The number of interleaved channels of each pixel (1 or 3)
+ * @param threshold The minimum (channel-averaged) intensity of an Earth pixel
+ * @param mask The output, where each byte is 0xFF iff its pixel is part of Earth, and 0 otherwise
+ */
+static void ThresholdRowScalar(const unsigned char *row, int width, int channels,
+                               unsigned char threshold, unsigned char *mask) {
+    if (channels == 1) {
+        for (int i = 0; i < width; i++) {
+            mask[i] = row[i] >= threshold ? 0xFF : 0;
+        }
+    } else {
+        int sumThreshold = 3 * threshold;
+        for (int i = 0; i < width; i++) {
+            int sum = row[3*i] + row[3*i+1] + row[3*i+2];
+            mask[i] = sum >= sumThreshold ? 0xFF : 0;
+        }
+    }
+}
+
+/**
+ * Finds the horizon pixels of a part of a row without vectorization
+ *
+ * @param above The mask of the row above
+ * @param row The mask of the row
+ * @param below The mask of the row below
+ * @param width The number of pixels to scan
+ * @param edges The output, where each byte is nonzero iff its pixel is on the horizon
+ *
+ * @pre row[-1] and row[width] are readable
+ */
+static void HorizonRowScalar(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                             int width, unsigned char *edges) {
+    for (int i = 0; i < width; i++) {
+        edges[i] = row[i] & ~(above[i] & below[i] & row[i-1] & row[i+1]);
+    }
+}
+
+///////////////////////////////////
+/////// VECTORIZED KERNELS ////////
+///////////////////////////////////
+
+#if defined(__ARM_NEON)
+
+/**
+ * Thresholds a row of 1-channel pixels with NEON
+ *
+ * @param row The first pixel to threshold
+ * @param width The number of pixels to threshold
+ * @param threshold The minimum intensity of an Earth pixel
+ * @param mask The output mask
+ *
+ * @return The number of pixels thresholded (the rest are left to the scalar kernel)
+ */
+static int ThresholdRow1Neon(const unsigned char *row, int width, unsigned char threshold, unsigned char *mask) {
+    uint8x16_t t = vdupq_n_u8(threshold);
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        vst1q_u8(mask + i, vcgeq_u8(vld1q_u8(row + i), t));
+    }
+    return i;
+}
+
+/**
+ * Thresholds a row of 3-channel pixels with NEON
+ *
+ * @param row The first pixel to threshold
+ * @param width The number of pixels to threshold
+ * @param threshold The minimum channel-averaged intensity of an Earth pixel
+ * @param mask The output mask
+ *
+ * @return The number of pixels thresholded (the rest are left to the scalar kernel)
+ */
+static int ThresholdRow3Neon(const unsigned char *row, int width, unsigned char threshold, unsigned char *mask) {
+    uint16x8_t t = vdupq_n_u16(3 * threshold);
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        uint8x16x3_t rgb = vld3q_u8(row + 3*i);
+        uint16x8_t lo = vaddw_u8(vaddl_u8(vget_low_u8(rgb.val[0]), vget_low_u8(rgb.val[1])),
+                                 vget_low_u8(rgb.val[2]));
+        uint16x8_t hi = vaddw_u8(vaddl_u8(vget_high_u8(rgb.val[0]), vget_high_u8(rgb.val[1])),
+                                 vget_high_u8(rgb.val[2]));
+        vst1q_u8(mask + i, vcombine_u8(vmovn_u16(vcgeq_u16(lo, t)), vmovn_u16(vcgeq_u16(hi, t))));
+    }
+    return i;
+}
+
+/**
+ * Finds the horizon pixels of a row with NEON
+ *
+ * @param above The mask of the row above
+ * @param row The mask of the row
+ * @param below The mask of the row below
+ * @param width The number of pixels to scan
+ * @param edges The output
+ *
+ * @return The number of pixels scanned (the rest are left to the scalar kernel)
+ */
+static int HorizonRowNeon(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                          int width, unsigned char *edges) {
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        uint8x16_t earth = vandq_u8(vandq_u8(vld1q_u8(above + i), vld1q_u8(below + i)),
+                                    vandq_u8(vld1q_u8(row + i - 1), vld1q_u8(row + i + 1)));
+        vst1q_u8(edges + i, vbicq_u8(vld1q_u8(row + i), earth));
+    }
+    return i;
+}
+
+#elif defined(FOUND_X86_KERNELS)
+
+// GCOVR_EXCL_START (only used by processors without AVX2)
+/**
+ * Thresholds a row of 1-channel pixels with SSE2
+ *
+ * @param row The first pixel to threshold
+ * @param width The number of pixels to threshold
+ * @param threshold The minimum intensity of an Earth pixel
+ * @param mask The output mask
+ *
+ * @return The number of pixels thresholded (the rest are left to the scalar kernel)
+ */
+static int ThresholdRow1Sse2(const unsigned char *row, int width, unsigned char threshold, unsigned char *mask) {
+    __m128i t = _mm_set1_epi8(static_cast<char>(threshold));
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        // v >= t iff max(v, t) == v
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(mask + i), _mm_cmpeq_epi8(_mm_max_epu8(v, t), v));
+    }
+    return i;
+}
+// GCOVR_EXCL_STOP
+
+/**
+ * Thresholds a row of 1-channel pixels with AVX2
+ *
+ * @param row The first pixel to threshold
+ * @param width The number of pixels to threshold
+ * @param threshold The minimum intensity of an Earth pixel
+ * @param mask The output mask
+ *
+ * @return The number of pixels thresholded (the rest are left to the scalar kernel)
+ */
+__attribute__((target("avx2")))
+static int ThresholdRow1Avx2(const unsigned char *row, int width, unsigned char threshold, unsigned char *mask) {
+    __m256i t = _mm256_set1_epi8(static_cast<char>(threshold));
+    int i = 0;
+    for (; i + 32 <= width; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(mask + i), _mm256_cmpeq_epi8(_mm256_max_epu8(v, t), v));
+    }
+    return i;
+}
+
+/**
+ * Thresholds a row of 3-channel pixels with SSSE3, by deinterleaving
+ * 16 pixels at a time and comparing their channel sums
+ *
+ * @param row The first pixel to threshold
+ * @param width The number of pixels to threshold
+ * @param threshold The minimum channel-averaged intensity of an Earth pixel
+ * @param mask The output mask
+ *
+ * @return The number of pixels thresholded (the rest are left to the scalar kernel)
+ */
+__attribute__((target("ssse3")))
+static int ThresholdRow3Ssse3(const unsigned char *row, int width, unsigned char threshold, unsigned char *mask) {
+    // Shuffles that gather channel c of 16 pixels from the 3 registers they span
+    const __m128i r0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i r1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+    const __m128i r2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+    const __m128i g0 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i g1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+    const __m128i g2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+    const __m128i b0 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i b1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+    const __m128i b2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+    const __m128i zero = _mm_setzero_si128();
+    // sum >= 3 * threshold iff sum > 3 * threshold - 1
+    const __m128i t = _mm_set1_epi16(static_cast<int16_t>(3 * threshold - 1));
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        const __m128i *p = reinterpret_cast<const __m128i *>(row + 3*i);
+        __m128i a = _mm_loadu_si128(p);
+        __m128i b = _mm_loadu_si128(p + 1);
+        __m128i c = _mm_loadu_si128(p + 2);
+        __m128i red = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, r0), _mm_shuffle_epi8(b, r1)),
+                                   _mm_shuffle_epi8(c, r2));
+        __m128i green = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, g0), _mm_shuffle_epi8(b, g1)),
+                                     _mm_shuffle_epi8(c, g2));
+        __m128i blue = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, b0), _mm_shuffle_epi8(b, b1)),
+                                    _mm_shuffle_epi8(c, b2));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(red, zero), _mm_unpacklo_epi8(green, zero)),
+                                   _mm_unpacklo_epi8(blue, zero));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(red, zero), _mm_unpackhi_epi8(green, zero)),
+                                   _mm_unpackhi_epi8(blue, zero));
+        __m128i result = _mm_packs_epi16(_mm_cmpgt_epi16(lo, t), _mm_cmpgt_epi16(hi, t));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(mask + i), result);
+    }
+    return i;
+}
+
+// GCOVR_EXCL_START (only used by processors without AVX2)
+/**
+ * Finds the horizon pixels of a row with SSE2
+ *
+ * @param above The mask of the row above
+ * @param row The mask of the row
+ * @param below The mask of the row below
+ * @param width The number of pixels to scan
+ * @param edges The output
+ *
+ * @return The number of pixels scanned (the rest are left to the scalar kernel)
+ */
+static int HorizonRowSse2(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                          int width, unsigned char *edges) {
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        __m128i earth = _mm_and_si128(
+            _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(above + i)),
+                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(below + i))),
+            _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i - 1)),
+                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i + 1))));
+        __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(edges + i), _mm_andnot_si128(earth, center));
+    }
+    return i;
+}
+// GCOVR_EXCL_STOP
+
+/**
+ * Finds the horizon pixels of a row with AVX2
+ *
+ * @param above The mask of the row above
+ * @param row The mask of the row
+ * @param below The mask of the row below
+ * @param width The number of pixels to scan
+ * @param edges The output
+ *
+ * @return The number of pixels scanned (the rest are left to the scalar kernel)
+ */
+__attribute__((target("avx2")))
+static int HorizonRowAvx2(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                          int width, unsigned char *edges) {
+    int i = 0;
+    for (; i + 32 <= width; i += 32) {
+        __m256i earth = _mm256_and_si256(
+            _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(above + i)),
+                             _mm256_loadu_si256(reinterpret_cast<const __m256i *>(below + i))),
+            _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i - 1)),
+                             _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i + 1))));
+        __m256i center = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(edges + i), _mm256_andnot_si256(earth, center));
+    }
+    return i;
+}
+
+#endif
+
+///////////////////////////////////
+//////// KERNEL DISPATCH //////////
+///////////////////////////////////
+
+/// A vectorized kernel for thresholding, returning how many pixels it processed
+typedef int (*ThresholdKernel)(const unsigned char *, int, unsigned char, unsigned char *);
+/// A vectorized kernel for horizon scanning, returning how many pixels it processed
+typedef int (*HorizonKernel)(const unsigned char *, const unsigned char *, const unsigned char *,
+                             int, unsigned char *);
+
+/**
+ * The best kernels supported by this processor (nullptr means there are none)
+ */
+struct Kernels {
+    /// The 1-channel thresholding kernel
+    ThresholdKernel threshold1 = nullptr;
+    /// The 3-channel thresholding kernel
+    ThresholdKernel threshold3 = nullptr;
+    /// The horizon scanning kernel
+    HorizonKernel horizon = nullptr;
+};
+
+/**
+ * Picks the best kernels supported by this processor
+ *
+ * @return The kernels to use
+ */
+static Kernels SelectKernels() {
+    Kernels kernels;
+#if defined(__ARM_NEON)
+    kernels.threshold1 = ThresholdRow1Neon;
+    kernels.threshold3 = ThresholdRow3Neon;
+    kernels.horizon = HorizonRowNeon;
+#elif defined(FOUND_X86_KERNELS)
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2");
+    kernels.threshold1 = avx2 ? ThresholdRow1Avx2 : ThresholdRow1Sse2;
+    if (__builtin_cpu_supports("ssse3")) kernels.threshold3 = ThresholdRow3Ssse3;
+    kernels.horizon = avx2 ? HorizonRowAvx2 : HorizonRowSse2;
+#endif
+    return kernels;
+}
+
+/**
+ * Provides the kernels to use, selecting them on first use
+ *
+ * @return The kernels to use
+ */
+static const Kernels &GetKernels() {
+    static const Kernels kernels = SelectKernels();
+    return kernels;
+}
+
+void ThresholdRow(const unsigned char *row, int width, int channels, unsigned char threshold, unsigned char *mask) {
+    const Kernels &kernels = GetKernels();
+    ThresholdKernel kernel = channels == 1 ? kernels.threshold1 : kernels.threshold3;
+    int done = kernel ? kernel(row, width, threshold, mask) : 0;
+    ThresholdRowScalar(row + done * channels, width - done, channels, threshold, mask + done);
+}
+
+void HorizonRow(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                int width, unsigned char *edges) {
+    const Kernels &kernels = GetKernels();
+    int done = kernels.horizon ? kernels.horizon(above, row, below, width, edges) : 0;
+    HorizonRowScalar(above + done, row + done, below + done, width - done, edges + done);
+}
+
+///////////////////////////////////
+////// REGION OF INTEREST /////////
+///////////////////////////////////
+
+RegionOfInterest::RegionOfInterest(int width, int height, int tileSize)
+    : width(width), height(height), tileSize(tileSize) {
+    if (tileSize <= 0) throw std::invalid_argument("tileSize must be positive");
+    this->tilesX = (width + tileSize - 1) / tileSize;
+    this->tilesY = (height + tileSize - 1) / tileSize;
+    this->tiles.assign(this->tilesX * this->tilesY, 0);
+}
+
+void RegionOfInterest::AddPoint(decimal x, decimal y, decimal margin) {
+    int tileX0 = std::max(static_cast<int>(floor((x - margin) / this->tileSize)), 0);
+    int tileX1 = std::min(static_cast<int>(floor((x + margin) / this->tileSize)), this->tilesX - 1);
+    int tileY0 = std::max(static_cast<int>(floor((y - margin) / this->tileSize)), 0);
+    int tileY1 = std::min(static_cast<int>(floor((y + margin) / this->tileSize)), this->tilesY - 1);
+    for (int tileY = tileY0; tileY <= tileY1; tileY++) {
+        for (int tileX = tileX0; tileX <= tileX1; tileX++) {
+            this->tiles[tileY * this->tilesX + tileX] = 1;
+        }
+    }
+}
+
+void RegionOfInterest::AddSegment(const Vec2 &from, const Vec2 &to, decimal margin) {
+    // Clip the segment to the image (grown by margin), so that far away
+    // projections do not cost anything (Liang-Barsky)
+    decimal dx = to.x - from.x;
+    decimal dy = to.y - from.y;
+    decimal p[4] = {-dx, dx, -dy, dy};
+    decimal q[4] = {from.x + margin, this->width + margin - from.x,
+                    from.y + margin, this->height + margin - from.y};
+    decimal start = 0;
+    decimal end = 1;
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0) {
+            if (q[i] < 0) return;
+        } else {
+            decimal t = q[i] / p[i];
+            if (p[i] < 0) start = std::max(start, t);
+            else
+                end = std::min(end, t);
+        }
+    }
+    if (start > end) return;
+
+    // Every point of the segment is within half a step of a sample
+    decimal step = std::max(std::min(margin, static_cast<decimal>(this->tileSize / 2.0)),
+                            static_cast<decimal>(0.5));
+    decimal length = hypot(dx, dy) * (end - start);
+    int steps = static_cast<int>(ceil(length / step));
+    for (int i = 0; i <= steps; i++) {
+        decimal t = start + (end - start) * (steps == 0 ? 0 : static_cast<decimal>(i) / steps);
+        this->AddPoint(from.x + dx * t, from.y + dy * t, margin);
+    }
+}
+
+bool RegionOfInterest::Empty() const {
+    for (unsigned char tile : this->tiles) {
+        if (tile) return false;
+    }
+    return true;
+}
+
+bool RegionOfInterest::Covers(const Image &image) const {
+    return this->tileSize > 0 && this->width == image.dimensions[0] && this->height == image.dimensions[1]
+        && !this->Empty();
+}
+
+RegionOfInterest PredictHorizonRegion(const Camera &camera, const Attitude &attitude, const PositionVector &position,
+                                      decimal radius, decimal margin, int tileSize) {
+    RegionOfInterest region(camera.XResolution(), camera.YResolution(), tileSize);
+
+    // The horizon is a circle of directions at an angle theta around the direction to Earth's center
+    Vec3 center = attitude.Rotate(position * -1);
+    decimal distance = center.Magnitude();
+    if (distance <= radius) return RegionOfInterest();
+    Vec3 axis = center * (1 / distance);
+    decimal sinTheta = radius / distance;
+    decimal cosTheta = sqrt(1 - sinTheta * sinTheta);
+    Vec3 helper = fabs(axis.x) < 0.9 ? Vec3(1, 0, 0) : Vec3(0, 1, 0);
+    Vec3 u = axis.CrossProduct(helper).Normalize();
+    Vec3 v = axis.CrossProduct(u);
+
+    // Project samples of the circle, and add the segments between them
+    const int kSamples = 128;
+    bool hasLast = false;
+    decimal lastX = 0;
+    decimal lastY = 0;
+    for (int i = 0; i <= kSamples; i++) {
+        decimal phi = 2 * M_PI * i / kSamples;
+        Vec3 direction = axis * cosTheta + (u * cos(phi) + v * sin(phi)) * sinTheta;
+        if (direction.x <= 0) {
+            // This part of the horizon is behind the camera
+            hasLast = false;
+            continue;
+        }
+        Vec2 point = camera.SpatialToCamera(direction);
+        if (hasLast) region.AddSegment({lastX, lastY}, point, margin);
+        hasLast = true;
+        lastX = point.x;
+        lastY = point.y;
+    }
+    return region;
+}
+
+///////////////////////////////////
+///// SIMPLE EDGE DETECTION ///////
+///////////////////////////////////
+
+/**
+ * Thresholds part of a row of an image into a padded mask
+ *
+ * @param image The image to threshold
+ * @param y The row to threshold
+ * @param x0,x1 The range of columns of the mask
+ * @param threshold The minimum (channel-averaged) intensity of an Earth pixel
+ * @param mask The output, of x1 - x0 + 2 bytes, where mask[i] is the mask of pixel x0 - 1 + i
+ *
+ * @note Pixels outside of the image are treated as Earth, so that the sides of the
+ * image never look like the horizon
+ */
+static void ThresholdImageRow(const Image &image, int y, int x0, int x1, unsigned char threshold,
+                              unsigned char *mask) {
+    int width = image.dimensions[0];
+    int channels = image.dimensions[2];
+    if (y < 0 || y >= image.dimensions[1]) {
+        memset(mask, 0xFF, x1 - x0 + 2);
+        return;
+    }
+    int lo = std::max(x0 - 1, 0);
+    int hi = std::min(x1 + 1, width);
+    mask[0] = 0xFF;
+    mask[x1 - x0 + 1] = 0xFF;
+    const unsigned char *row = image.Row(y);
+    ThresholdRow(row + lo * channels, hi - lo, channels, threshold, mask + (lo - x0 + 1));
+}
+
+SimpleEdgeDetectionAlgorithm::SimpleEdgeDetectionAlgorithm(unsigned char threshold, size_t bands,
+                                                           TaskScheduler &scheduler)
+    : threshold(threshold), bands(bands), scheduler(&scheduler) {
+    if (bands == 0) throw std::invalid_argument("An image must be scanned in at least one band");
+}
+
+SimpleEdgeDetectionAlgorithm::~SimpleEdgeDetectionAlgorithm() {}
+
+Points SimpleEdgeDetectionAlgorithm::Run(const Image &image) {
+    Points points;
+    this->RunInto(image, points);
+    return points;
+}
+
+void SimpleEdgeDetectionAlgorithm::RunInto(const Image &image, Points &points) {
+    int width = image.dimensions[0];
+    int height = image.dimensions[1];
+    int channels = image.dimensions[2];
+    if (channels != 1 && channels != 3) throw std::invalid_argument("Images must have 1 or 3 channels");
+
+    points.clear();
+    if (width <= 0 || height <= 0) return;
+
+    // Room for the widest rectangle: 3 padded masks, and the horizon pixels of a row (per band)
+    size_t bands = std::min(this->bands, static_cast<size_t>(std::max(height / kMinimumBandRows, 1)));
+    size_t stride = 3 * static_cast<size_t>(width + 2) + width + 8;
+    ArenaScope scope(this->Scratch());
+    unsigned char *scratch = this->Scratch().Allocate<unsigned char>(bands * stride);
+
+    if (this->roi.Covers(image)) {
+        // Scan each run of consecutive tiles in a row of tiles as one rectangle
+        int tileSize = this->roi.TileSize();
+        for (int tileY = 0; tileY < this->roi.TilesY(); tileY++) {
+            int tileX = 0;
+            while (tileX < this->roi.TilesX()) {
+                if (!this->roi.Contains(tileX, tileY)) {
+                    tileX++;
+                    continue;
+                }
+                int start = tileX;
+                while (tileX < this->roi.TilesX() && this->roi.Contains(tileX, tileY)) tileX++;
+                this->ScanRectangle(image, start * tileSize, tileY * tileSize,
+                                    std::min(tileX * tileSize, width), std::min((tileY + 1) * tileSize, height),
+                                    scratch, points);
+            }
+        }
+        if (!points.empty()) {
+            this->Refine(image, points);
+            return;
+        }
+    }
+    if (bands > 1) {
+        this->ScanBands(image, bands, scratch, points);
+    } else {
+        this->ScanRectangle(image, 0, 0, width, height, scratch, points);
+    }
+    this->Refine(image, points);
+}
+
+void SimpleEdgeDetectionAlgorithm::ScanBands(const Image &image, size_t bands, unsigned char *scratch,
+                                             Points &points) {
+    int width = image.dimensions[0];
+    int height = image.dimensions[1];
+    size_t stride = 3 * static_cast<size_t>(width + 2) + width + 8;
+    if (this->shards.size() < bands) this->shards.resize(bands);
+
+    TaskGroup group(*this->scheduler);
+    for (size_t band = 0; band < bands; band++) {
+        int y0 = static_cast<int>(band * height / bands);
+        int y1 = static_cast<int>((band + 1) * height / bands);
+        Points &shard = this->shards[band];
+        unsigned char *memory = scratch + band * stride;
+        shard.clear();
+        group.Run([this, &image, y0, y1, width, memory, &shard]() {
+            this->ScanRectangle(image, 0, y0, width, y1, memory, shard);
+        });
+    }
+    group.Wait();
+
+    // Bands are in row order, so their points are too
+    size_t total = 0;
+    for (size_t band = 0; band < bands; band++) total += this->shards[band].size();
+    points.reserve(total);
+    for (size_t band = 0; band < bands; band++) {
+        const Points &shard = this->shards[band];
+        for (size_t i = 0; i < shard.size(); i++) points.push_back(shard.x()[i], shard.y()[i]);
+    }
+}
+
+void SimpleEdgeDetectionAlgorithm::ScanRectangle(const Image &image, int x0, int y0, int x1, int y1,
+                                                 unsigned char *scratch, Points &points) {
+    int span = x1 - x0;
+    unsigned char *above = scratch;
+    unsigned char *row = above + span + 2;
+    unsigned char *below = row + span + 2;
+    unsigned char *edges = below + span + 2;
+
+    ThresholdImageRow(image, y0 - 1, x0, x1, this->threshold, above);
+    ThresholdImageRow(image, y0, x0, x1, this->threshold, row);
+    for (int y = y0; y < y1; y++) {
+        ThresholdImageRow(image, y + 1, x0, x1, this->threshold, below);
+        HorizonRow(above + 1, row + 1, below + 1, span, edges);
+
+        // Horizon pixels are sparse, so skip over 8 pixels at a time
+        const unsigned char *e = edges;
+        memset(edges + span, 0, 8);
+        for (int x = 0; x < span; x += 8) {
+            uint64_t word;
+            memcpy(&word, e + x, sizeof(word));
+            if (word == 0) continue;
+            for (int i = x; i < x + 8 && i < span; i++) {
+                if (e[i]) points.push_back(static_cast<decimal>(x0 + i + 0.5), static_cast<decimal>(y + 0.5));
+            }
+        }
+
+        // Roll the masks down by one row
+        unsigned char *oldAbove = above;
+        above = row;
+        row = below;
+        below = oldAbove;
+    }
+}
+
+///////////////////////////////////
+/////// LoG EDGE DETECTION ////////
+///////////////////////////////////
+
+/**
+ * Samples a Gaussian
+ *
+ * @param sigma The standard deviation of the Gaussian
+ * @param radius The radius to sample it to
+ *
+ * @return The Gaussian at -radius, ..., radius, normalized to sum to 1
+ */
+static std::vector<decimal> GaussianKernel(decimal sigma, int radius) {
+    std::vector<decimal> kernel(2 * radius + 1);
+    decimal sum = 0;
+    for (int i = -radius; i <= radius; i++) {
+        kernel[i + radius] = exp(-i * i / (2 * sigma * sigma));
+        sum += kernel[i + radius];
+    }
+    for (decimal &value : kernel) value /= sum;
+    return kernel;
+}
+
+/**
+ * Samples the second derivative of a Gaussian
+ *
+ * @param sigma The standard deviation of the Gaussian
+ * @param radius The radius to sample it to
+ *
+ * @return The second derivative at -radius, ..., radius, shifted to sum to 0
+ * (so that flat regions have no response)
+ */
+static std::vector<decimal> GaussianSecondDerivativeKernel(decimal sigma, int radius) {
+    std::vector<decimal> kernel = GaussianKernel(sigma, radius);
+    decimal sum = 0;
+    for (int i = -radius; i <= radius; i++) {
+        kernel[i + radius] *= (i * i - sigma * sigma) / (sigma * sigma * sigma * sigma);
+        sum += kernel[i + radius];
+    }
+    for (decimal &value : kernel) value -= sum / kernel.size();
+    return kernel;
+}
+
+LoCEdgeDetectionAlgorithm::LoCEdgeDetectionAlgorithm(decimal sigma, decimal threshold,
+                                                     bool differenceOfGaussians, int tileSize)
+    : sigma(0), threshold(threshold), differenceOfGaussians(differenceOfGaussians), tileSize(tileSize) {
+    if (tileSize <= 0) throw std::invalid_argument("tileSize must be positive");
+    this->SetParameters(sigma, threshold);
+}
+
+void LoCEdgeDetectionAlgorithm::SetParameters(decimal sigma, decimal threshold) {
+    if (sigma <= 0) throw std::invalid_argument("sigma must be positive");
+    this->threshold = threshold;
+    if (sigma != this->sigma) this->MakeKernels(sigma);
+}
+
+void LoCEdgeDetectionAlgorithm::MakeKernels(decimal sigma) {
+    this->sigma = sigma;
+    if (this->differenceOfGaussians) {
+        // G(sigma) - G(1.6 sigma) closely approximates the (negated) LoG
+        decimal wideSigma = 1.6 * sigma;
+        this->radius = static_cast<int>(ceil(3 * wideSigma));
+        this->horizontalKernels[0] = GaussianKernel(sigma, this->radius);
+        this->verticalKernels[0] = this->horizontalKernels[0];
+        this->horizontalKernels[1] = GaussianKernel(wideSigma, this->radius);
+        this->verticalKernels[1] = this->horizontalKernels[1];
+        for (decimal &value : this->verticalKernels[1]) value = -value;
+    } else {
+        // LoG = G''(x)G(y) + G(x)G''(y)
+        this->radius = static_cast<int>(ceil(3 * sigma));
+        std::vector<decimal> gaussian = GaussianKernel(sigma, this->radius);
+        std::vector<decimal> secondDerivative = GaussianSecondDerivativeKernel(sigma, this->radius);
+        this->horizontalKernels[0] = secondDerivative;
+        this->verticalKernels[0] = gaussian;
+        this->horizontalKernels[1] = gaussian;
+        this->verticalKernels[1] = secondDerivative;
+    }
+}
+
+LoCEdgeDetectionAlgorithm::~LoCEdgeDetectionAlgorithm() {}
+
+Points LoCEdgeDetectionAlgorithm::Run(const Image &image) {
+    Points points;
+    this->RunInto(image, points);
+    return points;
+}
+
+void LoCEdgeDetectionAlgorithm::RunInto(const Image &image, Points &points) {
+    if (image.dimensions[2] != 1 && image.dimensions[2] != 3) {
+        throw std::invalid_argument("Images must have 1 or 3 channels");
+    }
+
+    points.clear();
+    if (this->roi.Covers(image)) {
+        int tileSize = this->roi.TileSize();
+        for (int tileY = 0; tileY < this->roi.TilesY(); tileY++) {
+            for (int tileX = 0; tileX < this->roi.TilesX(); tileX++) {
+                if (!this->roi.Contains(tileX, tileY)) continue;
+                int x = tileX * tileSize;
+                int y = tileY * tileSize;
+                this->FilterTile(image, x, y,
+                                 std::min(tileSize, image.dimensions[0] - x),
+                                 std::min(tileSize, image.dimensions[1] - y),
+                                 points);
+            }
+        }
+        if (!points.empty()) {
+            this->Refine(image, points);
+            return;
+        }
+    }
+    for (int y = 0; y < image.dimensions[1]; y += this->tileSize) {
+        for (int x = 0; x < image.dimensions[0]; x += this->tileSize) {
+            this->FilterTile(image, x, y,
+                             std::min(this->tileSize, image.dimensions[0] - x),
+                             std::min(this->tileSize, image.dimensions[1] - y),
+                             points);
+        }
+    }
+    this->Refine(image, points);
+}
+
+void LoCEdgeDetectionAlgorithm::FilterTile(const Image &image, int x0, int y0, int width, int height,
+                                           Points &points) {
+    int imageWidth = image.dimensions[0];
+    int imageHeight = image.dimensions[1];
+    int channels = image.dimensions[2];
+    int k = this->radius;
+    int kernelLength = 2 * k + 1;
+
+    // The response is needed one pixel around the tile (to find zero crossings),
+    // and the filter needs k more pixels around that
+    int responseWidth = width + 2;
+    int responseHeight = height + 2;
+    int inputWidth = responseWidth + 2 * k;
+    int inputHeight = responseHeight + 2 * k;
+
+    // The buffers of the tile come from the arena, and are freed for the next tile
+    ArenaScope scope(this->Scratch());
+    decimal *intensities = this->Scratch().Allocate<decimal>(static_cast<size_t>(inputWidth) * inputHeight);
+    decimal *horizontal[2];
+    for (decimal *&pass : horizontal) {
+        pass = this->Scratch().Allocate<decimal>(static_cast<size_t>(responseWidth) * inputHeight);
+    }
+    decimal *response = this->Scratch().Allocate<decimal>(static_cast<size_t>(responseWidth) * responseHeight);
+
+    // 1. Load the tile (and its apron), clamping to the sides of the image
+    decimal scale = static_cast<decimal>(1.0) / channels;
+    for (int r = 0; r < inputHeight; r++) {
+        int y = std::min(std::max(y0 - 1 - k + r, 0), imageHeight - 1);
+        const unsigned char *row = image.Row(y);
+        decimal *out = intensities + r * inputWidth;
+        for (int c = 0; c < inputWidth; c++) {
+            int x = std::min(std::max(x0 - 1 - k + c, 0), imageWidth - 1);
+            const unsigned char *pixel = row + x * channels;
+            int sum = 0;
+            for (int ch = 0; ch < channels; ch++) sum += pixel[ch];
+            out[c] = sum * scale;
+        }
+    }
+
+    // 2. Horizontal pass of each separable filter
+    for (int p = 0; p < 2; p++) {
+        const decimal *kernel = this->horizontalKernels[p].data();
+        for (int r = 0; r < inputHeight; r++) {
+            const decimal *in = intensities + r * inputWidth;
+            decimal *out = horizontal[p] + r * responseWidth;
+            for (int c = 0; c < responseWidth; c++) out[c] = 0;
+            for (int i = 0; i < kernelLength; i++) {
+                decimal weight = kernel[i];
+                for (int c = 0; c < responseWidth; c++) out[c] += weight * in[c + i];
+            }
+        }
+    }
+
+    // 3. Vertical pass of each separable filter, summed into the response
+    std::fill(response, response + responseWidth * responseHeight, 0);
+    for (int p = 0; p < 2; p++) {
+        const decimal *kernel = this->verticalKernels[p].data();
+        for (int r = 0; r < responseHeight; r++) {
+            decimal *out = response + r * responseWidth;
+            for (int i = 0; i < kernelLength; i++) {
+                decimal weight = kernel[i];
+                const decimal *in = horizontal[p] + (r + i) * responseWidth;
+                for (int c = 0; c < responseWidth; c++) out[c] += weight * in[c];
+            }
+        }
+    }
+
+    // 4. Emit the zero crossings between each pixel of the tile and its right and
+    // bottom neighbours (within the image), interpolating where the response is 0
+    for (int r = 1; r <= height; r++) {
+        int y = y0 + r - 1;
+        const decimal *row = response + r * responseWidth;
+        const decimal *nextRow = row + responseWidth;
+        for (int c = 1; c <= width; c++) {
+            int x = x0 + c - 1;
+            decimal here = row[c];
+            decimal right = row[c + 1];
+            if (x + 1 < imageWidth && (here < 0) != (right < 0) && fabs(here - right) >= this->threshold) {
+                points.push_back(static_cast<decimal>(x + 0.5 + here / (here - right)),
+                                 static_cast<decimal>(y + 0.5));
+            }
+            decimal below = nextRow[c];
+            if (y + 1 < imageHeight && (here < 0) != (below < 0) && fabs(here - below) >= this->threshold) {
+                points.push_back(static_cast<decimal>(x + 0.5),
+                                 static_cast<decimal>(y + 0.5 + here / (here - below)));
+            }
+        }
+    }
+}
+
+///////////////////////////////////
+///// PYRAMID EDGE DETECTION //////
+///////////////////////////////////
+
+PyramidEdgeDetectionAlgorithm::PyramidEdgeDetectionAlgorithm(EdgeDetectionAlgorithm &coarse,
+                                                             EdgeDetectionAlgorithm &fine,
+                                                             int levels, decimal margin, int tileSize)
+    : coarse(coarse), fine(fine), levels(levels), margin(margin), tileSize(tileSize),
+      pyramid(levels > 0 ? levels : 0) {
+    if (levels < 0) throw std::invalid_argument("levels must not be negative");
+    if (margin < 0) throw std::invalid_argument("margin must not be negative");
+    if (tileSize <= 0) throw std::invalid_argument("tileSize must be positive");
+}
+
+PyramidEdgeDetectionAlgorithm::~PyramidEdgeDetectionAlgorithm() {}
+
+void PyramidEdgeDetectionAlgorithm::SetArena(Arena *arena) {
+    EdgeDetectionAlgorithm::SetArena(arena);
+    this->coarse.SetArena(arena);
+    this->fine.SetArena(arena);
+}
+
+Points PyramidEdgeDetectionAlgorithm::Run(const Image &image) {
+    Points points;
+    this->RunInto(image, points);
+    return points;
+}
+
+const Image &PyramidEdgeDetectionAlgorithm::BuildPyramid(const Image &image) {
+    const Image *source = &image;
+    int channels = image.dimensions[2];
+    for (int level = 0; level < this->levels; level++) {
+        int sourceWidth = source->dimensions[0];
+        int sourceHeight = source->dimensions[1];
+        if (sourceWidth < 2 || sourceHeight < 2) break;
+        int width = sourceWidth / 2;
+        int height = sourceHeight / 2;
+
+        unsigned char *out = this->Scratch().Allocate<unsigned char>(static_cast<size_t>(width) * height * channels);
+        size_t stride = source->RowStride();
+        for (int y = 0; y < height; y++) {
+            const unsigned char *top = source->Row(2 * y);
+            const unsigned char *bottom = top + stride;
+            unsigned char *row = out + static_cast<size_t>(y) * width * channels;
+            for (int x = 0; x < width * channels; x++) {
+                // Pixel x / channels of this level covers pixels 2 * (x / channels) and the one after it
+                int left = 2 * (x - x % channels) + x % channels;
+                int right = left + channels;
+                row[x] = static_cast<unsigned char>((top[left] + top[right] + bottom[left] + bottom[right] + 2) / 4);
+            }
+        }
+
+        Image &decimated = this->pyramid[level];
+        decimated.image = out;
+        decimated.dimensions[0] = width;
+        decimated.dimensions[1] = height;
+        decimated.dimensions[2] = channels;
+        decimated.stride = 0;
+        source = &decimated;
+    }
+    return *source;
+}
+
+void PyramidEdgeDetectionAlgorithm::RunInto(const Image &image, Points &points) {
+    RegionOfInterest coarseRegion = this->coarse.GetRegionOfInterest();
+    RegionOfInterest fineRegion = this->fine.GetRegionOfInterest();
+    try {
+        RegionOfInterest region = this->roi;
+        if (!region.Covers(image)) {
+            // The pyramid is only needed until the horizon is found on it
+            ArenaScope scope(this->Scratch());
+            // 1. Find the horizon on the smallest level
+            const Image &smallest = this->BuildPyramid(image);
+            this->coarse.ClearRegionOfInterest();
+            this->coarse.RunInto(smallest, this->coarsePoints);
+
+            // 2. Mark the tiles around it at full resolution
+            decimal scaleX = static_cast<decimal>(image.dimensions[0]) / smallest.dimensions[0];
+            decimal scaleY = static_cast<decimal>(image.dimensions[1]) / smallest.dimensions[1];
+            decimal fineMargin = this->margin * std::max(scaleX, scaleY);
+            region = RegionOfInterest(image.dimensions[0], image.dimensions[1], this->tileSize);
+            for (size_t i = 0; i < this->coarsePoints.size(); i++) {
+                region.AddPoint(this->coarsePoints.x()[i] * scaleX, this->coarsePoints.y()[i] * scaleY, fineMargin);
+            }
+        }
+
+        // 3. Search those tiles at full resolution
+        this->fine.SetRegionOfInterest(region);
+        this->fine.RunInto(image, points);
+    } catch (...) {
+        this->coarse.SetRegionOfInterest(coarseRegion);
+        this->fine.SetRegionOfInterest(fineRegion);
+        throw;
+    }
+    this->coarse.SetRegionOfInterest(coarseRegion);
+    this->fine.SetRegionOfInterest(fineRegion);
+    this->Refine(image, points);
+}
+
+///////////////////////////////////
+////// SUB-PIXEL REFINEMENT ///////
+///////////////////////////////////
+
+/**
+ * Provides the (channel-averaged) intensity of a pixel, clamping to the edges of an image
+ *
+ * @param image The image
+ * @param x,y The column and row of the pixel
+ *
+ * @return The intensity of the nearest pixel of image
+ */
+static decimal PixelIntensity(const Image &image, int x, int y) {
+    x = std::min(std::max(x, 0), image.dimensions[0] - 1);
+    y = std::min(std::max(y, 0), image.dimensions[1] - 1);
+    const unsigned char *pixel = image.Row(y) + static_cast<size_t>(x) * image.dimensions[2];
+    if (image.dimensions[2] == 1) return pixel[0];
+    return (static_cast<decimal>(pixel[0]) + pixel[1] + pixel[2]) / 3;
+}
+
+/**
+ * Samples the intensity of an image between pixels, by bilinear interpolation
+ *
+ * @param image The image
+ * @param x,y The point to sample, in image coordinates (pixel centers are at half pixels)
+ *
+ * @return The intensity at the point
+ */
+static decimal SampleIntensity(const Image &image, decimal x, decimal y) {
+    decimal u = x - static_cast<decimal>(0.5), v = y - static_cast<decimal>(0.5);
+    int x0 = static_cast<int>(floor(u)), y0 = static_cast<int>(floor(v));
+    decimal fx = u - x0, fy = v - y0;
+    decimal top = PixelIntensity(image, x0, y0) * (1 - fx) + PixelIntensity(image, x0 + 1, y0) * fx;
+    decimal bottom = PixelIntensity(image, x0, y0 + 1) * (1 - fx) + PixelIntensity(image, x0 + 1, y0 + 1) * fx;
+    return top * (1 - fy) + bottom * fy;
+}
+
+void RefineHorizonPoints(const Image &image, const SubpixelOptions &options, Points &points) {
+    if (options.radius < 0) throw std::invalid_argument("The refinement radius must not be negative");
+    if (image.dimensions[2] != 1 && image.dimensions[2] != 3) {
+        throw std::invalid_argument("Images must have 1 or 3 channels");
+    }
+    size_t size = points.size();
+    size_t kept = options.maxPoints > 0 ? std::min(options.maxPoints, size) : size;
+    if (options.radius == 0) {
+        for (size_t k = 0; k < kept; k++) {
+            size_t index = k * size / kept;
+            points.x()[k] = points.x()[index];
+            points.y()[k] = points.y()[index];
+        }
+        points.resize(kept);
+        return;
+    }
+    int radius = options.radius;
+    // The profile along the normal, from -radius - 1 to radius + 1 pixels
+    decimal profile[2 * kMaximumRefinementRadius + 3];
+    radius = std::min(radius, kMaximumRefinementRadius);
+
+    // The points are thinned and refined in place, since each is written at or before where it was read
+    size_t count = 0;
+    for (size_t k = 0; k < kept; k++) {
+        size_t index = k * size / kept;
+        decimal x = points.x()[index], y = points.y()[index];
+        int px = static_cast<int>(floor(x)), py = static_cast<int>(floor(y));
+
+        // 1. The normal, from a Sobel filter around the pixel of the point
+        decimal gx = PixelIntensity(image, px + 1, py - 1) + 2 * PixelIntensity(image, px + 1, py) +
+                     PixelIntensity(image, px + 1, py + 1) - PixelIntensity(image, px - 1, py - 1) -
+                     2 * PixelIntensity(image, px - 1, py) - PixelIntensity(image, px - 1, py + 1);
+        decimal gy = PixelIntensity(image, px - 1, py + 1) + 2 * PixelIntensity(image, px, py + 1) +
+                     PixelIntensity(image, px + 1, py + 1) - PixelIntensity(image, px - 1, py - 1) -
+                     2 * PixelIntensity(image, px, py - 1) - PixelIntensity(image, px + 1, py - 1);
+        // The Sobel filter weighs the gradient by 8
+        decimal gradient = sqrt(gx * gx + gy * gy);
+        if (!(gradient >= 8 * options.minimumGradient) || gradient == 0) continue;
+        decimal nx = gx / gradient, ny = gy / gradient;
+
+        // 2. The peak of the derivative of the profile along the normal
+        for (int t = -radius - 1; t <= radius + 1; t++) {
+            profile[t + radius + 1] = SampleIntensity(image, x + t * nx, y + t * ny);
+        }
+        int best = 0;
+        decimal bestSlope = -1;
+        decimal slopes[2 * kMaximumRefinementRadius + 1];
+        for (int t = -radius; t <= radius; t++) {
+            decimal slope = profile[t + radius + 2] - profile[t + radius];
+            slopes[t + radius] = slope;
+            if (slope > bestSlope) {
+                bestSlope = slope;
+                best = t;
+            }
+        }
+        decimal offset = best;
+        if (best > -radius && best < radius) {
+            decimal before = slopes[best + radius - 1], after = slopes[best + radius + 1];
+            decimal curvature = before - 2 * bestSlope + after;
+            if (curvature < 0) offset += (before - after) / (2 * curvature);
+        }
+        points.x()[count] = x + offset * nx;
+        points.y()[count] = y + offset * ny;
+        count++;
+    }
+    points.resize(count);
+}
+
+}  // namespace found
@@ -1,67 +1,537 @@
 #ifndef EDGE_H
 #define EDGE_H
 
+#include <stdexcept>
+#include <vector>
+
 #include "style/style.hpp"
 #include "pipeline/pipeline.hpp"
+#include "pipeline/scheduler.hpp"
+#include "spatial/attitude-utils.hpp"
+#include "spatial/camera.hpp"
 
 namespace found {
 
+/**
+ * A RegionOfInterest is a mutable object that marks which parts of an image are worth searching
+ * for the horizon. The image is split into square tiles, and each tile is either in or out of
+ * the region.
+ *
+ * @note An empty RegionOfInterest means that the whole image should be searched
+ */
+class RegionOfInterest {
+ public:
+    /**
+     * Creates an empty RegionOfInterest
+     */
+    RegionOfInterest() : width(0), height(0), tileSize(0), tilesX(0), tilesY(0) {}
+
+    /**
+     * Creates a RegionOfInterest with no tiles in it
+     *
+     * @param width The width of the image the region is for
+     * @param height The height of the image the region is for
+     * @param tileSize The side length of each tile, in pixels
+     */
+    RegionOfInterest(int width, int height, int tileSize);
+
+    /**
+     * Adds every tile that touches a square around a point
+     *
+     * @param x,y The point, in image coordinates
+     * @param margin The half side length of the square, in pixels
+     */
+    void AddPoint(decimal x, decimal y, decimal margin);
+
+    /**
+     * Adds every tile that touches a band around a line segment
+     *
+     * @param from The start of the segment, in image coordinates
+     * @param to The end of the segment, in image coordinates
+     * @param margin The half width of the band, in pixels
+     */
+    void AddSegment(const Vec2 &from, const Vec2 &to, decimal margin);
+
+    /**
+     * Tells whether a tile is in this region
+     *
+     * @param tileX,tileY The column and row of the tile
+     *
+     * @return true iff the tile is in this
+     */
+    bool Contains(int tileX, int tileY) const { return this->tiles[tileY * this->tilesX + tileX] != 0; }
+
+    /**
+     * Tells whether this region has no tiles in it
+     *
+     * @return true iff no tile is in this
+     */
+    bool Empty() const;
+
+    /**
+     * Tells whether this region can be used on an image
+     *
+     * @param image The image to check
+     *
+     * @return true iff this is not empty and was made for images of the size of image
+     */
+    bool Covers(const Image &image) const;
+
+    /// Returns the side length of each tile, in pixels
+    int TileSize() const { return tileSize; }
+    /// Returns the number of columns of tiles
+    int TilesX() const { return tilesX; }
+    /// Returns the number of rows of tiles
+    int TilesY() const { return tilesY; }
+
+ private:
+    /// The image width
+    int width;
+    /// The image height
+    int height;
+    /// The side length of a tile
+    int tileSize;
+    /// The number of columns of tiles
+    int tilesX;
+    /// The number of rows of tiles
+    int tilesY;
+    /// Whether each tile (row-major) is in this
+    std::vector<unsigned char> tiles;
+};
+
+/**
+ * Predicts where the horizon will be in the next image, from the last known state of the satellite
+ *
+ * @param camera The camera taking the image
+ * @param attitude The attitude of the camera, rotating the reference frame into the camera frame
+ * @param position The position of the satellite relative to Earth's center, in the reference frame
+ * @param radius The radius of Earth
+ * @param margin How far from the predicted horizon to search, in pixels
+ * @param tileSize The side length of the tiles of the region
+ *
+ * @return The tiles within margin of the projected horizon, which is empty if the horizon is not
+ * in front of the camera (so that the whole image gets searched)
+ */
+RegionOfInterest PredictHorizonRegion(const Camera &camera, const Attitude &attitude, const PositionVector &position,
+                                      decimal radius, decimal margin, int tileSize);
+
+/// The furthest (in pixels) that sub-pixel refinement samples along the normal of an edge
+const int kMaximumRefinementRadius = 16;
+
+/**
+ * SubpixelOptions controls the refinement of horizon points to sub-pixel accuracy (see
+ * RefineHorizonPoints), and so the trade-off between the number of points and their accuracy
+ */
+struct SubpixelOptions {
+    /// How far the intensity is sampled along the normal of the edge, to each side, in pixels
+    /// (at most kMaximumRefinementRadius), or 0 to only thin out the points
+    int radius = 3;
+    /// The most points to keep, picked evenly from those found, before refinement (0 to keep all)
+    size_t maxPoints = 0;
+    /// The least intensity gradient (per pixel) a point needs to be kept, since flat points cannot be refined
+    decimal minimumGradient = 4;
+};
+
+/**
+ * Refines horizon points to sub-pixel accuracy, from the image around each of them only
+ *
+ * The normal of the edge at each point is the direction of the intensity gradient (a Sobel
+ * filter over its 3x3 neighbourhood). The intensity is sampled along the normal (bilinearly), and
+ * the point is moved to the peak of its derivative, as interpolated by a parabola through the
+ * largest derivative and its two neighbours.
+ *
+ * @param image The image the points were found in, with 1 or 3 interleaved channels
+ * @param options How to refine the points
+ * @param points The points, in image coordinates, which are thinned out to at most
+ * options.maxPoints and refined in place (keeping their order)
+ *
+ * @throws invalid_argument iff options.radius is negative, or image does not have 1 or 3 channels
+ */
+void RefineHorizonPoints(const Image &image, const SubpixelOptions &options, Points &points);
+
 /**
  * The EdgeDetection Algorithm class houses the Edge Detection Algorithm. This algorithm uses 
  * a picture of Earth and finds all points on the horizon within the picture.
+ *
+ * Algorithms may be given a RegionOfInterest, in which case they only search its tiles, and only
+ * fall back to searching the whole image if nothing was found there.
 */
-class EdgeDetectionAlgorithm : public Stage<Image, Points> {};
+class EdgeDetectionAlgorithm : public Stage<Image, Points> {
+ public:
+    /**
+     * Restricts the search of every later run to a region
+     *
+     * @param region The region to search, which is ignored for images of another size
+     */
+    void SetRegionOfInterest(const RegionOfInterest &region) { this->roi = region; }
+
+    /**
+     * Lifts any restriction on the search
+     */
+    void ClearRegionOfInterest() { this->roi = RegionOfInterest(); }
+
+    /**
+     * Provides the region searched by this
+     *
+     * @return The region of interest of this
+     */
+    const RegionOfInterest &GetRegionOfInterest() const { return this->roi; }
+
+    /**
+     * Refines the points of every later run to sub-pixel accuracy (see RefineHorizonPoints)
+     *
+     * @param options How to refine the points
+     *
+     * @throws invalid_argument iff options.radius is negative
+     */
+    void SetSubpixelRefinement(const SubpixelOptions &options) {
+        if (options.radius < 0) throw std::invalid_argument("The refinement radius must not be negative");
+        this->subpixel = options;
+        this->refine = true;
+    }
+
+    /**
+     * Keeps the points of every later run as they are found
+     */
+    void ClearSubpixelRefinement() { this->refine = false; }
+
+ protected:
+    /**
+     * Refines the points of a run, if this was asked to
+     *
+     * @param image The image the points were found in
+     * @param points The points
+     */
+    void Refine(const Image &image, Points &points) const {
+        if (this->refine) RefineHorizonPoints(image, this->subpixel, points);
+    }
+
+    /// The region to search
+    RegionOfInterest roi;
+    /// Whether points are refined
+    bool refine = false;
+    /// How points are refined
+    SubpixelOptions subpixel;
+};
+
+/// The fewest rows of an image worth scanning as a band of their own
+const int kMinimumBandRows = 64;
 
 /**
  * The SimpleEdgeDetection Algorithm class houses the Edge Detection Algorithm. This algorithm uses 
  * a picture of Earth and finds all points on the horizon within the picture by employing thresholding
  * to filter out edge components
+ *
+ * A pixel is part of Earth iff its (channel-averaged) intensity is at least the threshold, and a pixel
+ * is on the horizon iff it is part of Earth and one of its 4 neighbours (within the image) is not. Both
+ * the thresholding and the horizon scan are vectorized (SSE2/SSSE3/AVX2 or NEON, picked at runtime).
 */
 class SimpleEdgeDetectionAlgorithm : public EdgeDetectionAlgorithm {
  public:
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
-    SimpleEdgeDetectionAlgorithm(/*Put more fields here!*/);
+     * Creates a SimpleEdgeDetectionAlgorithm
+     *
+     * @param threshold The minimum intensity of a pixel that belongs to Earth
+     * @param bands The number of row bands a whole image is split into, which are scanned
+     * at once (bands are at least kMinimumBandRows tall, so small images use fewer)
+     * @param scheduler The scheduler to scan the bands on
+     *
+     * @throws invalid_argument iff bands is 0
+     */
+    explicit SimpleEdgeDetectionAlgorithm(unsigned char threshold, size_t bands = 1,
+                                          TaskScheduler &scheduler = TaskScheduler::Default());
+
+    /**
+     * Destroys this
+     */
+    virtual ~SimpleEdgeDetectionAlgorithm();
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
-    virtual ~SimpleEdgeDetectionAlgorithm(/*Put more fields here!*/);
+     * Finds the horizon of Earth in an image
+     *
+     * @param image The image to search, with 1 or 3 interleaved channels
+     *
+     * @return The centers of every pixel on the horizon, in row-major order (within each searched
+     * run of tiles, if there is a region of interest)
+     *
+     * @throws invalid_argument iff image does not have 1 or 3 channels
+     */
+    Points Run(const Image &image) override;
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
-    Points Run(const Image &image/*parameters all algorithms will need (Override this plz)*/) override;
+     * Finds the horizon of Earth in an image, reusing the storage of points
+     *
+     * @param image The image to search, with 1 or 3 interleaved channels
+     * @param points The variable to place the horizon points in
+     *
+     * @throws invalid_argument iff image does not have 1 or 3 channels
+     */
+    void RunInto(const Image &image, Points &points) override;
+
+    /**
+     * Changes the threshold of this (i.e. for the next frame)
+     *
+     * @param threshold The minimum intensity of a pixel that belongs to Earth
+     */
+    void SetThreshold(unsigned char threshold) { this->threshold = threshold; }
+
  private:
-    // useful fields specific to this algorithm and helper methods
+    /**
+     * Finds the horizon within a rectangle of an image
+     *
+     * @param image The image to search
+     * @param x0,y0 The top left pixel of the rectangle
+     * @param x1,y1 One past the bottom right pixel of the rectangle
+     * @param scratch The memory for the thresholded rows above, at and below the scanned
+     * row (each padded by one pixel per side), then the horizon pixels of the scanned row
+     * (and 8 more bytes), i.e. 4 (x1 - x0) + 14 bytes
+     * @param points The variable to append the horizon points to
+     *
+     * @note Pixels just outside of the rectangle are still looked at, so that
+     * the horizon is the same no matter how the image is split up
+     */
+    void ScanRectangle(const Image &image, int x0, int y0, int x1, int y1, unsigned char *scratch, Points &points);
+
+    /**
+     * Finds the horizon of a whole image, one row band at a time on the scheduler
+     *
+     * @param image The image to search
+     * @param bands The number of bands (more than 1)
+     * @param scratch The memory of every band, each as for ScanRectangle, one after the other
+     * @param points The variable to place the horizon points in, in row-major order
+     */
+    void ScanBands(const Image &image, size_t bands, unsigned char *scratch, Points &points);
+
+    /// The minimum intensity of an Earth pixel
+    unsigned char threshold;
+    /// The most row bands a whole image is split into
+    size_t bands;
+    /// The scheduler the bands are scanned on
+    TaskScheduler *scheduler;
+    /// The horizon points of each band, reused from one run to the next
+    std::vector<Points> shards;
 };
 
 /**
  * The LoGEdgeDetection Algorithm class houses the Edge Detection Algorithm. This algorithm uses 
  * a picture of Earth and finds all points on the horizon within the picture by employing a 
  * Laplacian of Gaussian (LoC) filter to the image.
+ *
+ * The filter is applied as a sum of separable passes (G''(x)G(y) + G(x)G''(y), or G1 - G2 for the
+ * Difference of Gaussians approximation), one square tile at a time so that every intermediate buffer
+ * stays in cache, and zero crossings of the response are emitted straight from each tile with
+ * sub-pixel (linearly interpolated) positions.
 */
 class LoCEdgeDetectionAlgorithm : public EdgeDetectionAlgorithm {
  public:
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
-    LoCEdgeDetectionAlgorithm(/*Put more fields here!*/);
+     * Creates a LoCEdgeDetectionAlgorithm
+     *
+     * @param sigma The standard deviation of the Gaussian, in pixels
+     * @param threshold The minimum change in the filter response across a zero crossing for it to
+     * count as the horizon (filters out the zero crossings of noise)
+     * @param differenceOfGaussians true to approximate the LoG filter by a Difference of Gaussians
+     * (with standard deviations sigma and 1.6 * sigma), which is cheaper for large sigma
+     * @param tileSize The side length of the tiles the image is filtered in, in pixels
+     *
+     * @throws invalid_argument iff sigma or tileSize is not positive
+     */
+    LoCEdgeDetectionAlgorithm(decimal sigma, decimal threshold, bool differenceOfGaussians = false,
+                              int tileSize = 64);
+
+    /**
+     * Destroys this
+     */
+    virtual ~LoCEdgeDetectionAlgorithm();
+
+    /**
+     * Finds the horizon of Earth in an image
+     *
+     * @param image The image to search, with 1 or 3 interleaved channels
+     *
+     * @return The sub-pixel positions of the zero crossings of the filter response, tile by tile
+     *
+     * @throws invalid_argument iff image does not have 1 or 3 channels
+     */
+    Points Run(const Image &image) override;
+
+    /**
+     * Finds the horizon of Earth in an image, reusing the storage of points
+     *
+     * @param image The image to search, with 1 or 3 interleaved channels
+     * @param points The variable to place the horizon points in
+     *
+     * @throws invalid_argument iff image does not have 1 or 3 channels
+     */
+    void RunInto(const Image &image, Points &points) override;
+
+    /**
+     * Changes the filter of this (i.e. for the next frame), remaking its kernels only if
+     * sigma changes
+     *
+     * @param sigma The standard deviation of the Gaussian, in pixels
+     * @param threshold The minimum change in the filter response across a zero crossing
+     *
+     * @throws invalid_argument iff sigma is not positive
+     */
+    void SetParameters(decimal sigma, decimal threshold);
+
+ private:
+    /**
+     * Makes the kernels of the filter
+     *
+     * @param sigma The standard deviation of the Gaussian, in pixels
+     */
+    void MakeKernels(decimal sigma);
+
+    /**
+     * Filters one tile of an image and emits its zero crossings
+     *
+     * @param image The image to filter
+     * @param x0,y0 The top left pixel of the tile
+     * @param width,height The size of the tile
+     * @param points The variable to append the zero crossings to
+     */
+    void FilterTile(const Image &image, int x0, int y0, int width, int height, Points &points);
+
+    /// The standard deviation of the Gaussian
+    decimal sigma;
+    /// The minimum change in the response across a zero crossing
+    decimal threshold;
+    /// Whether the filter is a Difference of Gaussians
+    bool differenceOfGaussians;
+    /// The side length of a tile
+    int tileSize;
+    /// The radius of the kernels
+    int radius;
+    /// The horizontal kernels of each separable pass (of length 2 * radius + 1)
+    std::vector<decimal> horizontalKernels[2];
+    /// The vertical kernels of each separable pass (of length 2 * radius + 1)
+    std::vector<decimal> verticalKernels[2];
+};
+
+/**
+ * The PyramidEdgeDetection Algorithm class speeds up another Edge Detection Algorithm on large
+ * images. It decimates the image into a pyramid (halving its size at each level by averaging 2x2
+ * blocks of pixels), finds the horizon on the smallest level, and then only searches tiles around
+ * that coarse horizon at full resolution. Apart from building the pyramid, the cost of each frame
+ * then grows with the length of the horizon instead of the area of the image.
+ *
+ * If this is given a RegionOfInterest that covers the image, the coarse search is skipped and that
+ * region is searched at full resolution instead.
+ *
+ * @note The detectors given to this are borrowed, and their regions of interest are restored after
+ * every run, so the same detector can do both the coarse and the fine search
+*/
+class PyramidEdgeDetectionAlgorithm : public EdgeDetectionAlgorithm {
+ public:
+    /**
+     * Creates a PyramidEdgeDetectionAlgorithm
+     *
+     * @param coarse The detector to find the horizon with on the smallest level of the pyramid
+     * @param fine The detector to find the horizon with at full resolution
+     * @param levels The number of times to halve the image (0 searches the whole image with fine)
+     * @param margin How far from the coarse horizon to search at full resolution, in pixels of the
+     * smallest level
+     * @param tileSize The side length of the tiles searched at full resolution
+     *
+     * @throws invalid_argument iff levels or margin is negative, or tileSize is not positive
+     */
+    PyramidEdgeDetectionAlgorithm(EdgeDetectionAlgorithm &coarse, EdgeDetectionAlgorithm &fine,
+                                  int levels = 2, decimal margin = 2, int tileSize = 16);
+
+    /**
+     * Destroys this
+     */
+    virtual ~PyramidEdgeDetectionAlgorithm();
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
-    virtual ~LoCEdgeDetectionAlgorithm(/*Put more fields here!*/);
+     * Finds the horizon of Earth in an image
+     *
+     * @param image The image to search, with 1 or 3 interleaved channels
+     *
+     * @return The horizon points that fine finds around the coarse horizon
+     *
+     * @throws invalid_argument iff coarse or fine does (e.g. if image does not have 1 or 3 channels)
+     */
+    Points Run(const Image &image) override;
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
-    Points Run(const Image &image/*parameters all algorithms will need (Override this plz)*/) override;
+     * Finds the horizon of Earth in an image, reusing the storage of points
+     *
+     * @param image The image to search, with 1 or 3 interleaved channels
+     * @param points The variable to place the horizon points in
+     *
+     * @throws invalid_argument iff coarse or fine does (e.g. if image does not have 1 or 3 channels)
+     */
+    void RunInto(const Image &image, Points &points) override;
+
+    /**
+     * Makes this, and the detectors it runs, take scratch memory from an arena
+     *
+     * @param arena The arena (nullptr for their own)
+     */
+    void SetArena(Arena *arena) override;
+
  private:
-    // useful fields specific to this algorithm and helper methods
+    /**
+     * Decimates an image into the pyramid of this
+     *
+     * @param image The image to decimate
+     *
+     * @return The smallest level of the pyramid (which is image itself if levels is 0),
+     * whose pixels are taken from the arena of this
+     */
+    const Image &BuildPyramid(const Image &image);
+
+    /// The detector on the smallest level
+    EdgeDetectionAlgorithm &coarse;
+    /// The detector at full resolution
+    EdgeDetectionAlgorithm &fine;
+    /// The number of levels below full resolution
+    int levels;
+    /// How far around coarse horizon points to search, in pixels of the smallest level
+    decimal margin;
+    /// The side length of the tiles searched at full resolution
+    int tileSize;
+    /// Each level below full resolution (whose pixels are in the arena of this)
+    std::vector<Image> pyramid;
+    /// The horizon points on the smallest level
+    Points coarsePoints;
 };
 
+// Vectorized Kernels
+
+/**
+ * Thresholds a row of pixels, using the fastest kernel available
+ *
+ * @param row The first pixel to threshold, with its channels interleaved
+ * @param width The number of pixels to threshold
+ * @param channels The number of interleaved channels of each pixel (1 or 3)
+ * @param threshold The minimum (channel-averaged) intensity of an Earth pixel
+ * @param mask The output, of width bytes, where each byte is 0xFF iff its pixel is part of Earth,
+ * and 0 otherwise
+ *
+ * @pre channels is 1 or 3, and row holds width * channels bytes
+ */
+void ThresholdRow(const unsigned char *row, int width, int channels, unsigned char threshold, unsigned char *mask);
+
+/**
+ * Finds the horizon pixels of a row, using the fastest kernel available
+ *
+ * @param above The mask of the row above, as made by ThresholdRow
+ * @param row The mask of the row, as made by ThresholdRow
+ * @param below The mask of the row below, as made by ThresholdRow
+ * @param width The number of pixels to scan
+ * @param edges The output, of width bytes, where each byte is nonzero iff its pixel is part of
+ * Earth, but one of its 4 neighbours is not
+ *
+ * @pre above, below and edges hold width bytes, and row[-1] and row[width] are readable (the
+ * mask must be padded by a pixel at each end)
+ */
+void HorizonRow(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                int width, unsigned char *edges);
+
 }  // namespace found
 
 #endif
@@ -0,0 +1,69 @@
+#include "distance/vectorize.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+
+#include "spatial/attitude-utils.hpp"
+
+namespace found {
+
+VectorGenerationAlgorithm::~VectorGenerationAlgorithm() {}
+
+LOSTVectorGenerationAlgorithm::LOSTVectorGenerationAlgorithm(const DistanceDeterminationAlgorithm &distance,
+                                                             size_t capacity)
+    : distance(distance), capacity(capacity), frameTime(0), cached(false) {
+    if (capacity == 0) throw std::invalid_argument("At least 1 attitude must be kept");
+}
+
+LOSTVectorGenerationAlgorithm::~LOSTVectorGenerationAlgorithm() {}
+
+void LOSTVectorGenerationAlgorithm::AddAttitude(preciseDecimal time, const Attitude &attitude) {
+    if (!this->attitudes.empty() && !(time > this->attitudes.back().time)) {
+        throw std::invalid_argument("Attitudes must be added in the order of their times");
+    }
+    // Only a frame after the last attitude (which was held) or before the first one kept moves
+    if (this->attitudes.empty() || this->frameTime > this->attitudes.back().time) this->cached = false;
+    this->attitudes.push_back({time, attitude.GetQuaternion()});
+    if (this->attitudes.size() > this->capacity) {
+        this->attitudes.pop_front();
+        if (this->frameTime < this->attitudes.front().time) this->cached = false;
+    }
+}
+
+void LOSTVectorGenerationAlgorithm::SetFrameTime(preciseDecimal time) {
+    if (time != this->frameTime) this->cached = false;
+    this->frameTime = time;
+}
+
+const Attitude &LOSTVectorGenerationAlgorithm::FrameAttitude() {
+    if (this->cached) return this->frameAttitude;
+    if (this->attitudes.empty()) throw std::runtime_error("There is no attitude to place the frame with");
+
+    // The first attitude after the frame
+    std::deque<TimedAttitude>::const_iterator after =
+        std::upper_bound(this->attitudes.begin(), this->attitudes.end(), this->frameTime,
+                         [](preciseDecimal time, const TimedAttitude &attitude) { return time < attitude.time; });
+    Quaternion rotation;
+    if (after == this->attitudes.begin()) {
+        rotation = after->attitude;
+    } else if (after == this->attitudes.end()) {
+        rotation = this->attitudes.back().attitude;
+    } else {
+        const TimedAttitude &before = *(after - 1);
+        decimal t = static_cast<decimal>((this->frameTime - before.time) / (after->time - before.time));
+        rotation = Slerp(before.attitude, after->attitude, t);
+    }
+    this->frameAttitude = Attitude(rotation);
+    this->toReference = this->frameAttitude.GetDCM().Transpose();
+    this->cached = true;
+    return this->frameAttitude;
+}
+
+PositionVector LOSTVectorGenerationAlgorithm::Run(const distFromEarth &x_E) {
+    this->FrameAttitude();
+    // Earth's center is x_E along the center direction, so the satellite is x_E the other way
+    return this->toReference * this->distance.Center() * -x_E;
+}
+
+}  // namespace found
@@ -1,6 +1,11 @@
 #ifndef VECTORIZE_H
 #define VECTORIZE_H
 
+#include <stddef.h>
+
+#include <deque>
+
+#include "distance/distance.hpp"
 #include "spatial/attitude-utils.hpp"
 #include "style/style.hpp"
 #include "pipeline/pipeline.hpp"
@@ -20,24 +25,75 @@ class VectorGenerationAlgorithm : public Stage<distFromEarth, PositionVector> {
     virtual ~VectorGenerationAlgorithm();
 };
 
+/// The number of attitudes a LOSTVectorGenerationAlgorithm keeps, unless told otherwise
+const size_t kAttitudeHistoryLength = 64;
+
+/**
+ * A TimedAttitude is an attitude, and when it was true
+ */
+struct TimedAttitude {
+    /// The time of the attitude, in s
+    preciseDecimal time;
+    /// The attitude, rotating the reference frame into the camera frame
+    Quaternion attitude;
+};
+
 /**
  * The LOSTVectorGenerationAlgorithm class houses the a Vector Assembly Algorithm that calculates the
  * position of the satellite using orientation information determined from LOST.
- * 
-*/
+ *
+ * LOST gives attitudes as a stream, each with its time, and every frame has a time of its own.
+ * This keeps the latest attitudes, and turns each distance into a position with the attitude at
+ * the time of its frame, interpolated (by Slerp) between the attitudes on either side of it. The
+ * rotation of a frame is cached until its time or the attitudes around it change, so the same
+ * stage (and the Pipeline it is in) serves every frame.
+ *
+ * The direction towards Earth's center, in the camera frame, is the one found by the distance
+ * algorithm that feeds this.
+ */
 class LOSTVectorGenerationAlgorithm : public VectorGenerationAlgorithm {
  public:
     /**
      * Creates a LOSTVectorGenerationAlgorithm object
-     * 
-     * @param orientation The orientation of the satellite as determined by LOST
-    */
-    explicit LOSTVectorGenerationAlgorithm(Vec3 orientation/*Params to initialze fields for this object*/)
-        : orientation(orientation) {}
+     *
+     * @param distance The distance algorithm that feeds this, whose Center() is read on every run
+     * @param capacity The most attitudes to keep (the oldest are dropped)
+     *
+     * @throws invalid_argument iff capacity is 0
+     */
+    explicit LOSTVectorGenerationAlgorithm(const DistanceDeterminationAlgorithm &distance,
+                                           size_t capacity = kAttitudeHistoryLength);
 
     // Destroys this
     ~LOSTVectorGenerationAlgorithm();
 
+    /**
+     * Adds the next attitude from LOST
+     *
+     * @param time The time of the attitude, in s
+     * @param attitude The attitude of the camera, rotating the reference frame into the camera frame
+     *
+     * @throws invalid_argument iff time is not after that of the last attitude added
+     */
+    void AddAttitude(preciseDecimal time, const Attitude &attitude);
+
+    /**
+     * Sets the time of the frames that are run next
+     *
+     * @param time The time of the frame, in s
+     */
+    void SetFrameTime(preciseDecimal time);
+
+    /**
+     * Provides the attitude at the time of the frame
+     *
+     * @return The attitude, held at the first or last attitude for frames before or after
+     * all of them
+     *
+     * @throws runtime_error iff this has no attitudes
+     */
+    const Attitude &FrameAttitude();
+
     /**
      * Runs the Vector Assembly Algorithm, which finds the vector of the satellite with respect
      * to Earth's center using information from LOST
@@ -45,15 +101,30 @@ class LOSTVectorGenerationAlgorithm : public VectorGenerationAlgorithm {
      * @param x_E The distance from Earth
      * 
      * @return A PositionVector that represents the 3D Vector of the satellite relative to
-     * Earth's center
+     * Earth's center, in the reference frame
+     *
+     * @throws runtime_error iff this has no attitudes
     */
-    PositionVector Run(const distFromEarth &x_E /*Params to override the base class one*/) override;
+    PositionVector Run(const distFromEarth &x_E) override;
 
- private:
-    // Fields specific to this algorithm go here, and helper methods
+    /// Returns the number of attitudes this keeps
+    size_t Attitudes() const { return this->attitudes.size(); }
 
-    // Orientation from LOST
-    Vec3 orientation;
+ private:
+    /// The distance algorithm that feeds this
+    const DistanceDeterminationAlgorithm &distance;
+    /// The most attitudes to keep
+    size_t capacity;
+    /// The latest attitudes, oldest first
+    std::deque<TimedAttitude> attitudes;
+    /// The time of the frame
+    preciseDecimal frameTime;
+    /// Whether frameAttitude and toReference are those at frameTime
+    bool cached;
+    /// The attitude at frameTime
+    Attitude frameAttitude;
+    /// The map from the camera frame to the reference frame at frameTime
+    Mat3 toReference;
 };
 
 /**
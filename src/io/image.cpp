@@ -0,0 +1,117 @@
+#include "io/image.hpp"
+
+#include <ctype.h>
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "io/mapping.hpp"
+
+namespace found {
+
+/**
+ * Wraps part of a mapping as an Image
+ *
+ * @param file The mapping
+ * @param width,height,channels The size of the image
+ * @param offset The number of bytes before the first pixel
+ * @param stride The number of bytes between the starts of two rows (0 if rows are not padded)
+ * @param path The path of the file (for errors)
+ *
+ * @return The image, which keeps file alive
+ *
+ * @throws invalid_argument iff the size of the image is not positive, or file is too small to hold it
+ */
+static Image WrapMapping(const std::shared_ptr<MappedFile> &file, int width, int height, int channels,
+                         size_t offset, size_t stride, const std::string &path) {
+    if (width <= 0 || height <= 0 || channels <= 0) {
+        throw std::invalid_argument("The size of an image must be positive");
+    }
+    size_t rowLength = static_cast<size_t>(width) * channels;
+    if (stride != 0 && stride < rowLength) throw std::invalid_argument("The stride is shorter than a row");
+    size_t rowStride = stride != 0 ? stride : rowLength;
+    size_t needed = offset + rowStride * (height - 1) + rowLength;
+    if (file->length < needed) throw std::invalid_argument(path + " is too small for its image");
+
+    Image image = {file->data + offset, {width, height, channels}};
+    image.stride = stride;
+    // Shares ownership of the mapping, but points at the MappedFile
+    image.owner = std::shared_ptr<void>(file, file.get());
+    return image;
+}
+
+/**
+ * Reads a number of a Netpbm header
+ *
+ * @param data The file
+ * @param length The length of the file
+ * @param position The position to read from, which is moved past the number
+ *
+ * @return The number read, or -1 if there is none
+ */
+static long ReadHeaderNumber(const unsigned char *data, size_t length, size_t &position) {
+    // Skips whitespace and comments
+    while (position < length && (isspace(data[position]) || data[position] == '#')) {
+        if (data[position] == '#') {
+            while (position < length && data[position] != '\n') position++;
+        } else {
+            position++;
+        }
+    }
+    if (position >= length || !isdigit(data[position])) return -1;
+    long value = 0;
+    while (position < length && isdigit(data[position]) && value <= 0xFFFFFF) {
+        value = 10 * value + (data[position] - '0');
+        position++;
+    }
+    return value;
+}
+
+Image MapNetpbmImage(const std::string &path) {
+    std::shared_ptr<MappedFile> file = MapFile(path);
+    const unsigned char *data = file->data;
+    size_t length = file->length;
+
+    if (length < 2 || data[0] != 'P' || (data[1] != '5' && data[1] != '6')) {
+        throw std::invalid_argument(path + " is not a binary PGM or PPM");
+    }
+    int channels = data[1] == '5' ? 1 : 3;
+
+    size_t position = 2;
+    long width = ReadHeaderNumber(data, length, position);
+    long height = ReadHeaderNumber(data, length, position);
+    long maxValue = ReadHeaderNumber(data, length, position);
+    // Exactly one whitespace character separates the header from the pixels
+    if (width <= 0 || height <= 0 || maxValue <= 0 || position >= length || !isspace(data[position])) {
+        throw std::invalid_argument(path + " has an invalid header");
+    }
+    if (maxValue > 255) throw std::invalid_argument(path + " does not have 8 bit samples");
+
+    return WrapMapping(file, static_cast<int>(width), static_cast<int>(height), channels,
+                       position + 1, 0, path);
+}
+
+Image MapRawImage(const std::string &path, int width, int height, int channels, size_t offset, size_t stride) {
+    return WrapMapping(MapFile(path), width, height, channels, offset, stride, path);
+}
+
+Image MapImage(const std::string &path, int width, int height, int channels, size_t offset) {
+    if (width == 0) return MapNetpbmImage(path);
+    return MapRawImage(path, width, height, channels, offset);
+}
+
+void WriteNetpbmImage(const std::string &path, const Image &image) {
+    int width = image.dimensions[0], height = image.dimensions[1], channels = image.dimensions[2];
+    if (channels != 1 && channels != 3) throw std::invalid_argument("Only 1 or 3 channel images can be written");
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Could not write " + path);
+    file << (channels == 1 ? "P5\n" : "P6\n") << width << ' ' << height << "\n255\n";
+    for (int y = 0; y < height; y++) {
+        file.write(reinterpret_cast<const char *>(image.Row(y)), static_cast<std::streamsize>(width) * channels);
+    }
+    if (!file) throw std::runtime_error("Could not write " + path);  // GCOVR_EXCL_LINE
+}
+
+}  // namespace found
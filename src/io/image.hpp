@@ -0,0 +1,78 @@
+#ifndef IMAGE_IO_H
+#define IMAGE_IO_H
+
+#include <stddef.h>
+
+#include <string>
+
+#include "style/style.hpp"
+
+namespace found {
+
+/**
+ * Maps a binary PGM (P5) or PPM (P6) file into memory. The pixels of the returned
+ * Image point straight into the mapping, so nothing is decoded or copied, and the
+ * mapping lives for as long as any copy of the Image does.
+ *
+ * @param path The path to the file
+ *
+ * @return The image in the file, with 1 (PGM) or 3 (PPM) channels
+ *
+ * @throws runtime_error iff the file cannot be opened or mapped
+ * @throws invalid_argument iff the file is not a binary PGM or PPM with 8 bit samples,
+ * or is too small for its header
+ *
+ * @note The mapping is private, so writing to the pixels of the Image never changes
+ * the file
+ */
+Image MapNetpbmImage(const std::string &path);
+
+/**
+ * Maps a file of raw, interleaved pixels into memory, without copying them
+ *
+ * @param path The path to the file
+ * @param width,height,channels The size of the image in the file
+ * @param offset The number of bytes before the first pixel (e.g. a header)
+ * @param stride The number of bytes between the starts of two rows (0 if rows are not padded)
+ *
+ * @return The image in the file
+ *
+ * @throws runtime_error iff the file cannot be opened or mapped
+ * @throws invalid_argument iff the size of the image is not positive, or the file
+ * is too small to hold it
+ *
+ * @note The mapping is private, so writing to the pixels of the Image never changes
+ * the file
+ */
+Image MapRawImage(const std::string &path, int width, int height, int channels,
+                  size_t offset = 0, size_t stride = 0);
+
+/**
+ * Maps an image file into memory, without copying its pixels
+ *
+ * @param path The path to the file
+ * @param width,height,channels The size of the image if the file is raw, or a
+ * width of 0 if the file is a PGM or PPM
+ * @param offset The number of bytes before the first pixel of a raw file
+ *
+ * @return The image in the file
+ *
+ * @throws runtime_error iff the file cannot be opened or mapped
+ * @throws invalid_argument iff the file does not hold an image of the given kind
+ */
+Image MapImage(const std::string &path, int width = 0, int height = 0, int channels = 1, size_t offset = 0);
+
+/**
+ * Writes an image as a binary PGM (P5) or PPM (P6) file
+ *
+ * @param path The path to write to
+ * @param image The image, with 1 (PGM) or 3 (PPM) channels
+ *
+ * @throws invalid_argument iff the image has another number of channels
+ * @throws runtime_error iff the file cannot be written
+ */
+void WriteNetpbmImage(const std::string &path, const Image &image);
+
+}  // namespace found
+
+#endif
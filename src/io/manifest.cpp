@@ -0,0 +1,50 @@
+#include "io/manifest.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace found {
+
+std::vector<std::string> ReadManifest(const std::string &path) {
+    std::ifstream manifest(path);
+    if (!manifest) throw std::runtime_error("Could not read " + path);
+
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+    std::vector<std::string> frames;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        // Tolerates manifests written on Windows
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        frames.push_back(line[0] == '/' ? line : directory + line);
+    }
+    return frames;
+}
+
+std::vector<std::string> ListDirectory(const std::string &path) {
+    DIR *directory = opendir(path.c_str());
+    if (directory == nullptr) throw std::runtime_error("Could not read " + path);
+
+    std::string prefix = !path.empty() && path.back() == '/' ? path : path + "/";
+    std::vector<std::string> frames;
+    for (struct dirent *entry = readdir(directory); entry != nullptr; entry = readdir(directory)) {
+        if (entry->d_name[0] == '.') continue;
+        std::string frame = prefix + entry->d_name;
+        struct stat status;
+        if (stat(frame.c_str(), &status) == 0 && S_ISREG(status.st_mode)) frames.push_back(frame);
+    }
+    closedir(directory);
+
+    std::sort(frames.begin(), frames.end());
+    return frames;
+}
+
+}  // namespace found
@@ -0,0 +1,36 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <string>
+#include <vector>
+
+namespace found {
+
+/**
+ * Reads the frames listed in a manifest, which lists one image path per line.
+ * Blank lines and lines starting with '#' are skipped, and relative paths are
+ * relative to the directory of the manifest.
+ *
+ * @param path The path to the manifest
+ *
+ * @return The paths of the frames, in the order listed
+ *
+ * @throws runtime_error iff the manifest cannot be read
+ */
+std::vector<std::string> ReadManifest(const std::string &path);
+
+/**
+ * Lists the frames in a directory, which are all of its regular files
+ * except hidden ones
+ *
+ * @param path The path to the directory
+ *
+ * @return The paths of the frames, sorted by name
+ *
+ * @throws runtime_error iff the directory cannot be read
+ */
+std::vector<std::string> ListDirectory(const std::string &path);
+
+}  // namespace found
+
+#endif
@@ -0,0 +1,44 @@
+#include "io/mapping.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace found {
+
+std::shared_ptr<MappedFile> MapFile(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Could not open " + path);
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+        close(fd);
+        throw std::runtime_error(path + " is not a regular file");
+    }
+    if (status.st_size == 0) {
+        close(fd);
+        throw std::invalid_argument(path + " is empty");
+    }
+
+    size_t length = static_cast<size_t>(status.st_size);
+    // Private, so that the mapping can be written to without changing the file
+    void *data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid without the descriptor
+    close(fd);
+    if (data == MAP_FAILED) throw std::runtime_error("Could not map " + path);  // GCOVR_EXCL_LINE
+    // Files are read front to back, so let the kernel read ahead
+    posix_madvise(data, length, POSIX_MADV_SEQUENTIAL);
+
+    MappedFile *file = new MappedFile{static_cast<unsigned char *>(data), length};
+    return std::shared_ptr<MappedFile>(file, [](MappedFile *mapped) {
+        munmap(mapped->data, mapped->length);
+        delete mapped;
+    });
+}
+
+}  // namespace found
@@ -0,0 +1,38 @@
+#ifndef MAPPING_H
+#define MAPPING_H
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+namespace found {
+
+/**
+ * A MappedFile is a file mapped into memory
+ */
+struct MappedFile {
+    /// The start of the mapping
+    unsigned char *data;
+    /// The size of the mapping, in bytes
+    size_t length;
+};
+
+/**
+ * Maps a whole file into memory
+ *
+ * @param path The path to the file
+ *
+ * @return The mapping, which is unmapped once the last copy of the pointer is gone
+ *
+ * @throws runtime_error iff the file cannot be opened or mapped
+ * @throws invalid_argument iff the file is empty
+ *
+ * @note The mapping is private, so writing to it never changes the file, and
+ * starts at a page boundary
+ */
+std::shared_ptr<MappedFile> MapFile(const std::string &path);
+
+}  // namespace found
+
+#endif
@@ -0,0 +1,216 @@
+#include "io/render.hpp"
+
+#include <math.h>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace found {
+
+/**
+ * A SplitMix64 generator, whose sequence is the same on every platform
+ * (unlike those of the distributions of <random>), so that noise is reproducible
+ */
+class NoiseGenerator {
+ public:
+    /**
+     * Creates a NoiseGenerator
+     *
+     * @param seed The seed of the sequence
+     */
+    explicit NoiseGenerator(uint64_t seed) : state(seed) {}
+
+    /**
+     * Provides a standard normal value
+     *
+     * @return The next value of the sequence
+     */
+    double Normal() {
+        // Box-Muller, with a uniform value in (0, 1] so that the logarithm is finite
+        double uniform = (static_cast<double>(this->Next() >> 11) + 1) / 9007199254740992.0;
+        double angle = 2 * M_PI * static_cast<double>(this->Next() >> 11) / 9007199254740992.0;
+        return sqrt(-2 * log(uniform)) * cos(angle);
+    }
+
+ private:
+    /**
+     * Provides the next 64 random bits
+     *
+     * @return The bits
+     */
+    uint64_t Next() {
+        uint64_t z = (this->state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /// The state of the sequence
+    uint64_t state;
+};
+
+/**
+ * Checks the inputs of a rendering
+ *
+ * @param camera The camera that takes the image
+ * @param position The position of the camera, relative to Earth's center
+ * @param options The Earth and effects to render
+ *
+ * @return The position of the camera in the frame where Earth is the unit sphere
+ *
+ * @throws invalid_argument iff the camera is inside Earth, or the options are invalid
+ */
+static PreciseVec3 CheckRendering(const Camera &camera, const PositionVector &position,
+                                  const RenderOptions &options) {
+    if (camera.XResolution() <= 0 || camera.YResolution() <= 0) {
+        throw std::invalid_argument("The image must have a positive size");
+    }
+    if (!(options.equatorialRadius > 0) || !(options.polarRadius > 0)) {
+        throw std::invalid_argument("The radii of Earth must be positive");
+    }
+    if (options.supersample < 1) throw std::invalid_argument("A pixel needs at least 1 sample");
+    if (options.blurSigma < 0 || options.noiseSigma < 0) {
+        throw std::invalid_argument("The blur and noise must not be negative");
+    }
+    if (options.terminator && options.sunDirection.MagnitudeSq() == 0) {
+        throw std::invalid_argument("The sun needs a direction");
+    }
+    PreciseVec3 scaled(position.x / options.equatorialRadius, position.y / options.equatorialRadius,
+                       position.z / options.polarRadius);
+    if (scaled.MagnitudeSq() <= 1) throw std::invalid_argument("The camera is inside Earth");
+    return scaled;
+}
+
+/**
+ * Blurs an image with a Gaussian, clamping it at its edges
+ *
+ * @param pixels The intensities of the image, row by row, which are blurred in place
+ * @param width,height The size of the image
+ * @param sigma The standard deviation of the Gaussian, in pixels
+ */
+static void GaussianBlur(std::vector<double> &pixels, int width, int height, double sigma) {
+    int radius = static_cast<int>(ceil(3 * sigma));
+    std::vector<double> kernel(2 * radius + 1);
+    double total = 0;
+    for (int k = -radius; k <= radius; k++) {
+        kernel[k + radius] = exp(-0.5 * k * k / (sigma * sigma));
+        total += kernel[k + radius];
+    }
+    for (double &weight : kernel) weight /= total;
+
+    // The Gaussian is separable, so rows then columns
+    std::vector<double> blurred(pixels.size());
+    for (int y = 0; y < height; y++) {
+        const double *row = pixels.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; x++) {
+            double sum = 0;
+            for (int k = -radius; k <= radius; k++) {
+                sum += kernel[k + radius] * row[std::min(std::max(x + k, 0), width - 1)];
+            }
+            blurred[static_cast<size_t>(y) * width + x] = sum;
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            double sum = 0;
+            for (int k = -radius; k <= radius; k++) {
+                size_t source = static_cast<size_t>(std::min(std::max(y + k, 0), height - 1));
+                sum += kernel[k + radius] * blurred[source * width + x];
+            }
+            pixels[static_cast<size_t>(y) * width + x] = sum;
+        }
+    }
+}
+
+Image RenderEarth(const Camera &camera, const PositionVector &position, const Attitude &attitude,
+                  const RenderOptions &options) {
+    PreciseVec3 origin = CheckRendering(camera, position, options);
+    int width = camera.XResolution(), height = camera.YResolution();
+    int samples = options.supersample;
+    // From the camera frame to the reference frame
+    PreciseMat3 toReference = PrecisionCast<preciseDecimal>(attitude.GetDCM().Transpose());
+    preciseDecimal a = options.equatorialRadius, b = options.polarRadius;
+    PreciseVec3 sun = options.terminator ? options.sunDirection.Normalize() : PreciseVec3(0, 0, 0);
+    preciseDecimal contrast = options.earthIntensity - options.spaceIntensity;
+    preciseDecimal originTerm = origin * origin - 1;
+
+    std::vector<double> pixels(static_cast<size_t>(width) * height);
+    // The samples of one row of samples, and their rays
+    size_t rowSamples = static_cast<size_t>(width) * samples;
+    std::vector<decimal> xs(rowSamples), ys(rowSamples);
+    std::vector<decimal> rayX(rowSamples), rayY(rowSamples), rayZ(rowSamples);
+    for (size_t i = 0; i < rowSamples; i++) {
+        xs[i] = static_cast<decimal>(i / samples) + (static_cast<decimal>(i % samples) + 0.5f) / samples;
+    }
+
+    for (int y = 0; y < height; y++) {
+        double *row = pixels.data() + static_cast<size_t>(y) * width;
+        for (int sy = 0; sy < samples; sy++) {
+            std::fill(ys.begin(), ys.end(), y + (sy + 0.5f) / samples);
+            camera.PixelsToRays(xs.data(), ys.data(), rowSamples, rayX.data(), rayY.data(), rayZ.data());
+            for (size_t i = 0; i < rowSamples; i++) {
+                PreciseVec3 ray = toReference * PreciseVec3(rayX[i], rayY[i], rayZ[i]);
+                // In the frame where Earth is the unit sphere, |origin + t direction| = 1
+                PreciseVec3 direction(ray.x / a, ray.y / a, ray.z / b);
+                preciseDecimal quadratic = direction * direction;
+                preciseDecimal half = origin * direction;
+                preciseDecimal discriminant = half * half - quadratic * originTerm;
+                if (discriminant < 0 || half >= 0) continue;
+                preciseDecimal shade = 1;
+                if (options.terminator) {
+                    PreciseVec3 hit = origin + direction * ((-half - sqrt(discriminant)) / quadratic);
+                    PreciseVec3 normal(hit.x / a, hit.y / a, hit.z / b);
+                    shade = std::max(static_cast<preciseDecimal>(0), normal.Normalize() * sun);
+                }
+                row[i / samples] += shade;
+            }
+        }
+    }
+
+    for (double &pixel : pixels) pixel = options.spaceIntensity + contrast * pixel / (samples * samples);
+    if (options.blurSigma > 0) GaussianBlur(pixels, width, height, options.blurSigma);
+
+    std::shared_ptr<std::vector<unsigned char>> bytes = std::make_shared<std::vector<unsigned char>>(pixels.size());
+    NoiseGenerator noise(options.seed);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        double value = pixels[i];
+        if (options.noiseSigma > 0) value += options.noiseSigma * noise.Normal();
+        (*bytes)[i] = static_cast<unsigned char>(std::min(std::max(round(value), 0.0), 255.0));
+    }
+    Image image = {bytes->data(), {width, height, 1}, 0, bytes};
+    return image;
+}
+
+Points RenderHorizon(const Camera &camera, const PositionVector &position, const Attitude &attitude,
+                     const RenderOptions &options, size_t samples) {
+    PreciseVec3 origin = CheckRendering(camera, position, options);
+    PreciseMat3 toCamera = PrecisionCast<preciseDecimal>(attitude.GetDCM());
+    PreciseVec3 from = PrecisionCast<preciseDecimal>(position);
+
+    // On the unit sphere, the horizon is a circle about the direction of the camera
+    preciseDecimal distance2 = origin.MagnitudeSq();
+    PreciseVec3 center = origin * (1 / distance2);
+    preciseDecimal radius = sqrt(1 - 1 / distance2);
+    PreciseVec3 axis = fabs(origin.z) < fabs(origin.x) || fabs(origin.z) < fabs(origin.y) ? PreciseVec3(0, 0, 1)
+                                                                                         : PreciseVec3(1, 0, 0);
+    PreciseVec3 e1 = origin.CrossProduct(axis).Normalize();
+    PreciseVec3 e2 = origin.Normalize().CrossProduct(e1);
+
+    Points points;
+    for (size_t i = 0; i < samples; i++) {
+        preciseDecimal angle = 2 * M_PI * i / samples;
+        PreciseVec3 tangent = center + (e1 * cos(angle) + e2 * sin(angle)) * radius;
+        PreciseVec3 horizon(tangent.x * options.equatorialRadius, tangent.y * options.equatorialRadius,
+                            tangent.z * options.polarRadius);
+        PreciseVec3 seen = toCamera * (horizon - from);
+        // Behind the camera
+        if (seen.x <= 0) continue;
+        Vec2 pixel = camera.SpatialToCamera(PrecisionCast<decimal>(seen));
+        if (camera.InSensor(pixel)) points.push_back(pixel);
+    }
+    return points;
+}
+
+}  // namespace found
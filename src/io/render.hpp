@@ -0,0 +1,83 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "style/style.hpp"
+#include "spatial/attitude-utils.hpp"
+#include "spatial/camera.hpp"
+
+namespace found {
+
+/**
+ * RenderOptions describe the Earth a synthetic image is rendered of,
+ * and the effects that are applied to the image
+ */
+struct RenderOptions {
+    /// The equatorial radius of Earth, in km
+    preciseDecimal equatorialRadius = 6378.137;
+    /// The polar radius of Earth, in km (the equatorial radius for a spherical Earth)
+    preciseDecimal polarRadius = 6356.752;
+    /// The intensity of (lit) Earth
+    decimal earthIntensity = 220;
+    /// The intensity of space
+    decimal spaceIntensity = 10;
+    /// The number of samples across each pixel (so samples^2 per pixel), for anti-aliasing
+    int supersample = 4;
+    /// The standard deviation of the Gaussian blur, in pixels (0 for none)
+    decimal blurSigma = 0;
+    /// The standard deviation of the Gaussian noise, in intensity levels (0 for none)
+    decimal noiseSigma = 0;
+    /// Whether Earth is lit by the sun (so part of it is in night), instead of evenly
+    bool terminator = false;
+    /// The direction of the sun, from Earth, in the reference frame
+    PreciseVec3 sunDirection = PreciseVec3(1, 0, 0);
+    /// The seed of the noise, so that images are reproducible
+    uint64_t seed = 0;
+};
+
+/**
+ * Renders a synthetic image of Earth, as taken by a camera
+ *
+ * Earth is an ellipsoid about the z axis of the reference frame. Each pixel
+ * is shaded by the fraction of its samples whose rays hit Earth (lit evenly,
+ * or by the sun if options.terminator is set), then the image is blurred and
+ * noise is added.
+ *
+ * @param camera The camera that takes the image
+ * @param position The position of the camera, relative to Earth's center, in km
+ * @param attitude The attitude of the camera (from the reference frame to the camera frame)
+ * @param options The Earth and effects to render
+ *
+ * @return A new grayscale image, which owns its pixels
+ *
+ * @throws invalid_argument iff the camera is inside Earth, or the options are invalid
+ *
+ * @note The same inputs always give the same image
+ */
+Image RenderEarth(const Camera &camera, const PositionVector &position, const Attitude &attitude,
+                  const RenderOptions &options);
+
+/**
+ * Provides the horizon of Earth that RenderEarth renders, as seen in an image
+ *
+ * @param camera The camera that takes the image
+ * @param position The position of the camera, relative to Earth's center, in km
+ * @param attitude The attitude of the camera (from the reference frame to the camera frame)
+ * @param options The Earth that is rendered
+ * @param samples The number of points the horizon is sampled at
+ *
+ * @return The points (of the samples) of the horizon that are in the image
+ *
+ * @throws invalid_argument iff the camera is inside Earth, or the options are invalid
+ *
+ * @note The horizon is geometric, so points in night (with options.terminator) are
+ * included even though the image does not show them
+ */
+Points RenderHorizon(const Camera &camera, const PositionVector &position, const Attitude &attitude,
+                     const RenderOptions &options, size_t samples);
+
+}  // namespace found
+
+#endif
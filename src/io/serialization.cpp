@@ -0,0 +1,374 @@
+#include "io/serialization.hpp"
+
+#include <string.h>
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "io/mapping.hpp"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+/// Set iff this machine stores numbers big-endian, in which case records are byte swapped
+#define FOUND_BIG_ENDIAN
+#endif
+
+namespace found {
+
+/// The alignment of payloads, in bytes
+const size_t kRecordAlignment = 8;
+
+static_assert(sizeof(PositionVector) == 3 * sizeof(decimal), "Position histories are read as blocks of scalars");
+
+/**
+ * Appends a little-endian unsigned integer to a buffer
+ *
+ * @param buffer The buffer
+ * @param value The integer
+ * @param size The number of bytes of the integer
+ */
+static void AppendInteger(std::vector<unsigned char> &buffer, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) buffer.push_back(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+/**
+ * Reads a little-endian unsigned integer
+ *
+ * @param data The first byte of the integer
+ * @param size The number of bytes of the integer
+ *
+ * @return The integer
+ */
+static uint64_t ReadInteger(const unsigned char *data, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+/**
+ * Rounds a length up to the alignment of payloads
+ *
+ * @param length The length, in bytes
+ *
+ * @return The smallest multiple of kRecordAlignment that is at least length
+ */
+constexpr size_t Pad(size_t length) {
+    return (length + kRecordAlignment - 1) / kRecordAlignment * kRecordAlignment;
+}
+
+/// The offset of the elements in the payload of an orbit, after its initial condition
+const size_t kOrbitElementsOffset = Pad(3 * sizeof(decimal));
+/// The number of elements of an orbit that are recorded as preciseDecimals
+const size_t kOrbitElements = 9;
+/// The size of the payload of an orbit, in bytes
+const size_t kOrbitSize = kOrbitElementsOffset + kOrbitElements * sizeof(preciseDecimal);
+/// The number of integers that describe the grid of a table of rays, including padding
+const size_t kRayTableIntegers = 4;
+/// The number of scalars that describe the camera of a table of rays
+const size_t kRayTableParameters = 8;
+/// The offset of the rays in the payload of a table of rays, after its grid and camera
+const size_t kRayTableRaysOffset = Pad(kRayTableIntegers * sizeof(uint32_t) + kRayTableParameters * sizeof(decimal));
+
+/**
+ * Reverses the bytes of scalars in place (on big-endian machines only)
+ *
+ * @param data The first scalar
+ * @param count The number of scalars
+ * @param size The size of each scalar, in bytes
+ */
+static void SwapScalars(unsigned char *data, size_t count, size_t size) {
+#ifdef FOUND_BIG_ENDIAN
+    for (size_t i = 0; i < count; i++) {
+        unsigned char *scalar = data + i * size;
+        for (size_t j = 0; j < size / 2; j++) std::swap(scalar[j], scalar[size - 1 - j]);
+    }
+#else
+    (void) data;
+    (void) count;
+    (void) size;
+#endif
+}
+
+/**
+ * Appends the header of a record to a buffer, and makes room for its payload
+ *
+ * @param buffer The buffer
+ * @param type The kind of record
+ * @param count The number of items in the record
+ * @param payload The number of bytes in the payload, before padding
+ *
+ * @return The offset of the payload in buffer
+ */
+static size_t AppendRecord(std::vector<unsigned char> &buffer, RecordType type, uint64_t count, size_t payload) {
+    size_t padded = Pad(payload);
+    buffer.reserve(buffer.size() + kRecordHeaderSize + padded);
+    AppendInteger(buffer, kRecordMagic, 4);
+    AppendInteger(buffer, kRecordVersion, 2);
+    AppendInteger(buffer, static_cast<uint16_t>(type), 2);
+    AppendInteger(buffer, sizeof(decimal), 4);
+    AppendInteger(buffer, 0, 4);
+    AppendInteger(buffer, count, 8);
+    AppendInteger(buffer, padded, 8);
+    size_t start = buffer.size();
+    buffer.resize(start + padded, 0);
+    return start;
+}
+
+/**
+ * Copies scalars into a buffer
+ *
+ * @tparam T The type of the scalars
+ *
+ * @param buffer The buffer
+ * @param offset The offset in buffer to copy to
+ * @param values The scalars
+ * @param count The number of scalars
+ */
+template <typename T>
+static void WriteScalars(std::vector<unsigned char> &buffer, size_t offset, const T *values, size_t count) {
+    if (count == 0) return;
+    memcpy(buffer.data() + offset, values, count * sizeof(T));
+    SwapScalars(buffer.data() + offset, count, sizeof(T));
+}
+
+/**
+ * Copies scalars out of a record
+ *
+ * @tparam T The type of the scalars
+ *
+ * @param data The first scalar in the record
+ * @param values The place to copy the scalars to
+ * @param count The number of scalars
+ */
+template <typename T>
+static void ReadScalars(const unsigned char *data, T *values, size_t count) {
+    if (count == 0) return;
+    memcpy(values, data, count * sizeof(T));
+    SwapScalars(reinterpret_cast<unsigned char *>(values), count, sizeof(T));
+}
+
+void SerializePoints(const Points &points, std::vector<unsigned char> &buffer) {
+    size_t size = points.size();
+    size_t offset = AppendRecord(buffer, RecordType::Points, size, 2 * size * sizeof(decimal));
+    WriteScalars(buffer, offset, points.x(), size);
+    WriteScalars(buffer, offset + size * sizeof(decimal), points.y(), size);
+}
+
+void SerializeDistance(distFromEarth distance, std::vector<unsigned char> &buffer) {
+    decimal value = distance;
+    WriteScalars(buffer, AppendRecord(buffer, RecordType::Distance, 1, sizeof(decimal)), &value, 1);
+}
+
+void SerializePosition(const PositionVector &position, std::vector<unsigned char> &buffer) {
+    decimal values[3] = {position.x, position.y, position.z};
+    WriteScalars(buffer, AppendRecord(buffer, RecordType::Position, 1, 3 * sizeof(decimal)), values, 3);
+}
+
+void SerializePositionHistory(const std::vector<PositionVector> &positions, std::vector<unsigned char> &buffer) {
+    size_t offset = AppendRecord(buffer, RecordType::PositionHistory, positions.size(),
+                                 3 * positions.size() * sizeof(decimal));
+    // A Vec3 is exactly its x, y and z, so the whole history is one block
+    WriteScalars(buffer, offset, reinterpret_cast<const decimal *>(positions.data()), 3 * positions.size());
+}
+
+void SerializeOrbitParams(const OrbitParams &orbit, std::vector<unsigned char> &buffer) {
+    decimal initial[3] = {orbit.initialCondition.x, orbit.initialCondition.y, orbit.initialCondition.z};
+    preciseDecimal elements[kOrbitElements] = {orbit.semiMajorAxis, orbit.eccentricity, orbit.meanAnomaly,
+                                               orbit.periapsis.x, orbit.periapsis.y, orbit.periapsis.z,
+                                               orbit.normal.x, orbit.normal.y, orbit.normal.z};
+    size_t offset = AppendRecord(buffer, RecordType::OrbitParams, 1, kOrbitSize);
+    WriteScalars(buffer, offset, initial, 3);
+    WriteScalars(buffer, offset + kOrbitElementsOffset, elements, kOrbitElements);
+}
+
+void SerializeRayTable(const RayTable &table, std::vector<unsigned char> &buffer) {
+    const Camera &camera = table.GetCamera();
+    const LensDistortion &distortion = camera.Distortion();
+    uint32_t grid[kRayTableIntegers] = {static_cast<uint32_t>(camera.XResolution()),
+                                        static_cast<uint32_t>(camera.YResolution()),
+                                        static_cast<uint32_t>(table.Step()), 0};
+    decimal parameters[kRayTableParameters] = {camera.FocalLength(), camera.XCenter(), camera.YCenter(),
+                                               distortion.k1, distortion.k2, distortion.k3,
+                                               distortion.p1, distortion.p2};
+    size_t entries = table.RayY().size();
+    size_t offset = AppendRecord(buffer, RecordType::RayTable, entries,
+                                 kRayTableRaysOffset + 2 * entries * sizeof(decimal));
+    WriteScalars(buffer, offset, grid, kRayTableIntegers);
+    WriteScalars(buffer, offset + kRayTableIntegers * sizeof(uint32_t), parameters, kRayTableParameters);
+    WriteScalars(buffer, offset + kRayTableRaysOffset, table.RayY().data(), entries);
+    WriteScalars(buffer, offset + kRayTableRaysOffset + entries * sizeof(decimal), table.RayZ().data(), entries);
+}
+
+RecordHeader PeekRecord(const unsigned char *data, size_t length, size_t position) {
+    if (position > length || length - position < kRecordHeaderSize) {
+        throw std::invalid_argument("There is no record header");
+    }
+    const unsigned char *header = data + position;
+    if (ReadInteger(header, 4) != kRecordMagic) throw std::invalid_argument("There is no record");
+    if (ReadInteger(header + 4, 2) != kRecordVersion) throw std::invalid_argument("The record has another version");
+    if (ReadInteger(header + 8, 4) != sizeof(decimal)) {
+        throw std::invalid_argument("The record has another precision");
+    }
+    uint64_t payload = ReadInteger(header + 24, 8);
+    if (payload % kRecordAlignment != 0) throw std::invalid_argument("The record is not padded");
+    if (payload > length - position - kRecordHeaderSize) throw std::invalid_argument("The record is truncated");
+    return {static_cast<RecordType>(ReadInteger(header + 6, 2)), ReadInteger(header + 16, 8),
+            kRecordHeaderSize + static_cast<size_t>(payload)};
+}
+
+/**
+ * Reads the header of a record of a given kind, and moves past the record
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data, which is moved past it
+ * @param type The kind of record expected
+ * @param itemSize The number of bytes in each item of the record
+ * @param single Whether the record must hold exactly one item
+ *
+ * @return The offset of the payload in data, and the header of the record
+ *
+ * @throws invalid_argument iff there is no whole record of kind type at position
+ */
+static std::pair<size_t, RecordHeader> OpenRecord(const unsigned char *data, size_t length, size_t &position,
+                                                  RecordType type, size_t itemSize, bool single) {
+    RecordHeader header = PeekRecord(data, length, position);
+    if (header.type != type) throw std::invalid_argument("The record holds another kind of product");
+    if (single && header.count != 1) throw std::invalid_argument("The record does not hold one item");
+    if (header.count > (header.length - kRecordHeaderSize) / itemSize) {
+        throw std::invalid_argument("The record is too short for its items");
+    }
+    size_t payload = position + kRecordHeaderSize;
+    position += header.length;
+    return std::make_pair(payload, header);
+}
+
+Points DeserializePoints(const unsigned char *data, size_t length, size_t &position) {
+    std::pair<size_t, RecordHeader> record = OpenRecord(data, length, position, RecordType::Points,
+                                                        2 * sizeof(decimal), false);
+    size_t size = static_cast<size_t>(record.second.count);
+    Points points;
+    points.resize(size);
+    ReadScalars(data + record.first, points.x(), size);
+    ReadScalars(data + record.first + size * sizeof(decimal), points.y(), size);
+    return points;
+}
+
+distFromEarth DeserializeDistance(const unsigned char *data, size_t length, size_t &position) {
+    std::pair<size_t, RecordHeader> record = OpenRecord(data, length, position, RecordType::Distance,
+                                                        sizeof(decimal), true);
+    decimal value;
+    ReadScalars(data + record.first, &value, 1);
+    return value;
+}
+
+/**
+ * Reads a record of one vector
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data, which is moved past it
+ * @param type The kind of record expected
+ *
+ * @return The vector in the record
+ *
+ * @throws invalid_argument iff there is no record of one vector of kind type at position
+ */
+static Vec3 DeserializeVector(const unsigned char *data, size_t length, size_t &position, RecordType type) {
+    std::pair<size_t, RecordHeader> record = OpenRecord(data, length, position, type,
+                                                        3 * sizeof(decimal), true);
+    decimal values[3];
+    ReadScalars(data + record.first, values, 3);
+    return Vec3(values[0], values[1], values[2]);
+}
+
+PositionVector DeserializePosition(const unsigned char *data, size_t length, size_t &position) {
+    return DeserializeVector(data, length, position, RecordType::Position);
+}
+
+std::vector<PositionVector> DeserializePositionHistory(const unsigned char *data, size_t length, size_t &position) {
+    std::pair<size_t, RecordHeader> record = OpenRecord(data, length, position, RecordType::PositionHistory,
+                                                        3 * sizeof(decimal), false);
+    std::vector<PositionVector> positions(static_cast<size_t>(record.second.count));
+    ReadScalars(data + record.first, reinterpret_cast<decimal *>(positions.data()), 3 * positions.size());
+    return positions;
+}
+
+OrbitParams DeserializeOrbitParams(const unsigned char *data, size_t length, size_t &position) {
+    std::pair<size_t, RecordHeader> record = OpenRecord(data, length, position, RecordType::OrbitParams,
+                                                        kOrbitSize, true);
+    decimal initial[3];
+    preciseDecimal elements[kOrbitElements];
+    ReadScalars(data + record.first, initial, 3);
+    ReadScalars(data + record.first + kOrbitElementsOffset, elements, kOrbitElements);
+    OrbitParams orbit = {Vec3(initial[0], initial[1], initial[2]), elements[0], elements[1],
+                         PreciseVec3(elements[3], elements[4], elements[5]),
+                         PreciseVec3(elements[6], elements[7], elements[8]), elements[2]};
+    return orbit;
+}
+
+RayTable DeserializeRayTable(const unsigned char *data, size_t length, size_t &position) {
+    size_t start = position;
+    std::pair<size_t, RecordHeader> record = OpenRecord(data, length, position, RecordType::RayTable,
+                                                        2 * sizeof(decimal), false);
+    size_t entries = static_cast<size_t>(record.second.count);
+    if (kRayTableRaysOffset + 2 * entries * sizeof(decimal) > record.second.length - kRecordHeaderSize) {
+        position = start;
+        throw std::invalid_argument("The record is too short for its items");
+    }
+    uint32_t grid[kRayTableIntegers];
+    decimal parameters[kRayTableParameters];
+    ReadScalars(data + record.first, grid, kRayTableIntegers);
+    ReadScalars(data + record.first + kRayTableIntegers * sizeof(uint32_t), parameters, kRayTableParameters);
+    Camera camera(parameters[0], parameters[1], parameters[2], static_cast<int>(grid[0]), static_cast<int>(grid[1]));
+    // An empty or truncated table would otherwise look up the wrong rays
+    if (entries == 0 || entries != RayTable::Entries(camera, static_cast<int>(grid[2]))) {
+        position = start;
+        throw std::invalid_argument("The table of rays does not have one ray for every entry");
+    }
+    std::vector<decimal> rayY(entries), rayZ(entries);
+    ReadScalars(data + record.first + kRayTableRaysOffset, rayY.data(), entries);
+    ReadScalars(data + record.first + kRayTableRaysOffset + entries * sizeof(decimal), rayZ.data(), entries);
+
+    LensDistortion distortion = {parameters[3], parameters[4], parameters[5], parameters[6], parameters[7]};
+    camera.SetDistortion(distortion);
+    return RayTable(camera, static_cast<int>(grid[2]), std::move(rayY), std::move(rayZ));
+}
+
+void WriteRecords(const std::string &path, const std::vector<unsigned char> &records) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Could not open " + path);
+    file.write(reinterpret_cast<const char *>(records.data()), records.size());
+    if (!file) throw std::runtime_error("Could not write " + path);  // GCOVR_EXCL_LINE
+}
+
+PositionHistoryView MapPositionHistory(const std::string &path) {
+#ifdef FOUND_BIG_ENDIAN
+    throw std::runtime_error("Records can only be read in place on little-endian machines");
+#endif
+    std::shared_ptr<MappedFile> file = MapFile(path);
+    size_t position = 0;
+    std::pair<size_t, RecordHeader> record = OpenRecord(file->data, file->length, position,
+                                                        RecordType::PositionHistory, 3 * sizeof(decimal),
+                                                        false);
+    // The mapping is page aligned, and payloads are 8 byte aligned within it
+    const PositionVector *positions = reinterpret_cast<const PositionVector *>(file->data + record.first);
+    return {positions, static_cast<size_t>(record.second.count), std::shared_ptr<void>(file, file.get())};
+}
+
+std::vector<PositionVector> ReadPositionHistory(const std::string &path) {
+    std::shared_ptr<MappedFile> file = MapFile(path);
+    size_t position = 0;
+    return DeserializePositionHistory(file->data, file->length, position);
+}
+
+std::shared_ptr<const RayTable> ReadRayTable(const std::string &path) {
+    std::shared_ptr<MappedFile> file = MapFile(path);
+    size_t position = 0;
+    return std::make_shared<const RayTable>(DeserializeRayTable(file->data, file->length, position));
+}
+
+}  // namespace found
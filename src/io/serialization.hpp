@@ -0,0 +1,284 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spatial/camera.hpp"
+#include "style/style.hpp"
+
+namespace found {
+
+/**
+ * The products of the pipeline are logged as records, which are written one after another
+ * into a buffer or file. Every record is a header followed by its payload:
+ *
+ * | Offset | Size | Field                                              |
+ * |--------|------|----------------------------------------------------|
+ * | 0      | 4    | kRecordMagic                                       |
+ * | 4      | 2    | The version of the format (kRecordVersion)         |
+ * | 6      | 2    | The RecordType                                     |
+ * | 8      | 4    | The size of each scalar, sizeof(decimal)           |
+ * | 12     | 4    | Reserved (0)                                       |
+ * | 16     | 8    | The number of items in the payload                 |
+ * | 24     | 8    | The length of the payload, padded to 8 bytes       |
+ *
+ * Every field and scalar is little-endian. Payloads start 8 byte aligned, so that
+ * a mapped file can be read in place.
+ */
+
+/// The first field of every record ("FNDR")
+constexpr uint32_t kRecordMagic = 0x52444E46;
+/// The version of the format written, and the only one read
+constexpr uint16_t kRecordVersion = 2;
+/// The size of the header of a record, in bytes
+constexpr size_t kRecordHeaderSize = 32;
+
+/**
+ * The kinds of products a record can hold
+ */
+enum class RecordType : uint16_t {
+    /// A Points, its x coordinates followed by its y coordinates
+    Points = 1,
+    /// A distFromEarth
+    Distance = 2,
+    /// A PositionVector, as x, y and z
+    Position = 3,
+    /// A sequence of PositionVectors, each as x, y and z
+    PositionHistory = 4,
+    /// An OrbitParams, as its initial condition (padded to 8 bytes), then its semi-major axis,
+    /// eccentricity, mean anomaly, periapsis and normal as preciseDecimals
+    OrbitParams = 5,
+    /// A RayTable, as its resolution, step and padding as uint32s, then its focal length,
+    /// principal point and distortion (k1, k2, k3, p1, p2), then the y components of its
+    /// rays followed by their z components
+    RayTable = 6,
+};
+
+/**
+ * A RecordHeader describes a record
+ */
+struct RecordHeader {
+    /// The kind of product in the record
+    RecordType type;
+    /// The number of items in the record
+    uint64_t count;
+    /// The number of bytes in the record, including the header
+    size_t length;
+};
+
+/**
+ * Appends a record of points to a buffer
+ *
+ * @param points The points
+ * @param buffer The buffer
+ */
+void SerializePoints(const Points &points, std::vector<unsigned char> &buffer);
+
+/**
+ * Appends a record of a distance to a buffer
+ *
+ * @param distance The distance
+ * @param buffer The buffer
+ */
+void SerializeDistance(distFromEarth distance, std::vector<unsigned char> &buffer);
+
+/**
+ * Appends a record of a position to a buffer
+ *
+ * @param position The position
+ * @param buffer The buffer
+ */
+void SerializePosition(const PositionVector &position, std::vector<unsigned char> &buffer);
+
+/**
+ * Appends a record of a sequence of positions to a buffer
+ *
+ * @param positions The positions
+ * @param buffer The buffer
+ */
+void SerializePositionHistory(const std::vector<PositionVector> &positions, std::vector<unsigned char> &buffer);
+
+/**
+ * Appends a record of an orbit to a buffer
+ *
+ * @param orbit The orbit
+ * @param buffer The buffer
+ */
+void SerializeOrbitParams(const OrbitParams &orbit, std::vector<unsigned char> &buffer);
+
+/**
+ * Appends a record of a table of rays to a buffer
+ *
+ * @param table The table
+ * @param buffer The buffer
+ */
+void SerializeRayTable(const RayTable &table, std::vector<unsigned char> &buffer);
+
+/**
+ * Reads the header of a record
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data
+ *
+ * @return The header of the record
+ *
+ * @throws invalid_argument iff there is no whole record of this version and precision at position
+ */
+RecordHeader PeekRecord(const unsigned char *data, size_t length, size_t position);
+
+/**
+ * Reads a record of points
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data, which is moved past it
+ *
+ * @return The points in the record
+ *
+ * @throws invalid_argument iff there is no record of points at position
+ */
+Points DeserializePoints(const unsigned char *data, size_t length, size_t &position);
+
+/**
+ * Reads a record of a distance
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data, which is moved past it
+ *
+ * @return The distance in the record
+ *
+ * @throws invalid_argument iff there is no record of a distance at position
+ */
+distFromEarth DeserializeDistance(const unsigned char *data, size_t length, size_t &position);
+
+/**
+ * Reads a record of a position
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data, which is moved past it
+ *
+ * @return The position in the record
+ *
+ * @throws invalid_argument iff there is no record of a position at position
+ */
+PositionVector DeserializePosition(const unsigned char *data, size_t length, size_t &position);
+
+/**
+ * Reads a record of a sequence of positions
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data, which is moved past it
+ *
+ * @return The positions in the record
+ *
+ * @throws invalid_argument iff there is no record of a position history at position
+ */
+std::vector<PositionVector> DeserializePositionHistory(const unsigned char *data, size_t length, size_t &position);
+
+/**
+ * Reads a record of an orbit
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data, which is moved past it
+ *
+ * @return The orbit in the record
+ *
+ * @throws invalid_argument iff there is no record of an orbit at position
+ */
+OrbitParams DeserializeOrbitParams(const unsigned char *data, size_t length, size_t &position);
+
+/**
+ * Reads a record of a table of rays
+ *
+ * @param data The records
+ * @param length The number of bytes in data
+ * @param position The offset of the record in data, which is moved past it
+ *
+ * @return The table in the record
+ *
+ * @throws invalid_argument iff there is no record of a table of rays at position
+ */
+RayTable DeserializeRayTable(const unsigned char *data, size_t length, size_t &position);
+
+/**
+ * Writes records to a file
+ *
+ * @param path The path to the file, which is replaced
+ * @param records The records
+ *
+ * @throws runtime_error iff the file cannot be written
+ */
+void WriteRecords(const std::string &path, const std::vector<unsigned char> &records);
+
+/**
+ * A PositionHistoryView is a sequence of positions read in place from a mapped file
+ */
+struct PositionHistoryView {
+    /// The first position
+    const PositionVector *positions;
+    /// The number of positions
+    size_t count;
+    /// Keeps the mapping of positions alive while any copy of this exists
+    std::shared_ptr<void> owner;
+
+    /// Returns the first position
+    const PositionVector *begin() const { return this->positions; }
+    /// Returns the position past the last one
+    const PositionVector *end() const { return this->positions + this->count; }
+};
+
+/**
+ * Maps a position history into memory, without copying or decoding it
+ *
+ * @param path The path to a file whose first record is a position history
+ *
+ * @return The positions in the file
+ *
+ * @throws runtime_error iff the file cannot be mapped, or this machine
+ * is not little-endian
+ * @throws invalid_argument iff the file does not start with a position history
+ */
+PositionHistoryView MapPositionHistory(const std::string &path);
+
+/**
+ * Reads a position history from a file, in a form OrbitDeterminationAlgorithm takes
+ *
+ * @param path The path to a file whose first record is a position history
+ *
+ * @return The positions in the file
+ *
+ * @throws runtime_error iff the file cannot be mapped
+ * @throws invalid_argument iff the file does not start with a position history
+ *
+ * @note The positions are copied out of the mapping in one block, rather than decoded one by one
+ */
+std::vector<PositionVector> ReadPositionHistory(const std::string &path);
+
+/**
+ * Reads a table of rays from a file, to give to Camera::SetRayTable
+ *
+ * @param path The path to a file whose first record is a table of rays
+ *
+ * @return The table in the file
+ *
+ * @throws runtime_error iff the file cannot be mapped
+ * @throws invalid_argument iff the file does not start with a table of rays
+ *
+ * @note Reading a table is far faster than making one for a distorted camera, which
+ * inverts its distortion at every entry
+ */
+std::shared_ptr<const RayTable> ReadRayTable(const std::string &path);
+
+}  // namespace found
+
+#endif
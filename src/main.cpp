@@ -1,24 +1,21 @@
 
-#include <getopt.h>
-
 #include <iostream>
+#include <fstream>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
+#include "command-line/config.hpp"
 #include "command-line/other.hpp"
+#include "command-line/batch.hpp"
+#include "command-line/generate.hpp"
+#include "pipeline/scheduler.hpp"
 #include "style/style.hpp"
 
 namespace found {
 
-/// For macro processing
-const char kNoDefaultArgument = 0;
-
-/// For command-line processing
-#define LOST_OPTIONAL_OPTARG()                                   \
-    ((optarg == NULL && optind < argc && argv[optind][0] != '-') \
-        ? static_cast<bool>(optarg = argv[optind++])             \
-        : (optarg != NULL))
-
-
 /**
  * This is where the program starts.
  * 
@@ -38,49 +35,47 @@ int FoundMain(int argc, char **argv) {
         return 0;
     }
     std::string command(argv[1]);
-    int optind = 2;
-
-    enum class DatabaseCliOption {
-        #define FOUND_CLI_OPTION(name, type, prop, defaultVal, converter, defaultArg) prop,
-        #include "command-line/options.hpp"
-        #undef FOUND_CLI_OPTION
-    };
-
-    static struct option long_options[] = {
-        #define FOUND_CLI_OPTION(name, type, prop, defaultVal, converter, defaultArg) \
-                    {name,                                                            \
-                    defaultArg == 0 ? required_argument : optional_argument,          \
-                    0,                                                                \
-                    static_cast<int>(DatabaseCliOption::prop)},
-        #include "command-line/options.hpp"  // NOLINT
-        #undef FOUND_CLI_OPTION
-                        {0}
-    };
 
     Options options;
-        int index;
-        int option;
+    // What the command line gave, to be placed over a configuration file
+    OptionOverrides overrides;
+    try {
+        ParseCommandLine(argc, argv, options, overrides);
+    } catch (const std::invalid_argument &exception) {
+        std::cout << exception.what() << std::endl;
+        return 1;
+    }
 
-        while ((option = getopt_long(argc, argv, "", long_options, &index)) != -1) {
-            switch (option) {
-#define FOUND_CLI_OPTION(name, type, prop, defaultVal, converter, defaultArg) \
-                case static_cast<int>(DatabaseCliOption::prop) :              \
-                    if (defaultArg == 0) {                                    \
-                        options.prop = converter;                             \
-                    } else {                                                  \
-                        if (LOST_OPTIONAL_OPTARG()) {                         \
-                            options.prop = converter;                         \
-                        } else {                                              \
-                            options.prop = defaultArg;                        \
-                        }                                                     \
-                    }                                                         \
-            break;
-#include "command-line/options.hpp"  // NOLINT
-#undef FOUND_CLI_OPTION
-                default :std::cout << "Illegal flag" << std::endl;
-                    exit(1);
+    try {
+        // The batch command is told of every later version of the configuration file
+        std::unique_ptr<ConfigReloader> reloader;
+        if (!options.config.empty()) {
+            std::function<void(const Options &)> validate = nullptr;
+            if (command == "batch") validate = CheckEdgeOptions;
+            reloader.reset(new ConfigReloader(options.config, overrides, validate, [](const std::string &reason) {
+                std::cerr << "Kept the last configuration: " << reason << std::endl;
+            }));
+            reloader->Current(options);
+        }
+        // Every command (and every stage) shares one pool of workers
+        if (options.threads < 0) throw std::invalid_argument("The number of threads must not be negative");
+        if (options.threads > 0 || options.pinThreads) {
+            TaskScheduler::Default().Configure(options.threads, options.pinThreads);
+        }
+        if (command == "batch") {
+            if (options.output.empty()) return BatchCommand(options, std::cout, reloader.get());
+            std::ofstream output(options.output);
+            if (!output) {
+                std::cerr << "Could not write " << options.output << std::endl;
+                return 1;
             }
+            return BatchCommand(options, output, reloader.get());
         }
+        if (command == "generate") return GenerateCommand(options, std::cout);
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
     return 0;
 }
 
@@ -97,6 +92,5 @@ int FoundMain(int argc, char **argv) {
  * 
 */
 int main(int argc, char **argv) {
-    found::FoundMain(argc, argv);
-    return 0;
+    return found::FoundMain(argc, argv);
 }
@@ -0,0 +1,176 @@
+#include "model/kepler.hpp"
+
+#include <math.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace found {
+
+/// The change in eccentric anomaly at which Newton's method stops, in radians
+const preciseDecimal kKeplerTolerance = 1e-14;
+/// The most Newton steps taken to solve Kepler's equation
+const int kKeplerIterations = 32;
+/// The number of samples of an ephemeris that are solved together
+const size_t kEphemerisBlock = 8;
+
+/**
+ * Provides a first guess of the eccentric anomaly, without knowing any nearby solution
+ *
+ * @param meanAnomaly The mean anomaly, in radians
+ * @param eccentricity The eccentricity of the orbit
+ *
+ * @return A guess from which Newton's and Halley's methods converge, for every eccentricity
+ */
+static preciseDecimal ColdGuess(preciseDecimal meanAnomaly, preciseDecimal eccentricity) {
+    // Danby's guess
+    return meanAnomaly + (sin(meanAnomaly) < 0 ? -0.85 : 0.85) * eccentricity;
+}
+
+preciseDecimal SolveKepler(preciseDecimal meanAnomaly, preciseDecimal eccentricity, preciseDecimal guess) {
+    preciseDecimal anomaly = guess;
+    for (int i = 0; i < kKeplerIterations; i++) {
+        preciseDecimal step = (anomaly - eccentricity * sin(anomaly) - meanAnomaly) /
+                              (1 - eccentricity * cos(anomaly));
+        anomaly -= step;
+        if (fabs(step) < kKeplerTolerance) break;
+    }
+    return anomaly;
+}
+
+KeplerOrbit::KeplerOrbit(const OrbitParams &orbit, preciseDecimal gravitationalParameter)
+    : eccentricity(orbit.eccentricity), meanAnomaly(orbit.meanAnomaly) {
+    if (orbit.semiMajorAxis <= 0) throw std::invalid_argument("The semi-major axis must be positive");
+    if (orbit.eccentricity < 0 || orbit.eccentricity >= 1) {
+        throw std::invalid_argument("The eccentricity of an ellipse is in [0, 1)");
+    }
+    if (gravitationalParameter <= 0) throw std::invalid_argument("The gravitational parameter must be positive");
+    PreciseVec3 inPlane = orbit.normal.CrossProduct(orbit.periapsis);
+    if (inPlane.MagnitudeSq() == 0) throw std::invalid_argument("The orbit plane is not defined");
+
+    preciseDecimal a = orbit.semiMajorAxis;
+    PreciseVec3 periapsis = orbit.periapsis.Normalize();
+    this->meanMotion = sqrt(gravitationalParameter / (a * a * a));
+    this->cosAxis = periapsis * a;
+    this->sinAxis = inPlane.Normalize() * (a * sqrt(1 - this->eccentricity * this->eccentricity));
+    this->center = periapsis * (-a * this->eccentricity);
+}
+
+preciseDecimal KeplerOrbit::Period() const {
+    return 2 * M_PI / this->meanMotion;
+}
+
+void KeplerOrbit::Tabulate(size_t samples) {
+    if (samples < 2) throw std::invalid_argument("A table needs at least 2 samples");
+    // Pairs of the eccentric anomaly and its derivative by the mean anomaly, side by side,
+    // so that one interpolation reads one cache line
+    this->table.resize(2 * (samples + 1));
+    preciseDecimal anomaly = 0;
+    for (size_t k = 0; k <= samples; k++) {
+        preciseDecimal mean = 2 * M_PI * k / samples;
+        // The last solution is close to this one
+        anomaly = SolveKepler(mean, this->eccentricity, k == 0 ? 0 : anomaly);
+        this->table[2 * k] = anomaly;
+        this->table[2 * k + 1] = 1 / (1 - this->eccentricity * cos(anomaly));
+    }
+}
+
+preciseDecimal KeplerOrbit::EccentricAnomaly(preciseDecimal time) const {
+    preciseDecimal mean = fmod(this->meanAnomaly + this->meanMotion * time, 2 * M_PI);
+    if (mean < 0) mean += 2 * M_PI;
+
+    if (this->table.empty()) {
+        return SolveKepler(mean, this->eccentricity, ColdGuess(mean, this->eccentricity));
+    }
+
+    // Cubic Hermite interpolation within the interval holding mean
+    size_t samples = this->table.size() / 2 - 1;
+    preciseDecimal width = 2 * M_PI / samples;
+    preciseDecimal position = mean / width;
+    size_t k = static_cast<size_t>(position);
+    if (k >= samples) k = samples - 1;
+    preciseDecimal t = position - k;
+    const preciseDecimal *node = this->table.data() + 2 * k;
+    preciseDecimal t2 = t * t, t3 = t2 * t;
+    return (2 * t3 - 3 * t2 + 1) * node[0] + (t3 - 2 * t2 + t) * width * node[1] +
+           (3 * t2 - 2 * t3) * node[2] + (t3 - t2) * width * node[3];
+}
+
+PreciseVec3 KeplerOrbit::Position(preciseDecimal time) const {
+    preciseDecimal anomaly = this->EccentricAnomaly(time);
+    return this->cosAxis * cos(anomaly) + this->sinAxis * sin(anomaly) + this->center;
+}
+
+void KeplerOrbit::EvaluateMany(const preciseDecimal *times, size_t count, PreciseVec3 *out) const {
+    for (size_t i = 0; i < count; i++) {
+        preciseDecimal anomaly = this->EccentricAnomaly(times[i]);
+        preciseDecimal c = cos(anomaly), s = sin(anomaly);
+        out[i] = PreciseVec3(this->cosAxis.x * c + this->sinAxis.x * s + this->center.x,
+                             this->cosAxis.y * c + this->sinAxis.y * s + this->center.y,
+                             this->cosAxis.z * c + this->sinAxis.z * s + this->center.z);
+    }
+}
+
+PreciseVec3 KeplerOrbit::Velocity(preciseDecimal time) const {
+    preciseDecimal anomaly = this->EccentricAnomaly(time);
+    preciseDecimal rate = this->meanMotion / (1 - this->eccentricity * cos(anomaly));
+    return (this->sinAxis * cos(anomaly) - this->cosAxis * sin(anomaly)) * rate;
+}
+
+void KeplerOrbit::EvaluateRange(preciseDecimal start, preciseDecimal step, size_t first, size_t count,
+                                Ephemeris &out) const {
+    if (first > out.size() || count > out.size() - first) {
+        throw std::invalid_argument("The ephemeris is too short for the samples");
+    }
+    if (count == 0) return;
+    preciseDecimal e = this->eccentricity;
+    // The mean anomaly is not wrapped within the range, so that the anomalies of neighbouring samples are close
+    preciseDecimal base = fmod(this->meanAnomaly + this->meanMotion * (start + first * step), 2 * M_PI);
+    preciseDecimal meanStep = this->meanMotion * step;
+    preciseDecimal lastMean = base;
+    preciseDecimal lastAnomaly = SolveKepler(base, e, ColdGuess(base, e));
+
+    preciseDecimal mean[kEphemerisBlock];
+    preciseDecimal anomaly[kEphemerisBlock];
+    for (size_t block = 0; block < count; block += kEphemerisBlock) {
+        size_t lanes = std::min(kEphemerisBlock, count - block);
+        preciseDecimal slope = 1 / (1 - e * cos(lastAnomaly));
+        for (size_t j = 0; j < lanes; j++) {
+            mean[j] = base + meanStep * (block + j);
+            anomaly[j] = lastAnomaly + (mean[j] - lastMean) * slope;
+        }
+        // If the block spans much of the orbit, the extrapolation is no good
+        if (fabs(mean[lanes - 1] - lastMean) * slope > 1) {
+            for (size_t j = 0; j < lanes; j++) anomaly[j] = ColdGuess(mean[j], e);
+        }
+
+        for (int i = 0; i < kKeplerIterations; i++) {
+            preciseDecimal largest = 0;
+            for (size_t j = 0; j < lanes; j++) {
+                preciseDecimal s = e * sin(anomaly[j]), c = 1 - e * cos(anomaly[j]);
+                preciseDecimal f = anomaly[j] - s - mean[j];
+                preciseDecimal change = f * c / (c * c - 0.5 * f * s);
+                anomaly[j] -= change;
+                largest = std::max(largest, fabs(change));
+            }
+            if (largest < kKeplerTolerance) break;
+        }
+
+        size_t index = first + block;
+        for (size_t j = 0; j < lanes; j++, index++) {
+            preciseDecimal c = cos(anomaly[j]), s = sin(anomaly[j]);
+            preciseDecimal rate = this->meanMotion / (1 - e * c);
+            out.x()[index] = this->cosAxis.x * c + this->sinAxis.x * s + this->center.x;
+            out.y()[index] = this->cosAxis.y * c + this->sinAxis.y * s + this->center.y;
+            out.z()[index] = this->cosAxis.z * c + this->sinAxis.z * s + this->center.z;
+            out.vx()[index] = (this->sinAxis.x * c - this->cosAxis.x * s) * rate;
+            out.vy()[index] = (this->sinAxis.y * c - this->cosAxis.y * s) * rate;
+            out.vz()[index] = (this->sinAxis.z * c - this->cosAxis.z * s) * rate;
+        }
+        lastMean = mean[lanes - 1];
+        lastAnomaly = anomaly[lanes - 1];
+    }
+}
+
+}  // namespace found
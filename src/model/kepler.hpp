@@ -0,0 +1,249 @@
+#ifndef KEPLER_H
+#define KEPLER_H
+
+#include <stddef.h>
+
+#include <initializer_list>
+#include <vector>
+
+#include "common/memory.hpp"
+#include "spatial/attitude-utils.hpp"
+#include "style/style.hpp"
+
+namespace found {
+
+/// The gravitational parameter of Earth, in km^3/s^2
+const preciseDecimal kEarthGravitationalParameter = 398600.4418;
+
+/**
+ * Solves Kepler's equation, M = E - e sin(E), for the eccentric anomaly E
+ *
+ * @param meanAnomaly The mean anomaly M, in radians
+ * @param eccentricity The eccentricity e, in [0, 1)
+ * @param guess The first guess of E
+ *
+ * @return The eccentric anomaly, in radians
+ *
+ * @note This uses Newton's method, which converges in a few steps from a close guess
+ */
+preciseDecimal SolveKepler(preciseDecimal meanAnomaly, preciseDecimal eccentricity, preciseDecimal guess);
+
+/**
+ * An Ephemeris holds the positions and velocities of a satellite at a
+ * sequence of times, as a structure of arrays: every coordinate is in its
+ * own aligned array, so that loops over the samples (e.g. checking which
+ * of them are in view of a ground station) can process several per
+ * instruction.
+ *
+ * @note Resizing an Ephemeris to fewer samples keeps its storage, so it
+ * can be refilled without allocating
+ */
+class Ephemeris {
+ public:
+    /// The storage of one coordinate of every sample
+    typedef std::vector<preciseDecimal, AlignedAllocator<preciseDecimal>> Coordinates;
+
+    /**
+     * Creates an empty Ephemeris
+     */
+    Ephemeris() = default;
+
+    /**
+     * Creates an Ephemeris
+     *
+     * @param count The number of samples (all zero)
+     */
+    explicit Ephemeris(size_t count) { this->resize(count); }
+
+    /// Returns the number of samples
+    size_t size() const { return this->xs.size(); }
+
+    /**
+     * Changes the number of samples
+     *
+     * @param count The new number of samples (new samples are zero)
+     */
+    void resize(size_t count) {
+        for (Coordinates *coordinates : {&this->xs, &this->ys, &this->zs, &this->vxs, &this->vys, &this->vzs}) {
+            coordinates->resize(count);
+        }
+    }
+
+    /**
+     * Provides the position of a sample
+     *
+     * @param index The index of the sample
+     *
+     * @return The position of the sample at index, in km
+     */
+    PreciseVec3 Position(size_t index) const { return {this->xs[index], this->ys[index], this->zs[index]}; }
+
+    /**
+     * Provides the velocity of a sample
+     *
+     * @param index The index of the sample
+     *
+     * @return The velocity of the sample at index, in km/s
+     */
+    PreciseVec3 Velocity(size_t index) const { return {this->vxs[index], this->vys[index], this->vzs[index]}; }
+
+    /// Returns the x coordinates of the positions
+    preciseDecimal *x() { return this->xs.data(); }
+    /// Returns the x coordinates of the positions
+    const preciseDecimal *x() const { return this->xs.data(); }
+    /// Returns the y coordinates of the positions
+    preciseDecimal *y() { return this->ys.data(); }
+    /// Returns the y coordinates of the positions
+    const preciseDecimal *y() const { return this->ys.data(); }
+    /// Returns the z coordinates of the positions
+    preciseDecimal *z() { return this->zs.data(); }
+    /// Returns the z coordinates of the positions
+    const preciseDecimal *z() const { return this->zs.data(); }
+    /// Returns the x coordinates of the velocities
+    preciseDecimal *vx() { return this->vxs.data(); }
+    /// Returns the x coordinates of the velocities
+    const preciseDecimal *vx() const { return this->vxs.data(); }
+    /// Returns the y coordinates of the velocities
+    preciseDecimal *vy() { return this->vys.data(); }
+    /// Returns the y coordinates of the velocities
+    const preciseDecimal *vy() const { return this->vys.data(); }
+    /// Returns the z coordinates of the velocities
+    preciseDecimal *vz() { return this->vzs.data(); }
+    /// Returns the z coordinates of the velocities
+    const preciseDecimal *vz() const { return this->vzs.data(); }
+
+ private:
+    /// The x coordinates of the positions
+    Coordinates xs;
+    /// The y coordinates of the positions
+    Coordinates ys;
+    /// The z coordinates of the positions
+    Coordinates zs;
+    /// The x coordinates of the velocities
+    Coordinates vxs;
+    /// The y coordinates of the velocities
+    Coordinates vys;
+    /// The z coordinates of the velocities
+    Coordinates vzs;
+};
+
+/**
+ * A KeplerOrbit evaluates the position on an orbit at any time, as a
+ * two-body (Keplerian) orbit about Earth.
+ *
+ * Everything that depends on the orbit alone is worked out once, when the
+ * KeplerOrbit is made, so evaluating a position is a solve of Kepler's
+ * equation and a few multiplications. A KeplerOrbit may also tabulate the
+ * eccentric anomaly over one period, in which case Kepler's equation is
+ * not solved at all: the eccentric anomaly is interpolated instead.
+ */
+class KeplerOrbit {
+ public:
+    /**
+     * Creates a KeplerOrbit
+     *
+     * @param orbit The elements of the orbit
+     * @param gravitationalParameter The gravitational parameter of the body orbited, in km^3/s^2
+     *
+     * @throws invalid_argument iff orbit is not an ellipse, or gravitationalParameter is not positive
+     */
+    explicit KeplerOrbit(const OrbitParams &orbit,
+                         preciseDecimal gravitationalParameter = kEarthGravitationalParameter);
+
+    /**
+     * Provides the position at a time
+     *
+     * @param time The time, in s since t = 0
+     *
+     * @return The position at time, in km
+     */
+    PreciseVec3 Position(preciseDecimal time) const;
+
+    /**
+     * Provides the positions at many times
+     *
+     * @param times The times, in s since t = 0
+     * @param count The number of times
+     * @param out The place to store the position at each time, in km
+     */
+    void EvaluateMany(const preciseDecimal *times, size_t count, PreciseVec3 *out) const;
+
+    /**
+     * Provides the velocity at a time
+     *
+     * @param time The time, in s since t = 0
+     *
+     * @return The velocity at time, in km/s
+     */
+    PreciseVec3 Velocity(preciseDecimal time) const;
+
+    /**
+     * Evaluates part of an ephemeris at evenly spaced times
+     *
+     * @param start The time of the first sample of the ephemeris, in s since t = 0
+     * @param step The time between samples, in s
+     * @param first The index of the first sample to evaluate
+     * @param count The number of samples to evaluate
+     * @param out The ephemeris, whose samples first to first + count - 1 are set
+     *
+     * @throws invalid_argument iff out has fewer than first + count samples
+     *
+     * @note Samples are solved in blocks: each block starts from the
+     * anomaly of the last one, extrapolated with its rate, and every
+     * sample of a block takes the same Halley steps together. For steps
+     * that are short next to the period this takes one or two steps.
+     * The table of Tabulate is not used.
+     */
+    void EvaluateRange(preciseDecimal start, preciseDecimal step, size_t first, size_t count, Ephemeris &out) const;
+
+    /**
+     * Tabulates the eccentric anomaly over one period, so that later
+     * evaluations interpolate it instead of solving Kepler's equation
+     *
+     * @param samples The number of intervals in the table
+     *
+     * @throws invalid_argument iff samples is less than 2
+     *
+     * @note The eccentric anomaly is interpolated with cubic Hermite
+     * splines, so 1024 samples of an orbit of eccentricity 0.1 are
+     * within about 1e-11 rad of the solution
+     */
+    void Tabulate(size_t samples);
+
+    /// Returns true iff this evaluates positions with a table
+    bool Tabulated() const { return !this->table.empty(); }
+    /// Returns the period of the orbit, in s
+    preciseDecimal Period() const;
+    /// Returns the mean motion of the orbit, in rad/s
+    preciseDecimal MeanMotion() const { return this->meanMotion; }
+
+ private:
+    /**
+     * Provides the eccentric anomaly at a time
+     *
+     * @param time The time, in s since t = 0
+     *
+     * @return The eccentric anomaly, in [0, 2 pi)
+     */
+    preciseDecimal EccentricAnomaly(preciseDecimal time) const;
+
+    /// The eccentricity of the orbit
+    preciseDecimal eccentricity;
+    /// The mean motion of the orbit, in rad/s
+    preciseDecimal meanMotion;
+    /// The mean anomaly at t = 0
+    preciseDecimal meanAnomaly;
+    /// The position is cosAxis cos(E) + sinAxis sin(E) + center, E being the eccentric anomaly
+    PreciseVec3 cosAxis;
+    /// The position is cosAxis cos(E) + sinAxis sin(E) + center, E being the eccentric anomaly
+    PreciseVec3 sinAxis;
+    /// The center of the ellipse, relative to Earth's center
+    PreciseVec3 center;
+    /// The eccentric anomaly, and its derivative by the mean anomaly, at evenly spaced mean
+    /// anomalies over one period, in pairs (empty if not tabulated)
+    std::vector<preciseDecimal> table;
+};
+
+}  // namespace found
+
+#endif
@@ -0,0 +1,50 @@
+#include "model/kinematic.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#include "pipeline/scheduler.hpp"
+
+namespace found {
+
+/// The fewest samples worth handing to a task of their own
+const size_t kEphemerisSpan = 4096;
+
+KinematicProfilingAlgorithm::~KinematicProfilingAlgorithm() {}
+
+KeplerKinematicProfilingAlgorithm::KeplerKinematicProfilingAlgorithm(size_t threads,
+                                                                     preciseDecimal gravitationalParameter)
+    : threads(threads > 0 ? threads : TaskScheduler::Default().Workers()),
+      gravitationalParameter(gravitationalParameter) {}
+
+KeplerKinematicProfilingAlgorithm::~KeplerKinematicProfilingAlgorithm() {}
+
+KinematicPrediction KeplerKinematicProfilingAlgorithm::Run(const OrbitParams &orbit) {
+    std::shared_ptr<const KeplerOrbit> kepler(new KeplerOrbit(orbit, this->gravitationalParameter));
+    return KinematicPrediction(
+        [kepler](int time) { return PrecisionCast<decimal>(kepler->Position(time)); },
+        [kepler](int time) { return PrecisionCast<decimal>(kepler->Velocity(time)); });
+}
+
+void KeplerKinematicProfilingAlgorithm::Generate(const OrbitParams &orbit, preciseDecimal start,
+                                                 preciseDecimal step, Ephemeris &out) {
+    KeplerOrbit kepler(orbit, this->gravitationalParameter);
+    size_t count = out.size();
+    size_t spans = std::max(std::min(this->threads, count / kEphemerisSpan), static_cast<size_t>(1));
+    if (spans == 1) {
+        kepler.EvaluateRange(start, step, 0, count, out);
+        return;
+    }
+
+    // Every span writes its own samples of out, so the tasks share nothing else
+    TaskGroup group;
+    for (size_t i = 0; i < spans; i++) {
+        size_t first = i * count / spans, last = (i + 1) * count / spans;
+        group.Run([&kepler, &out, start, step, first, last]() {
+            kepler.EvaluateRange(start, step, first, last - first, out);
+        });
+    }
+    group.Wait();
+}
+
+}  // namespace found
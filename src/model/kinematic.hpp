@@ -1,9 +1,12 @@
 #ifndef VELOCITY_H
 #define VELOCITY_H
 
+#include <stddef.h>
+
 #include "style/style.hpp"
 #include "spatial/attitude-utils.hpp"
 #include "pipeline/pipeline.hpp"
+#include "model/kepler.hpp"
 
 namespace found {
 
@@ -16,7 +19,7 @@ namespace found {
 */
 class KinematicProfilingAlgorithm : public Stage<OrbitParams, KinematicPrediction> {
  public:
-    // Destroys this
+    /// Destroys this
     virtual ~KinematicProfilingAlgorithm();
 };
 
@@ -59,21 +62,54 @@ class EulerianKinematicProfilingAlgorithm : public KinematicProfilingAlgorithm {
 class KeplerKinematicProfilingAlgorithm : public KinematicProfilingAlgorithm {
  public:
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
-    KeplerKinematicProfilingAlgorithm(/*Params to initialze fields for this object*/);
+     * Creates a KeplerKinematicProfilingAlgorithm
+     *
+     * @param threads The number of spans an ephemeris is generated in at once (0 for one per
+     * thread of the default TaskScheduler)
+     * @param gravitationalParameter The gravitational parameter of the body orbited, in km^3/s^2
+     */
+    explicit KeplerKinematicProfilingAlgorithm(size_t threads = 1,
+                                               preciseDecimal gravitationalParameter = kEarthGravitationalParameter);
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
+     * Destroys this
+     */
     ~KeplerKinematicProfilingAlgorithm();
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
-     * */
+     * Makes the kinematic profile of an orbit
+     *
+     * @param orbit The orbit
+     *
+     * @return The position (km) and velocity (km/s) as functions of the time, in s since t = 0
+     *
+     * @throws invalid_argument iff orbit is not an ellipse
+     *
+     * @note Each call of the functions solves Kepler's equation on its own; use
+     * Generate for many evenly spaced times
+     */
     KinematicPrediction Run(const OrbitParams &orbit /*Params to override the base class one*/) override;
+
+    /**
+     * Generates the ephemeris of an orbit at evenly spaced times
+     *
+     * @param orbit The orbit
+     * @param start The time of the first sample, in s since t = 0
+     * @param step The time between samples, in s
+     * @param out The ephemeris, every sample of which is set
+     *
+     * @throws invalid_argument iff orbit is not an ellipse
+     *
+     * @note The samples are split into contiguous spans, each a task of the default
+     * TaskScheduler, so that each task warm starts from its own neighbouring samples
+     */
+    void Generate(const OrbitParams &orbit, preciseDecimal start, preciseDecimal step, Ephemeris &out);
+
  private:
-    // Fields specific to this algorithm go here, and helper methods
+    /// The number of spans an ephemeris is generated in at once
+    size_t threads;
+    /// The gravitational parameter of the body orbited, in km^3/s^2
+    preciseDecimal gravitationalParameter;
 };
 
 }  // namespace found
@@ -0,0 +1,147 @@
+#include "model/orbit.hpp"
+
+#include <math.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace found {
+
+OrbitDeterminationAlgorithm::~OrbitDeterminationAlgorithm() {}
+
+/**
+ * Evaluates a quadratic form of a symmetric matrix
+ *
+ * @param matrix The upper triangle of the matrix (xx, xy, xz, yy, yz, zz)
+ * @param a,b The vectors
+ *
+ * @return a^T matrix b
+ */
+static preciseDecimal Quadratic(const preciseDecimal matrix[6], const PreciseVec3 &a, const PreciseVec3 &b) {
+    return a.x * (matrix[0] * b.x + matrix[1] * b.y + matrix[2] * b.z) +
+           a.y * (matrix[1] * b.x + matrix[3] * b.y + matrix[4] * b.z) +
+           a.z * (matrix[2] * b.x + matrix[4] * b.y + matrix[5] * b.z);
+}
+
+EllipticalOrbitDerminationAlgorithm::EllipticalOrbitDerminationAlgorithm(size_t windowSize)
+    : windowSize(windowSize) {
+    this->Reset();
+}
+
+EllipticalOrbitDerminationAlgorithm::~EllipticalOrbitDerminationAlgorithm() {}
+
+void EllipticalOrbitDerminationAlgorithm::Reset() {
+    this->window.clear();
+    this->removed = 0;
+    this->sum = PreciseVec3(0, 0, 0);
+    for (preciseDecimal &entry : this->scatter) entry = 0;
+    this->weightedSum = PreciseVec3(0, 0, 0);
+    this->radiusSum = 0;
+    this->momentum = PreciseVec3(0, 0, 0);
+    this->normal = PreciseVec3(0, 0, 0);
+    this->eccentricity = PreciseVec3(0, 0, 0);
+    this->semiLatusRectum = 0;
+}
+
+void EllipticalOrbitDerminationAlgorithm::Accumulate(const PreciseVec3 &position, preciseDecimal sign) {
+    this->sum = this->sum + position * sign;
+    this->scatter[0] += sign * position.x * position.x;
+    this->scatter[1] += sign * position.x * position.y;
+    this->scatter[2] += sign * position.x * position.z;
+    this->scatter[3] += sign * position.y * position.y;
+    this->scatter[4] += sign * position.y * position.z;
+    this->scatter[5] += sign * position.z * position.z;
+    preciseDecimal radius = position.Magnitude();
+    this->weightedSum = this->weightedSum + position * (sign * radius);
+    this->radiusSum += sign * radius;
+}
+
+void EllipticalOrbitDerminationAlgorithm::Push(const PreciseVec3 &position) {
+    if (!this->window.empty()) this->momentum = this->momentum + this->window.back().CrossProduct(position);
+    this->window.push_back(position);
+    this->Accumulate(position, 1);
+}
+
+void EllipticalOrbitDerminationAlgorithm::Trim() {
+    if (this->windowSize == 0 || this->window.size() <= this->windowSize) return;
+    const PreciseVec3 &oldest = this->window[0];
+    this->momentum = this->momentum - oldest.CrossProduct(this->window[1]);
+    this->Accumulate(oldest, -1);
+    this->window.pop_front();
+
+    // Removing positions from the sums slowly loses precision, so they are rebuilt once
+    // per window (which keeps updates constant time, on average)
+    if (++this->removed >= this->windowSize) {
+        std::deque<PreciseVec3> latest;
+        latest.swap(this->window);
+        this->Reset();
+        for (const PreciseVec3 &position : latest) this->Push(position);
+    }
+}
+
+OrbitParams EllipticalOrbitDerminationAlgorithm::Run(const std::vector<Vec3> &positions) {
+    this->Reset();
+    for (const Vec3 &position : positions) {
+        this->Push(PrecisionCast<preciseDecimal>(position));
+        this->Trim();
+    }
+    return this->Fit();
+}
+
+OrbitParams EllipticalOrbitDerminationAlgorithm::Update(const PositionVector &position) {
+    this->Push(PrecisionCast<preciseDecimal>(position));
+    this->Trim();
+    return this->Fit();
+}
+
+OrbitParams EllipticalOrbitDerminationAlgorithm::Fit() {
+    if (this->window.size() < 3) throw std::invalid_argument("At least 3 positions are needed to find an orbit");
+
+    // 1. The orbit plane is normal to the angular momentum
+    preciseDecimal momentumNorm = this->momentum.Magnitude();
+    if (momentumNorm <= 1e-12 * (this->scatter[0] + this->scatter[3] + this->scatter[5])) {
+        throw std::invalid_argument("The positions do not determine an orbit plane");
+    }
+    PreciseVec3 n = this->momentum * (1 / momentumNorm);
+    PreciseVec3 axis = fabs(n.x) <= fabs(n.y) && fabs(n.x) <= fabs(n.z) ? PreciseVec3(1, 0, 0)
+                     : fabs(n.y) <= fabs(n.z) ? PreciseVec3(0, 1, 0) : PreciseVec3(0, 0, 1);
+    PreciseVec3 u = n.CrossProduct(axis).Normalize();
+    PreciseVec3 v = n.CrossProduct(u);
+
+    // 2. Least squares for |r| + e_u x + e_v y - p = 0, x and y being coordinates in the plane
+    preciseDecimal count = static_cast<preciseDecimal>(this->window.size());
+    preciseDecimal sumX = u * this->sum, sumY = v * this->sum;
+    preciseDecimal sumXX = Quadratic(this->scatter, u, u);
+    preciseDecimal sumXY = Quadratic(this->scatter, u, v);
+    preciseDecimal sumYY = Quadratic(this->scatter, v, v);
+    PreciseMat3 normalMatrix = {sumXX, sumXY, -sumX,
+                                sumXY, sumYY, -sumY,
+                                -sumX, -sumY, count};
+    if (fabs(normalMatrix.Det()) <= 1e-12 * sumXX * sumYY * count) {
+        throw std::invalid_argument("The positions do not determine an ellipse");
+    }
+    PreciseVec3 rhs(-(u * this->weightedSum), -(v * this->weightedSum), this->radiusSum);
+    PreciseVec3 solution = normalMatrix.Inverse() * rhs;
+
+    // 3. The elements of the orbit
+    PreciseVec3 e = u * solution.x + v * solution.y;
+    preciseDecimal p = solution.z;
+    preciseDecimal magnitude = e.Magnitude();
+    if (p <= 0 || magnitude >= 1) throw std::invalid_argument("The positions do not lie on an ellipse");
+    this->normal = n;
+    this->eccentricity = e;
+    this->semiLatusRectum = p;
+
+    // Periapsis is along e, or anywhere on a circle
+    PreciseVec3 periapsisDirection = magnitude > 1e-12 ? e * (1 / magnitude) : u;
+    // The orbit is given from periapsis, at t = 0
+    OrbitParams orbit = {PrecisionCast<decimal>(periapsisDirection * (p / (1 + magnitude))),
+                         p / (1 - magnitude * magnitude), magnitude, periapsisDirection, n, 0};
+    return orbit;
+}
+
+preciseDecimal EllipticalOrbitDerminationAlgorithm::SemiMajorAxis() const {
+    return this->semiLatusRectum / (1 - this->eccentricity.MagnitudeSq());
+}
+
+}  // namespace found
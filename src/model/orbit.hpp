@@ -1,6 +1,9 @@
 #ifndef ORBIT_H
 #define ORBIT_H
 
+#include <stddef.h>
+
+#include <deque>
 #include <vector>
 
 #include "spatial/attitude-utils.hpp"
@@ -25,25 +28,121 @@ class OrbitDeterminationAlgorithm : public Stage<std::vector<Vec3>, OrbitParams>
  * This algorithm finds the orbit path of the satellite from known position vectors relative to Earth
  * by assuming that the orbital path is an ellipse that is spatially fixed.
  * 
+ * The orbit is fit from running sums over a sliding window of the latest positions: the orbit
+ * plane from the angular momentum (the sum of the cross products of consecutive positions), and
+ * the ellipse, with Earth at a focus, from the least squares solution of |r| + e . r = p (e being
+ * the eccentricity vector and p the semi-latus rectum). Adding a position (and dropping the oldest
+ * one) only updates the sums, so each update costs the same however long the history is.
+ * 
 */
 class EllipticalOrbitDerminationAlgorithm : public OrbitDeterminationAlgorithm {
  public:
     /**
-     * Place documentation here. Press enter to automatically make a new line
+     * Creates an EllipticalOrbitDerminationAlgorithm
+     * 
+     * @param windowSize The number of latest positions the orbit is fit to (0 to fit to every position)
      * */
-    EllipticalOrbitDerminationAlgorithm(/*Params to initialze fields for this object*/);
+    explicit EllipticalOrbitDerminationAlgorithm(size_t windowSize = 0);
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
+     * Destroys this
      * */
     ~EllipticalOrbitDerminationAlgorithm();
 
     /**
-     * Place documentation here. Press enter to automatically make a new line
+     * Fits an orbit to a whole position history, in place of the positions given so far
+     * 
+     * @param positions The positions of the satellite, in the order they were taken
+     * 
+     * @return The orbit, whose initial condition is its periapsis
+     * 
+     * @throws invalid_argument iff the (latest) positions do not determine an ellipse
      * */
     OrbitParams Run(const std::vector<Vec3> &positions /*Params to override the base class one*/) override;
+
+    /**
+     * Adds the next position of the satellite, and refits the orbit, in constant time
+     * 
+     * @param position The position
+     * 
+     * @return The orbit, whose initial condition is its periapsis
+     * 
+     * @throws invalid_argument iff the positions in the window do not determine an ellipse
+     * 
+     * @note The position is kept even if the fit fails
+     * */
+    OrbitParams Update(const PositionVector &position);
+
+    /**
+     * Forgets every position
+     * */
+    void Reset();
+
+    /// Returns the number of positions the orbit is fit to
+    size_t Size() const { return this->window.size(); }
+    /// Returns the unit normal of the plane of the last orbit fit, along its angular momentum
+    PreciseVec3 Normal() const { return this->normal; }
+    /// Returns the eccentricity vector of the last orbit fit, which points at periapsis
+    PreciseVec3 Eccentricity() const { return this->eccentricity; }
+    /// Returns the semi-latus rectum of the last orbit fit
+    preciseDecimal SemiLatusRectum() const { return this->semiLatusRectum; }
+    /// Returns the semi-major axis of the last orbit fit
+    preciseDecimal SemiMajorAxis() const;
+
  private:
-    // Fields specific to this algorithm go here, and helper methods
+    /**
+     * Adds a position to, or removes it from, the running sums
+     * 
+     * @param position The position
+     * @param sign 1 to add position, or -1 to remove it
+     * */
+    void Accumulate(const PreciseVec3 &position, preciseDecimal sign);
+
+    /**
+     * Adds the next position to the window and the running sums
+     * 
+     * @param position The position
+     * */
+    void Push(const PreciseVec3 &position);
+
+    /**
+     * Drops the oldest position if the window is over full
+     * */
+    void Trim();
+
+    /**
+     * Fits the orbit to the running sums
+     * 
+     * @return The orbit
+     * 
+     * @throws invalid_argument iff the sums do not determine an ellipse
+     * */
+    OrbitParams Fit();
+
+    /// The most positions fit to (0 if unbounded)
+    size_t windowSize;
+    /// The positions fit to, oldest first
+    std::deque<PreciseVec3> window;
+    /// The number of positions removed since the sums were last rebuilt
+    size_t removed;
+
+    /// The sum of the positions
+    PreciseVec3 sum;
+    /// The sums of the products of the coordinates of the positions (xx, xy, xz, yy, yz, zz)
+    preciseDecimal scatter[6];
+    /// The sum of the positions, each scaled by its magnitude
+    PreciseVec3 weightedSum;
+    /// The sum of the magnitudes of the positions
+    preciseDecimal radiusSum;
+    /// The sum of the cross products of consecutive positions
+    PreciseVec3 momentum;
+
+    /// The normal of the last orbit fit
+    PreciseVec3 normal;
+    /// The eccentricity vector of the last orbit fit
+    PreciseVec3 eccentricity;
+    /// The semi-latus rectum of the last orbit fit
+    preciseDecimal semiLatusRectum;
 };
 
 /**
@@ -0,0 +1,183 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <stddef.h>
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+#include "pipeline/scheduler.hpp"
+
+namespace found {
+
+/**
+ * A StealingQueue is the queue of frame indices of one batch
+ * worker. Its owner takes frames from the front, and idle workers
+ * steal them from the back, so that an owner and a thief rarely
+ * want the same frame.
+ */
+class StealingQueue {
+ public:
+    /**
+     * Places a frame at the back of this
+     *
+     * @param index The index of the frame
+     */
+    void Push(size_t index) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->indices.push_back(index);
+    }
+
+    /**
+     * Takes the frame at the front of this, for its owner
+     *
+     * @param index The variable to place the index of the frame in
+     *
+     * @return true iff there was a frame to take
+     */
+    bool Pop(size_t &index) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->indices.empty()) return false;
+        index = this->indices.front();
+        this->indices.pop_front();
+        return true;
+    }
+
+    /**
+     * Takes the frame at the back of this, for another worker
+     *
+     * @param index The variable to place the index of the frame in
+     *
+     * @return true iff there was a frame to take
+     */
+    bool Steal(size_t &index) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->indices.empty()) return false;
+        index = this->indices.back();
+        this->indices.pop_back();
+        return true;
+    }
+
+ private:
+    /// The indices of the frames in this
+    std::deque<size_t> indices;
+    /// The lock guarding indices
+    std::mutex mutex;
+};
+
+/**
+ * Processes a batch of frames on several threads, and hands their
+ * results back in input order.
+ *
+ * The frames are processed by a number of workers, each a task of a
+ * TaskScheduler. Each worker first builds its own processor with
+ * makeProcessor (e.g. its own pipeline, so that no stage is shared
+ * between threads), and starts on an even, contiguous share of the
+ * frames. Once a worker runs out of frames, it steals from the others,
+ * so that slow frames do not leave cores idle.
+ *
+ * @param Output The result of processing one frame
+ *
+ * @param count The number of frames
+ * @param threads The number of workers (at least 1 is used), which run
+ * at once as far as the scheduler has threads for them
+ * @param makeProcessor Makes the processor of one worker, which makes
+ * the result of the frame with a given index
+ * @param emit Takes the result of each frame, in input order, on the
+ * calling thread (as soon as every frame before it is done)
+ * @param scheduler The scheduler to run the workers on
+ *
+ * @throws Anything makeProcessor, a processor or emit throws, after
+ * every worker has stopped
+ *
+ * @pre The calling thread is not a thread of scheduler, since it waits
+ * for the workers without running tasks itself
+ */
+template<typename Output>
+void RunBatch(size_t count, size_t threads,
+              const std::function<std::function<Output(size_t)>()> &makeProcessor,
+              const std::function<void(size_t, Output &)> &emit,
+              TaskScheduler &scheduler = TaskScheduler::Default()) {
+    threads = std::max(std::min(threads, count), static_cast<size_t>(1));
+    std::vector<std::unique_ptr<StealingQueue>> queues;
+    for (size_t i = 0; i < threads; i++) {
+        queues.push_back(std::unique_ptr<StealingQueue>(new StealingQueue()));
+        for (size_t index = i * count / threads; index < (i + 1) * count / threads; index++) {
+            queues[i]->Push(index);
+        }
+    }
+
+    std::vector<Output> results(count);
+    std::vector<bool> done(count, false);
+    std::exception_ptr error;
+    bool failed = false;
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    TaskGroup workers(scheduler);
+    for (size_t i = 0; i < threads; i++) {
+        workers.Run([&, i]() {
+            try {
+                std::function<Output(size_t)> process = makeProcessor();
+                size_t index;
+                while (true) {
+                    bool found = queues[i]->Pop(index);
+                    for (size_t other = 1; !found && other < threads; other++) {
+                        found = queues[(i + other) % threads]->Steal(index);
+                    }
+                    if (!found) return;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (failed) return;
+                    }
+                    Output result = process(index);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        results[index] = std::move(result);
+                        done[index] = true;
+                    }
+                    finished.notify_all();
+                }
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!failed) error = std::current_exception();
+                    failed = true;
+                }
+                finished.notify_all();
+            }
+        });
+    }
+
+    // Hands out results in order while the workers go on
+    try {
+        for (size_t next = 0; next < count; next++) {
+            Output result;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                finished.wait(lock, [&]() { return failed || done[next]; });
+                if (failed) break;
+                result = std::move(results[next]);
+            }
+            emit(next, result);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failed) error = std::current_exception();
+        failed = true;
+    }
+
+    workers.Wait();
+    if (error) std::rethrow_exception(error);
+}
+
+}  // namespace found
+
+#endif
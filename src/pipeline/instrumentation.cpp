@@ -0,0 +1,222 @@
+#include "pipeline/instrumentation.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace found {
+
+Histogram::Histogram(const HistogramOptions &options) : options(options) {
+    if (!(options.smallest > 0)) throw std::invalid_argument("The first bucket must have a positive bound");
+    if (!(options.growth > 1)) throw std::invalid_argument("Buckets must grow by more than 1");
+    if (options.buckets == 0) throw std::invalid_argument("A histogram needs a bucket");
+    this->logGrowth = log(options.growth);
+    this->buckets.resize(options.buckets);
+    this->Reset();
+}
+
+void Histogram::Record(double value) {
+    size_t index = 0;
+    if (value >= this->options.smallest) {
+        double position = log(value / this->options.smallest) / this->logGrowth;
+        index = std::min(static_cast<size_t>(position) + 1, this->options.buckets - 1);
+    }
+    this->buckets[index]++;
+    this->sum += value;
+    if (this->count == 0 || value < this->minimum) this->minimum = value;
+    if (this->count == 0 || value > this->maximum) this->maximum = value;
+    this->count++;
+}
+
+void Histogram::Merge(const Histogram &other) {
+    if (other.options.smallest != this->options.smallest || other.options.growth != this->options.growth ||
+        other.options.buckets != this->options.buckets) {
+        throw std::invalid_argument("The histograms have other buckets");
+    }
+    if (other.count == 0) return;
+    for (size_t i = 0; i < this->buckets.size(); i++) this->buckets[i] += other.buckets[i];
+    this->minimum = this->count == 0 ? other.minimum : std::min(this->minimum, other.minimum);
+    this->maximum = this->count == 0 ? other.maximum : std::max(this->maximum, other.maximum);
+    this->count += other.count;
+    this->sum += other.sum;
+}
+
+void Histogram::Reset() {
+    std::fill(this->buckets.begin(), this->buckets.end(), 0);
+    this->count = 0;
+    this->sum = 0;
+    this->minimum = 0;
+    this->maximum = 0;
+}
+
+double Histogram::Quantile(double quantile) const {
+    if (this->count == 0) return 0;
+    if (quantile <= 0) return this->minimum;
+    // The rank of the value at quantile, from 1
+    uint64_t rank = static_cast<uint64_t>(ceil(std::min(quantile, 1.0) * this->count));
+    rank = std::max(rank, static_cast<uint64_t>(1));
+    uint64_t seen = 0;
+    size_t index = 0;
+    while (true) {
+        seen += this->buckets[index];
+        if (seen >= rank) break;
+        index++;
+    }
+    double bound = this->options.smallest * pow(this->options.growth, static_cast<double>(index));
+    return std::min(std::max(bound, this->minimum), this->maximum);
+}
+
+void CounterSet::Record(const char *name, uint64_t value) {
+    for (Counter &counter : this->counters) {
+        if (counter.name == name) {
+            counter.total += value;
+            counter.last = value;
+            return;
+        }
+    }
+    this->counters.push_back({name, value, value});
+}
+
+const Counter *CounterSet::Find(const std::string &name) const {
+    for (const Counter &counter : this->counters) {
+        if (counter.name == name) return &counter;
+    }
+    return nullptr;
+}
+
+void CounterSet::Merge(const CounterSet &other) {
+    for (const Counter &counter : other.counters) {
+        std::vector<Counter>::iterator mine = std::find_if(this->counters.begin(), this->counters.end(),
+                                                           [&](const Counter &c) { return c.name == counter.name; });
+        if (mine == this->counters.end()) {
+            this->counters.push_back(counter);
+        } else {
+            mine->total += counter.total;
+        }
+    }
+}
+
+PipelineProfile::PipelineProfile(const HistogramOptions &options) : options(options), frames(options) {}
+
+void PipelineProfile::Configure(const HistogramOptions &options) {
+    this->frames = Histogram(options);
+    this->options = options;
+    for (StageProfile &stage : this->stages) {
+        stage.time = Histogram(options);
+        stage.counters.Reset();
+    }
+}
+
+void PipelineProfile::AddStage(const std::string &name) {
+    this->stages.push_back({name, Histogram(this->options), CounterSet()});
+}
+
+const StageProfile *PipelineProfile::FindStage(const std::string &name) const {
+    for (const StageProfile &stage : this->stages) {
+        if (stage.name == name) return &stage;
+    }
+    return nullptr;
+}
+
+void PipelineProfile::Merge(const PipelineProfile &other) {
+    if (other.stages.size() != this->stages.size()) throw std::invalid_argument("The profiles have other stages");
+    for (size_t i = 0; i < this->stages.size(); i++) {
+        if (other.stages[i].name != this->stages[i].name) {
+            throw std::invalid_argument("The profiles have other stages");
+        }
+    }
+    this->frames.Merge(other.frames);
+    for (size_t i = 0; i < this->stages.size(); i++) {
+        this->stages[i].time.Merge(other.stages[i].time);
+        this->stages[i].counters.Merge(other.stages[i].counters);
+    }
+}
+
+void PipelineProfile::Reset() {
+    this->frames.Reset();
+    for (StageProfile &stage : this->stages) {
+        stage.time.Reset();
+        stage.counters.Reset();
+    }
+}
+
+/**
+ * Writes a string as JSON
+ *
+ * @param out The stream to write to
+ * @param text The string
+ */
+static void WriteJsonString(std::ostream &out, const std::string &text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * Writes a summary of a Histogram as JSON
+ *
+ * @param out The stream to write to
+ * @param histogram The Histogram
+ */
+static void WriteJsonHistogram(std::ostream &out, const Histogram &histogram) {
+    out << "{\"count\": " << histogram.Count() << ", \"mean_ns\": " << histogram.Mean()
+        << ", \"p50_ns\": " << histogram.Quantile(0.5) << ", \"p99_ns\": " << histogram.Quantile(0.99)
+        << ", \"max_ns\": " << histogram.Max() << "}";
+}
+
+void PipelineProfile::WriteJson(std::ostream &out) const {
+    out << "{\"enabled\": " << (kInstrumentationEnabled ? "true" : "false") << ", \"frames\": ";
+    WriteJsonHistogram(out, this->frames);
+    out << ", \"stages\": [";
+    for (size_t i = 0; i < this->stages.size(); i++) {
+        const StageProfile &stage = this->stages[i];
+        out << (i == 0 ? "" : ", ") << "{\"name\": ";
+        WriteJsonString(out, stage.name);
+        out << ", \"time\": ";
+        WriteJsonHistogram(out, stage.time);
+        out << ", \"counters\": {";
+        for (size_t j = 0; j < stage.counters.All().size(); j++) {
+            const Counter &counter = stage.counters.All()[j];
+            out << (j == 0 ? "" : ", ");
+            WriteJsonString(out, counter.name);
+            out << ": " << counter.total;
+        }
+        out << "}}";
+    }
+    out << "]}\n";
+}
+
+std::string TypeName(const char *name) {
+#ifdef __GNUG__
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) {
+        std::string result(demangled);
+        free(demangled);
+        // Every stage is in this namespace, so it says nothing
+        if (result.compare(0, 7, "found::") == 0) result.erase(0, 7);
+        return result;
+    }
+    free(demangled);  // GCOVR_EXCL_LINE
+#endif
+    return name;  // GCOVR_EXCL_LINE
+}
+
+}  // namespace found
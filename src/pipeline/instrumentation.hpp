@@ -0,0 +1,305 @@
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace found {
+
+/**
+ * Instrumentation times every stage of a Pipeline (and every frame
+ * through it) and collects counters that stages report, such as the
+ * number of points found or solver iterations.
+ *
+ * It is compiled in iff FOUND_INSTRUMENTATION is defined (make
+ * INSTRUMENTATION=1). Otherwise, Pipelines do not read the clock or
+ * ask stages for counters, and their profile stays empty, so flight
+ * builds pay nothing for it. The types below are always available, so
+ * that code reading a profile builds either way.
+ */
+
+/// Set to whether instrumentation is compiled in
+#ifdef FOUND_INSTRUMENTATION
+constexpr bool kInstrumentationEnabled = true;
+#else
+constexpr bool kInstrumentationEnabled = false;
+#endif
+
+/// The clock that stages are timed with (monotonic)
+typedef std::chrono::steady_clock ProfileClock;
+
+/**
+ * HistogramOptions define the buckets of a Histogram: bucket 0 holds
+ * values below smallest, and each bucket after it is growth times as
+ * wide as the last, so that every bucket has the same relative error
+ */
+struct HistogramOptions {
+    /// The upper bound of the first bucket
+    double smallest = 100;
+    /// The ratio between the bounds of consecutive buckets
+    double growth = 1.05;
+    /// The number of buckets (the last one holds every larger value)
+    size_t buckets = 512;
+};
+
+/**
+ * A Histogram summarizes a distribution of values (i.e. durations in
+ * ns) in logarithmic buckets, so that recording a value takes constant
+ * time and space, and quantiles are exact to within one bucket
+ */
+class Histogram {
+ public:
+    /**
+     * Creates an empty Histogram
+     *
+     * @param options The buckets of this
+     *
+     * @throws invalid_argument iff smallest is not positive, growth is not greater than 1,
+     * or there are no buckets
+     */
+    explicit Histogram(const HistogramOptions &options = HistogramOptions());
+
+    /**
+     * Adds a value to this
+     *
+     * @param value The value
+     */
+    void Record(double value);
+
+    /**
+     * Adds every value of another Histogram to this
+     *
+     * @param other The other Histogram
+     *
+     * @throws invalid_argument iff other has other buckets
+     */
+    void Merge(const Histogram &other);
+
+    /**
+     * Removes every value
+     */
+    void Reset();
+
+    /**
+     * Provides a quantile of the values
+     *
+     * @param quantile The quantile, in [0, 1] (e.g. 0.99 for p99)
+     *
+     * @return The upper bound of the bucket holding the quantile (clamped to the range
+     * of the values), the smallest value for quantile 0, or 0 if this is empty
+     */
+    double Quantile(double quantile) const;
+
+    /// Returns the number of values
+    uint64_t Count() const { return this->count; }
+    /// Returns the sum of the values
+    double Sum() const { return this->sum; }
+    /// Returns the mean of the values (0 if there are none)
+    double Mean() const { return this->count == 0 ? 0 : this->sum / this->count; }
+    /// Returns the smallest value (0 if there are none)
+    double Min() const { return this->count == 0 ? 0 : this->minimum; }
+    /// Returns the largest value (0 if there are none)
+    double Max() const { return this->maximum; }
+    /// Returns the buckets of this
+    const HistogramOptions &Options() const { return this->options; }
+
+ private:
+    /// The buckets of this
+    HistogramOptions options;
+    /// The logarithm of options.growth
+    double logGrowth;
+    /// The number of values in each bucket
+    std::vector<uint64_t> buckets;
+    /// The number of values
+    uint64_t count;
+    /// The sum of the values
+    double sum;
+    /// The smallest value
+    double minimum;
+    /// The largest value
+    double maximum;
+};
+
+/**
+ * A Counter is a named count that a stage reports once per run
+ */
+struct Counter {
+    /// The name of the counter
+    std::string name;
+    /// The sum of the counts of every run
+    uint64_t total;
+    /// The count of the last run
+    uint64_t last;
+};
+
+/**
+ * A CounterSet holds the counters of a stage
+ */
+class CounterSet {
+ public:
+    /**
+     * Records the count of a run
+     *
+     * @param name The name of the counter
+     * @param value The count of the run
+     */
+    void Record(const char *name, uint64_t value);
+
+    /**
+     * Finds a counter
+     *
+     * @param name The name of the counter
+     *
+     * @return The counter, or nullptr if it was never recorded
+     */
+    const Counter *Find(const std::string &name) const;
+
+    /**
+     * Adds every count of another CounterSet to this
+     *
+     * @param other The other CounterSet
+     */
+    void Merge(const CounterSet &other);
+
+    /// Removes every counter
+    void Reset() { this->counters.clear(); }
+    /// Returns every counter, in the order they were first recorded
+    const std::vector<Counter> &All() const { return this->counters; }
+
+ private:
+    /// The counters (there are few, so a linear search is fastest)
+    std::vector<Counter> counters;
+};
+
+/**
+ * A StageProfile holds the timings and counters of one stage
+ */
+struct StageProfile {
+    /// The name of the stage
+    std::string name;
+    /// The time of each run of the stage, in ns
+    Histogram time;
+    /// The counters of the stage
+    CounterSet counters;
+};
+
+/**
+ * A PipelineProfile holds the timings and counters of every stage of
+ * a Pipeline, and of every frame through it
+ */
+class PipelineProfile {
+ public:
+    /**
+     * Creates an empty PipelineProfile
+     *
+     * @param options The buckets of every histogram of this
+     */
+    explicit PipelineProfile(const HistogramOptions &options = HistogramOptions());
+
+    /**
+     * Changes the buckets of every histogram, removing every timing
+     *
+     * @param options The buckets
+     *
+     * @throws invalid_argument iff options is invalid (see Histogram)
+     */
+    void Configure(const HistogramOptions &options);
+
+    /**
+     * Adds a stage to the end of this
+     *
+     * @param name The name of the stage
+     */
+    void AddStage(const std::string &name);
+
+    /**
+     * Records a run of a stage
+     *
+     * @param index The index of the stage
+     * @param time The time the run took
+     */
+    void RecordStage(size_t index, ProfileClock::duration time) {
+        this->stages[index].time.Record(std::chrono::duration<double, std::nano>(time).count());
+    }
+
+    /**
+     * Records a frame through every stage
+     *
+     * @param time The time the frame took
+     */
+    void RecordFrame(ProfileClock::duration time) {
+        this->frames.Record(std::chrono::duration<double, std::nano>(time).count());
+    }
+
+    /**
+     * Provides the counters of a stage
+     *
+     * @param index The index of the stage
+     *
+     * @return The counters of the stage
+     */
+    CounterSet &Counters(size_t index) { return this->stages[index].counters; }
+
+    /**
+     * Finds a stage
+     *
+     * @param name The name of the stage
+     *
+     * @return The first stage named name, or nullptr if there is none
+     */
+    const StageProfile *FindStage(const std::string &name) const;
+
+    /**
+     * Adds every timing and count of another PipelineProfile (i.e. of the same
+     * Pipeline on another thread) to this
+     *
+     * @param other The other PipelineProfile
+     *
+     * @throws invalid_argument iff other has other stages or buckets
+     */
+    void Merge(const PipelineProfile &other);
+
+    /**
+     * Removes every timing and count, keeping the stages
+     */
+    void Reset();
+
+    /**
+     * Writes this as JSON, with the count, mean, p50, p99 and max of every
+     * histogram (in ns) and every counter
+     *
+     * @param out The stream to write to
+     */
+    void WriteJson(std::ostream &out) const;
+
+    /// Returns every stage, in order
+    const std::vector<StageProfile> &Stages() const { return this->stages; }
+    /// Returns the time of each frame, in ns
+    const Histogram &Frames() const { return this->frames; }
+
+ private:
+    /// The buckets of every histogram
+    HistogramOptions options;
+    /// The stages, in order
+    std::vector<StageProfile> stages;
+    /// The time of each frame, in ns
+    Histogram frames;
+};
+
+/**
+ * Provides a readable name of a type
+ *
+ * @param name The name of the type, as given by typeid
+ *
+ * @return The demangled name (or name itself, if it cannot be demangled)
+ */
+std::string TypeName(const char *name);
+
+}  // namespace found
+
+#endif
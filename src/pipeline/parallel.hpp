@@ -0,0 +1,150 @@
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <stddef.h>
+
+#include <vector>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+
+#include "pipeline/pipeline.hpp"
+#include "pipeline/scheduler.hpp"
+
+namespace found {
+
+/**
+ * ParallelStage is a composite Stage that fans one input out to
+ * several branches (e.g. several distance algorithms), runs them at
+ * the same time, and then hands their outputs, in the order the
+ * branches were added, to a reducer that fuses them into one (e.g.
+ * a DistanceFusionAlgorithm). A run takes as long as its slowest
+ * branch, rather than all of them together.
+ *
+ * The first branch runs on the calling thread, and every other
+ * branch is a task of a TaskScheduler.
+ *
+ * @param Input The input of this, and of every branch
+ * @param Intermediate The output of every branch
+ * @param Output The output of the reducer, and of this
+ *
+ * @note A branch is only ever run by one thread at a time, so branches
+ * do not need to be thread safe, but no stage may be shared between two
+ * branches. Only the first branch and the reducer take scratch memory
+ * from the arena of the Pipeline this runs in; the others use their own.
+ */
+template<typename Input, typename Intermediate, typename Output>
+class ParallelStage : public Stage<Input, Output> {
+ public:
+    /**
+     * Constructs a ParallelStage
+     *
+     * @param reducer The stage that fuses the outputs of the branches
+     * @param scheduler The scheduler to run the branches on
+     */
+    explicit ParallelStage(Stage<std::vector<Intermediate>, Output> &reducer,
+                           TaskScheduler &scheduler = TaskScheduler::Default())
+        : reducer(reducer), scheduler(scheduler) {}
+
+    /**
+     * Adds a branch to this
+     *
+     * @param branch The stage to run on every input
+     *
+     * @return this, with the new branch added (for chaining)
+     */
+    ParallelStage &AddBranch(Stage<Input, Intermediate> &branch) {
+        // Only the first branch runs on the thread of the Pipeline
+        branch.SetArena(this->branches.empty() ? &this->Scratch() : nullptr);
+        this->branches.push_back(branch);
+        this->results.resize(this->branches.size());
+        return *this;
+    }
+
+    /**
+     * Runs every branch on an input, then fuses their outputs
+     *
+     * @param input The input to every branch
+     *
+     * @return The output of the reducer
+     *
+     * @throws invalid_argument iff this has no branches
+     * @throws Anything a branch threw (the first one to fail), or the reducer threw
+     */
+    Output Run(const Input &input) override {
+        this->Fork(input);
+        return this->reducer.Run(this->results);
+    }
+
+    /**
+     * Runs every branch on an input, then fuses their outputs into an existing output
+     *
+     * @param input The input to every branch
+     * @param output The variable to place the output of the reducer in
+     *
+     * @throws invalid_argument iff this has no branches
+     * @throws Anything a branch threw (the first one to fail), or the reducer threw
+     */
+    void RunInto(const Input &input, Output &output) override {
+        this->Fork(input);
+        this->reducer.RunInto(this->results, output);
+    }
+
+    /**
+     * Makes the first branch and the reducer take their scratch memory
+     * from the arena of the Pipeline this runs in
+     *
+     * @param arena The arena (nullptr for the one of this)
+     */
+    void SetArena(Arena *arena) override {
+        this->arena = arena;
+        if (!this->branches.empty()) this->branches[0].get().SetArena(&this->Scratch());
+        this->reducer.SetArena(&this->Scratch());
+    }
+
+    /**
+     * Provides the number of branches of this
+     *
+     * @return The number of branches
+     */
+    size_t Branches() const { return this->branches.size(); }
+
+ private:
+    /**
+     * Runs every branch on an input, and waits for all of them
+     *
+     * @param input The input to every branch
+     *
+     * @throws invalid_argument iff this has no branches
+     * @throws Anything a branch threw (the first one to fail)
+     */
+    void Fork(const Input &input) {
+        if (this->branches.empty()) throw std::invalid_argument("A ParallelStage needs at least one branch");
+        TaskGroup group(this->scheduler);
+        for (size_t i = 1; i < this->branches.size(); i++) {
+            group.Run([this, &input, i]() { this->branches[i].get().RunInto(input, this->results[i]); });
+        }
+        // The other branches must finish even if this one throws, since they use input
+        std::exception_ptr error;
+        try {
+            this->branches[0].get().RunInto(input, this->results[0]);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        group.Wait();
+        if (error) std::rethrow_exception(error);
+    }
+
+    /// The branches of this
+    std::vector<std::reference_wrapper<Stage<Input, Intermediate>>> branches;
+    /// The stage that fuses the outputs of the branches
+    Stage<std::vector<Intermediate>, Output> &reducer;
+    /// The scheduler the branches run on
+    TaskScheduler &scheduler;
+    /// The output of each branch, reused from one run to the next
+    std::vector<Intermediate> results;
+};
+
+}  // namespace found
+
+#endif
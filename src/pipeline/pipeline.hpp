@@ -1,12 +1,19 @@
 #ifndef PIPELINE_H_
 #define PIPELINE_H_
 
+#include <stdint.h>
+
 #include <vector>
 #include <functional>
 #include <stdexcept>
+#include <string>
+#include <typeinfo>
 #include <utility>
 #include <iostream>
 
+#include "common/arena.hpp"
+#include "pipeline/instrumentation.hpp"
+
 namespace found {
 
 /**
@@ -19,8 +26,67 @@ class Action {
      * Performs some action
      */
     virtual void DoAction() = 0;
+
+    /**
+     * Gives this the arena of the Pipeline it runs in, to take the
+     * scratch memory of each run from
+     *
+     * @param arena The arena (nullptr for one of this' own)
+     *
+     * @note Stages that run other stages should override this, and
+     * pass the arena on to them
+     */
+    virtual void SetArena(Arena *arena) { this->arena = arena; }
+
+    /**
+     * Records the counters of the last action (e.g. the number of
+     * points found, or solver iterations)
+     *
+     * @param counters The counters to record into
+     *
+     * @note This is declared in every build, so that every Action has
+     * the same layout whether or not instrumentation is compiled in, but
+     * only a Pipeline with instrumentation calls it
+     */
+    virtual void Count(CounterSet &counters) const { (void) counters; }
+
+ protected:
+    /**
+     * Provides the arena for the scratch memory of a run (i.e. rays,
+     * candidate edges or filtered tiles)
+     *
+     * @return The arena of the Pipeline this runs in, or one of this' own
+     *
+     * @note The arena is reset at the end of every run of the Pipeline,
+     * so nothing that outlives a run (like an output) may be taken from it.
+     * Stages that also run on their own should free what they take with an
+     * ArenaScope.
+     */
+    Arena &Scratch() { return this->arena != nullptr ? *this->arena : this->ownArena; }
+
+    /// The arena of the Pipeline this runs in (nullptr if there is none)
+    Arena *arena = nullptr;
+    /// The arena of this, if it does not run in a Pipeline
+    Arena ownArena;
 };
 
+/**
+ * Records the number of items of an output that is a container
+ *
+ * @param output The output
+ * @param counters The counters to record into
+ */
+template<typename Output>
+auto CountItems(const Output &output, CounterSet &counters, int) -> decltype(output.size(), void()) {
+    counters.Record("items", static_cast<uint64_t>(output.size()));
+}
+
+/**
+ * Records nothing for an output that is not a container
+ */
+template<typename Output>
+void CountItems(const Output &, CounterSet &, long) {}  // NOLINT
+
 /**
  * A Stage is a data structure that
  * wraps a function, and taking in
@@ -32,6 +98,11 @@ class Action {
 template<typename Input, typename Output>
 class Stage : public Action {
  public:
+    /// The type of input this Stage accepts
+    typedef Input InputType;
+    /// The type of output this Stage produces
+    typedef Output OutputType;
+
     /**
      * Constructs a new Stage
      */
@@ -52,11 +123,37 @@ class Stage : public Action {
     virtual Output Run(const Input &input) = 0;
 
     /**
-     * Executes Run (with a stored input and storing the output)
+     * Runs this stage, placing the result into an existing output
+     *
+     * @param input The input to the stage
+     * @param output The variable to place the output of this stage in
+     *
+     * @note By default, this moves the result of Run into output. Stages
+     * that produce containers (i.e. Points) should override this to refill
+     * output in place, so that its storage is reused from one run to the
+     * next and steady-state runs do not allocate.
+     */
+    virtual void RunInto(const Input &input, Output &output) {
+        output = this->Run(input);
+    }
+
+    /**
+     * Executes RunInto (with a stored input and storing the output)
      */
-    void DoAction() override {  // GCOVR_EXCL_START
-      *this->product = this->Run(this->resource);
-    };  // GCOVR_EXCL_STOP
+    void DoAction() override {
+      this->RunInto(this->resource, *this->product);
+    }
+
+    /**
+     * Records the number of items of the last output, if it is a container
+     *
+     * @param counters The counters to record into
+     *
+     * @note Stages with more to report should override this, and call it
+     */
+    void Count(CounterSet &counters) const override {
+        CountItems(*this->product, counters, 0);
+    }
 
     /**
      * Returns the stored input of this
@@ -111,6 +208,8 @@ class Pipeline : public Stage<Input, Output> {
      * Adds a stage to this pipeline
      * 
      * @param stage The stage to add to the pipeline
+     * @param name The name of the stage in the profile of this
+     * (its type, by default)
      * 
      * @return this, with the new stage added (for chaining)
      * 
@@ -121,7 +220,7 @@ class Pipeline : public Stage<Input, Output> {
      * @pre Iff this method has already been called, O from the last
      * parameter must match I of the next parameter
      */
-    template<typename I, typename O> Pipeline &AddStage(Stage<I, O> &stage) {
+    template<typename I, typename O> Pipeline &AddStage(Stage<I, O> &stage, const std::string &name = "") {
         // Check the input
         if (this->ready) throw std::invalid_argument("Pipeline is already ready");
         if (this->stages.empty()) {
@@ -131,8 +230,14 @@ class Pipeline : public Stage<Input, Output> {
             // Chain here, and blindly trust the user
             *this->lastProduct = static_cast<void *>(&stage.GetResource());
         }
-        // Add to our list
+        // Add to our list, sharing the scratch memory of this
         this->stages.push_back(stage);
+        stage.SetArena(&this->Scratch());
+#ifdef FOUND_INSTRUMENTATION
+        this->profile.AddStage(name.empty() ? TypeName(typeid(stage).name()) : name);
+#else
+        (void) name;
+#endif
         // Now, reset the lastProduct to be of this stage
         this->lastProduct = reinterpret_cast<void **>(&stage.GetProduct());
         // Return the pipeline for chaining
@@ -144,6 +249,8 @@ class Pipeline : public Stage<Input, Output> {
      * preventing further manipulation of the Pipeline
      * 
      * @param stage The stage to add
+     * @param name The name of the stage in the profile of this
+     * (its type, by default)
      * 
      * @return this, with the last stage added (to run this::Run)
      * 
@@ -151,8 +258,8 @@ class Pipeline : public Stage<Input, Output> {
      * method is called, and I does not match Input OR if the Pipeline
      * is already complete (aka this::Complete was called successfully)
      */
-    template<typename I> Pipeline &Complete(Stage<I, Output> &stage) {
-        this->AddStage(stage);
+    template<typename I> Pipeline &Complete(Stage<I, Output> &stage, const std::string &name = "") {
+        this->AddStage(stage, name);
         this->ready = true;
         stage.GetProduct() = &this->finalProduct;
         return *this;
@@ -175,16 +282,137 @@ class Pipeline : public Stage<Input, Output> {
      * been called successfully
      */
     Output Run(const Input &input) override {
-        if (!this->ready) throw std::runtime_error("This is an illegal action: the pipeline is not ready yet");
-        this->resource = input;
+        this->CheckReady();
         *this->firstResource = input;
+        this->Execute();
+        return this->finalProduct;
+    }
+
+    /**
+     * Executes this Pipeline on an input that is no longer needed
+     *
+     * @param input The input to this Pipeline, which is moved into
+     * the first stage instead of being copied
+     *
+     * @return The output of the Pipeline
+     *
+     * @pre The pipeline must have been completed successfully
+     */
+    Output Run(Input &&input) {
+        this->CheckReady();
+        *this->firstResource = std::move(input);
+        this->Execute();
+        return this->finalProduct;
+    }
+
+    /**
+     * Executes this Pipeline, placing the result into an existing output
+     *
+     * @param input The input to this Pipeline
+     * @param output The variable to place the output of this Pipeline in
+     *
+     * @note The final product is swapped (not copied) with output, so
+     * calling this repeatedly with the same output variable alternates
+     * between two buffers, and stages that override RunInto reuse them
+     *
+     * @pre The pipeline must have been completed successfully
+     */
+    void RunInto(const Input &input, Output &output) override {
+        this->CheckReady();
+        *this->firstResource = input;
+        this->Execute();
+        std::swap(output, this->finalProduct);
+    }
+
+    /**
+     * Executes this Pipeline as a stage of another Pipeline
+     *
+     * @note The stored input is moved into the first stage, since
+     * the enclosing Pipeline overwrites it on its next run anyway
+     */
+    void DoAction() override {
+        this->CheckReady();
+        *this->firstResource = std::move(this->resource);
+        this->Execute();
+        std::swap(*this->product, this->finalProduct);
+    }
+
+    /**
+     * Makes every stage of this take its scratch memory from the arena
+     * of the Pipeline this runs in
+     *
+     * @param arena The arena (nullptr for the one of this)
+     */
+    void SetArena(Arena *arena) override {
+        this->arena = arena;
+        for (Action &stage : this->stages) stage.SetArena(&this->Scratch());
+    }
+
+    /**
+     * Provides the arena that every stage of this takes its scratch memory from
+     *
+     * @return The arena, which is emptied at the end of every run
+     */
+    const Arena &GetArena() { return this->Scratch(); }
+
+    /**
+     * Provides the timings and counters of every run of this
+     *
+     * @return The profile of this, which is empty unless
+     * instrumentation is compiled in (see kInstrumentationEnabled)
+     */
+    const PipelineProfile &GetProfile() const { return this->profile; }
+
+    /**
+     * Changes the histogram buckets of the profile of this, and
+     * removes every timing and count from it
+     *
+     * @param options The buckets
+     *
+     * @throws invalid_argument iff options is invalid
+     */
+    void SetHistogramOptions(const HistogramOptions &options) { this->profile.Configure(options); }
+
+    /**
+     * Removes every timing and count from the profile of this
+     */
+    void ResetProfile() { this->profile.Reset(); }
+
+ private:
+    /**
+     * Ensures this is ready to run
+     *
+     * @throws runtime_error iff this::Complete was not called successfully
+     */
+    void CheckReady() const {
+        if (!this->ready) throw std::runtime_error("This is an illegal action: the pipeline is not ready yet");
+    }
+
+    /**
+     * Runs every stage of this, in order, then frees the scratch memory
+     * of the run (unless this runs in another Pipeline, which does)
+     */
+    void Execute() {
+        // Also frees what a run that threw left behind
+        if (this->arena == nullptr) this->ownArena.Reset();
+#ifdef FOUND_INSTRUMENTATION
+        ProfileClock::time_point frameStart = ProfileClock::now();
+        for (size_t i = 0; i < this->stages.size(); i++) {
+            Action &stage = this->stages[i];
+            ProfileClock::time_point start = ProfileClock::now();
+            stage.DoAction();
+            this->profile.RecordStage(i, ProfileClock::now() - start);
+            stage.Count(this->profile.Counters(i));
+        }
+        this->profile.RecordFrame(ProfileClock::now() - frameStart);
+#else
         for (Action &stage : this->stages) {
            stage.DoAction();
         }
-        return this->finalProduct;
+#endif
+        if (this->arena == nullptr) this->ownArena.Reset();
     }
 
- private:
     /// The stages of this
     std::vector<std::reference_wrapper<Action>> stages;
     /// The pointer to the variable that will store the first input
@@ -195,6 +423,8 @@ class Pipeline : public Stage<Input, Output> {
     void **lastProduct = nullptr;
     /// An indicator for if this Pipeline is ready
     bool ready;
+    /// The timings and counters of every run of this
+    PipelineProfile profile;
 };
 
 }  // namespace found
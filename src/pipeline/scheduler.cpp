@@ -0,0 +1,202 @@
+#include "pipeline/scheduler.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace found {
+
+/// The scheduler whose worker the current thread is (nullptr if it is not a worker)
+static thread_local const TaskScheduler *currentScheduler = nullptr;
+/// The index of the worker the current thread is
+static thread_local size_t currentWorker = 0;
+
+/**
+ * Provides the cores the current process may run on
+ *
+ * @return The indices of the cores (empty if they are not known)
+ */
+static std::vector<int> AvailableCores() {
+    std::vector<int> cores;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int core = 0; core < CPU_SETSIZE; core++) {
+            if (CPU_ISSET(core, &set)) cores.push_back(core);
+        }
+    }
+#endif
+    return cores;
+}
+
+/**
+ * Pins a thread to a core
+ *
+ * @param thread The thread
+ * @param core The index of the core
+ *
+ * @note Does nothing where threads cannot be pinned, or if the core is not available
+ */
+static void PinThread(std::thread &thread, int core) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void) thread;
+    (void) core;
+#endif
+}
+
+TaskScheduler::TaskScheduler(size_t workers, bool pin) : pinned(false), queued(0), next(0), stopping(false) {
+    this->Start(workers, pin);
+}
+
+TaskScheduler::~TaskScheduler() {
+    this->Stop();
+}
+
+void TaskScheduler::Configure(size_t workers, bool pin) {
+    this->Stop();
+    this->Start(workers, pin);
+}
+
+TaskScheduler &TaskScheduler::Default() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+void TaskScheduler::Start(size_t workers, bool pin) {
+    if (workers == 0) workers = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<int> cores;
+    if (pin) cores = AvailableCores();
+    this->pinned = !cores.empty();
+
+    for (size_t i = 0; i < workers; i++) {
+        this->queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+    for (size_t i = 0; i < workers; i++) {
+        this->threads.push_back(std::thread(&TaskScheduler::Work, this, i));
+        if (this->pinned) PinThread(this->threads.back(), cores[i % cores.size()]);
+    }
+}
+
+void TaskScheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread &thread : this->threads) thread.join();
+    this->threads.clear();
+    this->queues.clear();
+    this->stopping = false;
+}
+
+void TaskScheduler::Submit(Task &&task) {
+    {
+        // Counted before it is queued, so that a thief can never take the count below zero
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->queued++;
+    }
+    // Work made by a task stays on its worker, while its data is in cache
+    if (currentScheduler == this) {
+        this->queues[currentWorker]->PushFront(std::move(task));
+    } else {
+        this->queues[this->next++ % this->queues.size()]->PushBack(std::move(task));
+    }
+    this->wake.notify_one();
+}
+
+bool TaskScheduler::Take(Task &task) {
+    size_t count = this->queues.size();
+    size_t own = currentScheduler == this ? currentWorker : 0;
+    if (currentScheduler == this && this->queues[own]->PopFront(task)) {
+        this->queued--;
+        return true;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (this->queues[(own + i) % count]->StealBack(task)) {
+            this->queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::Execute(Task &task) {
+    TaskGroup *group = task.group;
+    try {
+        task.function();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(group->errorMutex);
+        if (!group->error) group->error = std::current_exception();
+    }
+    // Frees what the task holds before its group may end
+    task.function = nullptr;
+    if (--group->pending == 0) {
+        // Taking the lock orders this with a thread about to wait for the group
+        { std::lock_guard<std::mutex> lock(this->mutex); }
+        this->wake.notify_all();
+    }
+}
+
+void TaskScheduler::Work(size_t index) {
+    currentScheduler = this;
+    currentWorker = index;
+    Task task;
+    while (true) {
+        if (this->Take(task)) {
+            this->Execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->wake.wait(lock, [this] { return this->stopping || this->queued.load() > 0; });
+        if (this->stopping && this->queued.load() == 0) return;
+    }
+}
+
+TaskGroup::~TaskGroup() {
+    try {
+        this->Wait();
+    } catch (...) {}
+}
+
+void TaskGroup::Run(std::function<void()> task) {
+    this->pending++;
+    this->scheduler.Submit({std::move(task), this});
+}
+
+void TaskGroup::Wait() {
+    TaskScheduler::Task task;
+    while (this->pending.load() > 0) {
+        if (this->scheduler.Take(task)) {
+            this->scheduler.Execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->scheduler.mutex);
+        this->scheduler.wake.wait(lock, [this] {
+            return this->pending.load() == 0 || this->scheduler.queued.load() > 0;
+        });
+    }
+    std::exception_ptr thrown;
+    {
+        std::lock_guard<std::mutex> lock(this->errorMutex);
+        std::swap(thrown, this->error);
+    }
+    if (thrown) std::rethrow_exception(thrown);
+}
+
+}  // namespace found
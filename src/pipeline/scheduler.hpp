@@ -0,0 +1,270 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace found {
+
+class TaskGroup;
+
+/**
+ * A TaskScheduler is a pool of persistent worker threads that runs
+ * short tasks (a branch of a ParallelStage, a band of an image, a
+ * span of an ephemeris, ...), so that features that need threads
+ * share the cores instead of each starting threads of their own.
+ *
+ * Every worker has a queue of its own. A task submitted from a worker
+ * goes to the front of its queue, where that worker takes it next
+ * (while its data is still in cache), and idle workers steal tasks
+ * from the back of the other queues. Tasks submitted from other
+ * threads are spread over the queues in turn.
+ *
+ * Tasks are submitted and waited for through a TaskGroup. Threads
+ * that wait for a group run queued tasks in the meantime, so tasks may
+ * themselves wait for groups of their own without starving the pool.
+ *
+ * @note Tasks should not block for long (e.g. on I/O, or on another
+ * thread that is not a task), since that takes a worker away from
+ * every other user of the pool
+ */
+class TaskScheduler {
+ public:
+    /**
+     * Creates a TaskScheduler, and starts its workers
+     *
+     * @param workers The number of worker threads (0 for one per core)
+     * @param pin true to pin each worker to a core (on Linux only), so
+     * that it keeps its cache
+     */
+    explicit TaskScheduler(size_t workers = 0, bool pin = false);
+
+    /**
+     * Destroys this, after its workers finish every queued task
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /**
+     * Replaces the workers of this
+     *
+     * @param workers The number of worker threads (0 for one per core)
+     * @param pin true to pin each worker to a core (on Linux only)
+     *
+     * @pre No task of this is queued or running (e.g. at the start of the program)
+     */
+    void Configure(size_t workers, bool pin);
+
+    /// Returns the number of worker threads of this
+    size_t Workers() const { return this->threads.size(); }
+    /// Returns true iff the workers of this are pinned to cores
+    bool Pinned() const { return this->pinned; }
+
+    /**
+     * Provides the TaskScheduler that the library submits to, unless
+     * given another one
+     *
+     * @return The shared TaskScheduler, with one worker per core until
+     * it is configured otherwise (e.g. by the --threads of the command line)
+     */
+    static TaskScheduler &Default();
+
+ private:
+    friend class TaskGroup;
+
+    /**
+     * A Task is a function to run, and the group it belongs to
+     */
+    struct Task {
+        /// The function to run
+        std::function<void()> function;
+        /// The group that waits for function
+        TaskGroup *group;
+    };
+
+    /**
+     * A TaskQueue is the queue of tasks of one worker
+     */
+    class TaskQueue {
+     public:
+        /**
+         * Places a task at the front of this, to be taken next by its owner
+         *
+         * @param task The task
+         */
+        void PushFront(Task &&task) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->tasks.push_front(std::move(task));
+        }
+
+        /**
+         * Places a task at the back of this
+         *
+         * @param task The task
+         */
+        void PushBack(Task &&task) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->tasks.push_back(std::move(task));
+        }
+
+        /**
+         * Takes the task at the front of this, for its owner
+         *
+         * @param task The variable to move the task into
+         *
+         * @return true iff there was a task to take
+         */
+        bool PopFront(Task &task) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->tasks.empty()) return false;
+            task = std::move(this->tasks.front());
+            this->tasks.pop_front();
+            return true;
+        }
+
+        /**
+         * Takes the task at the back of this, for another thread
+         *
+         * @param task The variable to move the task into
+         *
+         * @return true iff there was a task to take
+         */
+        bool StealBack(Task &task) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->tasks.empty()) return false;
+            task = std::move(this->tasks.back());
+            this->tasks.pop_back();
+            return true;
+        }
+
+     private:
+        /// The tasks of this
+        std::deque<Task> tasks;
+        /// The lock guarding tasks
+        std::mutex mutex;
+    };
+
+    /**
+     * Starts the workers of this
+     *
+     * @param workers The number of worker threads (0 for one per core)
+     * @param pin true to pin each worker to a core
+     */
+    void Start(size_t workers, bool pin);
+
+    /**
+     * Stops the workers of this, once every queued task has run
+     */
+    void Stop();
+
+    /**
+     * Queues a task
+     *
+     * @param task The task
+     */
+    void Submit(Task &&task);
+
+    /**
+     * Takes a queued task, from the queue of the calling worker first
+     *
+     * @param task The variable to move the task into
+     *
+     * @return true iff there was a task to take
+     */
+    bool Take(Task &task);
+
+    /**
+     * Runs a task, and tells its group
+     *
+     * @param task The task
+     */
+    void Execute(Task &task);
+
+    /**
+     * Runs tasks on a worker thread until this stops
+     *
+     * @param index The index of the worker
+     */
+    void Work(size_t index);
+
+    /// The queue of every worker
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    /// The worker threads
+    std::vector<std::thread> threads;
+    /// Whether the workers are pinned to cores
+    bool pinned;
+    /// The number of queued tasks
+    std::atomic<size_t> queued;
+    /// The queue that the next task from outside of the workers goes to
+    std::atomic<size_t> next;
+    /// An indicator for if the workers should stop
+    bool stopping;
+    /// The lock that threads wait for tasks with
+    std::mutex mutex;
+    /// Signalled when a task is queued, a group finishes, or this stops
+    std::condition_variable wake;
+};
+
+/**
+ * A TaskGroup is a set of tasks that run on a TaskScheduler, and that
+ * are waited for together
+ */
+class TaskGroup {
+ public:
+    /**
+     * Creates an empty TaskGroup
+     *
+     * @param scheduler The scheduler to run the tasks on
+     */
+    explicit TaskGroup(TaskScheduler &scheduler = TaskScheduler::Default())
+        : scheduler(scheduler), pending(0) {}
+
+    /**
+     * Destroys this, after waiting for every task of it (whatever they throw)
+     */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    /**
+     * Queues a task in this
+     *
+     * @param task The task, which may run on any worker (or on a thread that waits)
+     */
+    void Run(std::function<void()> task);
+
+    /**
+     * Waits for every task of this, running queued tasks in the meantime
+     *
+     * @throws Anything the first task to fail threw, after every task of this is done
+     */
+    void Wait();
+
+ private:
+    friend class TaskScheduler;
+
+    /// The scheduler the tasks run on
+    TaskScheduler &scheduler;
+    /// The number of tasks that have not finished
+    std::atomic<size_t> pending;
+    /// What the first task to fail threw
+    std::exception_ptr error;
+    /// The lock guarding error
+    std::mutex errorMutex;
+};
+
+}  // namespace found
+
+#endif
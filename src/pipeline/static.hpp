@@ -0,0 +1,182 @@
+#ifndef STATIC_H_
+#define STATIC_H_
+
+#include <type_traits>
+
+#include "pipeline/pipeline.hpp"
+
+namespace found {
+
+/**
+ * CompatibleStages tells whether a list of stage types can be
+ * chained, i.e. whether the OutputType of every stage is the
+ * InputType of the stage after it
+ *
+ * @param Stages The stage types, in order
+ */
+template<typename... Stages>
+struct CompatibleStages;
+
+/**
+ * A single stage is always compatible with itself
+ */
+template<typename Last>
+struct CompatibleStages<Last> : std::true_type {};
+
+/**
+ * Two or more stages are compatible iff the first feeds the
+ * second, and the rest are compatible
+ */
+template<typename First, typename Second, typename... Rest>
+struct CompatibleStages<First, Second, Rest...>
+    : std::integral_constant<bool,
+                             std::is_same<typename First::OutputType, typename Second::InputType>::value &&
+                             CompatibleStages<Second, Rest...>::value> {};
+
+/**
+ * A StageChain holds references to a list of stages and runs
+ * them one after the other. Every call is a qualified (non-virtual)
+ * call on the concrete stage type, so the compiler is free to inline
+ * across stage boundaries, and intermediate products are handed over
+ * as temporaries instead of being copied into stored resources.
+ *
+ * @param Head The first stage type
+ * @param Tail The remaining stage types
+ */
+template<typename Head, typename... Tail>
+class StageChain {
+ public:
+    /// The input of the first stage
+    typedef typename Head::InputType InputType;
+    /// The output of the last stage
+    typedef typename StageChain<Tail...>::OutputType OutputType;
+
+    static_assert(std::is_same<typename Head::OutputType, typename StageChain<Tail...>::InputType>::value,
+                  "The Output of each stage must match the Input of the next stage");
+
+    /**
+     * Constructs a StageChain
+     *
+     * @param head The first stage
+     * @param tail The remaining stages
+     */
+    StageChain(Head &head, Tail &...tail) : head(head), tail(tail...) {}  // NOLINT
+
+    /**
+     * Runs every stage of this
+     *
+     * @param input The input to the first stage
+     *
+     * @return The output of the last stage
+     */
+    OutputType Run(const InputType &input) {
+        return this->tail.Run(this->head.Head::Run(input));
+    }
+
+ private:
+    /// The first stage
+    Head &head;
+    /// The remaining stages
+    StageChain<Tail...> tail;
+};
+
+/**
+ * The last link of a StageChain
+ *
+ * @param Last The last stage type
+ */
+template<typename Last>
+class StageChain<Last> {
+ public:
+    /// The input of this stage
+    typedef typename Last::InputType InputType;
+    /// The output of this stage
+    typedef typename Last::OutputType OutputType;
+
+    /**
+     * Constructs a StageChain
+     *
+     * @param last The last stage
+     */
+    explicit StageChain(Last &last) : last(last) {}
+
+    /**
+     * Runs the last stage
+     *
+     * @param input The input to the last stage
+     *
+     * @return The output of the last stage
+     */
+    OutputType Run(const InputType &input) {
+        return this->last.Last::Run(input);
+    }
+
+ private:
+    /// The last stage
+    Last &last;
+};
+
+/**
+ * StaticPipeline is the compile-time counterpart of Pipeline. The
+ * stages are given as template parameters, e.g.
+ * StaticPipeline<SimpleEdgeDetectionAlgorithm, SphericalDistanceDeterminationAlgorithm>,
+ * so mismatched stages are a compile error instead of a runtime
+ * std::invalid_argument, and running it costs no virtual calls
+ * between stages.
+ *
+ * A StaticPipeline is itself a Stage, so it can be nested inside a
+ * Pipeline (at the cost of one virtual call per run).
+ *
+ * @param Stages The stage types, in order
+ *
+ * @pre Each stage given to this must be of exactly the type listed
+ * in Stages (not a subclass of it), since stages are called without
+ * virtual dispatch
+ */
+template<typename... Stages>
+class StaticPipeline final
+    : public Stage<typename StageChain<Stages...>::InputType, typename StageChain<Stages...>::OutputType> {
+ public:
+    /// The input of this StaticPipeline
+    typedef typename StageChain<Stages...>::InputType InputType;
+    /// The output of this StaticPipeline
+    typedef typename StageChain<Stages...>::OutputType OutputType;
+
+    /**
+     * Constructs a StaticPipeline
+     *
+     * @param stages The stages of this, in order
+     */
+    explicit StaticPipeline(Stages &...stages) : chain(stages...) {}
+
+    /**
+     * Executes this StaticPipeline
+     *
+     * @param input The input to the first stage
+     *
+     * @return The output of the last stage
+     */
+    OutputType Run(const InputType &input) override {
+        return this->chain.Run(input);
+    }
+
+ private:
+    /// The stages of this
+    StageChain<Stages...> chain;
+};
+
+/**
+ * Creates a StaticPipeline, deducing its stage types
+ *
+ * @param stages The stages of the pipeline, in order
+ *
+ * @return A StaticPipeline running stages
+ */
+template<typename... Stages>
+StaticPipeline<Stages...> MakeStaticPipeline(Stages &...stages) {
+    return StaticPipeline<Stages...>(stages...);
+}
+
+}  // namespace found
+
+#endif
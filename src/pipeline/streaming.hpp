@@ -0,0 +1,421 @@
+#ifndef STREAMING_H_
+#define STREAMING_H_
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
+
+#include "pipeline/pipeline.hpp"
+
+namespace found {
+
+/**
+ * A BoundedBuffer is a fixed-capacity, thread-safe ring
+ * buffer that hands items from one thread to another.
+ * Producers block while it is full, and consumers block
+ * while it is empty.
+ *
+ * @param T The type of item held in the buffer
+ *
+ * @note Once closed, a BoundedBuffer refuses new items,
+ * but still hands out the ones it already holds
+ */
+template<typename T>
+class BoundedBuffer {
+ public:
+    /**
+     * Constructs a BoundedBuffer
+     *
+     * @param capacity The maximum number of items this can hold
+     *
+     * @throws invalid_argument iff capacity is 0
+     */
+    explicit BoundedBuffer(size_t capacity)
+        : slots(capacity), head(0), count(0), closed(false) {
+        if (capacity == 0) throw std::invalid_argument("A BoundedBuffer must hold at least one item");
+    }
+
+    /**
+     * Places an item at the back of this, waiting for space
+     * if this is full
+     *
+     * @param item The item to place
+     *
+     * @return true iff item was placed, and false if this was
+     * closed before space became available
+     */
+    bool Push(T &&item) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->notFull.wait(lock, [this] { return this->closed || this->count < this->slots.size(); });
+        if (this->closed) return false;
+        this->slots[(this->head + this->count) % this->slots.size()] = std::move(item);
+        this->count++;
+        lock.unlock();
+        this->notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * Takes an item from the front of this, waiting for one
+     * if this is empty
+     *
+     * @param item The variable to move the item into
+     *
+     * @return true iff an item was taken, and false if this
+     * is closed and has no items left
+     */
+    bool Pop(T &item) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->notEmpty.wait(lock, [this] { return this->closed || this->count > 0; });
+        return this->Take(lock, item);
+    }
+
+    /**
+     * Takes an item from the front of this without waiting
+     *
+     * @param item The variable to move the item into
+     *
+     * @return true iff an item was taken
+     */
+    bool TryPop(T &item) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        return this->Take(lock, item);
+    }
+
+    /**
+     * Closes this, waking up every thread waiting on it
+     *
+     * @post Push always fails, and Pop fails once this is empty
+     */
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->closed = true;
+        }
+        this->notFull.notify_all();
+        this->notEmpty.notify_all();
+    }
+
+ private:
+    /**
+     * Moves the front item out of this
+     *
+     * @param lock The held lock of this
+     * @param item The variable to move the item into
+     *
+     * @return true iff there was an item to take
+     */
+    bool Take(std::unique_lock<std::mutex> &lock, T &item) {
+        if (this->count == 0) return false;
+        item = std::move(this->slots[this->head]);
+        this->head = (this->head + 1) % this->slots.size();
+        this->count--;
+        lock.unlock();
+        this->notFull.notify_one();
+        return true;
+    }
+
+    /// The storage of this
+    std::vector<T> slots;
+    /// The index of the front item
+    size_t head;
+    /// The number of items held
+    size_t count;
+    /// An indicator for if this is closed
+    bool closed;
+    /// The lock guarding all fields above
+    std::mutex mutex;
+    /// Signalled when space frees up
+    std::condition_variable notFull;
+    /// Signalled when an item arrives
+    std::condition_variable notEmpty;
+};
+
+/**
+ * StreamingPipeline is the streaming counterpart of Pipeline.
+ * Every stage runs on its own worker thread, and consecutive
+ * stages are connected by BoundedBuffers, so that stage N can
+ * work on frame k while stage N + 1 works on frame k - 1. The
+ * throughput of a StreamingPipeline is that of its slowest
+ * stage, rather than that of all its stages combined.
+ *
+ * Inputs are fed with Push, and outputs are collected (in the
+ * same order) with Poll or TryPoll.
+ *
+ * @param Input The StreamingPipeline's Input
+ * @param Output The StreamingPipeline's Output
+ *
+ * @note Each stage is only ever run from a single thread, so
+ * stages do not need to be thread-safe. However, the same stage
+ * must not be added twice.
+ */
+template<typename Input, typename Output>
+class StreamingPipeline {
+ public:
+    /**
+     * Constructs a StreamingPipeline
+     *
+     * @param capacity The number of items that can wait between
+     * two stages (2 gives double buffering)
+     */
+    explicit StreamingPipeline(size_t capacity = 2)
+       : capacity(capacity), lastType(nullptr), ready(false), stopped(false) {}
+
+    /**
+     * Destroys this, stopping all workers
+     */
+    ~StreamingPipeline() {
+        this->Stop();
+    }
+
+    StreamingPipeline(const StreamingPipeline &) = delete;
+    StreamingPipeline &operator=(const StreamingPipeline &) = delete;
+
+    /**
+     * Adds a stage to this pipeline
+     *
+     * @param stage The stage to add to the pipeline
+     *
+     * @return this, with the new stage added (for chaining)
+     *
+     * @throws invalid_argument iff I does not match Input (for the
+     * first stage) or the O of the previous stage, OR if the
+     * StreamingPipeline is already complete
+     */
+    template<typename I, typename O> StreamingPipeline &AddStage(Stage<I, O> &stage) {
+        if (this->ready) throw std::invalid_argument("Pipeline is already ready");
+        std::shared_ptr<BoundedBuffer<I>> in;
+        if (this->workers.empty()) {
+            if (!std::is_same<Input, I>::value) throw std::invalid_argument("The initial input type is not correct");
+            in = std::make_shared<BoundedBuffer<I>>(this->capacity);
+            this->firstBuffer = std::static_pointer_cast<void>(in);
+        } else {
+            if (*this->lastType != typeid(I)) throw std::invalid_argument("The stage input type is not correct");
+            in = std::static_pointer_cast<BoundedBuffer<I>>(this->lastBuffer);
+        }
+        std::shared_ptr<BoundedBuffer<O>> out = std::make_shared<BoundedBuffer<O>>(this->capacity);
+        this->workers.push_back(std::unique_ptr<Worker>(new StageWorker<I, O>(stage, in, out, *this)));
+        this->lastBuffer = std::static_pointer_cast<void>(out);
+        this->lastType = &typeid(O);
+        return *this;
+    }
+
+    /**
+     * Adds the last stage to the pipeline and starts every worker
+     *
+     * @param stage The stage to add
+     *
+     * @return this, with the last stage added (to Push and Poll)
+     *
+     * @throws invalid_argument under the same conditions as AddStage
+     */
+    template<typename I> StreamingPipeline &Complete(Stage<I, Output> &stage) {
+        this->AddStage(stage);
+        this->input = std::static_pointer_cast<BoundedBuffer<Input>>(this->firstBuffer);
+        this->output = std::static_pointer_cast<BoundedBuffer<Output>>(this->lastBuffer);
+        this->ready = true;
+        for (std::unique_ptr<Worker> &worker : this->workers) {
+            this->threads.push_back(std::thread(&Worker::Work, worker.get()));
+        }
+        return *this;
+    }
+
+    /**
+     * Feeds an input to this pipeline, waiting if the first
+     * stage is still busy and its buffer is full
+     *
+     * @param in The input to feed
+     *
+     * @return true iff the input was accepted, and false
+     * if this is finished or stopped
+     *
+     * @throws runtime_error iff this is not complete
+     */
+    bool Push(Input in) {
+        if (!this->ready) throw std::runtime_error("This is an illegal action: the pipeline is not ready yet");
+        return this->input->Push(std::move(in));
+    }
+
+    /**
+     * Obtains the next output of this pipeline, waiting for
+     * one if none are ready
+     *
+     * @param out The variable to hold the output
+     *
+     * @return true iff an output was obtained, and false if
+     * every input has been processed after a Finish, or if this
+     * was stopped
+     *
+     * @throws runtime_error iff this is not complete
+     * @throws Anything a stage threw while running
+     */
+    bool Poll(Output &out) {
+        if (!this->ready) throw std::runtime_error("This is an illegal action: the pipeline is not ready yet");
+        bool result = this->output->Pop(out);
+        if (!result) this->Rethrow();
+        return result;
+    }
+
+    /**
+     * Obtains the next output of this pipeline, if one is ready
+     *
+     * @param out The variable to hold the output
+     *
+     * @return true iff an output was obtained
+     *
+     * @throws runtime_error iff this is not complete
+     * @throws Anything a stage threw while running
+     */
+    bool TryPoll(Output &out) {
+        if (!this->ready) throw std::runtime_error("This is an illegal action: the pipeline is not ready yet");
+        bool result = this->output->TryPop(out);
+        if (!result) this->Rethrow();
+        return result;
+    }
+
+    /**
+     * Signals that no more inputs will be pushed. Inputs that
+     * were already pushed still run to completion, and Poll
+     * returns false once all their outputs were taken.
+     */
+    void Finish() {
+        if (this->ready) this->input->Close();
+    }
+
+    /**
+     * Stops every worker, dropping any frames still in flight
+     *
+     * @post All workers have exited
+     */
+    void Stop() {
+        if (!this->ready || this->stopped) return;
+        this->stopped = true;
+        for (std::unique_ptr<Worker> &worker : this->workers) {
+            worker->Close();
+        }
+        for (std::thread &thread : this->threads) {
+            thread.join();
+        }
+    }
+
+ private:
+    /**
+     * A Worker is the loop that runs one stage
+     */
+    class Worker {
+     public:
+        virtual ~Worker() = default;
+
+        /**
+         * Runs the stage of this until its input closes
+         */
+        virtual void Work() = 0;
+
+        /**
+         * Closes both buffers of this
+         */
+        virtual void Close() = 0;
+    };
+
+    /**
+     * A StageWorker runs a Stage<I, O> between
+     * two BoundedBuffers
+     */
+    template<typename I, typename O>
+    class StageWorker : public Worker {
+     public:
+        StageWorker(Stage<I, O> &stage,
+                    std::shared_ptr<BoundedBuffer<I>> in,
+                    std::shared_ptr<BoundedBuffer<O>> out,
+                    StreamingPipeline &pipeline)
+            : stage(stage), in(in), out(out), pipeline(pipeline) {}
+
+        void Work() override {
+            I item;
+            try {
+                while (this->in->Pop(item)) {
+                    if (!this->out->Push(this->stage.Run(item))) break;
+                }
+            } catch (...) {
+                this->pipeline.Fail(std::current_exception());
+                return;
+            }
+            // Cascades the end of the stream down the pipeline
+            this->out->Close();
+        }
+
+        void Close() override {
+            this->in->Close();
+            this->out->Close();
+        }
+
+     private:
+        /// The stage this runs
+        Stage<I, O> &stage;
+        /// Where this takes inputs from
+        std::shared_ptr<BoundedBuffer<I>> in;
+        /// Where this places outputs into
+        std::shared_ptr<BoundedBuffer<O>> out;
+        /// The pipeline this belongs to
+        StreamingPipeline &pipeline;
+    };
+
+    /**
+     * Records the failure of a stage and closes every buffer
+     *
+     * @param exception The exception the stage threw
+     */
+    void Fail(std::exception_ptr exception) {
+        {
+            std::lock_guard<std::mutex> lock(this->errorMutex);
+            if (!this->error) this->error = exception;
+        }
+        for (std::unique_ptr<Worker> &worker : this->workers) {
+            worker->Close();
+        }
+    }
+
+    /**
+     * Rethrows the exception of a failed stage, if any
+     */
+    void Rethrow() {
+        std::lock_guard<std::mutex> lock(this->errorMutex);
+        if (this->error) std::rethrow_exception(this->error);
+    }
+
+    /// The capacity of each buffer
+    size_t capacity;
+    /// The workers of this (one per stage)
+    std::vector<std::unique_ptr<Worker>> workers;
+    /// The threads running the workers
+    std::vector<std::thread> threads;
+    /// The buffer feeding the first stage (type-erased while building)
+    std::shared_ptr<void> firstBuffer;
+    /// The buffer out of the last stage added (type-erased while building)
+    std::shared_ptr<void> lastBuffer;
+    /// The output type of the last stage added
+    const std::type_info *lastType;
+    /// The buffer feeding the first stage
+    std::shared_ptr<BoundedBuffer<Input>> input;
+    /// The buffer out of the last stage
+    std::shared_ptr<BoundedBuffer<Output>> output;
+    /// The first exception thrown by a stage
+    std::exception_ptr error;
+    /// The lock guarding error
+    std::mutex errorMutex;
+    /// An indicator for if this StreamingPipeline is ready
+    bool ready;
+    /// An indicator for if this StreamingPipeline was stopped
+    bool stopped;
+};
+
+}  // namespace found
+
+#endif
@@ -3,8 +3,15 @@
 
 #include <math.h>
 #include <assert.h>
+#include <string.h>
 #include <iostream>
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace found {
 
 ///////////////////////////////////
@@ -12,8 +19,9 @@ namespace found {
 ///////////////////////////////////
 
 /// Multiply two quaternions using the usual definition of quaternion multiplication (effectively composes rotations)
-Quaternion Quaternion::operator*(const Quaternion &other) const {
-    return Quaternion(
+template<typename T>
+BasicQuaternion<T> BasicQuaternion<T>::operator*(const BasicQuaternion<T> &other) const {
+    return BasicQuaternion<T>(
         real*other.real - i*other.i - j*other.j - k*other.k,
         real*other.i + other.real*i + j*other.k - k*other.j,
         real*other.j + other.real*j + k*other.i - i*other.k,
@@ -21,12 +29,14 @@ Quaternion Quaternion::operator*(const Quaternion &other) const {
 }
 
 /// Effectively computes a quaternion representing the inverse rotation of the original.
-Quaternion Quaternion::Conjugate() const {
-    return Quaternion(real, -i, -j, -k);
+template<typename T>
+BasicQuaternion<T> BasicQuaternion<T>::Conjugate() const {
+    return BasicQuaternion<T>(real, -i, -j, -k);
 }
 
 /// The vector formed by imaginary components of the quaternion. The axis of the represented rotation.
-Vec3 Quaternion::Vector() const {
+template<typename T>
+BasicVec3<T> BasicQuaternion<T>::Vector() const {
     return { i, j, k };
 }
 
@@ -35,7 +45,8 @@ Vec3 Quaternion::Vector() const {
  * 
  * @param vec The vector holding the imaginary quantities
  * */
-void Quaternion::SetVector(const Vec3 &vec) {
+template<typename T>
+void BasicQuaternion<T>::SetVector(const BasicVec3<T> &vec) {
     i = vec.x;
     j = vec.y;
     k = vec.z;
@@ -46,7 +57,8 @@ void Quaternion::SetVector(const Vec3 &vec) {
  * 
  * @param input The vector representing the imaginary part of the Quaternion to create
  * */
-Quaternion::Quaternion(const Vec3 &input) {
+template<typename T>
+BasicQuaternion<T>::BasicQuaternion(const BasicVec3<T> &input) {
     real = 0;
     SetVector(input);
 }
@@ -57,7 +69,8 @@ Quaternion::Quaternion(const Vec3 &input) {
  * @param input the axis about which theta is defined
  * @param theta the rotation about the input
 */
-Quaternion::Quaternion(const Vec3 &input, decimal theta) {
+template<typename T>
+BasicQuaternion<T>::BasicQuaternion(const BasicVec3<T> &input, T theta) {
     real = cos(theta/2);
     // the compiler will optimize it. Right?
     i = input.x * sin(theta/2);
@@ -72,9 +85,26 @@ Quaternion::Quaternion(const Vec3 &input, decimal theta) {
  * 
  * @return The input vector that has been rotated about this
 */
-Vec3 Quaternion::Rotate(const Vec3 &input) const {
+template<typename T>
+BasicVec3<T> BasicQuaternion<T>::Rotate(const BasicVec3<T> &input) const {
     // TODO: optimize
-    return ((*this)*Quaternion(input)*Conjugate()).Vector();
+    return ((*this)*BasicQuaternion<T>(input)*Conjugate()).Vector();
+}
+
+/**
+ * Rotates many vectors by this Quaternion at once
+ *
+ * @param x,y,z The components of the vectors to rotate
+ * @param count The number of vectors
+ * @param outX,outY,outZ The place to store the components of the rotated vectors
+ * (which may be x, y and z themselves)
+ *
+ * @note The rotation matrix of this is built once, and then applied to every vector
+*/
+template<typename T>
+void BasicQuaternion<T>::Rotate(const T *x, const T *y, const T *z, size_t count,
+                                 T *outX, T *outY, T *outZ) const {
+    QuaternionToDCM(*this).Multiply(x, y, z, count, outX, outY, outZ);
 }
 
 /**
@@ -82,7 +112,8 @@ Vec3 Quaternion::Rotate(const Vec3 &input) const {
  * 
  * @return The amount of rotations represented by this, in radians
 */
-decimal Quaternion::Angle() const {
+template<typename T>
+T BasicQuaternion<T>::Angle() const {
     if (real <= -1) {
         return 0;  // 180*2=360=0
     }
@@ -97,7 +128,8 @@ decimal Quaternion::Angle() const {
  * 
  * @post Changes this by altering the rotation angle of this by newAngle
 */
-void Quaternion::SetAngle(decimal newAngle) {
+template<typename T>
+void BasicQuaternion<T>::SetAngle(T newAngle) {
     real = cos(newAngle/2);
     SetVector(Vector().Normalize() * sin(newAngle/2));
 }
@@ -108,7 +140,8 @@ void Quaternion::SetAngle(decimal newAngle) {
  * @return true iff this is a unit Quaternion
  * 
 */
-bool Quaternion::IsUnit(decimal tolerance) const {
+template<typename T>
+bool BasicQuaternion<T>::IsUnit(T tolerance) const {
     return abs(i*i+j*j+k*k+real*real - 1) < tolerance;
 }
 
@@ -120,12 +153,13 @@ bool Quaternion::IsUnit(decimal tolerance) const {
  * is a canonicalized Quaternion already, and a new Quaternion if it is
  * not
  */
-Quaternion Quaternion::Canonicalize() const {
+template<typename T>
+BasicQuaternion<T> BasicQuaternion<T>::Canonicalize() const {
     if (real >= 0) {
         return *this;
     }
 
-    return Quaternion(-real, -i, -j, -k);
+    return BasicQuaternion<T>(-real, -i, -j, -k);
 }
 
 ///////////////////////////////////
@@ -138,7 +172,8 @@ Quaternion Quaternion::Canonicalize() const {
  * 
  * @return An EulerAngles object representing this in with Euler Angles
 */
-EulerAngles Quaternion::ToSpherical() const {
+template<typename T>
+EulerAngles BasicQuaternion<T>::ToSpherical() const {
     // Working out these equations would be a pain in the ass. Thankfully, this wikipedia page:
     // https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles#Quaternion_to_Euler_angles_conversion
     // uses almost exactly the same euler angle scheme that we do, so we copy their equations almost
@@ -146,17 +181,50 @@ EulerAngles Quaternion::ToSpherical() const {
     // and 2, we store the conjugate of the quaternion (double check why?), which means we need to
     // invert the final de and roll terms, as well as negate all the terms involving a mix between
     // the real and imaginary parts.
-    decimal ra = atan2(2*(-real*k+i*j), 1-2*(j*j+k*k));
+    T ra = atan2(2*(-real*k+i*j), 1-2*(j*j+k*k));
     if (ra < 0)
         ra += 2*M_PI;
-    decimal de = -asin(2*(-real*j-i*k));  // allow de to be positive or negaive, as is convention
-    decimal roll = -atan2(2*(-real*i+j*k), 1-2*(i*i+j*j));
+    T de = -asin(2*(-real*j-i*k));  // allow de to be positive or negaive, as is convention
+    T roll = -atan2(2*(-real*i+j*k), 1-2*(i*i+j*j));
     if (roll < 0)
         roll += 2*M_PI;
 
     return EulerAngles(ra, de, roll);
 }
 
+/**
+ * Interpolates between two rotations at a constant angular rate (spherical linear interpolation)
+ *
+ * @param from The rotation at t = 0, as a unit Quaternion
+ * @param to The rotation at t = 1, as a unit Quaternion
+ * @param t How far to go from from to to
+ *
+ * @return The unit Quaternion of the rotation a fraction t of the way along the shortest arc
+ * from from to to
+ *
+ * @note Rotations too close together to divide by the sine of their angle are interpolated
+ * linearly, which is then as accurate
+ */
+template<typename T>
+BasicQuaternion<T> Slerp(const BasicQuaternion<T> &from, const BasicQuaternion<T> &to, T t) {
+    T cosine = from.real * to.real + from.i * to.i + from.j * to.j + from.k * to.k;
+    // q and -q are the same rotation, so take the one on the short way round
+    T sign = cosine < 0 ? -1 : 1;
+    cosine *= sign;
+
+    T a = 1 - t, b = t * sign;
+    if (cosine < static_cast<T>(0.9995)) {
+        T angle = acos(cosine);
+        T inverseSine = 1 / sin(angle);
+        a = sin(a * angle) * inverseSine;
+        b = sin(t * angle) * inverseSine * sign;
+    }
+    BasicQuaternion<T> result(a * from.real + b * to.real, a * from.i + b * to.i,
+                              a * from.j + b * to.j, a * from.k + b * to.k);
+    T norm = sqrt(result.real * result.real + result.i * result.i + result.j * result.j + result.k * result.k);
+    return BasicQuaternion<T>(result.real / norm, result.i / norm, result.j / norm, result.k / norm);
+}
+
 /**
  * Converts Euler Angles into a quaternion
  * 
@@ -224,59 +292,6 @@ void SpatialToSpherical(const Vec3 &vec, decimal &ra, decimal &de) {
     de = asin(vec.z);
 }
 
-/**
- * Converts an angle in radians to degrees
- * 
- * @param rad The rad of the angle
- * 
- * @return The degrees of the angle
-*/
-decimal RadToDeg(decimal rad) {
-    return rad*180.0/M_PI;
-}
-
-/**
- * Converts an angle in degrees to radians
- * 
- * @param deg The degrees of the angle
- * 
- * @return The radians of the angle
-*/
-decimal DegToRad(decimal deg) {
-    return deg/180.0*M_PI;
-}
-
-/**
- * Calculates the approximate value for the
- * inverse secant of an angle
- * 
- * @param rad The angle, in radians
- * 
- * @return The arcsecant of the angle
- * 
- * @pre rad is in radians
- * 
- * @warning rad must be in radians
- * 
-*/
-decimal RadToArcSec(decimal rad) {
-    return RadToDeg(rad) * 3600.0;
-}
-
-
-/**
- * Calculates an angle from an inverse secant value
- * 
- * @param arcSec The arcsecant value
- * 
- * @return A possible angle value, in radians, corresponding
- * to the arcsecant value arcSec
- * 
-*/
-decimal ArcSecToRad(decimal arcSec) {
-    return DegToRad(arcSec / 3600.0);
-}
-
 ///////////////////////////////////
 ///////// VECTOR CLASSES //////////
 ///////////////////////////////////
@@ -286,7 +301,8 @@ decimal ArcSecToRad(decimal arcSec) {
  * 
  * @return The square of the magnitude of this
 */
-decimal Vec3::MagnitudeSq() const {
+template<typename T>
+T BasicVec3<T>::MagnitudeSq() const {
     return x*x+y*y+z*z;
 }
 
@@ -295,7 +311,8 @@ decimal Vec3::MagnitudeSq() const {
  * 
  * @return The square of the magnitude of this
 */
-decimal Vec2::MagnitudeSq() const {
+template<typename T>
+T BasicVec2<T>::MagnitudeSq() const {
     return x*x+y*y;
 }
 
@@ -304,7 +321,8 @@ decimal Vec2::MagnitudeSq() const {
  * 
  * @return The magnitude of this
 */
-decimal Vec3::Magnitude() const {
+template<typename T>
+T BasicVec3<T>::Magnitude() const {
     return sqrt(MagnitudeSq());
 }
 
@@ -313,7 +331,8 @@ decimal Vec3::Magnitude() const {
  * 
  * @return The magnitude of this
 */
-decimal Vec2::Magnitude() const {
+template<typename T>
+T BasicVec2<T>::Magnitude() const {
     return sqrt(MagnitudeSq());
 }
 
@@ -323,8 +342,9 @@ decimal Vec2::Magnitude() const {
  * @return The normalized vector
  * of this
  */
-Vec2 Vec2::Normalize() const {
-    decimal mag = Magnitude();
+template<typename T>
+BasicVec2<T> BasicVec2<T>::Normalize() const {
+    T mag = Magnitude();
     return {
         x/mag, y/mag,
     };
@@ -335,45 +355,59 @@ Vec2 Vec2::Normalize() const {
  * 
  * @return The magnitude of this
 */
-Vec3 Vec3::Normalize() const {
-    decimal mag = Magnitude();
+template<typename T>
+BasicVec3<T> BasicVec3<T>::Normalize() const {
+    T mag = Magnitude();
     return {
         x/mag, y/mag, z/mag,
     };
 }
 
 /// Dot product (Scalar product)
-decimal Vec3::operator*(const Vec3 &other) const {
+template<typename T>
+T BasicVec3<T>::operator*(const BasicVec3<T> &other) const {
     return x*other.x + y*other.y + z*other.z;
 }
 
 /// Dot product (Scalar product)
-decimal Vec2::operator*(const Vec2 &other) const {
+template<typename T>
+T BasicVec2<T>::operator*(const BasicVec2<T> &other) const {
     return x*other.x + y*other.y;
 }
 
 /// Scalar-vector Product
-Vec2 Vec2::operator*(const decimal &other) const {
+template<typename T>
+BasicVec2<T> BasicVec2<T>::operator*(const T &other) const {
     return { x*other, y*other };
 }
 
 /// Vector-Scalar Multiplication
-Vec3 Vec3::operator*(const decimal &other) const {
+template<typename T>
+BasicVec3<T> BasicVec3<T>::operator*(const T &other) const {
     return { x*other, y*other, z*other };
 }
 
 /// Vector Addition
-Vec2 Vec2::operator+(const Vec2 &other) const {
+template<typename T>
+BasicVec2<T> BasicVec2<T>::operator+(const BasicVec2<T> &other) const {
     return {x + other.x, y + other.y };
 }
 
 /// Vector Subtraction
-Vec2 Vec2::operator-(const Vec2 &other) const {
+template<typename T>
+BasicVec2<T> BasicVec2<T>::operator-(const BasicVec2<T> &other) const {
     return { x - other.x, y - other.y };
 }
 
+/// Vector Addition
+template<typename T>
+BasicVec3<T> BasicVec3<T>::operator+(const BasicVec3<T> &other) const {
+    return { x + other.x, y + other.y, z + other.z };
+}
+
 /// Vector Subtraction
-Vec3 Vec3::operator-(const Vec3 &other) const {
+template<typename T>
+BasicVec3<T> BasicVec3<T>::operator-(const BasicVec3<T> &other) const {
     return { x - other.x, y - other.y, z - other.z };
 }
 
@@ -386,7 +420,8 @@ Vec3 Vec3::operator-(const Vec3 &other) const {
  * this and other
  * 
 */
-Vec3 Vec3::CrossProduct(const Vec3 &other) const {
+template<typename T>
+BasicVec3<T> BasicVec3<T>::CrossProduct(const BasicVec3<T> &other) const {
     return {
         y*other.z - z*other.y,
         -(x*other.z - z*other.x),
@@ -403,7 +438,8 @@ Vec3 Vec3::CrossProduct(const Vec3 &other) const {
  * and other
  * 
 */
-Mat3 Vec3::OuterProduct(const Vec3 &other) const {
+template<typename T>
+BasicMat3<T> BasicVec3<T>::OuterProduct(const BasicVec3<T> &other) const {
     return {
         x*other.x, x*other.y, x*other.z,
         y*other.x, y*other.y, y*other.z,
@@ -420,7 +456,8 @@ Mat3 Vec3::OuterProduct(const Vec3 &other) const {
  * other and this
  * 
 */
-Vec3 Vec3::operator*(const Mat3 &other) const {
+template<typename T>
+BasicVec3<T> BasicVec3<T>::operator*(const BasicMat3<T> &other) const {
     return {
         x*other.At(0,0) + y*other.At(0,1) + z*other.At(0,2),
         x*other.At(1,0) + y*other.At(1,1) + z*other.At(1,2),
@@ -441,7 +478,8 @@ Vec3 Vec3::operator*(const Mat3 &other) const {
  * @return The angle, in radians, between vec1 and vec2
  * 
 */
-decimal Angle(const Vec3 &vec1, const Vec3 &vec2) {
+template<typename T>
+T Angle(const BasicVec3<T> &vec1, const BasicVec3<T> &vec2) {
     return AngleUnit(vec1.Normalize(), vec2.Normalize());
 }
 
@@ -457,8 +495,9 @@ decimal Angle(const Vec3 &vec1, const Vec3 &vec2) {
  * 
  * @warning vec1 and vec2 must have a magnitude of 1
 */
-decimal AngleUnit(const Vec3 &vec1, const Vec3 &vec2) {
-    decimal dot = vec1*vec2;
+template<typename T>
+T AngleUnit(const BasicVec3<T> &vec1, const BasicVec3<T> &vec2) {
+    T dot = vec1*vec2;
     // TODO: we shouldn't need this nonsense, right? how come acos sometimes gives nan?
     return dot >= 1 ? 0 : dot <= -1 ? M_PI-0.0000001 : acos(dot);
 }
@@ -472,7 +511,8 @@ decimal AngleUnit(const Vec3 &vec1, const Vec3 &vec2) {
  * @return The distance between v1 and v2
  * 
 */
-decimal Distance(const Vec2 &v1, const Vec2 &v2) {
+template<typename T>
+T Distance(const BasicVec2<T> &v1, const BasicVec2<T> &v2) {
     return sqrt(pow(v1.x-v2.x, 2) + pow(v1.y-v2.y, 2));
 }
 
@@ -485,7 +525,8 @@ decimal Distance(const Vec2 &v1, const Vec2 &v2) {
  * @return The distance between v1 and v2
  * 
 */
-decimal Distance(const Vec3 &v1, const Vec3 &v2) {
+template<typename T>
+T Distance(const BasicVec3<T> &v1, const BasicVec3<T> &v2) {
     return sqrt(pow(v1.x-v2.x, 2) + pow(v1.y-v2.y, 2) + pow(v1.z-v2.z, 2));
 }
 
@@ -502,7 +543,8 @@ decimal Distance(const Vec3 &v1, const Vec3 &v2) {
  * @return The value of the entry in this at (i, j)
  * 
 */
-decimal Mat3::At(int i, int j) const {
+template<typename T>
+T BasicMat3<T>::At(int i, int j) const {
     return x[3*i+j];
 }
 
@@ -513,7 +555,8 @@ decimal Mat3::At(int i, int j) const {
  * 
  * @return The vector at column j
 */
-Vec3 Mat3::Column(int j) const {
+template<typename T>
+BasicVec3<T> BasicMat3<T>::Column(int j) const {
     return {At(0,j), At(1,j), At(2,j)};
 }
 
@@ -524,12 +567,14 @@ Vec3 Mat3::Column(int j) const {
  * 
  * @return The vector at row i
 */
-Vec3 Mat3::Row(int i) const {
+template<typename T>
+BasicVec3<T> BasicMat3<T>::Row(int i) const {
     return {At(i,0), At(i,1), At(i,2)};
 }
 
 /// Matrix Addition
-Mat3 Mat3::operator+(const Mat3 &other) const {
+template<typename T>
+BasicMat3<T> BasicMat3<T>::operator+(const BasicMat3<T> &other) const {
     return {
         At(0,0)+other.At(0,0), At(0,1)+other.At(0,1), At(0,2)+other.At(0,2),
         At(1,0)+other.At(1,0), At(1,1)+other.At(1,1), At(1,2)+other.At(1,2),
@@ -538,7 +583,8 @@ Mat3 Mat3::operator+(const Mat3 &other) const {
 }
 
 /// Matrix Multiplication
-Mat3 Mat3::operator*(const Mat3 &other) const {
+template<typename T>
+BasicMat3<T> BasicMat3<T>::operator*(const BasicMat3<T> &other) const {
 #define _MATMUL_ENTRY(row, col) At(row,0)*other.At(0,col) + At(row,1)*other.At(1,col) + At(row,2)*other.At(2,col)
     return {
         _MATMUL_ENTRY(0,0), _MATMUL_ENTRY(0,1), _MATMUL_ENTRY(0,2),
@@ -549,7 +595,8 @@ Mat3 Mat3::operator*(const Mat3 &other) const {
 }
 
 /// Matrix-Vector Multiplication (Same as Vector::operator*(const Mat3 &))
-Vec3 Mat3::operator*(const Vec3 &vec) const {
+template<typename T>
+BasicVec3<T> BasicMat3<T>::operator*(const BasicVec3<T> &vec) const {
     return {
         vec.x*At(0,0) + vec.y*At(0,1) + vec.z*At(0,2),
         vec.x*At(1,0) + vec.y*At(1,1) + vec.z*At(1,2),
@@ -557,8 +604,93 @@ Vec3 Mat3::operator*(const Vec3 &vec) const {
     };
 }
 
+/**
+ * Multiplies vectors by a matrix four at a time, where SSE or NEON is available
+ *
+ * @param m The entries of the matrix
+ * @param x,y,z The components of the vectors
+ * @param count The number of vectors
+ * @param outX,outY,outZ The place to store the components of the products
+ *
+ * @return The number of vectors multiplied, from the start (0 without SSE or NEON)
+*/
+static size_t MultiplyWide(const float *m, const float *x, const float *y, const float *z, size_t count,
+                           float *outX, float *outY, float *outZ) {
+    size_t i = 0;
+#if defined(__SSE__)
+    __m128 entries[9];
+    for (int k = 0; k < 9; k++) entries[k] = _mm_set1_ps(m[k]);
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 vz = _mm_loadu_ps(z + i);
+        __m128 rows[3];
+        for (int r = 0; r < 3; r++) {
+            rows[r] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(entries[3 * r], vx), _mm_mul_ps(entries[3 * r + 1], vy)),
+                                 _mm_mul_ps(entries[3 * r + 2], vz));
+        }
+        _mm_storeu_ps(outX + i, rows[0]);
+        _mm_storeu_ps(outY + i, rows[1]);
+        _mm_storeu_ps(outZ + i, rows[2]);
+    }
+#elif defined(__ARM_NEON)
+    float32x4_t entries[9];
+    for (int k = 0; k < 9; k++) entries[k] = vdupq_n_f32(m[k]);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t vx = vld1q_f32(x + i);
+        float32x4_t vy = vld1q_f32(y + i);
+        float32x4_t vz = vld1q_f32(z + i);
+        float32x4_t rows[3];
+        for (int r = 0; r < 3; r++) {
+            rows[r] = vmlaq_f32(vmlaq_f32(vmulq_f32(entries[3 * r], vx), entries[3 * r + 1], vy),
+                                entries[3 * r + 2], vz);
+        }
+        vst1q_f32(outX + i, rows[0]);
+        vst1q_f32(outY + i, rows[1]);
+        vst1q_f32(outZ + i, rows[2]);
+    }
+#else
+    (void) m; (void) x; (void) y; (void) z; (void) count; (void) outX; (void) outY; (void) outZ;
+#endif
+    return i;
+}
+
+/**
+ * Multiplies no vectors, since there are no wide kernels for other types of entries
+ *
+ * @return 0
+*/
+template<typename T>
+static size_t MultiplyWide(const T *, const T *, const T *, const T *, size_t, T *, T *, T *) {
+    return 0;
+}
+
+/**
+ * Multiplies many vectors by this Matrix at once
+ *
+ * @param x,y,z The components of the vectors, each in its own array
+ * @param count The number of vectors
+ * @param outX,outY,outZ The place to store the components of the products
+ * (which may be x, y and z themselves)
+ *
+ * @note Float vectors are multiplied four at a time where SSE or NEON is available
+*/
+template<typename T>
+void BasicMat3<T>::Multiply(const T *x, const T *y, const T *z, size_t count,
+                            T *outX, T *outY, T *outZ) const {
+    const T *m = this->x;
+    for (size_t i = MultiplyWide(m, x, y, z, count, outX, outY, outZ); i < count; i++) {
+        // Reads the whole vector first, since the output may be the input
+        T vx = x[i], vy = y[i], vz = z[i];
+        outX[i] = m[0]*vx + m[1]*vy + m[2]*vz;
+        outY[i] = m[3]*vx + m[4]*vy + m[5]*vz;
+        outZ[i] = m[6]*vx + m[7]*vy + m[8]*vz;
+    }
+}
+
 /// Matrix-Scalar Multiplication
-Mat3 Mat3::operator*(const decimal &s) const {
+template<typename T>
+BasicMat3<T> BasicMat3<T>::operator*(const T &s) const {
     return {
         s*At(0,0), s*At(0,1), s*At(0,2),
         s*At(1,0), s*At(1,1), s*At(1,2),
@@ -572,7 +704,8 @@ Mat3 Mat3::operator*(const decimal &s) const {
  * @return The transpose Matrix of this
  * 
 */
-Mat3 Mat3::Transpose() const {
+template<typename T>
+BasicMat3<T> BasicMat3<T>::Transpose() const {
     return {
         At(0,0), At(1,0), At(2,0),
         At(0,1), At(1,1), At(2,1),
@@ -586,7 +719,8 @@ Mat3 Mat3::Transpose() const {
  * @return The trace of this
  * 
 */
-decimal Mat3::Trace() const {
+template<typename T>
+T BasicMat3<T>::Trace() const {
     return At(0,0) + At(1,1) + At(2,2);
 }
 
@@ -596,7 +730,8 @@ decimal Mat3::Trace() const {
  * @return The determinant of this
  * 
 */
-decimal Mat3::Det() const {
+template<typename T>
+T BasicMat3<T>::Det() const {
     return (At(0,0) * (At(1,1)*At(2,2) - At(2,1)*At(1,2))) -
     (At(0,1) * (At(1,0)*At(2,2) - At(2,0)*At(1,2))) +
     (At(0,2) * (At(1,0)*At(2,1) - At(2,0)*At(1,1)));
@@ -608,11 +743,12 @@ decimal Mat3::Det() const {
  * @return The inverse Matrix of this
  * 
 */
-Mat3 Mat3::Inverse() const {
+template<typename T>
+BasicMat3<T> BasicMat3<T>::Inverse() const {
     // https://ardoris.wordpress.com/2008/07/18/general-formula-for-the-inverse-of-a-3x3-matrix/
-    decimal scalar = 1 / Det();
+    T scalar = 1 / Det();
 
-    Mat3 res = {
+    BasicMat3<T> res = {
         At(1,1)*At(2,2) - At(1,2)*At(2,1), At(0,2)*At(2,1) - At(0,1)*At(2,2), At(0,1)*At(1,2) - At(0,2)*At(1,1),
         At(1,2)*At(2,0) - At(1,0)*At(2,2), At(0,0)*At(2,2) - At(0,2)*At(2,0), At(0,2)*At(1,0) - At(0,0)*At(1,2),
         At(1,0)*At(2,1) - At(1,1)*At(2,0), At(0,1)*At(2,0) - At(0,0)*At(2,1), At(0,0)*At(1,1) - At(0,1)*At(1,0)
@@ -621,12 +757,6 @@ Mat3 Mat3::Inverse() const {
     return res * scalar;
 }
 
-/// 3x3 identity matrix
-const Mat3 kIdentityMat3 = {1,0,0,
-                            0,1,0,
-                            0,0,1};
-
-
 ///////////////////////////////////
 ///////// ATTITUDE CLASS //////////
 ///////////////////////////////////
@@ -638,7 +768,7 @@ const Mat3 kIdentityMat3 = {1,0,0,
  * 
 */
 Attitude::Attitude(const Quaternion &quat)
-    : quaternion(quat), type(QuaternionType) {}
+    : quaternion(quat), dcm(QuaternionToDCM(quat)) {}
 
 /**
  * Constructs an Attitude object from a Direction Cosine Matrix (A
@@ -648,7 +778,7 @@ Attitude::Attitude(const Quaternion &quat)
  * 
 */
 Attitude::Attitude(const Mat3 &matrix)
-    : dcm(matrix), type(DCMType) {}
+    : quaternion(DCMToQuaternion(matrix)), dcm(matrix) {}
 
 /**
  * Creates a Direction Cosine Matrix (DCM) off of a Quaternion.
@@ -662,14 +792,15 @@ Attitude::Attitude(const Mat3 &matrix)
  * B by Vector v will result in vector u where u is v rotated to the
  * angles that the direction cosines hold.
 */
-Mat3 QuaternionToDCM(const Quaternion &quat) {
-    Vec3 x = quat.Rotate({1, 0, 0});
-    Vec3 y = quat.Rotate({0, 1, 0});
-    Vec3 z = quat.Rotate({0, 0, 1});
+template<typename T>
+BasicMat3<T> QuaternionToDCM(const BasicQuaternion<T> &quat) {
+    // The columns are the basis vectors rotated by quat, written out so that
+    // no quaternion products are needed
+    T w = quat.real, x = quat.i, y = quat.j, z = quat.k;
     return {
-        x.x, y.x, z.x,
-        x.y, y.y, z.y,
-        x.z, y.z, z.z,
+        w*w + x*x - y*y - z*z, 2*(x*y - w*z), 2*(x*z + w*y),
+        2*(x*y + w*z), w*w - x*x + y*y - z*z, 2*(y*z - w*x),
+        2*(x*z - w*y), 2*(y*z + w*x), w*w - x*x - y*y + z*z,
     };
 }
 
@@ -680,33 +811,43 @@ Mat3 QuaternionToDCM(const Quaternion &quat) {
  * 
  * @return A Quaternion that expresses the rotation defined in dcm
  * 
-*/
-Quaternion DCMToQuaternion(const Mat3 &dcm) {
-    // Make a quaternion that rotates the reference frame X-axis into the dcm's X-axis, just like
-    // the DCM itself does
-    Vec3 oldXAxis = Vec3({1, 0, 0});
-    Vec3 newXAxis = dcm.Column(0);  // this is where oldXAxis is mapped to
-    assert(abs(newXAxis.Magnitude()-1) < 0.001);
-    Vec3 xAlignAxis = oldXAxis.CrossProduct(newXAxis).Normalize();
-    decimal xAlignAngle = AngleUnit(oldXAxis, newXAxis);
-    Quaternion xAlign(xAlignAxis, xAlignAngle);
-
-    // Make a quaternion that will rotate the Y-axis into place
-    Vec3 oldYAxis = xAlign.Rotate({0, 1, 0});
-    Vec3 newYAxis = dcm.Column(1);
-    // we still need to take the cross product, because acos returns a value in [0,pi], and thus we
-    // need to know which direction to rotate before we rotate. We do this by checking if the cross
-    // product of old and new y axes is in the same direction as the new X axis.
-    bool rotateClockwise = oldYAxis.CrossProduct(newYAxis) * newXAxis > 0;  // * is dot product
-    Quaternion yAlign({1, 0, 0}, AngleUnit(oldYAxis, newYAxis) * (rotateClockwise ? 1 : -1));
-
-    // We're done! There's no need to worry about the Z-axis because the handed-ness of the
-    // coordinate system is always preserved, which means the Z-axis is uniquely determined as the
-    // cross product of the X- and Y-axes. This goes to show that DCMs store redundant information.
-
-    // we want the y alignment to have memory of X, which means we put its multiplication on the
-    // right
-    return xAlign*yAlign;
+ * @pre dcm is orthonormal
+*/
+template<typename T>
+BasicQuaternion<T> DCMToQuaternion(const BasicMat3<T> &dcm) {
+    // Shepperd's method: each of w, i, j and k can be found from the diagonal, and the rest from
+    // the off-diagonal entries divided by it. Dividing by the largest of the four keeps this
+    // accurate for every rotation.
+    T trace = dcm.Trace();
+    T m00 = dcm.At(0,0), m11 = dcm.At(1,1), m22 = dcm.At(2,2);
+    if (trace >= m00 && trace >= m11 && trace >= m22) {
+        T w = sqrt(1 + trace) / 2;
+        T scale = 1 / (4*w);
+        return BasicQuaternion<T>(w,
+                                  (dcm.At(2,1) - dcm.At(1,2)) * scale,
+                                  (dcm.At(0,2) - dcm.At(2,0)) * scale,
+                                  (dcm.At(1,0) - dcm.At(0,1)) * scale);
+    } else if (m00 >= m11 && m00 >= m22) {
+        T i = sqrt(1 + m00 - m11 - m22) / 2;
+        T scale = 1 / (4*i);
+        return BasicQuaternion<T>((dcm.At(2,1) - dcm.At(1,2)) * scale,
+                                  i,
+                                  (dcm.At(0,1) + dcm.At(1,0)) * scale,
+                                  (dcm.At(0,2) + dcm.At(2,0)) * scale);
+    } else if (m11 >= m22) {
+        T j = sqrt(1 - m00 + m11 - m22) / 2;
+        T scale = 1 / (4*j);
+        return BasicQuaternion<T>((dcm.At(0,2) - dcm.At(2,0)) * scale,
+                                  (dcm.At(0,1) + dcm.At(1,0)) * scale,
+                                  j,
+                                  (dcm.At(1,2) + dcm.At(2,1)) * scale);
+    }
+    T k = sqrt(1 - m00 - m11 + m22) / 2;
+    T scale = 1 / (4*k);
+    return BasicQuaternion<T>((dcm.At(1,0) - dcm.At(0,1)) * scale,
+                              (dcm.At(0,2) + dcm.At(2,0)) * scale,
+                              (dcm.At(1,2) + dcm.At(2,1)) * scale,
+                              k);
 }
 
 /**
@@ -717,14 +858,7 @@ Quaternion DCMToQuaternion(const Mat3 &dcm) {
  * 
 */
 Quaternion Attitude::GetQuaternion() const {
-    switch (type) {
-        case QuaternionType:
-            return quaternion;
-        case DCMType:
-            return DCMToQuaternion(dcm);
-        default:
-            assert(false);
-    }
+    return quaternion;
 }
 
 /**
@@ -735,14 +869,7 @@ Quaternion Attitude::GetQuaternion() const {
  * 
 */
 Mat3 Attitude::GetDCM() const {
-    switch (type) {
-        case DCMType:
-            return dcm;
-        case QuaternionType:
-            return QuaternionToDCM(quaternion);
-        default:
-            assert(false);
-    }
+    return dcm;
 }
 
 /**
@@ -755,14 +882,22 @@ Mat3 Attitude::GetDCM() const {
  * 
 */
 Vec3 Attitude::Rotate(const Vec3 &vec) const {
-    switch (type) {
-        case DCMType:
-            return dcm*vec;
-        case QuaternionType:
-            return quaternion.Rotate(vec);
-        default:
-            assert(false);
-    }
+    return dcm*vec;
+}
+
+/**
+ * Rotates many vectors to this Attitude at once
+ * (Converts vectors from the reference frame to the body frame.)
+ *
+ * @param x,y,z The components of the vectors to rotate
+ * @param count The number of vectors
+ * @param outX,outY,outZ The place to store the components of the rotated vectors
+ * (which may be x, y and z themselves)
+ *
+*/
+void Attitude::Rotate(const decimal *x, const decimal *y, const decimal *z, size_t count,
+                      decimal *outX, decimal *outY, decimal *outZ) const {
+    dcm.Multiply(x, y, z, count, outX, outY, outZ);
 }
 
 /**
@@ -773,14 +908,7 @@ Vec3 Attitude::Rotate(const Vec3 &vec) const {
  * 
 */
 EulerAngles Attitude::ToSpherical() const {
-    switch (type) {
-        case DCMType:
-            return GetQuaternion().ToSpherical();
-        case QuaternionType:
-            return quaternion.ToSpherical();
-        default:
-            assert(false);
-    }
+    return quaternion.ToSpherical();
 }
 
 ///////////////////////////////////
@@ -812,10 +940,9 @@ int64_t SerializeLengthVec3() {
  * 
 */
 void SerializeVec3(const Vec3 &vec, unsigned char *buffer) {
-    decimal *fBuffer = reinterpret_cast<decimal *>(buffer);
-    *fBuffer++ = vec.x;
-    *fBuffer++ = vec.y;
-    *fBuffer = vec.z;
+    // Copied byte by byte, since buffer need not be aligned for decimals
+    decimal components[3] = {vec.x, vec.y, vec.z};
+    memcpy(buffer, components, sizeof(components));
 }
 
 
@@ -834,12 +961,39 @@ void SerializeVec3(const Vec3 &vec, unsigned char *buffer) {
  * 
 */
 Vec3 DeserializeVec3(const unsigned char *buffer) {
-    Vec3 result;
-    const decimal *fBuffer = reinterpret_cast<decimal *>(const_cast<unsigned char *>(buffer));
-    result.x = *fBuffer++;
-    result.y = *fBuffer++;
-    result.z = *fBuffer;
-    return result;
+    decimal components[3];
+    memcpy(components, buffer, sizeof(components));
+    return Vec3(components[0], components[1], components[2]);
 }
 
+///////////////////////////////////
+//////// INSTANTIATIONS ///////////
+///////////////////////////////////
+
+// The vector types are only ever used in single and double precision
+
+template struct BasicVec2<float>;
+template struct BasicVec2<double>;
+template class BasicVec3<float>;
+template class BasicVec3<double>;
+template class BasicMat3<float>;
+template class BasicMat3<double>;
+template class BasicQuaternion<float>;
+template class BasicQuaternion<double>;
+
+template float Distance(const BasicVec2<float> &, const BasicVec2<float> &);
+template double Distance(const BasicVec2<double> &, const BasicVec2<double> &);
+template float Distance(const BasicVec3<float> &, const BasicVec3<float> &);
+template double Distance(const BasicVec3<double> &, const BasicVec3<double> &);
+template float Angle(const BasicVec3<float> &, const BasicVec3<float> &);
+template double Angle(const BasicVec3<double> &, const BasicVec3<double> &);
+template float AngleUnit(const BasicVec3<float> &, const BasicVec3<float> &);
+template double AngleUnit(const BasicVec3<double> &, const BasicVec3<double> &);
+template BasicMat3<float> QuaternionToDCM(const BasicQuaternion<float> &);
+template BasicMat3<double> QuaternionToDCM(const BasicQuaternion<double> &);
+template BasicQuaternion<float> DCMToQuaternion(const BasicMat3<float> &);
+template BasicQuaternion<double> DCMToQuaternion(const BasicMat3<double> &);
+template BasicQuaternion<float> Slerp(const BasicQuaternion<float> &, const BasicQuaternion<float> &, float);
+template BasicQuaternion<double> Slerp(const BasicQuaternion<double> &, const BasicQuaternion<double> &, double);
+
 }  // namespace found
@@ -1,59 +1,76 @@
 #ifndef ATTITUDE_UTILS_H
 #define ATTITUDE_UTILS_H
 
+#include <stddef.h>
+#include <math.h>
+
 #include <memory>
 
 namespace found {
 
 /// Alias for floating point numbers. Used for controlling
 /// floating-point type memory usage throughout the program
+/// (float, or double when built with FOUND_DOUBLE_PRECISION)
+#ifdef FOUND_DOUBLE_PRECISION
+typedef double decimal;
+#else
 typedef float decimal;
+#endif
+
+/// Alias for the floating point numbers of stages where rounding
+/// error accumulates over time, such as orbits and kinematics
+typedef double preciseDecimal;
 
 // At first, I wanted to have two separate Attitude classes, one storing Euler angles and converting
 // to Quaterinon, and another storing as Quaternion and converting to Euler. But abstract classes
 // make everything more annoying, because you need vectors of pointers...ugh!
 
 /**
- * A Vec2 is an immutable object that represents a 2D Vector
+ * A BasicVec2 is an immutable object that represents a 2D Vector
  * 
+ * @param T The type of the coordinates (float or double)
 */
-struct Vec2 {
+template<typename T>
+struct BasicVec2 {
     /// The x coordinate
-    const decimal x;
+    const T x;
     /// The y coordinate
-    const decimal y;
+    const T y;
 
     // Magnitude
 
-    decimal Magnitude() const;
-    decimal MagnitudeSq() const;
+    T Magnitude() const;
+    T MagnitudeSq() const;
 
     // Unit Vector of this
 
-    Vec2 Normalize() const;
+    BasicVec2 Normalize() const;
 
     // Operations
 
-    decimal operator*(const Vec2 &) const;
-    Vec2 operator*(const decimal &) const;
-    Vec2 operator-(const Vec2 &) const;
-    Vec2 operator+(const Vec2 &) const;
+    T operator*(const BasicVec2 &) const;
+    BasicVec2 operator*(const T &) const;
+    BasicVec2 operator-(const BasicVec2 &) const;
+    BasicVec2 operator+(const BasicVec2 &) const;
 };
 
-class Mat3;  // define above so we can use in Vec3 class
+template<typename T>
+class BasicMat3;  // define above so we can use in BasicVec3 class
 
 /**
- * A Vec3 is a mutable object that represents a 3D Vector
+ * A BasicVec3 is a mutable object that represents a 3D Vector
  * 
+ * @param T The type of the coordinates (float or double)
 */
-class Vec3 {
+template<typename T>
+class BasicVec3 {
  public:
     /// The x coordinate
-    decimal x;
+    T x;
     /// The y coordinate
-    decimal y;
+    T y;
     /// The z coordinate
-    decimal z;
+    T z;
 
     // TODO: Implement this constructor
     /**
@@ -62,7 +79,7 @@ class Vec3 {
      * @param de The declination of the vector to create
      * @param ra The right ascension of the vector to create
     */
-    Vec3(decimal de, decimal ra);
+    BasicVec3(T de, T ra);
 
     /**
      * Construction of vector with x, y, and z components
@@ -71,21 +88,21 @@ class Vec3 {
      * @param y The scalar value in the y direction of the vector to make
      * @param z The scalar value in the z direction of the vector to make
     */
-    Vec3(decimal x, decimal y, decimal z) : x(x), y(y), z(z) {}
+    constexpr BasicVec3(T x, T y, T z) : x(x), y(y), z(z) {}
 
     /**
      * Default construction of the Vector
     */
-    Vec3() {}
+    BasicVec3() {}
 
     // Magnitude
 
-    decimal Magnitude() const;
-    decimal MagnitudeSq() const;
+    T Magnitude() const;
+    T MagnitudeSq() const;
 
     // Unit Vector
 
-    Vec3 Normalize() const;
+    BasicVec3 Normalize() const;
 
     // TODO: Accessor Methods
 
@@ -98,7 +115,7 @@ class Vec3 {
      * @pre this is relative to the celestial
      * coordinate system
      */
-    decimal getRightAscension() const;
+    T getRightAscension() const;
     /**
      * Obtains the Declination of
      * this vector
@@ -108,51 +125,73 @@ class Vec3 {
      * @pre this is relative to the celestial
      * coordinate system
      */
-    decimal getDeclination() const;
+    T getDeclination() const;
 
     // Operations
 
-    decimal operator*(const Vec3 &) const;
-    Vec3 operator*(const decimal &) const;
-    Vec3 operator*(const Mat3 &) const;
-    Vec3 operator-(const Vec3 &) const;
-    Vec3 CrossProduct(const Vec3 &) const;
-    Mat3 OuterProduct(const Vec3 &) const;
+    T operator*(const BasicVec3 &) const;
+    BasicVec3 operator*(const T &) const;
+    BasicVec3 operator*(const BasicMat3<T> &) const;
+    BasicVec3 operator+(const BasicVec3 &) const;
+    BasicVec3 operator-(const BasicVec3 &) const;
+    BasicVec3 CrossProduct(const BasicVec3 &) const;
+    BasicMat3<T> OuterProduct(const BasicVec3 &) const;
 };
 
 /**
- * A Mat3 is a mutable object that represents a 3x3 Matrix
+ * A BasicMat3 is a mutable object that represents a 3x3 Matrix
  * 
+ * @param T The type of the entries (float or double)
 */
-class Mat3 {
+template<typename T>
+class BasicMat3 {
  public:
     /// The matrix entries
-    decimal x[9];
+    T x[9];
 
     // Accessor
 
-    decimal At(int i, int j) const;
-    Vec3 Column(int) const;
-    Vec3 Row(int) const;
-    decimal Trace() const;
-    decimal Det() const;
+    T At(int i, int j) const;
+    BasicVec3<T> Column(int) const;
+    BasicVec3<T> Row(int) const;
+    T Trace() const;
+    T Det() const;
 
     // Operations
 
-    Mat3 operator+(const Mat3 &) const;
-    Mat3 operator*(const Mat3 &) const;
-    Vec3 operator*(const Vec3 &) const;
-    Mat3 operator*(const decimal &) const;
+    BasicMat3 operator+(const BasicMat3 &) const;
+    BasicMat3 operator*(const BasicMat3 &) const;
+    BasicVec3<T> operator*(const BasicVec3<T> &) const;
+    BasicMat3 operator*(const T &) const;
+    void Multiply(const T *x, const T *y, const T *z, size_t count,
+                  T *outX, T *outY, T *outZ) const;
 
     // Transformations
 
-    Mat3 Transpose() const;
-    Mat3 Inverse() const;
+    BasicMat3 Transpose() const;
+    BasicMat3 Inverse() const;
 };
 
+/// A 2D Vector at the precision of most of the program
+typedef BasicVec2<decimal> Vec2;
+/// A 3D Vector at the precision of most of the program
+typedef BasicVec3<decimal> Vec3;
+/// A 3x3 Matrix at the precision of most of the program
+typedef BasicMat3<decimal> Mat3;
+
+/// A 2D Vector in double precision
+typedef BasicVec2<preciseDecimal> PreciseVec2;
+/// A 3D Vector in double precision
+typedef BasicVec3<preciseDecimal> PreciseVec3;
+/// A 3x3 Matrix in double precision
+typedef BasicMat3<preciseDecimal> PreciseMat3;
+
 // Identity Matrix
 
-extern const Mat3 kIdentityMat3;
+/// 3x3 identity matrix
+constexpr Mat3 kIdentityMat3 = {1, 0, 0,
+                                0, 1, 0,
+                                0, 0, 1};
 
 // Buffer-Vector Functions
 
@@ -162,8 +201,8 @@ Vec3 DeserializeVec3(const unsigned char *);
 
 // Distance between Vectors
 
-decimal Distance(const Vec2 &, const Vec2 &);
-decimal Distance(const Vec3 &, const Vec3 &);
+template<typename T> T Distance(const BasicVec2<T> &, const BasicVec2<T> &);
+template<typename T> T Distance(const BasicVec3<T> &, const BasicVec3<T> &);
 
 /**
  * An EulerAngle is a mutable Object representing Euler Angles of a 3D point
@@ -193,15 +232,17 @@ class EulerAngles {
 };
 
 /**
- * A Quaternion is a mutable object that represents a Quaternion. A Quaternion
+ * A BasicQuaternion is a mutable object that represents a Quaternion. A Quaternion
  * is a common way to represent rotations in 3D.
  * 
+ * @param T The type of the components (float or double)
 */
-class Quaternion {
+template<typename T>
+class BasicQuaternion {
  public:
-    Quaternion() = default;
-    explicit Quaternion(const Vec3 &);
-    Quaternion(const Vec3 &, decimal);
+    BasicQuaternion() = default;
+    explicit BasicQuaternion(const BasicVec3<T> &);
+    BasicQuaternion(const BasicVec3<T> &, T);
 
     /**
      * Creates a Quaternion with components
@@ -213,36 +254,105 @@ class Quaternion {
      * 
      * Initializes this to be {real + iI + jJ + kK}
      */
-    Quaternion(decimal real, decimal i, decimal j, decimal k)
+    constexpr BasicQuaternion(T real, T i, T j, T k)
         : real(real), i(i), j(j), k(k) {}
 
-    Quaternion operator*(const Quaternion &other) const;
-    Quaternion Conjugate() const;
-    Vec3 Vector() const;
-    void SetVector(const Vec3 &);
-    Vec3 Rotate(const Vec3 &) const;
-    decimal Angle() const;
-    void SetAngle(decimal);
+    BasicQuaternion operator*(const BasicQuaternion &other) const;
+    BasicQuaternion Conjugate() const;
+    BasicVec3<T> Vector() const;
+    void SetVector(const BasicVec3<T> &);
+    BasicVec3<T> Rotate(const BasicVec3<T> &) const;
+    void Rotate(const T *x, const T *y, const T *z, size_t count,
+                T *outX, T *outY, T *outZ) const;
+    T Angle() const;
+    void SetAngle(T);
     EulerAngles ToSpherical() const;
-    bool IsUnit(decimal tolerance) const;
-    Quaternion Canonicalize() const;
+    bool IsUnit(T tolerance) const;
+    BasicQuaternion Canonicalize() const;
 
     /// The real component
-    decimal real;
+    T real;
     /// The i component
-    decimal i;
+    T i;
     /// The j component
-    decimal j;
+    T j;
     /// The k component
-    decimal k;
+    T k;
 };
 
+/// A Quaternion at the precision of most of the program
+typedef BasicQuaternion<decimal> Quaternion;
+/// A Quaternion in double precision
+typedef BasicQuaternion<preciseDecimal> PreciseQuaternion;
+
+// Precision Conversions
+
+/**
+ * Converts a vector to another precision (e.g. between stages of different precisions)
+ *
+ * @param To The new type of the coordinates
+ *
+ * @param vec The vector to convert
+ *
+ * @return vec, with coordinates of type To
+ */
+template<typename To, typename From>
+BasicVec2<To> PrecisionCast(const BasicVec2<From> &vec) {
+    return {static_cast<To>(vec.x), static_cast<To>(vec.y)};
+}
+
+/**
+ * Converts a vector to another precision (e.g. between stages of different precisions)
+ *
+ * @param To The new type of the coordinates
+ *
+ * @param vec The vector to convert
+ *
+ * @return vec, with coordinates of type To
+ */
+template<typename To, typename From>
+BasicVec3<To> PrecisionCast(const BasicVec3<From> &vec) {
+    return {static_cast<To>(vec.x), static_cast<To>(vec.y), static_cast<To>(vec.z)};
+}
+
+/**
+ * Converts a matrix to another precision (e.g. between stages of different precisions)
+ *
+ * @param To The new type of the entries
+ *
+ * @param matrix The matrix to convert
+ *
+ * @return matrix, with entries of type To
+ */
+template<typename To, typename From>
+BasicMat3<To> PrecisionCast(const BasicMat3<From> &matrix) {
+    BasicMat3<To> result;
+    for (int k = 0; k < 9; k++) result.x[k] = static_cast<To>(matrix.x[k]);
+    return result;
+}
+
+/**
+ * Converts a quaternion to another precision (e.g. between stages of different precisions)
+ *
+ * @param To The new type of the components
+ *
+ * @param quat The quaternion to convert
+ *
+ * @return quat, with components of type To
+ */
+template<typename To, typename From>
+BasicQuaternion<To> PrecisionCast(const BasicQuaternion<From> &quat) {
+    return BasicQuaternion<To>(static_cast<To>(quat.real), static_cast<To>(quat.i),
+                               static_cast<To>(quat.j), static_cast<To>(quat.k));
+}
+
 
 /**
  * An Attitude is an immutable object that represents the orientation of a 3D point.
  * 
  * The attitude (orientation) of a spacecraft.
- * The Attitude object stores either a rotation matrix (direction cosine matrix) or a quaternion, and converts automatically to the other format when needed.
+ * The Attitude object stores both a rotation matrix (direction cosine matrix) and a quaternion. Whichever
+ * one it is made from, it converts to the other once, when it is made, so that getting either is free.
  * @note When porting to an embedded device, you'll probably want to get rid of this class and adapt to
  * either quaternions or DCMs exclusively, depending on the natural output format of whatever
  * attitude estimation algorithm you're using.
@@ -257,25 +367,24 @@ class Attitude {
     Mat3 GetDCM() const;
     EulerAngles ToSpherical() const;
     Vec3 Rotate(const Vec3 &) const;
+    void Rotate(const decimal *x, const decimal *y, const decimal *z, size_t count,
+                decimal *outX, decimal *outY, decimal *outZ) const;
 
  private:
-    enum AttitudeType {
-        NullType,
-        QuaternionType,
-        DCMType,
-    };
-
     Quaternion quaternion;
     Mat3 dcm;  // direction cosine matrix
-    AttitudeType type;
 };
 
 // DCM-Quaternion-Spherical Conversions
 
-Mat3 QuaternionToDCM(const Quaternion &);
-Quaternion DCMToQuaternion(const Mat3 &);
+template<typename T> BasicMat3<T> QuaternionToDCM(const BasicQuaternion<T> &);
+template<typename T> BasicQuaternion<T> DCMToQuaternion(const BasicMat3<T> &);
 Quaternion SphericalToQuaternion(decimal ra, decimal dec, decimal roll);
 
+// Interpolation Between Rotations
+
+template<typename T> BasicQuaternion<T> Slerp(const BasicQuaternion<T> &, const BasicQuaternion<T> &, T);
+
 // Spherical-Vector Conversions
 
 Vec3 SphericalToSpatial(decimal ra, decimal de);
@@ -283,15 +392,62 @@ void SpatialToSpherical(const Vec3 &, decimal &ra, decimal &de);
 
 // Angle Between Vectors
 
-decimal Angle(const Vec3 &, const Vec3 &);
-decimal AngleUnit(const Vec3 &, const Vec3 &);
+template<typename T> T Angle(const BasicVec3<T> &, const BasicVec3<T> &);
+template<typename T> T AngleUnit(const BasicVec3<T> &, const BasicVec3<T> &);
 
 // Angle Conversions
 
-decimal RadToDeg(decimal);
-decimal DegToRad(decimal);
-decimal RadToArcSec(decimal);
-decimal ArcSecToRad(decimal);
+/**
+ * Converts an angle in radians to degrees
+ * 
+ * @param rad The rad of the angle
+ * 
+ * @return The degrees of the angle
+*/
+constexpr decimal RadToDeg(decimal rad) {
+    return rad*180.0/M_PI;
+}
+
+/**
+ * Converts an angle in degrees to radians
+ * 
+ * @param deg The degrees of the angle
+ * 
+ * @return The radians of the angle
+*/
+constexpr decimal DegToRad(decimal deg) {
+    return deg/180.0*M_PI;
+}
+
+/**
+ * Calculates the approximate value for the
+ * inverse secant of an angle
+ * 
+ * @param rad The angle, in radians
+ * 
+ * @return The arcsecant of the angle
+ * 
+ * @pre rad is in radians
+ * 
+ * @warning rad must be in radians
+ * 
+*/
+constexpr decimal RadToArcSec(decimal rad) {
+    return RadToDeg(rad) * 3600.0;
+}
+
+/**
+ * Calculates an angle from an inverse secant value
+ * 
+ * @param arcSec The arcsecant value
+ * 
+ * @return A possible angle value, in radians, corresponding
+ * to the arcsecant value arcSec
+ * 
+*/
+constexpr decimal ArcSecToRad(decimal arcSec) {
+    return DegToRad(arcSec / 3600.0);
+}
 
 // TODO: quaternion and euler angle conversion, conversion between ascension/declination to rec9tu
 
@@ -3,10 +3,55 @@
 #include <math.h>
 #include <assert.h>
 
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 #include "spatial/attitude-utils.hpp"
 
 namespace found {
 
+/// The number of steps of the inversion of a distortion, enough for any real lens to converge
+const int kUndistortIterations = 20;
+
+/**
+ * Moves a point where an ideal lens would image it to where a distorted lens does
+ *
+ * @param distortion The distortion of the lens
+ * @param u,v The point, relative to the principal point in units of the focal length,
+ * which is distorted in place
+ */
+static void Distort(const LensDistortion &distortion, preciseDecimal &u, preciseDecimal &v) {
+    preciseDecimal r2 = u * u + v * v;
+    preciseDecimal radial = 1 + r2 * (distortion.k1 + r2 * (distortion.k2 + r2 * distortion.k3));
+    preciseDecimal distortedU = u * radial + 2 * distortion.p1 * u * v + distortion.p2 * (r2 + 2 * u * u);
+    preciseDecimal distortedV = v * radial + distortion.p1 * (r2 + 2 * v * v) + 2 * distortion.p2 * u * v;
+    u = distortedU;
+    v = distortedV;
+}
+
+/**
+ * Moves a point where a distorted lens images it to where an ideal lens would
+ *
+ * @param distortion The distortion of the lens
+ * @param u,v The point, relative to the principal point in units of the focal length,
+ * which is undistorted in place
+ *
+ * @note The distortion has no closed-form inverse, so it is inverted by fixed-point iteration
+ */
+static void Undistort(const LensDistortion &distortion, preciseDecimal &u, preciseDecimal &v) {
+    preciseDecimal distortedU = u, distortedV = v;
+    for (int i = 0; i < kUndistortIterations; i++) {
+        preciseDecimal r2 = u * u + v * v;
+        preciseDecimal radial = 1 + r2 * (distortion.k1 + r2 * (distortion.k2 + r2 * distortion.k3));
+        preciseDecimal tangentialU = 2 * distortion.p1 * u * v + distortion.p2 * (r2 + 2 * u * u);
+        preciseDecimal tangentialV = distortion.p1 * (r2 + 2 * v * v) + 2 * distortion.p2 * u * v;
+        u = (distortedU - tangentialU) / radial;
+        v = (distortedV - tangentialV) / radial;
+    }
+}
+
 /**
  * Converts from a 3D point in space to a 2D point on the camera sensor.
  * 
@@ -23,6 +68,14 @@ Vec2 Camera::SpatialToCamera(const Vec3 &vector) const {
     assert(vector.x > 0);
     // TODO: is there any sort of accuracy problem when vector.y and vector.z are small?
 
+    if (Distorted()) {
+        preciseDecimal u = -vector.y / static_cast<preciseDecimal>(vector.x);
+        preciseDecimal v = -vector.z / static_cast<preciseDecimal>(vector.x);
+        Distort(distortion, u, v);
+        return { static_cast<decimal>(u * focalLength + xCenter),
+                 static_cast<decimal>(v * focalLength + yCenter) };
+    }
+
     decimal focalFactor = focalLength/vector.x;
 
     decimal yPixel = vector.y*focalFactor;
@@ -41,11 +94,24 @@ Vec2 Camera::SpatialToCamera(const Vec3 &vector) const {
  * 
  * @note Not all vectors returned by this function will necessarily have the same magnitude.
  * 
+ * @note A distorted camera looks the vector up in its table of rays if it has one, and
+ * otherwise undistorts it
+ *
  * @warning Other functions rely on the fact that returned vectors are placed one unit away (x-component equal to 1). Don't change this behavior!
  */
 Vec3 Camera::CameraToSpatial(const Vec2 &vector) const {
     assert(InSensor(vector));
 
+    if (table || Distorted()) {
+        Vec3 ray = {1, 0, 0};
+        if (table) {
+            table->Lookup(vector.x, vector.y, ray.y, ray.z);
+        } else {
+            UndistortPixel(vector.x, vector.y, ray.y, ray.z);
+        }
+        return ray;
+    }
+
     // isn't it interesting: To convert from center-based to left-corner-based coordinates is the
     // same formula; f(x)=f^{-1}(x) !
     decimal xPixel = -vector.x + xCenter;
@@ -58,6 +124,66 @@ Vec3 Camera::CameraToSpatial(const Vec2 &vector) const {
     };
 }
 
+/**
+ * Converts many points on the camera sensor into unit vectors in 3d space at once, using the
+ * same coordinate system described for SpatialToCamera
+ *
+ * @param x,y The coordinates of each point on the camera
+ * @param count The number of points
+ * @param rayX,rayY,rayZ The outputs, i.e. the components of the unit vector towards each point
+ *
+ * @note Unlike CameraToSpatial, the vectors are normalized, and points are not checked to be in
+ * the sensor. No memory is allocated, and the outputs may not overlap the inputs.
+ *
+ * @note If this has a table of rays, each ray is looked up in it. Otherwise, a distorted camera
+ * undistorts every point, which is far slower.
+ */
+void Camera::PixelsToRays(const decimal *x, const decimal *y, size_t count,
+                          decimal *rayX, decimal *rayY, decimal *rayZ) const {
+    if (table || Distorted()) {
+        for (size_t i = 0; i < count; i++) {
+            decimal yRay, zRay;
+            if (table) {
+                table->Lookup(x[i], y[i], yRay, zRay);
+            } else {
+                UndistortPixel(x[i], y[i], yRay, zRay);
+            }
+            decimal scale = 1 / sqrt(1 + yRay * yRay + zRay * zRay);
+            rayX[i] = scale;
+            rayY[i] = yRay * scale;
+            rayZ[i] = zRay * scale;
+        }
+        return;
+    }
+
+    decimal inverseFocalLength = 1 / focalLength;
+    for (size_t i = 0; i < count; i++) {
+        decimal yRay = (xCenter - x[i]) * inverseFocalLength;
+        decimal zRay = (yCenter - y[i]) * inverseFocalLength;
+        decimal scale = 1 / sqrt(1 + yRay * yRay + zRay * zRay);
+        rayX[i] = scale;
+        rayY[i] = yRay * scale;
+        rayZ[i] = zRay * scale;
+    }
+}
+
+/**
+ * Computes the ray of a point on the camera sensor, undistorting it exactly
+ *
+ * @param x,y The point on the camera
+ * @param rayY,rayZ The outputs, i.e. the y and z components of the ray of the point
+ * whose x component is 1
+ *
+ * @note This ignores the table of rays of this, which it is used to make
+ */
+void Camera::UndistortPixel(decimal x, decimal y, decimal &rayY, decimal &rayZ) const {
+    preciseDecimal u = (x - static_cast<preciseDecimal>(xCenter)) / focalLength;
+    preciseDecimal v = (y - static_cast<preciseDecimal>(yCenter)) / focalLength;
+    if (Distorted()) Undistort(distortion, u, v);
+    rayY = static_cast<decimal>(-u);
+    rayZ = static_cast<decimal>(-v);
+}
+
 /**
  * Evaluates whether a vector can be seen in the camera
  * 
@@ -83,6 +209,123 @@ decimal Camera::Fov() const {
     return FocalLengthToFov(focalLength, xResolution, 1.0);
 }
 
+/**
+ * Sets the distortion of the lens of this
+ *
+ * @param distortion The distortion to give this camera
+ *
+ * @note The table of rays of this, which was made for another lens, is dropped
+ */
+void Camera::SetDistortion(const LensDistortion &distortion) {
+    this->distortion = distortion;
+    this->table.reset();
+}
+
+/**
+ * Makes a table of the rays of this, which this then looks rays up in
+ *
+ * @param step The number of pixels between the entries of the table (1 for an entry at
+ * every corner of every pixel)
+ *
+ * @throws invalid_argument iff step is not positive, or this has no pixels
+ *
+ * @note Copies of this made afterwards share the table
+ */
+void Camera::BuildRayTable(int step) {
+    this->table = std::make_shared<const RayTable>(*this, step);
+}
+
+/**
+ * Makes this look rays up in a table (e.g. one read from a file)
+ *
+ * @param table The table, or nullptr to compute the ray of every pixel again
+ *
+ * @throws invalid_argument iff the table was made for a camera other than this
+ */
+void Camera::SetRayTable(std::shared_ptr<const RayTable> table) {
+    if (table && !table->Matches(*this)) throw std::invalid_argument("The table of rays is for another camera");
+    this->table = std::move(table);
+}
+
+/**
+ * Makes the table of rays of a camera
+ *
+ * @param camera The camera
+ * @param step The number of pixels between neighbouring entries
+ *
+ * @throws invalid_argument iff step is not positive, or camera has no pixels
+ */
+RayTable::RayTable(const Camera &camera, int step)
+    : RayTable(camera, step, std::vector<decimal>(Entries(camera, step)), std::vector<decimal>(Entries(camera, step))) {
+    for (int j = 0; j < rows; j++) {
+        for (int i = 0; i < columns; i++) {
+            size_t entry = static_cast<size_t>(j) * columns + i;
+            camera.UndistortPixel(static_cast<decimal>(i * step), static_cast<decimal>(j * step),
+                                  rayY[entry], rayZ[entry]);
+        }
+    }
+}
+
+/**
+ * Makes a table of rays out of its entries (e.g. read from a file)
+ *
+ * @param camera The camera the entries are for
+ * @param step The number of pixels between neighbouring entries
+ * @param rayY,rayZ The y and z components of the ray of every entry, row by row
+ *
+ * @throws invalid_argument iff step is not positive, camera has no pixels, or there is
+ * not one of each component for every entry
+ */
+RayTable::RayTable(const Camera &camera, int step, std::vector<decimal> rayY, std::vector<decimal> rayZ)
+    : camera(camera), step(step), rayY(std::move(rayY)), rayZ(std::move(rayZ)) {
+    if (step < 1) throw std::invalid_argument("The step of a table of rays must be positive");
+    if (camera.XResolution() <= 0 || camera.YResolution() <= 0) {
+        throw std::invalid_argument("A table of rays needs a camera with pixels");
+    }
+    this->camera.SetRayTable(nullptr);
+    inverseStep = static_cast<decimal>(1) / step;
+    // Enough entries to cover the far edge of the last pixel
+    columns = (camera.XResolution() + step - 1) / step + 1;
+    rows = (camera.YResolution() + step - 1) / step + 1;
+    size_t entries = static_cast<size_t>(columns) * rows;
+    if (this->rayY.size() != entries || this->rayZ.size() != entries) {
+        throw std::invalid_argument("The table of rays does not have one ray for every entry");
+    }
+}
+
+/**
+ * Provides the number of entries of the table of rays of a camera
+ *
+ * @param camera The camera
+ * @param step The number of pixels between neighbouring entries
+ *
+ * @return The number of entries (0 iff step is not positive, or camera has no pixels)
+ */
+size_t RayTable::Entries(const Camera &camera, int step) {
+    if (step < 1 || camera.XResolution() <= 0 || camera.YResolution() <= 0) return 0;
+    size_t columns = (camera.XResolution() + step - 1) / step + 1;
+    size_t rows = (camera.YResolution() + step - 1) / step + 1;
+    return columns * rows;
+}
+
+/**
+ * Evaluates whether this was made for a camera
+ *
+ * @param camera The camera
+ *
+ * @return true iff camera has the same focal length, principal point, resolution and
+ * distortion as the camera this was made for
+ */
+bool RayTable::Matches(const Camera &camera) const {
+    const LensDistortion &mine = this->camera.Distortion();
+    const LensDistortion &theirs = camera.Distortion();
+    return this->camera.FocalLength() == camera.FocalLength()
+        && this->camera.XCenter() == camera.XCenter() && this->camera.YCenter() == camera.YCenter()
+        && this->camera.XResolution() == camera.XResolution() && this->camera.YResolution() == camera.YResolution()
+        && mine.k1 == theirs.k1 && mine.k2 == theirs.k2 && mine.k3 == theirs.k3
+        && mine.p1 == theirs.p1 && mine.p2 == theirs.p2;
+}
+
 /**
  * Provides the focal length of a camera for given parameters
  * 
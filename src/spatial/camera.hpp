@@ -1,12 +1,40 @@
 #ifndef CAMERA_H
 #define CAMERA_H
 
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "spatial/attitude-utils.hpp"
 
 #include "style/style.hpp"
 
 namespace found {
 
+/**
+ * A LensDistortion is the Brown-Conrady model of the distortion of a lens, with
+ * the coefficients of OpenCV's calibration (k1, k2, p1, p2, k3). They apply to
+ * (u, v) = ((x - xCenter) / f, (y - yCenter) / f), the position of a pixel
+ * relative to the principal point, in units of the focal length:
+ *
+ *     r^2 = u^2 + v^2
+ *     u' = u (1 + k1 r^2 + k2 r^4 + k3 r^6) + 2 p1 u v + p2 (r^2 + 2 u^2)
+ *     v' = v (1 + k1 r^2 + k2 r^4 + k3 r^6) + p1 (r^2 + 2 v^2) + 2 p2 u v
+ *
+ * where (u, v) is where an ideal lens would image a ray, and (u', v') is where
+ * this lens does. A LensDistortion of zeros is an ideal lens.
+ */
+struct LensDistortion {
+    /// The radial coefficients
+    decimal k1, k2, k3;
+    /// The tangential coefficients
+    decimal p1, p2;
+};
+
+class RayTable;
+
 /**
  * A Camera is a mutable object that represents a Camera. All camera dimensions
  * are in SI
@@ -55,9 +83,42 @@ class Camera {
 
     Vec2 SpatialToCamera(const Vec3 &) const;
     Vec3 CameraToSpatial(const Vec2 &) const;
+    void PixelsToRays(const decimal *x, const decimal *y, size_t count,
+                      decimal *rayX, decimal *rayY, decimal *rayZ) const;
+    void UndistortPixel(decimal x, decimal y, decimal &rayY, decimal &rayZ) const;
 
     bool InSensor(const Vec2 &vector) const;
 
+    // Lens distortion, and the table of rays that hides its cost
+
+    void SetDistortion(const LensDistortion &distortion);
+    void BuildRayTable(int step = 1);
+    void SetRayTable(std::shared_ptr<const RayTable> table);
+
+    /**
+     * Returns the distortion of the lens of this camera
+     *
+     * @return The distortion of this
+     */
+    const LensDistortion &Distortion() const { return distortion; }
+
+    /**
+     * Returns whether the lens of this camera distorts
+     *
+     * @return true iff any coefficient of the distortion of this is not 0
+     */
+    bool Distorted() const {
+        return distortion.k1 != 0 || distortion.k2 != 0 || distortion.k3 != 0
+            || distortion.p1 != 0 || distortion.p2 != 0;
+    }
+
+    /**
+     * Returns the table of rays of this camera
+     *
+     * @return The table of this, or nullptr if rays are computed for every pixel
+     */
+    const std::shared_ptr<const RayTable> &Table() const { return table; }
+
     // Accessor Methods to Camera Parameters
 
    /**
@@ -81,6 +142,20 @@ class Camera {
      */
     decimal FocalLength() const { return focalLength; }
 
+    /**
+     * Returns the x coordinate of the principal point of this camera
+     *
+     * @return The x center of this
+     */
+    decimal XCenter() const { return xCenter; }
+
+    /**
+     * Returns the y coordinate of the principal point of this camera
+     *
+     * @return The y center of this
+     */
+    decimal YCenter() const { return yCenter; }
+
     decimal Fov() const;
 
     // Mutator Method for Cameras
@@ -89,14 +164,114 @@ class Camera {
      * Sets the focal length of this
      * 
      * @param focalLength The focal length to give this camera
+     *
+     * @note The table of rays of this, which was made for another focal length, is dropped
      */
-    void SetFocalLength(decimal focalLength) { this->focalLength = focalLength; }
+    void SetFocalLength(decimal focalLength) {
+        this->focalLength = focalLength;
+        this->table.reset();
+    }
 
  private:
-    // TODO: distortion
     decimal focalLength;
     decimal xCenter; decimal yCenter;
     int xResolution; int yResolution;
+    /// The distortion of the lens (none by default)
+    LensDistortion distortion = {0, 0, 0, 0, 0};
+    /// The rays at a grid of pixels, shared between copies of this (nullptr if there is none)
+    std::shared_ptr<const RayTable> table;
+};
+
+/**
+ * A RayTable holds the undistorted rays of a Camera at a grid of its pixels, every
+ * step pixels along each axis from its top left corner, so that the ray of any
+ * pixel is a bilinear interpolation of four entries instead of the iterative
+ * inversion of the distortion of the lens.
+ *
+ * A step of 1 has an entry at every corner of every pixel. Larger steps are far
+ * smaller (1 / step^2 the size) and, since distortion varies smoothly over a
+ * sensor, barely less accurate.
+ *
+ * Each entry is the y and z components of the ray, whose x component is 1 (as
+ * for Camera::CameraToSpatial).
+ */
+class RayTable {
+ public:
+    RayTable(const Camera &camera, int step);
+    RayTable(const Camera &camera, int step, std::vector<decimal> rayY, std::vector<decimal> rayZ);
+
+    bool Matches(const Camera &camera) const;
+
+    /**
+     * Looks up the ray of a point on the sensor
+     *
+     * @param x,y The point on the sensor
+     * @param rayY,rayZ The outputs, i.e. the y and z components of the ray of the
+     * point whose x component is 1
+     *
+     * @note Points off the sensor are extrapolated from the nearest entries
+     */
+    void Lookup(decimal x, decimal y, decimal &rayY, decimal &rayZ) const {
+        decimal column = x * inverseStep;
+        decimal row = y * inverseStep;
+        int i = std::min(std::max(static_cast<int>(column), 0), columns - 2);
+        int j = std::min(std::max(static_cast<int>(row), 0), rows - 2);
+        decimal s = column - i;
+        decimal t = row - j;
+        size_t entry = static_cast<size_t>(j) * columns + i;
+        rayY = Interpolate(this->rayY.data() + entry, s, t);
+        rayZ = Interpolate(this->rayZ.data() + entry, s, t);
+    }
+
+    /**
+     * Returns the camera this table was made for
+     *
+     * @return The camera of this, with no table of its own
+     */
+    const Camera &GetCamera() const { return camera; }
+
+    /// Returns the number of pixels between neighbouring entries
+    int Step() const { return step; }
+    /// Returns the number of entries in each row of this
+    int Columns() const { return columns; }
+    /// Returns the number of rows of entries of this
+    int Rows() const { return rows; }
+    /// Returns the y component of the ray of every entry, row by row
+    const std::vector<decimal> &RayY() const { return rayY; }
+    /// Returns the z component of the ray of every entry, row by row
+    const std::vector<decimal> &RayZ() const { return rayZ; }
+
+    static size_t Entries(const Camera &camera, int step);
+
+ private:
+    /**
+     * Interpolates between four entries of a component
+     *
+     * @param entry The top left of the entries
+     * @param s,t The position between the entries, from 0 to 1 along each axis
+     *
+     * @return The interpolated value
+     */
+    decimal Interpolate(const decimal *entry, decimal s, decimal t) const {
+        decimal top = entry[0] + (entry[1] - entry[0]) * s;
+        decimal bottom = entry[columns] + (entry[columns + 1] - entry[columns]) * s;
+        return top + (bottom - top) * t;
+    }
+
+    /// The camera this was made for
+    Camera camera;
+    /// The number of pixels between neighbouring entries
+    int step;
+    /// 1 / step
+    decimal inverseStep;
+    /// The number of entries in each row
+    int columns;
+    /// The number of rows of entries
+    int rows;
+    /// The y component of the ray of every entry
+    std::vector<decimal> rayY;
+    /// The z component of the ray of every entry
+    std::vector<decimal> rayZ;
 };
 
 // Conversions from FOV to Focal Length
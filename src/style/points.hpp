@@ -0,0 +1,197 @@
+#ifndef POINTS_H
+#define POINTS_H
+
+#include <stddef.h>
+
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#include "common/memory.hpp"
+#include "spatial/attitude-utils.hpp"
+
+namespace found {
+
+/**
+ * A BasicPointSet is a set of 2D points, stored as a structure of arrays:
+ * all x coordinates are in one aligned array, and all y coordinates in
+ * another. Loops over every point (e.g. fitting the horizon) can then
+ * process several points per instruction.
+ *
+ * A BasicPointSet reads like a std::vector<Vec2> (size, push_back, [],
+ * range for), except that points are handed out by value.
+ *
+ * @param Allocator The allocator of the coordinates (see PointSet, and
+ * ScratchPoints in style.hpp)
+ *
+ * @note Clearing a BasicPointSet keeps its storage, so refilling it with
+ * as many points does not allocate
+ */
+template<typename Allocator>
+class BasicPointSet {
+ public:
+    /// The storage of one coordinate of every point
+    typedef std::vector<decimal, Allocator> Coordinates;
+
+    /**
+     * Iterates over the points of a BasicPointSet, in order
+     */
+    class const_iterator {
+     public:
+        /**
+         * Creates a const_iterator
+         *
+         * @param points The BasicPointSet to iterate over
+         * @param index The index of the point this is at
+         */
+        const_iterator(const BasicPointSet &points, size_t index) : points(&points), index(index) {}
+
+        /// Returns the point this is at
+        Vec2 operator*() const { return (*this->points)[this->index]; }
+        /// Moves this to the next point
+        const_iterator &operator++() { this->index++; return *this; }
+        /// Tells whether this is at the same point as other
+        bool operator==(const const_iterator &other) const { return this->index == other.index; }
+        /// Tells whether this is at a different point than other
+        bool operator!=(const const_iterator &other) const { return this->index != other.index; }
+
+     private:
+        /// The BasicPointSet this iterates over
+        const BasicPointSet *points;
+        /// The index of the point this is at
+        size_t index;
+    };
+
+    /**
+     * Creates an empty BasicPointSet
+     */
+    BasicPointSet() = default;
+
+    /**
+     * Creates an empty BasicPointSet
+     *
+     * @param allocator The allocator of the coordinates (e.g. of an Arena)
+     */
+    explicit BasicPointSet(const Allocator &allocator) : xs(allocator), ys(allocator) {}
+
+    /**
+     * Creates a BasicPointSet
+     *
+     * @param points The points of the BasicPointSet, in order
+     */
+    BasicPointSet(std::initializer_list<Vec2> points) {  // NOLINT
+        this->reserve(points.size());
+        for (const Vec2 &point : points) this->push_back(point);
+    }
+
+    /// Returns the number of points
+    size_t size() const { return this->xs.size(); }
+    /// Returns true iff there are no points
+    bool empty() const { return this->xs.empty(); }
+    /// Returns the number of points this can hold without allocating
+    size_t capacity() const { return this->xs.capacity(); }
+
+    /**
+     * Makes room for points
+     *
+     * @param count The number of points this should be able to hold without allocating
+     */
+    void reserve(size_t count) {
+        this->xs.reserve(count);
+        this->ys.reserve(count);
+    }
+
+    /**
+     * Changes the number of points
+     *
+     * @param count The new number of points (new points are at the origin)
+     */
+    void resize(size_t count) {
+        this->xs.resize(count);
+        this->ys.resize(count);
+    }
+
+    /**
+     * Removes every point, keeping the storage
+     */
+    void clear() {
+        this->xs.clear();
+        this->ys.clear();
+    }
+
+    /**
+     * Adds a point at the end
+     *
+     * @param x,y The point
+     */
+    void push_back(decimal x, decimal y) {
+        this->xs.push_back(x);
+        this->ys.push_back(y);
+    }
+
+    /**
+     * Adds a point at the end
+     *
+     * @param point The point
+     */
+    void push_back(const Vec2 &point) { this->push_back(point.x, point.y); }
+
+    /**
+     * Provides a point
+     *
+     * @param index The index of the point
+     *
+     * @return The point at index
+     */
+    Vec2 operator[](size_t index) const { return {this->xs[index], this->ys[index]}; }
+
+    /**
+     * Provides a point
+     *
+     * @param index The index of the point
+     *
+     * @return The point at index
+     *
+     * @throws out_of_range iff index is not less than size()
+     */
+    Vec2 at(size_t index) const {
+        if (index >= this->size()) throw std::out_of_range("There is no such point");
+        return (*this)[index];
+    }
+
+    /// Returns the x coordinates of every point
+    decimal *x() { return this->xs.data(); }
+    /// Returns the x coordinates of every point
+    const decimal *x() const { return this->xs.data(); }
+    /// Returns the y coordinates of every point
+    decimal *y() { return this->ys.data(); }
+    /// Returns the y coordinates of every point
+    const decimal *y() const { return this->ys.data(); }
+
+    /// Returns an iterator at the first point
+    const_iterator begin() const { return const_iterator(*this, 0); }
+    /// Returns an iterator past the last point
+    const_iterator end() const { return const_iterator(*this, this->size()); }
+
+    /**
+     * Tells whether two BasicPointSets hold the same points, in the same order
+     *
+     * @param other The other BasicPointSet
+     *
+     * @return true iff this and other are equal
+     */
+    bool operator==(const BasicPointSet &other) const { return this->xs == other.xs && this->ys == other.ys; }
+
+ private:
+    /// The x coordinates of every point
+    Coordinates xs;
+    /// The y coordinates of every point
+    Coordinates ys;
+};
+
+/// A set of 2D points on the heap, whose storage is reused from one run to the next
+typedef BasicPointSet<AlignedAllocator<decimal>> PointSet;
+
+}  // namespace found
+
+#endif
@@ -6,17 +6,32 @@
 #ifndef STYLE_H
 #define STYLE_H
 
+#include <stddef.h>
+
 #include <vector>
 #include <functional>
+#include <memory>
 #include <utility>
 
+#include "common/arena.hpp"
 #include "spatial/attitude-utils.hpp"
+#include "style/points.hpp"
 
 namespace found {
 
 /// The output for Edge Detection Algorithms (edge.hpp/cpp). Currently set
-/// to a vector of 2D points on the image, according to image coordinate systems
-typedef std::vector<Vec2> Points;
+/// to a set of 2D points on the image, according to image coordinate systems,
+/// stored as separate x and y arrays (see points.hpp)
+typedef PointSet Points;
+
+/// Scratch storage of a stage, for one frame: a vector whose storage comes from
+/// the Arena of its Pipeline (see Action::Scratch), so that it never calls the heap
+template<typename T>
+using ScratchVector = std::vector<T, ArenaAllocator<T>>;
+
+/// Scratch points of a stage, for one frame, whose storage comes from the Arena of
+/// its Pipeline (e.g. ScratchPoints candidates(ArenaAllocator<decimal>(&arena)))
+typedef BasicPointSet<ArenaAllocator<decimal>> ScratchPoints;
 
 /// The output for Distance Determination Algorithms (distance.hpp/cpp). Currently
 /// set to a floating point value that represents the distance from Earth
@@ -28,80 +43,70 @@ typedef decimal distFromEarth;
 typedef Vec3 PositionVector;
 
 /**
- * Represents an image
+ * Represents an image, whose pixels are stored row by row with their channels interleaved
+ *
+ * An Image may wrap memory it does not own (a camera buffer, a memory-mapped file, ...) without
+ * copying it. Rows may be padded, in which case stride gives the distance between the starts of
+ * two consecutive rows.
+ *
+ * @note Images are created with aggregate initialization, e.g. {pixels, {width, height, channels}},
+ * in which case stride (0) means that rows are not padded, and the pixels are not owned by the
+ * Image
  */
 struct Image {
     /// The image contents
     unsigned char *image;
     /// The image {width, height, channels}
     int dimensions[3];
+    /// The number of bytes from the start of one row to the start of the next (0 if rows are not padded)
+    size_t stride;
+    /// Keeps the memory of image alive while any copy of this Image exists (empty if it is borrowed)
+    std::shared_ptr<void> owner;
+
+    /**
+     * Provides the distance between two rows of this
+     *
+     * @return The number of bytes from the start of one row to the start of the next
+     */
+    size_t RowStride() const {
+        return this->stride != 0 ? this->stride : static_cast<size_t>(this->dimensions[0]) * this->dimensions[2];
+    }
+
+    /**
+     * Provides a row of this
+     *
+     * @param y The index of the row
+     *
+     * @return The first pixel of row y
+     */
+    unsigned char *Row(int y) const {
+        return this->image + static_cast<size_t>(y) * this->RowStride();
+    }
 };
 
 /**
  * OrbitParams defines the orbital
- * parameters of a given orbit
+ * parameters of a given orbit, as its Keplerian elements
+ *
+ * @note OrbitParams are plain data, so that they can be copied, logged
+ * (see io/serialization.hpp) and evaluated without indirect calls (see
+ * model/kepler.hpp).
  */
 struct OrbitParams {
     /// The initial position of the satellite with respect to Earth
-    /// (at t = 0 and theta = 0)
+    /// (at t = 0)
     Vec3 initialCondition;
 
-    /**
-     * The position of the satellite as a function of the number of revolutions
-     * it has done
-     * 
-     * @param theta The number of revolutions the satellite has done
-     * 
-     * @return The position vector after theta revolutions have taken place
-     * */
-    Vec3 (* position)(int theta);
-
-    /**
-     * The major axis vector as a function with respect to the revolutions
-     * of the satellite
-     * 
-     * @param theta The number of revolutions the satellite has done
-     * 
-     * @return The major axis vector after theta revolutions have taken
-     * place
-     * */
-    Vec3 (* majorAxis)(int theta);
-
-    /**
-     * The minor axis vector as a function with respect to the revolutions
-     * of the satellite
-     * 
-     * @param theta The number of revolutions the satellite has done
-     * 
-     * @return The minor axis vector after theta revolutions have taken
-     * place
-     * */
-    Vec3 (* minorAxis)(int theta);
-
-    /**
-     * The angular speed that the satellite's orbit plane rotates in plane at with respect
-     * to the number of revolutions in the satellite's orbit. This is the same as
-     * the speed at which the major axis rotates around the barycenter of orbit in the plane
-     * of orbit, which is approximately at Earth's center
-     * 
-     * @param theta The number of revolutions the satellite has done
-     * 
-     * @return The angular speed at which the plane of orbit rotates at, in plane, after theta 
-     * revolutions
-     * */
-    decimal (* inPlaneRotation)(int theta);
-
-    /**
-     * The angular speed that the satellite's orbit plane rotates out of plane at with 
-     * respect to the number of revolutions in the satellite's orbit. This is the same as
-     * the angular speed at which the plane of orbit changes
-     * 
-     * @param theta The number of revolutions the satellite has done
-     * 
-     * @return The angular speed at which the orbital plane rotates at, out of plane, after
-     * theta revolutions
-     * */
-    decimal (* outPlaneRotation)(int theta);
+    /// The semi-major axis of the orbit, in km
+    preciseDecimal semiMajorAxis;
+    /// The eccentricity of the orbit (0 for a circle, and less than 1)
+    preciseDecimal eccentricity;
+    /// The unit vector from Earth's center towards periapsis
+    PreciseVec3 periapsis;
+    /// The unit normal of the orbit plane, along the angular momentum
+    PreciseVec3 normal;
+    /// The mean anomaly of the satellite at t = 0, in radians
+    preciseDecimal meanAnomaly;
 };
 
 /// The output for Orbit Trajectory Calculation Algorithms. Currently set to
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "src/command-line/batch.hpp"
+
+#include "test/common/constants/edge-constants.hpp"
+
+namespace found {
+
+/**
+ * Writes the square image as a PGM
+ *
+ * @param path The path to write to
+ */
+static void WriteSquare(const std::string &path) {
+    std::ofstream file(path, std::ios::binary);
+    file << "P5 " << kSquareWidth << " " << kSquareHeight << " 255\n";
+    file.write(reinterpret_cast<const char *>(squarePixels.data()), squarePixels.size());
+}
+
+/**
+ * Makes a directory of frames: two copies of the square image, and a file that is not an image
+ *
+ * @param name The name of the directory
+ *
+ * @return The path to the directory
+ */
+static std::string MakeFrames(const std::string &name) {
+    std::string directory = testing::TempDir() + name;
+    mkdir(directory.c_str(), 0755);
+    WriteSquare(directory + "/1.pgm");
+    WriteSquare(directory + "/2.pgm");
+    std::ofstream(directory + "/3.txt") << "Not an image";
+    return directory;
+}
+
+/**
+ * Tests processing a directory of frames
+ */
+TEST(BatchCommandTest, TestBatchDirectory) {
+    std::string directory = MakeFrames("found-batch");
+    Options options;
+    options.directory = directory;
+    options.threads = 2;
+
+    std::ostringstream out;
+    ASSERT_EQ(1, BatchCommand(options, out));
+
+    std::istringstream lines(out.str());
+    std::string line;
+    for (const char *name : {"/1.pgm", "/2.pgm"}) {
+        ASSERT_TRUE(static_cast<bool>(std::getline(lines, line)));
+        std::string prefix = directory + name + "\t" + std::to_string(squareEdges.size()) + "\t";
+        ASSERT_EQ(prefix, line.substr(0, prefix.size()));
+        std::istringstream coordinates(line.substr(prefix.size()));
+        for (const Vec2 &edge : squareEdges) {
+            decimal x, y;
+            coordinates >> x >> y;
+            ASSERT_EQ(edge.x, x);
+            ASSERT_EQ(edge.y, y);
+        }
+    }
+    ASSERT_TRUE(static_cast<bool>(std::getline(lines, line)));
+    ASSERT_EQ(directory + "/3.txt\terror\t", line.substr(0, directory.size() + 13));
+    ASSERT_FALSE(static_cast<bool>(std::getline(lines, line)));
+}
+
+/**
+ * Tests processing the frames of a manifest with the LoG algorithm
+ */
+TEST(BatchCommandTest, TestBatchManifest) {
+    std::string directory = MakeFrames("found-batch-manifest");
+    {
+        std::ofstream manifest(directory + "/frames.txt");
+        manifest << "2.pgm\n1.pgm\n";
+    }
+    Options options;
+    options.manifest = directory + "/frames.txt";
+    options.edgeAlgorithm = "loc";
+    options.edgeThreshold = kLoCThreshold;
+
+    std::ostringstream out;
+    ASSERT_EQ(0, BatchCommand(options, out));
+    std::string first = directory + "/2.pgm\t";
+    ASSERT_EQ(first, out.str().substr(0, first.size()));
+
+    // A single image is a batch of one frame
+    Options single = options;
+    single.manifest = "";
+    single.image = directory + "/2.pgm";
+    std::ostringstream image;
+    ASSERT_EQ(0, BatchCommand(single, image));
+    ASSERT_EQ(out.str().substr(0, out.str().find('\n') + 1), image.str());
+    ASSERT_NE(std::string::npos, out.str().find("\n" + directory + "/1.pgm\t"));
+}
+
+/**
+ * Tests invalid options of the batch command
+ */
+TEST(BatchCommandTest, TestBatchInvalid) {
+    std::ostringstream out;
+    Options options;
+    ASSERT_THROW(BatchCommand(options, out), std::invalid_argument);
+
+    options.directory = MakeFrames("found-batch-invalid");
+    options.threads = -1;
+    ASSERT_THROW(BatchCommand(options, out), std::invalid_argument);
+
+    options.threads = 1;
+    options.edgeAlgorithm = "canny";
+    ASSERT_THROW(BatchCommand(options, out), std::invalid_argument);
+    options.edgeAlgorithm = "simple";
+    options.subpixelRadius = -1;
+    ASSERT_THROW(BatchCommand(options, out), std::invalid_argument);
+    ASSERT_TRUE(out.str().empty());
+}
+
+/**
+ * Tests making edge detection algorithms that refine and thin out their points
+ */
+TEST(BatchCommandTest, TestBatchSubpixel) {
+    Options options;
+    options.maxPoints = 3;
+    std::unique_ptr<EdgeDetectionAlgorithm> thinned = MakeEdgeDetectionAlgorithm(options);
+    ASSERT_EQ(3u, thinned->Run(squareImage).size());
+
+    options.maxPoints = 0;
+    options.subpixelRadius = 2;
+    std::unique_ptr<EdgeDetectionAlgorithm> refined = MakeEdgeDetectionAlgorithm(options);
+    Points points = refined->Run(squareImage);
+    ASSERT_FALSE(points.empty());
+    ASSERT_FALSE(points == squareEdges);
+}
+
+/**
+ * Tests moving the pipelines of a worker to new options, without making new ones
+ */
+TEST(BatchCommandTest, TestEdgeVariants) {
+    Options options;
+    EdgeVariants variants(options);
+    Pipeline<Image, Points> *simple = &variants.Selected();
+    ASSERT_EQ(squareEdges, simple->Run(squareImage));
+
+    options.edgeAlgorithm = "loc";
+    options.edgeThreshold = kLoCThreshold;
+    options.maxPoints = 3;
+    variants.Configure(options);
+    ASSERT_EQ(&variants.Variant("loc"), &variants.Selected());
+    ASSERT_EQ(MakeEdgeDetectionAlgorithm(options)->Run(squareImage), variants.Selected().Run(squareImage));
+
+    options.edgeAlgorithm = "canny";
+    ASSERT_THROW(variants.Configure(options), std::invalid_argument);
+    options.edgeAlgorithm = "simple";
+    options.edgeThreshold = 100;
+    options.maxPoints = 0;
+    variants.Configure(options);
+    ASSERT_EQ(simple, &variants.Selected());
+    ASSERT_EQ(squareEdges, variants.Selected().Run(squareImage));
+}
+
+/**
+ * Tests a batch that takes a new version of its configuration file
+ */
+TEST(BatchCommandTest, TestBatchReload) {
+    std::string directory = MakeFrames("found-batch-reload");
+    std::string config = directory + "/found.conf";
+    std::ofstream(config) << "edge-algorithm = simple\n";
+    Options options;
+    options.directory = directory;
+    options.threads = 2;
+    ConfigReloader reloader(config, {{"directory", directory}}, CheckEdgeOptions, nullptr,
+                            std::chrono::milliseconds(0));
+    reloader.Current(options);
+
+    // The workers take the new version before their first frame
+    std::ofstream(config) << "edge-algorithm = loc\nedge-threshold = " << kLoCThreshold << "\nimage-channels = 1\n";
+    std::ostringstream reloaded;
+    ASSERT_EQ(1, BatchCommand(options, reloaded, &reloader));
+    Options loc = options;
+    loc.edgeAlgorithm = "loc";
+    loc.edgeThreshold = kLoCThreshold;
+    std::ostringstream expected;
+    ASSERT_EQ(1, BatchCommand(loc, expected));
+    ASSERT_EQ(expected.str(), reloaded.str());
+
+    // A bad version keeps the last good one
+    std::ofstream(config) << "edge-algorithm = canny\n";
+    reloaded.str("");
+    ASSERT_EQ(1, BatchCommand(options, reloaded, &reloader));
+    ASSERT_EQ(expected.str(), reloaded.str());
+}
+
+/**
+ * Tests writing the profile of a batch, which needs instrumentation
+ */
+TEST(BatchCommandTest, TestBatchProfile) {
+    Options options;
+    options.directory = MakeFrames("found-batch-profile");
+    options.threads = 2;
+    options.profile = options.directory + "/profile.json";
+
+    std::ostringstream out;
+#ifdef FOUND_INSTRUMENTATION
+    ASSERT_EQ(1, BatchCommand(options, out));
+    std::ifstream file(options.profile);
+    std::stringstream profile;
+    profile << file.rdbuf();
+    ASSERT_NE(std::string::npos, profile.str().find("\"name\": \"SimpleEdgeDetectionAlgorithm\""));
+    ASSERT_NE(std::string::npos, profile.str().find("\"frames\": {\"count\": 2,"));
+
+    options.profile = options.directory + "/missing/profile.json";
+    ASSERT_THROW(BatchCommand(options, out), std::runtime_error);
+#else
+    ASSERT_THROW(BatchCommand(options, out), std::invalid_argument);
+#endif
+}
+
+}  // namespace found
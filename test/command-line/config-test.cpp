@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/command-line/config.hpp"
+
+namespace found {
+
+/**
+ * Writes a configuration file
+ *
+ * @param path The path to write to
+ * @param text The contents of the file
+ */
+static void WriteConfig(const std::string &path, const std::string &text) {
+    std::ofstream(path) << text;
+}
+
+/**
+ * Reads a command line
+ *
+ * @param arguments The arguments, after the name of the program
+ *
+ * @return The options they give
+ */
+static Options ParseArguments(const std::vector<std::string> &arguments) {
+    // getopt may reorder argv, so it is given its own copy of every argument
+    std::vector<std::vector<char>> storage;
+    std::vector<char *> argv;
+    std::vector<std::string> all(1, "found");
+    all.insert(all.end(), arguments.begin(), arguments.end());
+    for (const std::string &argument : all) storage.emplace_back(argument.begin(), argument.end());
+    for (std::vector<char> &argument : storage) {
+        argument.push_back('\0');
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+    Options options;
+    OptionOverrides overrides;
+    ParseCommandLine(static_cast<int>(storage.size()), argv.data(), options, overrides);
+    return options;
+}
+
+/**
+ * Tests options whose argument is optional, on the command line
+ */
+TEST(ConfigTest, TestParseCommandLineOptionalArgument) {
+    ASSERT_TRUE(ParseArguments({"generate", "--output", "frames", "--frames", "1", "--image-width", "64",
+                                "--image-height", "64", "--sun-longitude", "180", "--terminator"}).terminator);
+    ASSERT_TRUE(ParseArguments({"generate", "--terminator", "--output", "frames"}).terminator);
+    ASSERT_TRUE(ParseArguments({"generate", "--terminator=1"}).terminator);
+    ASSERT_FALSE(ParseArguments({"generate", "--terminator", "0"}).terminator);
+    ASSERT_FALSE(ParseArguments({"generate", "--output", "frames"}).terminator);
+
+    Options options = ParseArguments({"generate", "--output", "frames", "--frames", "2"});
+    ASSERT_EQ("frames", options.output);
+    ASSERT_EQ(2, options.frames);
+    ASSERT_THROW(ParseArguments({"generate", "--canny"}), std::invalid_argument);
+}
+
+/**
+ * Tests pinning the workers from the command line
+ */
+TEST(ConfigTest, TestParseCommandLinePinThreads) {
+    ASSERT_TRUE(ParseArguments({"batch", "--threads", "2", "--pin-threads"}).pinThreads);
+    ASSERT_TRUE(ParseArguments({"batch", "--pin-threads", "--threads", "2"}).pinThreads);
+    ASSERT_FALSE(ParseArguments({"batch", "--pin-threads=0", "--threads", "2"}).pinThreads);
+}
+
+/**
+ * Tests the radius of sub-pixel refinement from the command line
+ */
+TEST(ConfigTest, TestParseCommandLineSubpixelRadius) {
+    ASSERT_EQ(0, ParseArguments({"batch", "--image", "frame.pgm"}).subpixelRadius);
+    ASSERT_EQ(3, ParseArguments({"batch", "--image", "frame.pgm", "--subpixel-radius"}).subpixelRadius);
+    ASSERT_EQ(3, ParseArguments({"batch", "--subpixel-radius", "--image", "frame.pgm"}).subpixelRadius);
+    ASSERT_EQ(5, ParseArguments({"batch", "--image", "frame.pgm", "--subpixel-radius", "5"}).subpixelRadius);
+    ASSERT_EQ(5, ParseArguments({"batch", "--subpixel-radius=5", "--image", "frame.pgm"}).subpixelRadius);
+}
+
+/**
+ * Tests reading the options of a configuration file
+ */
+TEST(ConfigTest, TestReadConfig) {
+    std::string path = testing::TempDir() + "found-config.txt";
+    WriteConfig(path, "# The edges\n"
+                      "edge-algorithm = loc   # Not simple\n"
+                      "\n"
+                      "  loc-sigma=2.5\n"
+                      "subpixel-radius\n"
+                      "pin-threads = 0\n"
+                      "max-points = 40\n");
+    Options options;
+    ReadConfig(path, options);
+    ASSERT_EQ("loc", options.edgeAlgorithm);
+    ASSERT_EQ(2.5, options.locSigma);
+    ASSERT_EQ(3, options.subpixelRadius);
+    ASSERT_FALSE(options.pinThreads);
+    ASSERT_EQ(40u, options.maxPoints);
+    // Options the file does not name keep their values
+    ASSERT_EQ(100, options.edgeThreshold);
+
+    ApplyOption("edge-threshold", "7", options);
+    ASSERT_EQ(7, options.edgeThreshold);
+}
+
+/**
+ * Tests configuration files that are not options
+ */
+TEST(ConfigTest, TestReadConfigInvalid) {
+    Options options;
+    ASSERT_THROW(ReadConfig(testing::TempDir() + "found-config-missing.txt", options), std::runtime_error);
+    ASSERT_THROW(ApplyOption("edge-threshold", "", options), std::invalid_argument);
+
+    std::string path = testing::TempDir() + "found-config-invalid.txt";
+    for (const char *text : {"canny = 1\n", "threads = 2\nedge-threshold\n", "config = other.txt\n"}) {
+        WriteConfig(path, text);
+        ASSERT_THROW(ReadConfig(path, options), std::invalid_argument);
+    }
+    try {
+        ReadConfig(path, options);
+    } catch (const std::invalid_argument &error) {
+        ASSERT_EQ(path + ":1:", std::string(error.what()).substr(0, path.size() + 3));
+    }
+}
+
+/**
+ * Tests taking new versions of a configuration file, under the command line
+ */
+TEST(ConfigTest, TestConfigReloader) {
+    std::string path = testing::TempDir() + "found-config-reload.txt";
+    WriteConfig(path, "edge-threshold = 50\nloc-sigma = 2\n");
+    std::vector<std::string> rejected;
+    ConfigReloader reloader(path, {{"loc-sigma", "3"}},
+                            [](const Options &options) {
+                                if (options.edgeThreshold < 0) throw std::invalid_argument("Negative threshold");
+                            },
+                            [&](const std::string &reason) { rejected.push_back(reason); },
+                            std::chrono::milliseconds(0));
+
+    Options options;
+    ASSERT_EQ(0u, reloader.Current(options));
+    ASSERT_EQ(50, options.edgeThreshold);
+    ASSERT_EQ(3, options.locSigma);
+    ASSERT_EQ(path, options.config);
+    ASSERT_EQ(0u, reloader.Poll());
+
+    // Each version has another size, so that it is new even within one tick of the clock
+    WriteConfig(path, "edge-threshold = 60\n");
+    ASSERT_EQ(1u, reloader.Poll());
+    ASSERT_EQ(1u, reloader.Current(options));
+    ASSERT_EQ(60, options.edgeThreshold);
+    ASSERT_EQ(3, options.locSigma);
+
+    WriteConfig(path, "edge-threshold = -10\n");
+    ASSERT_EQ(1u, reloader.Poll());
+    WriteConfig(path, "edge-thresh = 70\n");
+    ASSERT_EQ(1u, reloader.Poll());
+    ASSERT_EQ(2u, rejected.size());
+    reloader.Current(options);
+    ASSERT_EQ(60, options.edgeThreshold);
+
+    WriteConfig(path, "edge-threshold = 80 \n");
+    ASSERT_EQ(2u, reloader.Poll());
+    reloader.Current(options);
+    ASSERT_EQ(80, options.edgeThreshold);
+
+    WriteConfig(path, "edge-threshold = -1\n");
+    ASSERT_THROW(ConfigReloader(path, {}, [](const Options &options) {
+        if (options.edgeThreshold < 0) throw std::invalid_argument("Negative threshold");
+    }), std::invalid_argument);
+}
+
+}  // namespace found
@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/command-line/generate.hpp"
+#include "src/io/image.hpp"
+#include "src/io/serialization.hpp"
+
+namespace found {
+
+/**
+ * Makes the options of a small corpus
+ *
+ * @param name The name of the directory of the corpus
+ *
+ * @return The options
+ */
+static Options MakeGenerateOptions(const std::string &name) {
+    Options options;
+    options.output = testing::TempDir() + name;
+    options.frames = 3;
+    options.imageWidth = 128;
+    options.imageHeight = 96;
+    options.focalLength = 100;
+    options.noise = 2;
+    options.blur = 0.5;
+    options.supersample = 2;
+    options.seed = 5;
+    return options;
+}
+
+/**
+ * Tests generating a corpus with its ground truth
+ */
+TEST(GenerateCommandTest, TestGenerateTruth) {
+    Options options = MakeGenerateOptions("found-generate");
+    options.truth = options.output + "-truth.txt";
+    options.threads = 2;
+    std::ostringstream out;
+    ASSERT_EQ(0, GenerateCommand(options, out));
+
+    std::istringstream manifest(out.str());
+    std::ifstream truth(options.truth);
+    std::string path, line;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(static_cast<bool>(std::getline(manifest, path)));
+        ASSERT_EQ(options.output + "/frame-00000" + std::to_string(i) + ".pgm", path);
+        Image image = MapImage(path);
+        ASSERT_EQ(128, image.dimensions[0]);
+        ASSERT_EQ(96, image.dimensions[1]);
+
+        ASSERT_TRUE(static_cast<bool>(std::getline(truth, line)));
+        std::istringstream fields(line);
+        std::string truthPath;
+        decimal distance;
+        size_t count;
+        std::getline(fields, truthPath, '\t');
+        fields >> distance >> count;
+        ASSERT_EQ(path, truthPath);
+        ASSERT_NEAR(options.equatorialRadius + options.altitude, distance, 1e-2);
+        ASSERT_GT(count, 0u);
+
+        // The camera looks at the horizon, so it passes through the middle of the image
+        decimal nearest = 1e9;
+        for (size_t j = 0; j < count; j++) {
+            decimal x, y;
+            fields >> x >> y;
+            ASSERT_TRUE(x >= 0 && x <= 128 && y >= 0 && y <= 96);
+            nearest = std::min(nearest, static_cast<decimal>(hypot(x - 64, y - 48)));
+        }
+        ASSERT_LT(nearest, 1);
+        // Earth is below the horizon, and space above it
+        ASSERT_GT(image.Row(90)[64], 150);
+        ASSERT_LT(image.Row(5)[64], 50);
+    }
+    ASSERT_FALSE(static_cast<bool>(std::getline(manifest, path)));
+}
+
+/**
+ * Tests that a corpus is the same for any number of threads
+ */
+TEST(GenerateCommandTest, TestGenerateDeterministic) {
+    Options options = MakeGenerateOptions("found-generate-one");
+    options.threads = 1;
+    options.terminator = true;
+    std::ostringstream one;
+    ASSERT_EQ(0, GenerateCommand(options, one));
+    Options many = MakeGenerateOptions("found-generate-many");
+    many.threads = 3;
+    many.terminator = true;
+    std::ostringstream other;
+    ASSERT_EQ(0, GenerateCommand(many, other));
+
+    for (int i = 0; i < 3; i++) {
+        std::string name = "/frame-00000" + std::to_string(i) + ".pgm";
+        Image first = MapImage(options.output + name);
+        Image second = MapImage(many.output + name);
+        ASSERT_TRUE(std::equal(first.image, first.image + 128 * 96, second.image));
+    }
+    // Consecutive frames are seeded apart
+    Image first = MapImage(options.output + "/frame-000000.pgm");
+    Image second = MapImage(options.output + "/frame-000001.pgm");
+    ASSERT_FALSE(std::equal(first.image, first.image + 128 * 96, second.image));
+}
+
+/**
+ * Tests generating through a distorted lens, whose table of rays is kept in a file
+ */
+TEST(GenerateCommandTest, TestGenerateDistortion) {
+    LensDistortion distortion = ParseDistortion("-0.2,0.05,0.001,-0.0005,0.01");
+    ASSERT_EQ(static_cast<decimal>(-0.2), distortion.k1);
+    ASSERT_EQ(static_cast<decimal>(0.05), distortion.k2);
+    ASSERT_EQ(static_cast<decimal>(0.001), distortion.p1);
+    ASSERT_EQ(static_cast<decimal>(-0.0005), distortion.p2);
+    ASSERT_EQ(static_cast<decimal>(0.01), distortion.k3);
+    ASSERT_EQ(0, ParseDistortion("-0.1").k2);
+    ASSERT_EQ(0, ParseDistortion("").k1);
+    ASSERT_THROW(ParseDistortion("-0.1,x"), std::invalid_argument);
+    ASSERT_THROW(ParseDistortion("1,2,3,4,5,6"), std::invalid_argument);
+    ASSERT_THROW(ParseDistortion("1;2"), std::invalid_argument);
+    ASSERT_THROW(ParseDistortion("0.1,"), std::invalid_argument);
+    ASSERT_THROW(ParseDistortion("0.1,,0.2"), std::invalid_argument);
+
+    Options options = MakeGenerateOptions("found-generate-distorted");
+    options.frames = 1;
+    options.distortion = "-0.2,0.05";
+    options.rayTable = options.output + "-rays.bin";
+    options.rayTableStep = 4;
+    std::remove(options.rayTable.c_str());
+    std::ostringstream out;
+    ASSERT_EQ(0, GenerateCommand(options, out));
+    std::shared_ptr<const RayTable> table = ReadRayTable(options.rayTable);
+    ASSERT_EQ(4, table->Step());
+    ASSERT_EQ(static_cast<decimal>(-0.2), table->GetCamera().Distortion().k1);
+    Image distorted = MapImage(options.output + "/frame-000000.pgm");
+
+    // The table is read back, and the frame is the same
+    ASSERT_EQ(0, GenerateCommand(options, out));
+    ASSERT_EQ(table->RayY(), ReadRayTable(options.rayTable)->RayY());
+    Image again = MapImage(options.output + "/frame-000000.pgm");
+    ASSERT_TRUE(std::equal(distorted.image, distorted.image + 128 * 96, again.image));
+
+    // An empty or truncated table is made again
+    std::vector<unsigned char> records;
+    SerializeRayTable(*table, records);
+    std::fill(records.begin() + 16, records.begin() + 24, 0);
+    WriteRecords(options.rayTable, records);
+    ASSERT_EQ(0, GenerateCommand(options, out));
+    ASSERT_EQ(table->RayY(), ReadRayTable(options.rayTable)->RayY());
+    records.clear();
+    SerializeRayTable(*table, records);
+    records.resize(records.size() / 2);
+    WriteRecords(options.rayTable, records);
+    ASSERT_EQ(0, GenerateCommand(options, out));
+    ASSERT_EQ(table->RayY(), ReadRayTable(options.rayTable)->RayY());
+
+    // A table for another lens is made again
+    options.distortion = "-0.1";
+    ASSERT_EQ(0, GenerateCommand(options, out));
+    ASSERT_EQ(static_cast<decimal>(-0.1), ReadRayTable(options.rayTable)->GetCamera().Distortion().k1);
+    options.rayTableStep = 0;
+    ASSERT_THROW(GenerateCommand(options, out), std::invalid_argument);
+}
+
+/**
+ * Tests generating with invalid options
+ */
+TEST(GenerateCommandTest, TestGenerateInvalid) {
+    std::ostringstream out;
+    Options options = MakeGenerateOptions("found-generate-invalid");
+    options.output = "";
+    ASSERT_THROW(GenerateCommand(options, out), std::invalid_argument);
+    options = MakeGenerateOptions("found-generate-invalid");
+    options.frames = -1;
+    ASSERT_THROW(GenerateCommand(options, out), std::invalid_argument);
+    options = MakeGenerateOptions("found-generate-invalid");
+    options.altitude = 0;
+    ASSERT_THROW(GenerateCommand(options, out), std::invalid_argument);
+    options = MakeGenerateOptions("found-generate-invalid");
+    options.supersample = 0;
+    ASSERT_THROW(GenerateCommand(options, out), std::invalid_argument);
+    options = MakeGenerateOptions("found-generate-invalid");
+    options.imageWidth = -5;
+    ASSERT_THROW(GenerateCommand(options, out), std::invalid_argument);
+    options = MakeGenerateOptions("found-generate-invalid");
+    options.truth = testing::TempDir() + "missing/truth.txt";
+    ASSERT_THROW(GenerateCommand(options, out), std::runtime_error);
+    // The output directory cannot be made, which fails before any frame is rendered
+    options = MakeGenerateOptions("missing/found-generate");
+    options.truth = testing::TempDir() + "found-generate-unmade.txt";
+    std::remove(options.truth.c_str());
+    ASSERT_THROW(GenerateCommand(options, out), std::runtime_error);
+    ASSERT_FALSE(std::ifstream(options.truth).good());
+    ASSERT_TRUE(out.str().empty());
+}
+
+}  // namespace found
@@ -0,0 +1,127 @@
+/**
+ * Constants for the distance determination tests
+ */
+
+#include <math.h>
+
+#include <random>
+
+#include "src/style/style.hpp"
+#include "src/spatial/attitude-utils.hpp"
+#include "src/spatial/camera.hpp"
+
+namespace found {
+
+/// The radius of Earth, in km
+const decimal kEarthRadius = 6371;
+/// The distance from the center of Earth that test images are taken at, in km
+const decimal kEarthDistance = 40000;
+
+/// The seed for randomized distance tests
+const unsigned int kDistanceSeed = 7;
+
+/// The camera that takes the test images
+static Camera distanceCamera(1000, 1024, 1024);
+
+/// The distortion of a wide lens, which moves the corners of distanceCamera by about 35 pixels
+const LensDistortion kBarrelDistortion = {-0.2, 0.05, 0, 0.001, -0.0005};
+
+/**
+ * Makes points on the horizon of Earth, as seen by distanceCamera
+ *
+ * @param distance The distance to the center of Earth
+ * @param count The number of points
+ * @param arc The angle of the arc of the horizon the points are on, in radians
+ *
+ * @return The horizon points, with Earth slightly off the center of the image
+ */
+inline Points MakeHorizonPoints(decimal distance, int count, decimal arc) {
+    Vec3 center = Vec3(1, 0.05, 0.02).Normalize();
+    Vec3 e1 = center.CrossProduct(Vec3(0, 0, 1)).Normalize();
+    Vec3 e2 = center.CrossProduct(e1);
+    decimal sine = kEarthRadius / distance;
+    decimal cosine = sqrt(1 - sine * sine);
+
+    Points points;
+    for (int i = 0; i < count; i++) {
+        decimal angle = arc * i / count;
+        Vec3 ray = center * cosine + (e1 * cos(angle) + e2 * sin(angle)) * sine;
+        points.push_back(distanceCamera.SpatialToCamera(ray));
+    }
+    return points;
+}
+
+/**
+ * Adds stray points (like clouds or lens flare) to horizon points
+ *
+ * @param points The horizon points
+ * @param count The number of stray points to add
+ *
+ * @return The horizon points, followed by count points scattered over the inside of Earth
+ */
+inline Points AddOutliers(const Points &points, int count) {
+    Points noisy = points;
+    std::mt19937 generator(kDistanceSeed);
+    std::uniform_real_distribution<decimal> offset(-100, 100);
+    for (int i = 0; i < count; i++) {
+        noisy.push_back(distanceCamera.XResolution() / 2 + offset(generator),
+                        distanceCamera.YResolution() / 2 + offset(generator));
+    }
+    return noisy;
+}
+
+/// The equatorial radius of Earth, in km
+const decimal kEquatorialRadius = 6378.137;
+/// The polar radius of Earth, in km
+const decimal kPolarRadius = 6356.752;
+
+/// Where the elliptic test images are taken from, in km
+static PositionVector ellipticPosition(-15000, 8000, 9000);
+/// How far the camera moves between two successive elliptic test images, in km
+static PositionVector ellipticStep(20, -15, 10);
+
+/**
+ * Makes the attitude of a camera pointing at the center of Earth
+ *
+ * @param position The position of the camera
+ *
+ * @return The attitude of the camera
+ */
+inline Attitude LookAtEarth(const PositionVector &position) {
+    Vec3 forward = (position * -1).Normalize();
+    Vec3 right = Vec3(0, 0, 1).CrossProduct(forward).Normalize();
+    Vec3 down = forward.CrossProduct(right);
+    return Attitude(Mat3{{forward.x, forward.y, forward.z,
+                          right.x, right.y, right.z,
+                          down.x, down.y, down.z}});
+}
+
+/**
+ * Makes points on the horizon of an ellipsoidal Earth, as seen by distanceCamera
+ *
+ * @param position The position of the camera, relative to Earth's center
+ * @param attitude The attitude of the camera
+ * @param count The number of points
+ *
+ * @return The horizon points
+ */
+inline Points MakeEllipsoidHorizonPoints(const PositionVector &position, const Attitude &attitude, int count) {
+    // The horizon is a circle on the unit sphere of the frame scaled by the inverse radii
+    Vec3 scaled(position.x / kEquatorialRadius, position.y / kEquatorialRadius, position.z / kPolarRadius);
+    decimal distance2 = scaled.MagnitudeSq();
+    Vec3 center = scaled * (1 / distance2);
+    decimal radius = sqrt(1 - 1 / distance2);
+    Vec3 e1 = scaled.CrossProduct(Vec3(0, 0, 1)).Normalize();
+    Vec3 e2 = scaled.Normalize().CrossProduct(e1);
+
+    Points points;
+    for (int i = 0; i < count; i++) {
+        decimal angle = 2 * M_PI * i / count;
+        Vec3 tangent = center + (e1 * cos(angle) + e2 * sin(angle)) * radius;
+        Vec3 horizon(tangent.x * kEquatorialRadius, tangent.y * kEquatorialRadius, tangent.z * kPolarRadius);
+        points.push_back(distanceCamera.SpatialToCamera(attitude.Rotate(horizon - position)));
+    }
+    return points;
+}
+
+}  // namespace found
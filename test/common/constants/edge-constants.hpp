@@ -0,0 +1,113 @@
+/**
+ * Constants for the edge detection tests
+ */
+
+#include <vector>
+
+#include "src/style/style.hpp"
+#include "src/spatial/attitude-utils.hpp"
+#include "src/spatial/camera.hpp"
+
+namespace found {
+
+/// The seed for randomized edge tests
+const unsigned int kEdgeSeed = 2025;
+
+/// The threshold for the edge detection algorithms
+const unsigned char kEdgeThreshold = 100;
+
+/// The dimensions of the square image
+const int kSquareWidth = 40;
+const int kSquareHeight = 6;
+
+/**
+ * Makes a dark image with a bright 35x4 rectangle in it,
+ * offset by (2, 1)
+ *
+ * @return The pixels of the image
+ */
+inline std::vector<unsigned char> MakeSquarePixels() {
+    std::vector<unsigned char> pixels(kSquareWidth * kSquareHeight, 20);
+    for (int y = 1; y < 5; y++) {
+        for (int x = 2; x < 37; x++) {
+            pixels[y * kSquareWidth + x] = 200;
+        }
+    }
+    return pixels;
+}
+
+/**
+ * Lists the border pixels of the rectangle of MakeSquarePixels
+ *
+ * @return The border pixels, in row-major order
+ */
+inline Points MakeSquareEdges() {
+    Points edges;
+    for (int y = 1; y < 5; y++) {
+        for (int x = 2; x < 37; x++) {
+            if (y == 1 || y == 4 || x == 2 || x == 36) edges.push_back({x + 0.5f, y + 0.5f});
+        }
+    }
+    return edges;
+}
+
+static std::vector<unsigned char> squarePixels = MakeSquarePixels();
+static Image squareImage = {squarePixels.data(), {kSquareWidth, kSquareHeight, 1}};
+static Points squareEdges = MakeSquareEdges();
+
+/// The standard deviation of the LoG filter
+const decimal kLoCSigma = 1.5;
+
+/// The minimum response change across a LoG zero crossing
+const decimal kLoCThreshold = 2.0;
+
+/// The dimensions of the disk image
+const int kDiskSize = 80;
+/// The center of the disk
+const decimal kDiskCenter = 40;
+/// The radius of the disk
+const decimal kDiskRadius = 25;
+
+/**
+ * Makes a dark image with a bright disk in it
+ *
+ * @return The pixels of the image
+ */
+inline std::vector<unsigned char> MakeDiskPixels() {
+    std::vector<unsigned char> pixels(kDiskSize * kDiskSize);
+    for (int y = 0; y < kDiskSize; y++) {
+        for (int x = 0; x < kDiskSize; x++) {
+            decimal dx = x + 0.5f - kDiskCenter;
+            decimal dy = y + 0.5f - kDiskCenter;
+            pixels[y * kDiskSize + x] = dx * dx + dy * dy <= kDiskRadius * kDiskRadius ? 200 : 20;
+        }
+    }
+    return pixels;
+}
+
+static std::vector<unsigned char> diskPixels = MakeDiskPixels();
+static Image diskImage = {diskPixels.data(), {kDiskSize, kDiskSize, 1}};
+
+/// The side length of the tiles of regions of interest
+const int kRegionTileSize = 8;
+/// How far around the predicted horizon to search
+const decimal kRegionMargin = 3;
+
+/// The number of times the disk image is halved by pyramid tests
+const int kPyramidLevels = 2;
+
+/// The focal length of the camera that "took" the disk image
+const decimal kDiskFocalLength = 100;
+/// The radius of Earth that the disk image is of
+const decimal kDiskEarthRadius = 1;
+/// The distance from Earth's center that the disk image is taken at (tan(theta) = kDiskRadius / focal length)
+const decimal kDiskDistance = 4.1231056;  // sqrt(17)
+
+/// A camera whose view of Earth at kDiskDistance is diskImage
+static Camera diskCamera(kDiskFocalLength, kDiskSize, kDiskSize);
+/// Pointing the camera ahead
+static Attitude diskAttitude(Quaternion(1, 0, 0, 0));
+/// Earth right ahead of the camera
+static PositionVector diskPosition(-kDiskDistance, 0, 0);
+
+}  // namespace found
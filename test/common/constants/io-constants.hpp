@@ -0,0 +1,26 @@
+/**
+ * Constants for the image input tests
+ */
+
+#include <string>
+
+namespace found {
+
+/// A 4x3 binary PGM, with a comment in its header
+const std::string kPgmHeader = "P5\n# A comment\n4 3\n255\n";
+/// The dimensions of the PGM
+const int kPgmWidth = 4;
+const int kPgmHeight = 3;
+
+/// A 2x2 binary PPM
+const std::string kPpmHeader = "P6 2 2 255\n";
+/// The dimensions of the PPM
+const int kPpmWidth = 2;
+const int kPpmHeight = 2;
+
+/// The number of bytes before the pixels of raw test images
+const size_t kRawOffset = 16;
+/// The number of padding bytes at the end of the rows of raw test images
+const size_t kRawPadding = 5;
+
+}  // namespace found
@@ -0,0 +1,75 @@
+/**
+ * Constants for the orbit determination tests
+ */
+
+#include <math.h>
+
+#include <vector>
+
+#include "src/spatial/attitude-utils.hpp"
+#include "src/style/style.hpp"
+
+namespace found {
+
+/// The semi-latus rectum of the test orbit, in km
+const preciseDecimal kOrbitSemiLatusRectum = 7500;
+/// The eccentricity of the test orbit
+const preciseDecimal kOrbitEccentricity = 0.12;
+/// The direction of periapsis of the test orbit
+static PreciseVec3 orbitPeriapsis = PreciseVec3(1, 2, 0).Normalize();
+/// The direction of motion at periapsis of the test orbit
+static PreciseVec3 orbitAscending = PreciseVec3(-2, 1, 1.5).Normalize();
+
+/**
+ * Makes positions along an orbit
+ *
+ * @param semiLatusRectum,eccentricity The shape of the orbit
+ * @param periapsis,ascending The unit directions of periapsis and of motion at periapsis
+ * @param count The number of positions
+ * @param start,step The true anomaly of the first position, and between positions, in radians
+ *
+ * @return The positions
+ */
+inline std::vector<Vec3> MakeOrbitPositions(preciseDecimal semiLatusRectum, preciseDecimal eccentricity,
+                                            const PreciseVec3 &periapsis, const PreciseVec3 &ascending,
+                                            int count, preciseDecimal start, preciseDecimal step) {
+    std::vector<Vec3> positions;
+    for (int i = 0; i < count; i++) {
+        preciseDecimal anomaly = start + step * i;
+        preciseDecimal radius = semiLatusRectum / (1 + eccentricity * cos(anomaly));
+        PreciseVec3 position = (periapsis * cos(anomaly) + ascending * sin(anomaly)) * radius;
+        positions.push_back(PrecisionCast<decimal>(position));
+    }
+    return positions;
+}
+
+/**
+ * Makes positions along the test orbit
+ *
+ * @param count The number of positions
+ * @param start,step The true anomaly of the first position, and between positions, in radians
+ *
+ * @return The positions
+ */
+inline std::vector<Vec3> MakeOrbitPositions(int count, preciseDecimal start = 0, preciseDecimal step = 0.05) {
+    return MakeOrbitPositions(kOrbitSemiLatusRectum, kOrbitEccentricity, orbitPeriapsis, orbitAscending,
+                              count, start, step);
+}
+
+/**
+ * Makes the elements of the test orbit
+ *
+ * @param meanAnomaly The mean anomaly at t = 0, in radians
+ *
+ * @return The test orbit
+ */
+inline OrbitParams MakeTestOrbit(preciseDecimal meanAnomaly = 0) {
+    PreciseVec3 periapsis = orbitPeriapsis * (kOrbitSemiLatusRectum / (1 + kOrbitEccentricity));
+    OrbitParams orbit = {PrecisionCast<decimal>(periapsis),
+                         kOrbitSemiLatusRectum / (1 - kOrbitEccentricity * kOrbitEccentricity),
+                         kOrbitEccentricity, orbitPeriapsis, orbitPeriapsis.CrossProduct(orbitAscending),
+                         meanAnomaly};
+    return orbit;
+}
+
+}  // namespace found
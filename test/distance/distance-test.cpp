@@ -0,0 +1,326 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "src/distance/distance.hpp"
+#include "src/spatial/camera.hpp"
+
+#include "test/common/constants/distance-constants.hpp"
+
+namespace found {
+
+/**
+ * Tests that batched rays match rays made one at a time
+ */
+TEST(DistanceTest, TestPixelsToRays) {
+    Points points = MakeHorizonPoints(kEarthDistance, 50, 2 * M_PI);
+    std::vector<decimal> x(points.size()), y(points.size()), z(points.size());
+
+    distanceCamera.PixelsToRays(points.x(), points.y(), points.size(), x.data(), y.data(), z.data());
+
+    for (size_t i = 0; i < points.size(); i++) {
+        Vec3 expected = distanceCamera.CameraToSpatial(points[i]).Normalize();
+        ASSERT_NEAR(expected.x, x[i], 1e-6);
+        ASSERT_NEAR(expected.y, y[i], 1e-6);
+        ASSERT_NEAR(expected.z, z[i], 1e-6);
+    }
+}
+
+/**
+ * Tests finding the distance from the whole horizon, with more points than
+ * are turned into rays at once
+ */
+TEST(DistanceTest, TestSphericalDistanceFullHorizon) {
+    SphericalDistanceDeterminationAlgorithm algorithm(kEarthRadius, distanceCamera);
+
+    ASSERT_EQ(1, algorithm.Center().x);
+    for (decimal distance : {kEarthDistance, 2 * kEarthRadius, 20 * kEarthDistance}) {
+        distFromEarth result = algorithm.Run(MakeHorizonPoints(distance, 1000, 2 * M_PI));
+        ASSERT_NEAR(distance, result, distance * 1e-3) << "distance " << distance;
+        // The points are about Vec3(1, 0.05, 0.02)
+        Vec3 center = algorithm.Center();
+        ASSERT_NEAR(1, center.Magnitude(), 1e-6);
+        ASSERT_NEAR(0.05, center.y / center.x, 1e-4);
+        ASSERT_NEAR(0.02, center.z / center.x, 1e-4);
+    }
+}
+
+/**
+ * Tests finding the distance from part of the horizon
+ */
+TEST(DistanceTest, TestSphericalDistanceArc) {
+    SphericalDistanceDeterminationAlgorithm algorithm(kEarthRadius, distanceCamera);
+
+    ASSERT_NEAR(kEarthDistance, algorithm.Run(MakeHorizonPoints(kEarthDistance, 3, M_PI / 2)),
+                kEarthDistance * 1e-3);
+    ASSERT_NEAR(kEarthDistance, algorithm.Run(MakeHorizonPoints(kEarthDistance, 100, M_PI / 3)),
+                kEarthDistance * 1e-2);
+}
+
+/**
+ * Tests points that do not give a distance
+ */
+TEST(DistanceTest, TestSphericalDistanceInvalid) {
+    ASSERT_THROW(SphericalDistanceDeterminationAlgorithm(0, distanceCamera), std::invalid_argument);
+
+    SphericalDistanceDeterminationAlgorithm algorithm(kEarthRadius, distanceCamera);
+    ASSERT_THROW(algorithm.Run(MakeHorizonPoints(kEarthDistance, 2, M_PI)), std::invalid_argument);
+
+    Points line = {{10, 10}, {10, 20}, {10, 30}, {10, 40}};
+    ASSERT_THROW(algorithm.Run(line), std::invalid_argument);
+}
+
+/**
+ * Tests that outliers are rejected
+ */
+TEST(DistanceTest, TestSphericalDistanceRobust) {
+    Points points = AddOutliers(MakeHorizonPoints(kEarthDistance, 300, M_PI), 150);
+
+    SphericalDistanceDeterminationAlgorithm plain(kEarthRadius, distanceCamera);
+    ASSERT_GT(fabs(plain.Run(points) - kEarthDistance), kEarthDistance * 1e-2);
+
+    SphericalDistanceDeterminationAlgorithm robust(kEarthRadius, distanceCamera, RobustFitOptions());
+    ASSERT_NEAR(kEarthDistance, robust.Run(points), kEarthDistance * 1e-3);
+
+    // Without outliers, sampling stops right away and the result matches the plain fit
+    Points clean = MakeHorizonPoints(kEarthDistance, 300, 2 * M_PI);
+    ASSERT_NEAR(plain.Run(clean), robust.Run(clean), kEarthDistance * 1e-4);
+}
+
+/**
+ * Tests robust fits that cannot be made
+ */
+TEST(DistanceTest, TestSphericalDistanceRobustInvalid) {
+    RobustFitOptions options;
+    options.inlierThreshold = 0;
+    ASSERT_THROW(SphericalDistanceDeterminationAlgorithm(kEarthRadius, distanceCamera, options), std::invalid_argument);
+    options = RobustFitOptions();
+    options.confidence = 1;
+    ASSERT_THROW(SphericalDistanceDeterminationAlgorithm(kEarthRadius, distanceCamera, options), std::invalid_argument);
+    options = RobustFitOptions();
+    options.targetInlierRatio = 0;
+    ASSERT_THROW(SphericalDistanceDeterminationAlgorithm(kEarthRadius, distanceCamera, options), std::invalid_argument);
+    options = RobustFitOptions();
+    options.maxIterations = 0;
+    ASSERT_THROW(SphericalDistanceDeterminationAlgorithm(kEarthRadius, distanceCamera, options), std::invalid_argument);
+
+    SphericalDistanceDeterminationAlgorithm robust(kEarthRadius, distanceCamera, RobustFitOptions());
+    Points line = {{10, 10}, {10, 20}, {10, 30}, {10, 40}};
+    ASSERT_THROW(robust.Run(line), std::invalid_argument);
+}
+
+/**
+ * Tests finding the position of the camera from the horizon of an oblate Earth
+ */
+TEST(DistanceTest, TestEllipticDistance) {
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    EllipticDistanceDeterminationAlgorithm algorithm(kEquatorialRadius, kPolarRadius, distanceCamera, attitude);
+
+    distFromEarth distance = algorithm.Run(MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 500));
+
+    ASSERT_FALSE(algorithm.WarmStarted());
+    ASSERT_NEAR(ellipticPosition.Magnitude(), distance, ellipticPosition.Magnitude() * 1e-4);
+    PositionVector position = algorithm.GetPosition();
+    ASSERT_NEAR(ellipticPosition.x, position.x, 5);
+    ASSERT_NEAR(ellipticPosition.y, position.y, 5);
+    ASSERT_NEAR(ellipticPosition.z, position.z, 5);
+    // The camera looks at Earth's center
+    Vec3 center = algorithm.Center();
+    ASSERT_NEAR(1, center.x, 1e-6);
+    ASSERT_NEAR(0, center.y, 1e-3);
+    ASSERT_NEAR(0, center.z, 1e-3);
+}
+
+/**
+ * Tests that successive frames start from the last solution, and converge faster
+ */
+TEST(DistanceTest, TestEllipticDistanceWarmStart) {
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    EllipticDistanceDeterminationAlgorithm algorithm(kEquatorialRadius, kPolarRadius, distanceCamera, attitude);
+    algorithm.Run(MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 500));
+
+    PositionVector position = ellipticPosition;
+    for (int frame = 0; frame < 5; frame++) {
+        position = position + ellipticStep;
+        attitude = LookAtEarth(position);
+        algorithm.SetAttitude(attitude);
+
+        distFromEarth distance = algorithm.Run(MakeEllipsoidHorizonPoints(position, attitude, 500));
+
+        ASSERT_TRUE(algorithm.WarmStarted()) << "frame " << frame;
+        ASSERT_LE(algorithm.Iterations(), 3) << "frame " << frame;
+        ASSERT_NEAR(position.Magnitude(), distance, position.Magnitude() * 1e-4) << "frame " << frame;
+    }
+
+    algorithm.Reset();
+    algorithm.Run(MakeEllipsoidHorizonPoints(position, attitude, 500));
+    ASSERT_FALSE(algorithm.WarmStarted());
+}
+
+/**
+ * Tests that a warm start that does not converge within the budget falls back to a cold start
+ */
+TEST(DistanceTest, TestEllipticDistanceBudget) {
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    EllipticDistanceDeterminationAlgorithm algorithm(kEquatorialRadius, kPolarRadius, distanceCamera, attitude, 1);
+    algorithm.Run(MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 500));
+
+    // Jumps far away from the last solution
+    PositionVector far = ellipticPosition * 3;
+    attitude = LookAtEarth(far);
+    algorithm.SetAttitude(attitude);
+    distFromEarth distance = algorithm.Run(MakeEllipsoidHorizonPoints(far, attitude, 500));
+
+    ASSERT_FALSE(algorithm.WarmStarted());
+    ASSERT_EQ(1, algorithm.Iterations());
+    ASSERT_NEAR(far.Magnitude(), distance, far.Magnitude() * 1e-3);
+}
+
+/**
+ * Tests that a refinement that overshoots past the boundary of the cones (from a
+ * nearby solution, to the tiny horizon of a far Earth) keeps a finite position
+ */
+TEST(DistanceTest, TestEllipticDistanceOvershoot) {
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    EllipticDistanceDeterminationAlgorithm algorithm(kEquatorialRadius, kPolarRadius, distanceCamera, attitude);
+    algorithm.Run(MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 500));
+
+    PositionVector far = ellipticPosition * 100;
+    attitude = LookAtEarth(far);
+    algorithm.SetAttitude(attitude);
+    distFromEarth distance = algorithm.Run(MakeEllipsoidHorizonPoints(far, attitude, 500));
+
+    ASSERT_FALSE(algorithm.WarmStarted());
+    ASSERT_TRUE(std::isfinite(distance));
+    ASSERT_TRUE(std::isfinite(algorithm.Residual()));
+    ASSERT_NEAR(far.Magnitude(), distance, far.Magnitude() * 1e-2);
+    Vec3 center = algorithm.Center();
+    ASSERT_NEAR(1, center.x, 1e-3);
+
+    // The next frame starts from the position just found
+    algorithm.Run(MakeEllipsoidHorizonPoints(far, attitude, 500));
+    ASSERT_TRUE(algorithm.WarmStarted());
+}
+
+/**
+ * Tests that the elliptic algorithm rejects outliers, when cold and warm started
+ */
+TEST(DistanceTest, TestEllipticDistanceRobust) {
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    Points points = AddOutliers(MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 300), 150);
+    decimal distance = ellipticPosition.Magnitude();
+
+    EllipticDistanceDeterminationAlgorithm plain(kEquatorialRadius, kPolarRadius, distanceCamera, attitude);
+    ASSERT_GT(fabs(plain.Run(points) - distance), distance * 1e-2);
+
+    EllipticDistanceDeterminationAlgorithm robust(kEquatorialRadius, kPolarRadius, distanceCamera, attitude,
+                                                  RobustFitOptions());
+    ASSERT_NEAR(distance, robust.Run(points), distance * 1e-4);
+    ASSERT_FALSE(robust.WarmStarted());
+
+    PositionVector position = ellipticPosition + ellipticStep;
+    attitude = LookAtEarth(position);
+    robust.SetAttitude(attitude);
+    points = AddOutliers(MakeEllipsoidHorizonPoints(position, attitude, 300), 150);
+    ASSERT_NEAR(position.Magnitude(), robust.Run(points), position.Magnitude() * 1e-4);
+    ASSERT_TRUE(robust.WarmStarted());
+
+    RobustFitOptions options;
+    options.inlierThreshold = 0;
+    ASSERT_THROW(EllipticDistanceDeterminationAlgorithm(kEquatorialRadius, kPolarRadius, distanceCamera, attitude,
+                                                        options),
+                 std::invalid_argument);
+    robust.Reset();
+    Points line = {{10, 10}, {10, 20}, {10, 30}, {10, 40}};
+    ASSERT_THROW(robust.Run(line), std::invalid_argument);
+}
+
+/**
+ * Tests that an ellipsoid with equal radii gives the same distance as a sphere
+ */
+TEST(DistanceTest, TestEllipticDistanceSphere) {
+    Attitude attitude(Quaternion(1, 0, 0, 0));
+    EllipticDistanceDeterminationAlgorithm elliptic(kEarthRadius, kEarthRadius, distanceCamera, attitude);
+    SphericalDistanceDeterminationAlgorithm spherical(kEarthRadius, distanceCamera);
+    Points points = MakeHorizonPoints(kEarthDistance, 300, 2 * M_PI);
+
+    ASSERT_NEAR(spherical.Run(points), elliptic.Run(points), kEarthDistance * 1e-4);
+}
+
+/**
+ * Tests invalid parameters and points for the elliptic algorithm
+ */
+TEST(DistanceTest, TestEllipticDistanceInvalid) {
+    Attitude attitude(Quaternion(1, 0, 0, 0));
+    ASSERT_THROW(EllipticDistanceDeterminationAlgorithm(0, kPolarRadius, distanceCamera, attitude),
+                 std::invalid_argument);
+    ASSERT_THROW(EllipticDistanceDeterminationAlgorithm(kEquatorialRadius, kPolarRadius, distanceCamera, attitude, 0),
+                 std::invalid_argument);
+
+    EllipticDistanceDeterminationAlgorithm algorithm(kEquatorialRadius, kPolarRadius, distanceCamera, attitude);
+    ASSERT_THROW(algorithm.Run(MakeHorizonPoints(kEarthDistance, 2, M_PI)), std::invalid_argument);
+    Points line = {{10, 10}, {10, 20}, {10, 30}, {10, 40}};
+    ASSERT_THROW(algorithm.Run(line), std::invalid_argument);
+}
+
+/**
+ * Tests that the residual of a fit grows with how far the points are from a horizon
+ */
+TEST(DistanceTest, TestResidual) {
+    SphericalDistanceDeterminationAlgorithm algorithm(kEarthRadius, distanceCamera);
+    ASSERT_EQ(0, algorithm.Residual());
+    Points points = MakeHorizonPoints(kEarthDistance, 300, 2 * M_PI);
+    algorithm.Run(points);
+    ASSERT_LT(algorithm.Residual(), 1e-5);
+
+    // Moves every other point 1 pixel, i.e. about 1 / 1000 radians
+    Points noisy = points;
+    for (size_t i = 0; i < noisy.size(); i += 2) noisy.x()[i] += 1;
+    algorithm.Run(noisy);
+    ASSERT_GT(algorithm.Residual(), 1e-4);
+    ASSERT_LT(algorithm.Residual(), 1e-3);
+
+    // Outliers are left out of the residual of a robust fit
+    SphericalDistanceDeterminationAlgorithm robust(kEarthRadius, distanceCamera, RobustFitOptions());
+    robust.Run(AddOutliers(points, 30));
+    ASSERT_LT(robust.Residual(), 1e-5);
+
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    EllipticDistanceDeterminationAlgorithm elliptic(kEquatorialRadius, kPolarRadius, distanceCamera, attitude);
+    elliptic.Run(MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 500));
+    ASSERT_LT(elliptic.Residual(), 1e-5);
+}
+
+/**
+ * Tests fusing the distances of several algorithms
+ */
+TEST(DistanceTest, TestDistanceFusion) {
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    Points points = MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 500);
+    SphericalDistanceDeterminationAlgorithm spherical(kEquatorialRadius, distanceCamera);
+    EllipticDistanceDeterminationAlgorithm elliptic(kEquatorialRadius, kPolarRadius, distanceCamera, attitude);
+    std::vector<distFromEarth> distances = {spherical.Run(points), elliptic.Run(points)};
+    std::vector<std::reference_wrapper<DistanceDeterminationAlgorithm>> algorithms = {spherical, elliptic};
+
+    // The sphere fits the horizon of an oblate Earth worse
+    DistanceFusionAlgorithm lowest(algorithms, FusionMethod::kLowestResidual);
+    ASSERT_EQ(distances[1], lowest.Run(distances));
+    ASSERT_EQ(1u, lowest.Chosen());
+
+    DistanceFusionAlgorithm average(algorithms, FusionMethod::kWeightedAverage);
+    ASSERT_NEAR((distances[0] + distances[1]) / 2, average.Run(distances), 1e-3);
+    DistanceFusionAlgorithm weighted(algorithms, FusionMethod::kWeightedAverage, {1, 3});
+    ASSERT_NEAR((distances[0] + 3 * distances[1]) / 4, weighted.Run(distances), 1e-3);
+
+    ASSERT_THROW(average.Run({distances[0]}), std::invalid_argument);
+    ASSERT_THROW(DistanceFusionAlgorithm({}, FusionMethod::kLowestResidual), std::invalid_argument);
+    ASSERT_THROW(DistanceFusionAlgorithm(algorithms, FusionMethod::kWeightedAverage, {1}), std::invalid_argument);
+    ASSERT_THROW(DistanceFusionAlgorithm(algorithms, FusionMethod::kWeightedAverage, {1, -1}), std::invalid_argument);
+    ASSERT_THROW(DistanceFusionAlgorithm(algorithms, FusionMethod::kWeightedAverage, {0, 0}), std::invalid_argument);
+}
+
+}  // namespace found
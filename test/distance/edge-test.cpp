@@ -0,0 +1,528 @@
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "src/distance/edge.hpp"
+
+#include "test/common/constants/edge-constants.hpp"
+
+namespace found {
+
+/**
+ * Tests thresholding rows of every width and number of channels
+ * against a direct evaluation
+ */
+TEST(EdgeTest, TestThresholdRow) {
+    srand(kEdgeSeed);
+    for (int channels : {1, 3}) {
+        for (int width = 0; width < 100; width++) {
+            std::vector<unsigned char> row(width * channels);
+            for (unsigned char &pixel : row) pixel = rand() % 256;
+            unsigned char threshold = rand() % 256;
+
+            std::vector<unsigned char> mask(width + 1, 0x5A);
+            ThresholdRow(row.data(), width, channels, threshold, mask.data());
+
+            for (int i = 0; i < width; i++) {
+                int sum = 0;
+                for (int c = 0; c < channels; c++) sum += row[i * channels + c];
+                ASSERT_EQ(sum >= channels * threshold ? 0xFF : 0, mask[i]) << "width " << width << ", pixel " << i;
+            }
+            ASSERT_EQ(0x5A, mask[width]);
+        }
+    }
+}
+
+/**
+ * Tests scanning rows for the horizon against a direct evaluation
+ */
+TEST(EdgeTest, TestHorizonRow) {
+    srand(kEdgeSeed);
+    for (int width = 1; width < 100; width++) {
+        std::vector<unsigned char> masks[3];
+        for (std::vector<unsigned char> &mask : masks) {
+            mask.resize(width + 2);
+            for (unsigned char &pixel : mask) pixel = rand() % 4 ? 0xFF : 0;
+        }
+        std::vector<unsigned char> edges(width);
+        HorizonRow(masks[0].data() + 1, masks[1].data() + 1, masks[2].data() + 1, width, edges.data());
+
+        for (int i = 1; i <= width; i++) {
+            bool expected = masks[1][i] && !(masks[0][i] && masks[2][i] && masks[1][i-1] && masks[1][i+1]);
+            ASSERT_EQ(expected, edges[i-1] != 0) << "width " << width << ", pixel " << i;
+        }
+    }
+}
+
+/**
+ * Tests finding the horizon of a square
+ */
+TEST(EdgeTest, TestSimpleEdgeDetectionSquare) {
+    SimpleEdgeDetectionAlgorithm algorithm(kEdgeThreshold);
+
+    Points points = algorithm.Run(squareImage);
+
+    ASSERT_EQ(squareEdges.size(), points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        ASSERT_EQ(squareEdges[i].x, points[i].x);
+        ASSERT_EQ(squareEdges[i].y, points[i].y);
+    }
+}
+
+/**
+ * Tests finding the horizon of a 3-channel square
+ */
+TEST(EdgeTest, TestSimpleEdgeDetectionSquareColor) {
+    SimpleEdgeDetectionAlgorithm algorithm(kEdgeThreshold);
+
+    std::vector<unsigned char> pixels(squarePixels.size() * 3);
+    for (size_t i = 0; i < squarePixels.size(); i++) {
+        // The channel average is what counts, so leave one channel dark
+        pixels[3*i] = 0;
+        pixels[3*i+1] = squarePixels[i] == 200 ? 255 : squarePixels[i];
+        pixels[3*i+2] = squarePixels[i] == 200 ? 255 : squarePixels[i];
+    }
+    Image image = {pixels.data(), {kSquareWidth, kSquareHeight, 3}};
+
+    Points points = algorithm.Run(image);
+
+    ASSERT_EQ(squareEdges.size(), points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        ASSERT_EQ(squareEdges[i].x, points[i].x);
+        ASSERT_EQ(squareEdges[i].y, points[i].y);
+    }
+}
+
+/**
+ * Tests that the sides of an image are not the horizon
+ */
+TEST(EdgeTest, TestSimpleEdgeDetectionUniform) {
+    SimpleEdgeDetectionAlgorithm algorithm(kEdgeThreshold);
+
+    std::vector<unsigned char> bright(kSquareWidth * kSquareHeight, 0xFF);
+    Image brightImage = {bright.data(), {kSquareWidth, kSquareHeight, 1}};
+    ASSERT_TRUE(algorithm.Run(brightImage).empty());
+
+    std::vector<unsigned char> dark(kSquareWidth * kSquareHeight, 0);
+    Image darkImage = {dark.data(), {kSquareWidth, kSquareHeight, 1}};
+    ASSERT_TRUE(algorithm.Run(darkImage).empty());
+
+    Image emptyImage = {dark.data(), {0, 0, 1}};
+    ASSERT_TRUE(algorithm.Run(emptyImage).empty());
+}
+
+/**
+ * Tests that points are refilled in place
+ */
+TEST(EdgeTest, TestSimpleEdgeDetectionRunInto) {
+    SimpleEdgeDetectionAlgorithm algorithm(kEdgeThreshold);
+
+    Points points;
+    algorithm.RunInto(squareImage, points);
+    const decimal *storage = points.x();
+    algorithm.RunInto(squareImage, points);
+
+    ASSERT_EQ(squareEdges.size(), points.size());
+    ASSERT_EQ(storage, points.x());
+}
+
+/**
+ * Tests images with an unsupported number of channels
+ */
+TEST(EdgeTest, TestSimpleEdgeDetectionInvalidChannels) {
+    SimpleEdgeDetectionAlgorithm algorithm(kEdgeThreshold);
+
+    Image image = {squarePixels.data(), {kSquareWidth, kSquareHeight / 2, 2}};
+
+    ASSERT_THROW(algorithm.Run(image), std::invalid_argument);
+}
+
+/**
+ * Tests that scanning an image in row bands finds the same points, in the same order
+ */
+TEST(EdgeTest, TestSimpleEdgeDetectionBands) {
+    const int size = 512;
+    std::vector<unsigned char> pixels(size * size, 0);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            if ((x - 250) * (x - 250) + (y - 260) * (y - 260) < 200 * 200) pixels[y * size + x] = 255;
+        }
+    }
+    Image image = {pixels.data(), {size, size, 1}};
+    SimpleEdgeDetectionAlgorithm whole(kEdgeThreshold);
+    Points expected = whole.Run(image);
+    ASSERT_LT(1000u, expected.size());
+
+    TaskScheduler scheduler(3);
+    // 5 bands cut the disk at rows that are not multiples of the band size, and 100 are more than fit
+    for (size_t bands : {2, 5, 100}) {
+        SimpleEdgeDetectionAlgorithm banded(kEdgeThreshold, bands, scheduler);
+        Points points;
+        banded.RunInto(image, points);
+        ASSERT_EQ(expected, points);
+        banded.RunInto(image, points);
+        ASSERT_EQ(expected, points);
+    }
+
+    // Small images are not split
+    SimpleEdgeDetectionAlgorithm banded(kEdgeThreshold, 8, scheduler);
+    ASSERT_EQ(squareEdges.size(), banded.Run(squareImage).size());
+    ASSERT_THROW(SimpleEdgeDetectionAlgorithm(kEdgeThreshold, 0), std::invalid_argument);
+}
+
+/**
+ * Sorts points, so that results of different tilings can be compared
+ *
+ * @param points The points to sort
+ *
+ * @return The points as sorted (x, y) pairs
+ */
+static std::vector<std::pair<decimal, decimal>> SortPoints(const Points &points) {
+    std::vector<std::pair<decimal, decimal>> sorted;
+    for (const Vec2 &point : points) sorted.push_back({point.x, point.y});
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+/**
+ * Tests that the LoG zero crossings of a disk lie on its rim
+ */
+TEST(EdgeTest, TestLoCEdgeDetectionDisk) {
+    LoCEdgeDetectionAlgorithm algorithm(kLoCSigma, kLoCThreshold);
+
+    Points points = algorithm.Run(diskImage);
+
+    // Every row and column crossing the disk contributes 2 crossings
+    ASSERT_GE(points.size(), static_cast<size_t>(4 * 2 * kDiskRadius));
+    for (const Vec2 &point : points) {
+        decimal distance = hypot(point.x - kDiskCenter, point.y - kDiskCenter);
+        ASSERT_NEAR(kDiskRadius, distance, 1.0);
+    }
+}
+
+/**
+ * Tests that the Difference of Gaussians approximation also finds the rim of a disk
+ */
+TEST(EdgeTest, TestLoCEdgeDetectionDiskDoG) {
+    LoCEdgeDetectionAlgorithm algorithm(kLoCSigma, kLoCThreshold, true);
+
+    Points points = algorithm.Run(diskImage);
+
+    ASSERT_GE(points.size(), static_cast<size_t>(4 * 2 * kDiskRadius));
+    for (const Vec2 &point : points) {
+        decimal distance = hypot(point.x - kDiskCenter, point.y - kDiskCenter);
+        ASSERT_NEAR(kDiskRadius, distance, 1.0);
+    }
+}
+
+/**
+ * Tests that the tiling of the image does not change the result
+ */
+TEST(EdgeTest, TestLoCEdgeDetectionTiling) {
+    LoCEdgeDetectionAlgorithm whole(kLoCSigma, kLoCThreshold, false, kDiskSize);
+    LoCEdgeDetectionAlgorithm tiled(kLoCSigma, kLoCThreshold, false, 7);
+
+    std::vector<std::pair<decimal, decimal>> expected = SortPoints(whole.Run(diskImage));
+    std::vector<std::pair<decimal, decimal>> actual = SortPoints(tiled.Run(diskImage));
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_NEAR(expected[i].first, actual[i].first, 1e-4);
+        ASSERT_NEAR(expected[i].second, actual[i].second, 1e-4);
+    }
+}
+
+/**
+ * Tests that a flat image has no zero crossings
+ */
+TEST(EdgeTest, TestLoCEdgeDetectionUniform) {
+    LoCEdgeDetectionAlgorithm algorithm(kLoCSigma, kLoCThreshold);
+
+    std::vector<unsigned char> bright(kSquareWidth * kSquareHeight * 3, 0xFF);
+    Image brightImage = {bright.data(), {kSquareWidth, kSquareHeight, 3}};
+
+    ASSERT_TRUE(algorithm.Run(brightImage).empty());
+}
+
+/**
+ * Tests invalid parameters and images for the LoG algorithm
+ */
+TEST(EdgeTest, TestLoCEdgeDetectionInvalid) {
+    ASSERT_THROW(LoCEdgeDetectionAlgorithm(0, kLoCThreshold), std::invalid_argument);
+    ASSERT_THROW(LoCEdgeDetectionAlgorithm(kLoCSigma, kLoCThreshold, false, 0), std::invalid_argument);
+
+    LoCEdgeDetectionAlgorithm algorithm(kLoCSigma, kLoCThreshold);
+    Image image = {squarePixels.data(), {kSquareWidth, kSquareHeight / 2, 2}};
+    ASSERT_THROW(algorithm.Run(image), std::invalid_argument);
+}
+
+/**
+ * Tests that changing the parameters of an algorithm matches making a new one
+ */
+TEST(EdgeTest, TestEdgeDetectionSetParameters) {
+    SimpleEdgeDetectionAlgorithm simple(kEdgeThreshold);
+    simple.Run(diskImage);
+    simple.SetThreshold(150);
+    ASSERT_EQ(SimpleEdgeDetectionAlgorithm(150).Run(diskImage), simple.Run(diskImage));
+
+    LoCEdgeDetectionAlgorithm loc(kLoCSigma, kLoCThreshold);
+    loc.Run(diskImage);
+    loc.SetParameters(2 * kLoCSigma, kLoCThreshold / 2);
+    ASSERT_EQ(SortPoints(LoCEdgeDetectionAlgorithm(2 * kLoCSigma, kLoCThreshold / 2).Run(diskImage)),
+              SortPoints(loc.Run(diskImage)));
+    loc.SetParameters(2 * kLoCSigma, kLoCThreshold);
+    ASSERT_EQ(SortPoints(LoCEdgeDetectionAlgorithm(2 * kLoCSigma, kLoCThreshold).Run(diskImage)),
+              SortPoints(loc.Run(diskImage)));
+    ASSERT_THROW(loc.SetParameters(0, kLoCThreshold), std::invalid_argument);
+}
+
+/**
+ * Tests predicting where the horizon of a disk is
+ */
+TEST(EdgeTest, TestPredictHorizonRegion) {
+    RegionOfInterest region = PredictHorizonRegion(diskCamera, diskAttitude, diskPosition,
+                                                   kDiskEarthRadius, kRegionMargin, kRegionTileSize);
+
+    ASSERT_TRUE(region.Covers(diskImage));
+    // The middle of the disk is not searched
+    ASSERT_FALSE(region.Contains(kDiskCenter / kRegionTileSize, kDiskCenter / kRegionTileSize));
+    // Its rim is
+    ASSERT_TRUE(region.Contains((kDiskCenter + kDiskRadius) / kRegionTileSize, kDiskCenter / kRegionTileSize));
+    ASSERT_TRUE(region.Contains(kDiskCenter / kRegionTileSize, (kDiskCenter - kDiskRadius) / kRegionTileSize));
+    // Its corners are not
+    ASSERT_FALSE(region.Contains(0, 0));
+}
+
+/**
+ * Tests predicting the horizon when Earth is behind the camera
+ */
+TEST(EdgeTest, TestPredictHorizonRegionBehind) {
+    RegionOfInterest region = PredictHorizonRegion(diskCamera, diskAttitude, diskPosition * -1,
+                                                   kDiskEarthRadius, kRegionMargin, kRegionTileSize);
+
+    ASSERT_TRUE(region.Empty());
+    ASSERT_FALSE(region.Covers(diskImage));
+}
+
+/**
+ * Tests adding to a region of interest
+ */
+TEST(EdgeTest, TestRegionOfInterest) {
+    ASSERT_THROW(RegionOfInterest(kDiskSize, kDiskSize, 0), std::invalid_argument);
+
+    RegionOfInterest region(kDiskSize, kDiskSize, kRegionTileSize);
+    ASSERT_TRUE(region.Empty());
+
+    // A segment far outside of the image adds nothing
+    region.AddSegment({-100, -100}, {-100, 1000}, kRegionMargin);
+    ASSERT_TRUE(region.Empty());
+
+    // A diagonal segment adds a staircase of tiles
+    region.AddSegment({0, 0}, {kDiskSize * 2.0f, kDiskSize * 2.0f}, 0);
+    for (int i = 0; i < region.TilesX(); i++) {
+        ASSERT_TRUE(region.Contains(i, i));
+    }
+    ASSERT_FALSE(region.Contains(region.TilesX() - 1, 0));
+
+    RegionOfInterest other(kDiskSize / 2, kDiskSize, kRegionTileSize);
+    other.AddPoint(0, 0, 0);
+    ASSERT_FALSE(other.Covers(diskImage));
+}
+
+/**
+ * Tests that searching the predicted region gives the same horizon as
+ * searching the whole image
+ */
+TEST(EdgeTest, TestEdgeDetectionRegionOfInterest) {
+    RegionOfInterest region = PredictHorizonRegion(diskCamera, diskAttitude, diskPosition,
+                                                   kDiskEarthRadius, kRegionMargin, kRegionTileSize);
+
+    SimpleEdgeDetectionAlgorithm simple(kEdgeThreshold);
+    std::vector<std::pair<decimal, decimal>> expectedSimple = SortPoints(simple.Run(diskImage));
+    simple.SetRegionOfInterest(region);
+    ASSERT_EQ(expectedSimple, SortPoints(simple.Run(diskImage)));
+
+    LoCEdgeDetectionAlgorithm loc(kLoCSigma, kLoCThreshold);
+    std::vector<std::pair<decimal, decimal>> expectedLoC = SortPoints(loc.Run(diskImage));
+    loc.SetRegionOfInterest(region);
+    std::vector<std::pair<decimal, decimal>> actualLoC = SortPoints(loc.Run(diskImage));
+    ASSERT_EQ(expectedLoC.size(), actualLoC.size());
+    for (size_t i = 0; i < expectedLoC.size(); i++) {
+        ASSERT_NEAR(expectedLoC[i].first, actualLoC[i].first, 1e-4);
+        ASSERT_NEAR(expectedLoC[i].second, actualLoC[i].second, 1e-4);
+    }
+
+    loc.ClearRegionOfInterest();
+    ASSERT_TRUE(loc.GetRegionOfInterest().Empty());
+}
+
+/**
+ * Tests that a region of interest without the horizon falls back to
+ * searching the whole image
+ */
+TEST(EdgeTest, TestEdgeDetectionRegionOfInterestMiss) {
+    RegionOfInterest region(kDiskSize, kDiskSize, kRegionTileSize);
+    region.AddPoint(0, 0, 0);
+
+    SimpleEdgeDetectionAlgorithm simple(kEdgeThreshold);
+    std::vector<std::pair<decimal, decimal>> expectedSimple = SortPoints(simple.Run(diskImage));
+    simple.SetRegionOfInterest(region);
+    ASSERT_EQ(expectedSimple, SortPoints(simple.Run(diskImage)));
+
+    LoCEdgeDetectionAlgorithm loc(kLoCSigma, kLoCThreshold);
+    size_t expectedLoC = loc.Run(diskImage).size();
+    loc.SetRegionOfInterest(region);
+    ASSERT_EQ(expectedLoC, loc.Run(diskImage).size());
+}
+
+/**
+ * Tests that searching around the horizon of a decimated image gives the same
+ * horizon as searching the whole image
+ */
+TEST(EdgeTest, TestPyramidEdgeDetection) {
+    SimpleEdgeDetectionAlgorithm simple(kEdgeThreshold);
+    std::vector<std::pair<decimal, decimal>> expectedSimple = SortPoints(simple.Run(diskImage));
+
+    for (int levels = 0; levels <= kPyramidLevels; levels++) {
+        PyramidEdgeDetectionAlgorithm pyramid(simple, simple, levels);
+        ASSERT_EQ(expectedSimple, SortPoints(pyramid.Run(diskImage))) << "levels " << levels;
+        ASSERT_TRUE(simple.GetRegionOfInterest().Empty());
+    }
+
+    // Decimation stops once the image cannot be halved any more
+    PyramidEdgeDetectionAlgorithm deep(simple, simple, kSquareWidth);
+    ASSERT_EQ(SortPoints(simple.Run(squareImage)), SortPoints(deep.Run(squareImage)));
+
+    LoCEdgeDetectionAlgorithm loc(kLoCSigma, kLoCThreshold);
+    std::vector<std::pair<decimal, decimal>> expectedLoC = SortPoints(loc.Run(diskImage));
+    PyramidEdgeDetectionAlgorithm pyramid(simple, loc, kPyramidLevels);
+    std::vector<std::pair<decimal, decimal>> actualLoC = SortPoints(pyramid.Run(diskImage));
+    ASSERT_EQ(expectedLoC.size(), actualLoC.size());
+    for (size_t i = 0; i < expectedLoC.size(); i++) {
+        ASSERT_NEAR(expectedLoC[i].first, actualLoC[i].first, 1e-4);
+        ASSERT_NEAR(expectedLoC[i].second, actualLoC[i].second, 1e-4);
+    }
+}
+
+/**
+ * Tests that a pyramid searches its own region of interest instead of the
+ * coarse horizon, and leaves the regions of its detectors alone
+ */
+TEST(EdgeTest, TestPyramidEdgeDetectionRegionOfInterest) {
+    RegionOfInterest region = PredictHorizonRegion(diskCamera, diskAttitude, diskPosition,
+                                                   kDiskEarthRadius, kRegionMargin, kRegionTileSize);
+    RegionOfInterest corner(kDiskSize, kDiskSize, kRegionTileSize);
+    corner.AddPoint(0, 0, 0);
+
+    SimpleEdgeDetectionAlgorithm coarse(kEdgeThreshold);
+    SimpleEdgeDetectionAlgorithm fine(kEdgeThreshold);
+    std::vector<std::pair<decimal, decimal>> expected = SortPoints(fine.Run(diskImage));
+    coarse.SetRegionOfInterest(corner);
+    fine.SetRegionOfInterest(corner);
+
+    PyramidEdgeDetectionAlgorithm pyramid(coarse, fine, kPyramidLevels);
+    pyramid.SetRegionOfInterest(region);
+    ASSERT_EQ(expected, SortPoints(pyramid.Run(diskImage)));
+    ASSERT_EQ(corner.TilesX(), coarse.GetRegionOfInterest().TilesX());
+    ASSERT_TRUE(fine.GetRegionOfInterest().Contains(0, 0));
+
+    Image image = {diskPixels.data(), {kDiskSize, kDiskSize / 2, 2}};
+    ASSERT_THROW(pyramid.Run(image), std::invalid_argument);
+    ASSERT_TRUE(fine.GetRegionOfInterest().Contains(0, 0));
+}
+
+/**
+ * Tests invalid parameters for the pyramid algorithm
+ */
+TEST(EdgeTest, TestPyramidEdgeDetectionInvalid) {
+    SimpleEdgeDetectionAlgorithm simple(kEdgeThreshold);
+
+    ASSERT_THROW(PyramidEdgeDetectionAlgorithm(simple, simple, -1), std::invalid_argument);
+    ASSERT_THROW(PyramidEdgeDetectionAlgorithm(simple, simple, 1, -1), std::invalid_argument);
+    ASSERT_THROW(PyramidEdgeDetectionAlgorithm(simple, simple, 1, 2, 0), std::invalid_argument);
+}
+
+/**
+ * Provides how far points are from a circle
+ *
+ * @param points The points
+ * @param cx,cy The center of the circle
+ * @param radius The radius of the circle
+ *
+ * @return The root mean square distance between the points and the circle
+ */
+static decimal CircleError(const Points &points, decimal cx, decimal cy, decimal radius) {
+    decimal squares = 0;
+    for (const Vec2 &point : points) {
+        decimal error = sqrt((point.x - cx) * (point.x - cx) + (point.y - cy) * (point.y - cy)) - radius;
+        squares += error * error;
+    }
+    return sqrt(squares / points.size());
+}
+
+/**
+ * Tests that refined points are on the true (anti-aliased) edge of a disk
+ */
+TEST(EdgeTest, TestSubpixelRefinement) {
+    const int size = 200;
+    const decimal cx = 100.3, cy = 97.8, radius = 61.7;
+    std::vector<unsigned char> pixels(size * size, 0);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            // The coverage of each pixel by the disk, from 8 x 8 samples
+            int inside = 0;
+            for (int sy = 0; sy < 8; sy++) {
+                for (int sx = 0; sx < 8; sx++) {
+                    decimal dx = x + (sx + 0.5f) / 8 - cx, dy = y + (sy + 0.5f) / 8 - cy;
+                    inside += dx * dx + dy * dy < radius * radius;
+                }
+            }
+            pixels[y * size + x] = static_cast<unsigned char>(20 + 200 * inside / 64);
+        }
+    }
+    Image image = {pixels.data(), {size, size, 1}};
+
+    SimpleEdgeDetectionAlgorithm algorithm(120);
+    Points coarse = algorithm.Run(image);
+    SubpixelOptions options;
+    algorithm.SetSubpixelRefinement(options);
+    Points fine = algorithm.Run(image);
+    ASSERT_EQ(coarse.size(), fine.size());
+    ASSERT_GT(CircleError(coarse, cx, cy, radius), 0.3);
+    ASSERT_LT(CircleError(fine, cx, cy, radius), 0.1);
+
+    // Fewer points, in the same order
+    options.maxPoints = 50;
+    algorithm.SetSubpixelRefinement(options);
+    Points few = algorithm.Run(image);
+    ASSERT_EQ(50u, few.size());
+    ASSERT_LT(CircleError(few, cx, cy, radius), 0.1);
+    ASSERT_LE(few[0].y, few[49].y);
+
+    // Points on flat parts of an image are dropped
+    Points flat = {{10.5, 10.5}, {100.5, 100.5}};
+    RefineHorizonPoints(image, SubpixelOptions(), flat);
+    ASSERT_TRUE(flat.empty());
+
+    algorithm.ClearSubpixelRefinement();
+    ASSERT_EQ(coarse, algorithm.Run(image));
+    // Without a radius, points are only thinned out
+    options.radius = 0;
+    options.maxPoints = 10;
+    algorithm.SetSubpixelRefinement(options);
+    Points thinned = algorithm.Run(image);
+    ASSERT_EQ(10u, thinned.size());
+    ASSERT_EQ(coarse[coarse.size() / 10].x, thinned[1].x);
+    ASSERT_EQ(coarse[coarse.size() / 10].y, thinned[1].y);
+    options.radius = -1;
+    ASSERT_THROW(algorithm.SetSubpixelRefinement(options), std::invalid_argument);
+    ASSERT_THROW(RefineHorizonPoints(image, options, few), std::invalid_argument);
+}
+
+}  // namespace found
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "src/distance/vectorize.hpp"
+#include "src/distance/distance.hpp"
+#include "src/pipeline/pipeline.hpp"
+
+#include "test/common/constants/distance-constants.hpp"
+
+namespace found {
+
+/**
+ * A DistanceDeterminationAlgorithm that always finds Earth at the same place
+ */
+class FixedDistanceAlgorithm : public DistanceDeterminationAlgorithm {
+ public:
+    /**
+     * Creates a FixedDistanceAlgorithm
+     *
+     * @param center The direction towards Earth's center, in the camera frame
+     */
+    explicit FixedDistanceAlgorithm(const Vec3 &center) { this->center = center.Normalize(); }
+
+    distFromEarth Run(const Points &) override { return kEarthDistance; }
+};
+
+/**
+ * Makes points on the horizon of a spherical Earth (of kEarthRadius), as seen by distanceCamera
+ *
+ * @param position The position of the camera, relative to Earth's center
+ * @param attitude The attitude of the camera
+ * @param count The number of points
+ *
+ * @return The horizon points
+ */
+static Points MakeSphereHorizonPoints(const PositionVector &position, const Attitude &attitude, int count) {
+    decimal distance2 = position.MagnitudeSq();
+    Vec3 center = position * (kEarthRadius * kEarthRadius / distance2);
+    decimal radius = kEarthRadius * sqrt(1 - kEarthRadius * kEarthRadius / distance2);
+    Vec3 e1 = position.CrossProduct(Vec3(0, 0, 1)).Normalize();
+    Vec3 e2 = position.Normalize().CrossProduct(e1);
+
+    Points points;
+    for (int i = 0; i < count; i++) {
+        decimal angle = 2 * M_PI * i / count;
+        Vec3 horizon = center + (e1 * cos(angle) + e2 * sin(angle)) * radius;
+        points.push_back(distanceCamera.SpatialToCamera(attitude.Rotate(horizon - position)));
+    }
+    return points;
+}
+
+/**
+ * Tests that frames between two attitudes are placed with the attitude interpolated between them
+ */
+TEST(VectorizeTest, TestInterpolatedAttitude) {
+    FixedDistanceAlgorithm distance(Vec3(1, 0, 0));
+    LOSTVectorGenerationAlgorithm vectorize(distance);
+    ASSERT_THROW(vectorize.Run(kEarthDistance), std::runtime_error);
+
+    // The camera turns about the z axis, from looking along x at t = 10 to looking along y at t = 20
+    Vec3 axis(0, 0, 1);
+    vectorize.AddAttitude(10, Attitude(Quaternion(axis, 0)));
+    vectorize.AddAttitude(20, Attitude(Quaternion(axis, DegToRad(90))));
+    ASSERT_THROW(vectorize.AddAttitude(20, Attitude(Quaternion(axis, 0))), std::invalid_argument);
+    ASSERT_EQ(2u, vectorize.Attitudes());
+
+    vectorize.SetFrameTime(15);
+    Vec3 expected = Attitude(Quaternion(axis, DegToRad(45))).GetDCM().Transpose() * Vec3(1, 0, 0) * -kEarthDistance;
+    PositionVector position = vectorize.Run(kEarthDistance);
+    ASSERT_NEAR(expected.x, position.x, 1e-2);
+    ASSERT_NEAR(expected.y, position.y, 1e-2);
+    ASSERT_NEAR(0, position.z, 1e-2);
+    ASSERT_NEAR(kEarthDistance, position.Magnitude(), 1e-2);
+
+    // Frames outside of the attitudes are held at the nearest one
+    vectorize.SetFrameTime(0);
+    PositionVector first = vectorize.Run(kEarthDistance);
+    ASSERT_NEAR(-kEarthDistance, first.x, 1e-2);
+    vectorize.SetFrameTime(25);
+    Vec3 last = Attitude(Quaternion(axis, DegToRad(90))).GetDCM().Transpose() * Vec3(-kEarthDistance, 0, 0);
+    ASSERT_NEAR(last.y, vectorize.Run(kEarthDistance).y, 1e-2);
+
+    // A later attitude moves a frame that was held at the last one
+    vectorize.AddAttitude(30, Attitude(Quaternion(axis, DegToRad(180))));
+    Quaternion moved = vectorize.FrameAttitude().GetQuaternion().Canonicalize();
+    Quaternion between = Quaternion(axis, DegToRad(135)).Canonicalize();
+    ASSERT_NEAR(between.real, moved.real, 1e-5);
+    ASSERT_NEAR(between.k, moved.k, 1e-5);
+
+    ASSERT_THROW(LOSTVectorGenerationAlgorithm(distance, 0), std::invalid_argument);
+}
+
+/**
+ * Tests that only the latest attitudes are kept
+ */
+TEST(VectorizeTest, TestAttitudeHistory) {
+    FixedDistanceAlgorithm distance(Vec3(1, 0, 0));
+    LOSTVectorGenerationAlgorithm vectorize(distance, 3);
+    Vec3 axis(1, 0, 0);
+    for (int i = 0; i < 10; i++) vectorize.AddAttitude(i, Attitude(Quaternion(axis, DegToRad(10 * i))));
+    ASSERT_EQ(3u, vectorize.Attitudes());
+
+    // The frame is before every attitude kept, so it is held at the first of them
+    vectorize.SetFrameTime(1);
+    Quaternion held = vectorize.FrameAttitude().GetQuaternion();
+    Quaternion expected(axis, DegToRad(70));
+    ASSERT_NEAR(expected.real, held.real, 1e-5);
+    ASSERT_NEAR(expected.i, held.i, 1e-5);
+    vectorize.AddAttitude(10, Attitude(Quaternion(axis, DegToRad(100))));
+    expected = Quaternion(axis, DegToRad(80));
+    ASSERT_NEAR(expected.i, vectorize.FrameAttitude().GetQuaternion().i, 1e-5);
+}
+
+/**
+ * Tests that one Pipeline turns every frame into a position, as attitudes stream in
+ */
+TEST(VectorizeTest, TestAttitudeStream) {
+    SphericalDistanceDeterminationAlgorithm distance(kEarthRadius, distanceCamera);
+    LOSTVectorGenerationAlgorithm vectorize(distance);
+    std::vector<std::reference_wrapper<Action>> stages;
+    Pipeline<Points, PositionVector> pipeline(stages);
+    pipeline.AddStage(distance).Complete(vectorize);
+
+    PositionVector start(-30000, 12000, 9000);
+    PositionVector step(300, 150, -200);
+    for (int frame = 0; frame < 5; frame++) {
+        PositionVector truth = start + step * frame;
+        // The camera looks slightly off Earth's center, so that the center is not along the boresight
+        Attitude attitude = LookAtEarth(truth + Vec3(0, 2000, 1000));
+        vectorize.AddAttitude(frame, attitude);
+        vectorize.SetFrameTime(frame);
+
+        PositionVector position = pipeline.Run(MakeSphereHorizonPoints(truth, attitude, 200));
+        ASSERT_NEAR(truth.x, position.x, 1e-3 * truth.Magnitude());
+        ASSERT_NEAR(truth.y, position.y, 1e-3 * truth.Magnitude());
+        ASSERT_NEAR(truth.z, position.z, 1e-3 * truth.Magnitude());
+    }
+}
+
+}  // namespace found
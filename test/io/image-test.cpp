@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/io/image.hpp"
+#include "src/distance/edge.hpp"
+
+#include "test/common/constants/io-constants.hpp"
+#include "test/common/constants/edge-constants.hpp"
+
+namespace found {
+
+/**
+ * Writes a test file
+ *
+ * @param name The name of the file
+ * @param contents The contents of the file
+ *
+ * @return The path to the file
+ */
+static std::string WriteFile(const std::string &name, const std::string &contents) {
+    std::string path = testing::TempDir() + name;
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+    return path;
+}
+
+/**
+ * Makes the pixels 0, 1, 2, ...
+ *
+ * @param count The number of pixels
+ *
+ * @return The pixels
+ */
+static std::string Ramp(int count) {
+    std::string pixels;
+    for (int i = 0; i < count; i++) pixels.push_back(static_cast<char>(i));
+    return pixels;
+}
+
+/**
+ * Tests mapping a PGM
+ */
+TEST(ImageTest, TestMapPgm) {
+    std::string path = WriteFile("found-pgm.pgm", kPgmHeader + Ramp(kPgmWidth * kPgmHeight));
+
+    Image image = MapNetpbmImage(path);
+
+    ASSERT_EQ(kPgmWidth, image.dimensions[0]);
+    ASSERT_EQ(kPgmHeight, image.dimensions[1]);
+    ASSERT_EQ(1, image.dimensions[2]);
+    ASSERT_EQ(static_cast<size_t>(kPgmWidth), image.RowStride());
+    ASSERT_NE(nullptr, image.owner);
+    for (int i = 0; i < kPgmWidth * kPgmHeight; i++) {
+        ASSERT_EQ(i, image.image[i]);
+    }
+}
+
+/**
+ * Tests mapping a PPM, and that the mapping outlives the first Image
+ */
+TEST(ImageTest, TestMapPpm) {
+    std::string path = WriteFile("found-ppm.ppm", kPpmHeader + Ramp(kPpmWidth * kPpmHeight * 3));
+
+    Image copy;
+    {
+        Image image = MapImage(path);
+        copy = image;
+    }
+
+    ASSERT_EQ(kPpmWidth, copy.dimensions[0]);
+    ASSERT_EQ(kPpmHeight, copy.dimensions[1]);
+    ASSERT_EQ(3, copy.dimensions[2]);
+    ASSERT_EQ(kPpmWidth * 3, copy.Row(1)[0]);
+
+    // Writing to the image never writes to the file
+    copy.image[0] = 0xFF;
+    ASSERT_EQ(0, MapNetpbmImage(path).image[0]);
+}
+
+/**
+ * Tests mapping a raw file with a header and padded rows
+ */
+TEST(ImageTest, TestMapRaw) {
+    int width = kPgmWidth;
+    int height = kPgmHeight;
+    size_t stride = width * 3 + kRawPadding;
+    std::string path = WriteFile("found-raw.bin", Ramp(kRawOffset + stride * height));
+
+    Image image = MapRawImage(path, width, height, 3, kRawOffset, stride);
+    ASSERT_EQ(stride, image.RowStride());
+    ASSERT_EQ(kRawOffset, image.image[0]);
+    ASSERT_EQ(kRawOffset + 2 * stride, image.Row(2)[0]);
+
+    Image packed = MapImage(path, width, height, 1, kRawOffset);
+    ASSERT_EQ(static_cast<size_t>(width), packed.RowStride());
+    ASSERT_EQ(kRawOffset + 2 * width, packed.Row(2)[0]);
+}
+
+/**
+ * Tests finding the horizon in a mapped image with padded rows
+ */
+TEST(ImageTest, TestEdgeDetectionMappedImage) {
+    std::string contents(kRawOffset, '\0');
+    for (int y = 0; y < kSquareHeight; y++) {
+        contents.append(reinterpret_cast<const char *>(squarePixels.data()) + y * kSquareWidth, kSquareWidth);
+        contents.append(kRawPadding, static_cast<char>(0xFF));
+    }
+    std::string path = WriteFile("found-square.bin", contents);
+
+    Image image = MapRawImage(path, kSquareWidth, kSquareHeight, 1, kRawOffset, kSquareWidth + kRawPadding);
+    SimpleEdgeDetectionAlgorithm algorithm(kEdgeThreshold);
+    Points points = algorithm.Run(image);
+
+    ASSERT_EQ(squareEdges.size(), points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        ASSERT_EQ(squareEdges[i].x, points[i].x);
+        ASSERT_EQ(squareEdges[i].y, points[i].y);
+    }
+}
+
+/**
+ * Tests files that cannot be mapped
+ */
+TEST(ImageTest, TestMapInvalidFiles) {
+    ASSERT_THROW(MapNetpbmImage(testing::TempDir() + "found-missing.pgm"), std::runtime_error);
+    ASSERT_THROW(MapNetpbmImage(testing::TempDir()), std::runtime_error);
+    ASSERT_THROW(MapNetpbmImage(WriteFile("found-empty.pgm", "")), std::invalid_argument);
+}
+
+/**
+ * Tests Netpbm files with invalid headers
+ */
+TEST(ImageTest, TestMapInvalidNetpbm) {
+    ASSERT_THROW(MapNetpbmImage(WriteFile("found-p2.pgm", "P2\n1 1\n255\n0\n")), std::invalid_argument);
+    ASSERT_THROW(MapNetpbmImage(WriteFile("found-short.pgm", "P")), std::invalid_argument);
+    ASSERT_THROW(MapNetpbmImage(WriteFile("found-no-height.pgm", "P5\n4\n")), std::invalid_argument);
+    ASSERT_THROW(MapNetpbmImage(WriteFile("found-no-pixels.pgm", "P5 4 3 255")), std::invalid_argument);
+    ASSERT_THROW(MapNetpbmImage(WriteFile("found-huge.pgm", "P5 99999999999 1 255\n")), std::invalid_argument);
+    ASSERT_THROW(MapNetpbmImage(WriteFile("found-16-bit.pgm", "P5 1 1 65535\n\1\1")), std::invalid_argument);
+    ASSERT_THROW(MapNetpbmImage(WriteFile("found-truncated.pgm", kPgmHeader + Ramp(kPgmWidth))),
+                 std::invalid_argument);
+}
+
+/**
+ * Tests raw images of invalid sizes
+ */
+TEST(ImageTest, TestMapInvalidRaw) {
+    std::string path = WriteFile("found-small.bin", Ramp(kPgmWidth * kPgmHeight));
+
+    ASSERT_THROW(MapRawImage(path, 0, kPgmHeight, 1), std::invalid_argument);
+    ASSERT_THROW(MapRawImage(path, kPgmWidth, -1, 1), std::invalid_argument);
+    ASSERT_THROW(MapRawImage(path, kPgmWidth, kPgmHeight, 0), std::invalid_argument);
+    ASSERT_THROW(MapRawImage(path, kPgmWidth, kPgmHeight, 1, 1), std::invalid_argument);
+    ASSERT_THROW(MapRawImage(path, kPgmWidth, kPgmHeight, 1, 0, kPgmWidth - 1), std::invalid_argument);
+    ASSERT_NO_THROW(MapRawImage(path, kPgmWidth, kPgmHeight, 1));
+}
+
+/**
+ * Tests writing a PGM and a PPM, and mapping them back
+ */
+TEST(ImageTest, TestWriteNetpbm) {
+    std::string pixels = Ramp(3 * kPgmWidth * kPgmHeight);
+    for (int channels : {1, 3}) {
+        Image image = {reinterpret_cast<unsigned char *>(&pixels[0]), {kPgmWidth, kPgmHeight, channels}, 0, nullptr};
+        std::string path = testing::TempDir() + "found-written.pnm";
+        WriteNetpbmImage(path, image);
+
+        Image written = MapNetpbmImage(path);
+        ASSERT_EQ(kPgmWidth, written.dimensions[0]);
+        ASSERT_EQ(kPgmHeight, written.dimensions[1]);
+        ASSERT_EQ(channels, written.dimensions[2]);
+        ASSERT_TRUE(std::equal(image.image, image.image + channels * kPgmWidth * kPgmHeight, written.image));
+    }
+
+    Image pixelsOnly = {reinterpret_cast<unsigned char *>(&pixels[0]), {kPgmWidth, kPgmHeight, 2}, 0, nullptr};
+    ASSERT_THROW(WriteNetpbmImage(testing::TempDir() + "found-written.pnm", pixelsOnly), std::invalid_argument);
+    Image image = {reinterpret_cast<unsigned char *>(&pixels[0]), {kPgmWidth, kPgmHeight, 1}, 0, nullptr};
+    ASSERT_THROW(WriteNetpbmImage(testing::TempDir() + "missing/found.pgm", image), std::runtime_error);
+}
+
+}  // namespace found
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/io/manifest.hpp"
+
+namespace found {
+
+/**
+ * Tests reading a manifest
+ */
+TEST(ManifestTest, TestReadManifest) {
+    std::string path = testing::TempDir() + "found-manifest.txt";
+    {
+        std::ofstream manifest(path);
+        manifest << "# Frames of the first pass\n"
+                 << "frame-1.pgm\n"
+                 << "\n"
+                 << "/absolute/frame-2.pgm\r\n"
+                 << "nested/frame-3.pgm";
+    }
+
+    std::vector<std::string> frames = ReadManifest(path);
+
+    ASSERT_EQ(3, frames.size());
+    ASSERT_EQ(testing::TempDir() + "frame-1.pgm", frames[0]);
+    ASSERT_EQ("/absolute/frame-2.pgm", frames[1]);
+    ASSERT_EQ(testing::TempDir() + "nested/frame-3.pgm", frames[2]);
+    ASSERT_THROW(ReadManifest(testing::TempDir() + "found-missing.txt"), std::runtime_error);
+}
+
+/**
+ * Tests listing a directory
+ */
+TEST(ManifestTest, TestListDirectory) {
+    std::string directory = testing::TempDir() + "found-frames";
+    mkdir(directory.c_str(), 0755);
+    mkdir((directory + "/subdirectory").c_str(), 0755);
+    for (const char *name : {"b.pgm", "a.pgm", ".hidden"}) {
+        std::ofstream(directory + "/" + name) << "P5 1 1 255\n";
+    }
+
+    std::vector<std::string> frames = ListDirectory(directory);
+    ASSERT_EQ(2, frames.size());
+    ASSERT_EQ(directory + "/a.pgm", frames[0]);
+    ASSERT_EQ(directory + "/b.pgm", frames[1]);
+    ASSERT_EQ(frames, ListDirectory(directory + "/"));
+    ASSERT_THROW(ListDirectory(directory + "/missing"), std::runtime_error);
+}
+
+}  // namespace found
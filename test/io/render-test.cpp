@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "src/io/render.hpp"
+#include "src/distance/distance.hpp"
+#include "src/distance/edge.hpp"
+
+#include "test/common/constants/distance-constants.hpp"
+
+namespace found {
+
+/// The camera that takes the rendered test images
+static Camera renderCamera(300, 256, 256);
+/// Where the rendered test images are taken from, in km
+static PositionVector renderPosition(-30000, 12000, 9000);
+
+/**
+ * Makes the options of a spherical Earth
+ *
+ * @return The options, with the radius of kEarthRadius
+ */
+static RenderOptions MakeSphericalOptions() {
+    RenderOptions options;
+    options.equatorialRadius = kEarthRadius;
+    options.polarRadius = kEarthRadius;
+    return options;
+}
+
+/**
+ * Tests that the edges of a rendered Earth are on its horizon, and give its distance
+ */
+TEST(RenderTest, TestEdgesOnHorizon) {
+    RenderOptions options = MakeSphericalOptions();
+    Attitude attitude = LookAtEarth(renderPosition);
+    Image image = RenderEarth(renderCamera, renderPosition, attitude, options);
+    ASSERT_EQ(256, image.dimensions[0]);
+    ASSERT_EQ(1, image.dimensions[2]);
+    ASSERT_NE(nullptr, image.owner);
+    // Earth is in the middle, and space is in the corners
+    ASSERT_EQ(options.earthIntensity, image.Row(128)[128]);
+    ASSERT_EQ(options.spaceIntensity, image.Row(0)[0]);
+
+    Points horizon = RenderHorizon(renderCamera, renderPosition, attitude, options, 720);
+    ASSERT_EQ(720u, horizon.size());
+    // Looking at the center of Earth, the horizon is a circle about the center of the image
+    decimal radius = sqrt(pow(horizon[0].x - 128, 2) + pow(horizon[0].y - 128, 2));
+    for (const Vec2 &point : horizon) {
+        ASSERT_NEAR(radius, sqrt(pow(point.x - 128, 2) + pow(point.y - 128, 2)), 1e-2);
+    }
+
+    SimpleEdgeDetectionAlgorithm edges((options.earthIntensity + options.spaceIntensity) / 2);
+    Points points = edges.Run(image);
+    ASSERT_GT(points.size(), 100u);
+    for (const Vec2 &point : points) {
+        ASSERT_NEAR(radius, sqrt(pow(point.x - 128, 2) + pow(point.y - 128, 2)), 1.5);
+    }
+
+    SphericalDistanceDeterminationAlgorithm distance(kEarthRadius, renderCamera);
+    ASSERT_NEAR(renderPosition.Magnitude(), distance.Run(points), 0.02 * renderPosition.Magnitude());
+}
+
+/**
+ * Tests that a few refined points give a better distance than as many points of whole pixels
+ */
+TEST(RenderTest, TestSubpixelDistance) {
+    RenderOptions options = MakeSphericalOptions();
+    Attitude attitude = LookAtEarth(renderPosition);
+    Image image = RenderEarth(renderCamera, renderPosition, attitude, options);
+    SphericalDistanceDeterminationAlgorithm distance(kEarthRadius, renderCamera);
+    SimpleEdgeDetectionAlgorithm edges((options.earthIntensity + options.spaceIntensity) / 2);
+
+    SubpixelOptions subpixel;
+    subpixel.maxPoints = 64;
+    Points coarse = edges.Run(image);
+    Points thinned;
+    for (size_t i = 0; i < 64; i++) thinned.push_back(coarse[i * coarse.size() / 64]);
+    edges.SetSubpixelRefinement(subpixel);
+    Points fine = edges.Run(image);
+    ASSERT_EQ(64u, fine.size());
+
+    decimal truth = renderPosition.Magnitude();
+    decimal coarseError = fabs(distance.Run(thinned) - truth);
+    decimal fineError = fabs(distance.Run(fine) - truth);
+    ASSERT_LT(fineError, coarseError);
+    ASSERT_LT(fineError, 0.002 * truth);
+}
+
+/**
+ * Tests that the distance through a distorted lens is found with the camera's table of rays
+ */
+TEST(RenderTest, TestDistortedDistance) {
+    RenderOptions options = MakeSphericalOptions();
+    Attitude attitude = LookAtEarth(renderPosition);
+    Camera exact = renderCamera;
+    exact.SetDistortion(kBarrelDistortion);
+    Camera camera = exact;
+    camera.BuildRayTable(4);
+
+    // The table renders the same image as undistorting every sample, but for samples right on the horizon
+    Image image = RenderEarth(camera, renderPosition, attitude, options);
+    Image expected = RenderEarth(exact, renderPosition, attitude, options);
+    decimal sample = (options.earthIntensity - options.spaceIntensity) / (options.supersample * options.supersample);
+    int different = 0;
+    for (int i = 0; i < 256 * 256; i++) {
+        ASSERT_NEAR(expected.image[i], image.image[i], sample + 1);
+        if (expected.image[i] != image.image[i]) different++;
+    }
+    ASSERT_LT(different, 10);
+
+    Points horizon = RenderHorizon(camera, renderPosition, attitude, options, 360);
+    decimal truth = renderPosition.Magnitude();
+    SphericalDistanceDeterminationAlgorithm distorted(kEarthRadius, camera);
+    SphericalDistanceDeterminationAlgorithm ideal(kEarthRadius, renderCamera);
+    decimal error = fabs(distorted.Run(horizon) - truth);
+    ASSERT_LT(error, 1e-4 * truth);
+    ASSERT_LT(10 * error, fabs(ideal.Run(horizon) - truth));
+}
+
+/**
+ * Tests that the horizon of an oblate Earth matches that of the distance tests
+ */
+TEST(RenderTest, TestOblateHorizon) {
+    RenderOptions options;
+    options.equatorialRadius = kEquatorialRadius;
+    options.polarRadius = kPolarRadius;
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    Points horizon = RenderHorizon(distanceCamera, ellipticPosition, attitude, options, 64);
+    Points expected = MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 64);
+    ASSERT_EQ(expected.size(), horizon.size());
+
+    // The circles may start at other angles, so each point is matched to its nearest
+    for (const Vec2 &point : horizon) {
+        decimal nearest = 1e9;
+        decimal along = 1e9;
+        for (const Vec2 &other : expected) {
+            nearest = std::min(nearest, (point - other).Magnitude());
+        }
+        for (size_t i = 0; i + 1 < expected.size(); i++) {
+            along = std::min(along, (expected[i + 1] - expected[i]).Magnitude());
+        }
+        ASSERT_LT(nearest, along);
+    }
+
+    // A part of Earth out of the image has no points
+    Attitude away = LookAtEarth(ellipticPosition * -1);
+    ASSERT_TRUE(RenderHorizon(distanceCamera, ellipticPosition, away, options, 64).empty());
+}
+
+/**
+ * Tests that noise is the same for the same seed, and that blur softens the horizon
+ */
+TEST(RenderTest, TestEffects) {
+    RenderOptions options = MakeSphericalOptions();
+    Attitude attitude = LookAtEarth(renderPosition);
+    options.supersample = 2;
+    options.noiseSigma = 5;
+    options.seed = 11;
+    Image first = RenderEarth(renderCamera, renderPosition, attitude, options);
+    Image second = RenderEarth(renderCamera, renderPosition, attitude, options);
+    ASSERT_TRUE(std::equal(first.image, first.image + 256 * 256, second.image));
+    options.seed = 12;
+    Image other = RenderEarth(renderCamera, renderPosition, attitude, options);
+    ASSERT_FALSE(std::equal(first.image, first.image + 256 * 256, other.image));
+    ASSERT_FALSE(std::all_of(first.Row(0), first.Row(1),
+                             [&](unsigned char pixel) { return pixel == options.spaceIntensity; }));
+
+    // Across the horizon, a blurred row has more levels between space and Earth
+    options.noiseSigma = 0;
+    Image sharp = RenderEarth(renderCamera, renderPosition, attitude, options);
+    options.blurSigma = 3;
+    Image blurred = RenderEarth(renderCamera, renderPosition, attitude, options);
+    int sharpLevels = 0, blurredLevels = 0;
+    for (int x = 0; x < 128; x++) {
+        sharpLevels += sharp.Row(128)[x] > options.spaceIntensity && sharp.Row(128)[x] < options.earthIntensity;
+        blurredLevels += blurred.Row(128)[x] > options.spaceIntensity && blurred.Row(128)[x] < options.earthIntensity;
+    }
+    ASSERT_GT(blurredLevels, sharpLevels + 4);
+}
+
+/**
+ * Tests that the sun lights only the side of Earth facing it
+ */
+TEST(RenderTest, TestTerminator) {
+    RenderOptions options = MakeSphericalOptions();
+    Attitude attitude = LookAtEarth(renderPosition);
+    options.terminator = true;
+
+    // The sun behind the camera lights the middle of Earth fully
+    options.sunDirection = PrecisionCast<preciseDecimal>(renderPosition);
+    Image day = RenderEarth(renderCamera, renderPosition, attitude, options);
+    ASSERT_EQ(options.earthIntensity, day.Row(128)[128]);
+    // Behind Earth, it leaves the whole image in night
+    options.sunDirection = PrecisionCast<preciseDecimal>(renderPosition * -1);
+    Image night = RenderEarth(renderCamera, renderPosition, attitude, options);
+    ASSERT_TRUE(std::all_of(night.image, night.image + 256 * 256,
+                            [&](unsigned char pixel) { return pixel == options.spaceIntensity; }));
+}
+
+/**
+ * Tests rendering impossible images
+ */
+TEST(RenderTest, TestInvalidRenderings) {
+    RenderOptions options = MakeSphericalOptions();
+    Attitude attitude = LookAtEarth(renderPosition);
+    ASSERT_THROW(RenderEarth(renderCamera, PositionVector(100, 0, 0), attitude, options), std::invalid_argument);
+    ASSERT_THROW(RenderHorizon(renderCamera, PositionVector(100, 0, 0), attitude, options, 8), std::invalid_argument);
+    ASSERT_THROW(RenderEarth(Camera(300, 0, 256), renderPosition, attitude, options), std::invalid_argument);
+
+    RenderOptions bad = options;
+    bad.supersample = 0;
+    ASSERT_THROW(RenderEarth(renderCamera, renderPosition, attitude, bad), std::invalid_argument);
+    bad = options;
+    bad.polarRadius = 0;
+    ASSERT_THROW(RenderEarth(renderCamera, renderPosition, attitude, bad), std::invalid_argument);
+    bad = options;
+    bad.blurSigma = -1;
+    ASSERT_THROW(RenderEarth(renderCamera, renderPosition, attitude, bad), std::invalid_argument);
+    bad = options;
+    bad.terminator = true;
+    bad.sunDirection = PreciseVec3(0, 0, 0);
+    ASSERT_THROW(RenderEarth(renderCamera, renderPosition, attitude, bad), std::invalid_argument);
+}
+
+}  // namespace found
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/io/serialization.hpp"
+
+#include "test/common/constants/distance-constants.hpp"
+
+namespace found {
+
+/**
+ * Makes a position history
+ *
+ * @param count The number of positions
+ *
+ * @return The positions
+ */
+static std::vector<PositionVector> MakePositionHistory(size_t count) {
+    std::vector<PositionVector> positions;
+    for (size_t i = 0; i < count; i++) positions.push_back(PositionVector(7000 + i, -0.5f * i, 3.25f));
+    return positions;
+}
+
+/**
+ * Tests writing every kind of record into one buffer, and reading them back
+ */
+TEST(SerializationTest, TestRoundTrip) {
+    Points points = {{1.5, 2}, {3, -4.25}, {1023, 0}};
+    std::vector<PositionVector> history = MakePositionHistory(5);
+    OrbitParams orbit = {PositionVector(1, 2, 3), 7000.125, 0.25, PreciseVec3(0, 1, 0), PreciseVec3(0, 0, 1), 1.5};
+
+    std::vector<unsigned char> buffer;
+    SerializePoints(points, buffer);
+    SerializeDistance(42164.5, buffer);
+    SerializePosition(PositionVector(-1, 0.5, 8), buffer);
+    SerializePositionHistory(history, buffer);
+    SerializeOrbitParams(orbit, buffer);
+
+    size_t position = 0;
+    ASSERT_EQ(RecordType::Points, PeekRecord(buffer.data(), buffer.size(), position).type);
+    ASSERT_EQ(points, DeserializePoints(buffer.data(), buffer.size(), position));
+    ASSERT_EQ(0u, position % 8);
+    ASSERT_EQ(42164.5, DeserializeDistance(buffer.data(), buffer.size(), position));
+    PositionVector vector = DeserializePosition(buffer.data(), buffer.size(), position);
+    ASSERT_EQ(-1, vector.x);
+    ASSERT_EQ(0.5, vector.y);
+    ASSERT_EQ(8, vector.z);
+    std::vector<PositionVector> readHistory = DeserializePositionHistory(buffer.data(), buffer.size(), position);
+    ASSERT_EQ(history.size(), readHistory.size());
+    for (size_t i = 0; i < history.size(); i++) {
+        ASSERT_EQ(history[i].x, readHistory[i].x);
+        ASSERT_EQ(history[i].y, readHistory[i].y);
+        ASSERT_EQ(history[i].z, readHistory[i].z);
+    }
+    RecordHeader header = PeekRecord(buffer.data(), buffer.size(), position);
+    ASSERT_EQ(RecordType::OrbitParams, header.type);
+    ASSERT_EQ(1u, header.count);
+    OrbitParams readOrbit = DeserializeOrbitParams(buffer.data(), buffer.size(), position);
+    ASSERT_EQ(3, readOrbit.initialCondition.z);
+    ASSERT_EQ(orbit.semiMajorAxis, readOrbit.semiMajorAxis);
+    ASSERT_EQ(orbit.eccentricity, readOrbit.eccentricity);
+    ASSERT_EQ(orbit.meanAnomaly, readOrbit.meanAnomaly);
+    ASSERT_EQ(1, readOrbit.periapsis.y);
+    ASSERT_EQ(1, readOrbit.normal.z);
+    ASSERT_EQ(buffer.size(), position);
+}
+
+/**
+ * Tests that records are laid out as documented
+ */
+TEST(SerializationTest, TestLayout) {
+    std::vector<unsigned char> buffer;
+    SerializeDistance(1, buffer);
+
+    ASSERT_EQ(kRecordHeaderSize + 8, buffer.size());
+    ASSERT_EQ(std::string("FNDR"), std::string(buffer.begin(), buffer.begin() + 4));
+    ASSERT_EQ(kRecordVersion, buffer[4] | buffer[5] << 8);
+    ASSERT_EQ(static_cast<int>(RecordType::Distance), buffer[6] | buffer[7] << 8);
+    ASSERT_EQ(sizeof(decimal), buffer[8]);
+    ASSERT_EQ(1, buffer[16]);
+    ASSERT_EQ(8, buffer[24]);
+
+    Points empty;
+    buffer.clear();
+    SerializePoints(empty, buffer);
+    size_t position = 0;
+    ASSERT_TRUE(DeserializePoints(buffer.data(), buffer.size(), position).empty());
+}
+
+/**
+ * Tests reading records that are not what they should be
+ */
+TEST(SerializationTest, TestInvalidRecords) {
+    std::vector<unsigned char> buffer;
+    SerializePosition(PositionVector(1, 2, 3), buffer);
+    size_t position = 0;
+
+    // Another kind of record
+    ASSERT_THROW(DeserializeDistance(buffer.data(), buffer.size(), position), std::invalid_argument);
+    ASSERT_EQ(0u, position);
+    // Truncated
+    ASSERT_THROW(DeserializePosition(buffer.data(), buffer.size() - 1, position), std::invalid_argument);
+    ASSERT_THROW(PeekRecord(buffer.data(), kRecordHeaderSize - 1, 0), std::invalid_argument);
+    ASSERT_THROW(PeekRecord(buffer.data(), buffer.size(), buffer.size() + 1), std::invalid_argument);
+
+    std::vector<unsigned char> corrupt = buffer;
+    corrupt[0] = 'X';
+    ASSERT_THROW(PeekRecord(corrupt.data(), corrupt.size(), 0), std::invalid_argument);
+    corrupt = buffer;
+    corrupt[4] = kRecordVersion + 1;
+    ASSERT_THROW(PeekRecord(corrupt.data(), corrupt.size(), 0), std::invalid_argument);
+    corrupt = buffer;
+    corrupt[8] = sizeof(decimal) + 1;
+    ASSERT_THROW(PeekRecord(corrupt.data(), corrupt.size(), 0), std::invalid_argument);
+    corrupt = buffer;
+    corrupt[24] = 3;
+    ASSERT_THROW(PeekRecord(corrupt.data(), corrupt.size(), 0), std::invalid_argument);
+    // More items than the payload holds
+    corrupt = buffer;
+    corrupt[16] = 2;
+    ASSERT_THROW(DeserializePosition(corrupt.data(), corrupt.size(), position), std::invalid_argument);
+    std::vector<unsigned char> points;
+    SerializePoints({{1, 2}}, points);
+    points[16] = 5;
+    ASSERT_THROW(DeserializePoints(points.data(), points.size(), position), std::invalid_argument);
+    std::vector<unsigned char> distance;
+    SerializeDistance(1, distance);
+    distance[16] = 0;
+    ASSERT_THROW(DeserializeDistance(distance.data(), distance.size(), position), std::invalid_argument);
+    ASSERT_EQ(0u, position);
+}
+
+/**
+ * Tests reading a position history from a file, in place and into a vector
+ */
+TEST(SerializationTest, TestPositionHistoryFile) {
+    std::vector<PositionVector> history = MakePositionHistory(1000);
+    std::vector<unsigned char> buffer;
+    SerializePositionHistory(history, buffer);
+    SerializeDistance(1, buffer);
+    std::string path = testing::TempDir() + "found-history.bin";
+    WriteRecords(path, buffer);
+
+    PositionHistoryView view = MapPositionHistory(path);
+    ASSERT_EQ(history.size(), view.count);
+    size_t i = 0;
+    for (const PositionVector &position : view) {
+        ASSERT_EQ(history[i].x, position.x);
+        ASSERT_EQ(history[i].y, position.y);
+        i++;
+    }
+
+    std::vector<PositionVector> positions = ReadPositionHistory(path);
+    ASSERT_EQ(history.size(), positions.size());
+    ASSERT_EQ(history.back().x, positions.back().x);
+
+    std::vector<unsigned char> other;
+    SerializeDistance(1, other);
+    std::string otherPath = testing::TempDir() + "found-distance.bin";
+    WriteRecords(otherPath, other);
+    ASSERT_THROW(MapPositionHistory(otherPath), std::invalid_argument);
+    ASSERT_THROW(WriteRecords(testing::TempDir() + "missing/found.bin", other), std::runtime_error);
+}
+
+/**
+ * Tests writing a table of rays to a file, and reading it back for its camera
+ */
+TEST(SerializationTest, TestRayTableFile) {
+    Camera camera = distanceCamera;
+    camera.SetDistortion(kBarrelDistortion);
+    camera.BuildRayTable(16);
+    const RayTable &table = *camera.Table();
+    std::vector<unsigned char> buffer;
+    SerializeRayTable(table, buffer);
+    RecordHeader header = PeekRecord(buffer.data(), buffer.size(), 0);
+    ASSERT_EQ(RecordType::RayTable, header.type);
+    ASSERT_EQ(table.RayY().size(), header.count);
+
+    std::string path = testing::TempDir() + "found-rays.bin";
+    WriteRecords(path, buffer);
+    std::shared_ptr<const RayTable> read = ReadRayTable(path);
+    ASSERT_EQ(16, read->Step());
+    ASSERT_EQ(table.Columns(), read->Columns());
+    ASSERT_EQ(table.Rows(), read->Rows());
+    ASSERT_EQ(table.RayY(), read->RayY());
+    ASSERT_EQ(table.RayZ(), read->RayZ());
+    ASSERT_TRUE(read->Matches(camera));
+    ASSERT_FALSE(read->Matches(distanceCamera));
+    Camera loaded = distanceCamera;
+    loaded.SetDistortion(kBarrelDistortion);
+    loaded.SetRayTable(read);
+    Vec3 ray = loaded.CameraToSpatial({3, 1000});
+    Vec3 expected = camera.CameraToSpatial({3, 1000});
+    ASSERT_EQ(expected.y, ray.y);
+    ASSERT_EQ(expected.z, ray.z);
+
+    // Too few rays for the grid, or for the count of the record
+    size_t position = 0;
+    std::vector<unsigned char> corrupt = buffer;
+    corrupt[16]--;
+    ASSERT_THROW(DeserializeRayTable(corrupt.data(), corrupt.size(), position), std::invalid_argument);
+    position = 0;
+    corrupt = buffer;
+    corrupt[16] = 0xFF;
+    corrupt[17] = 0xFF;
+    ASSERT_THROW(DeserializeRayTable(corrupt.data(), corrupt.size(), position), std::invalid_argument);
+    ASSERT_EQ(0u, position);
+    ASSERT_THROW(DeserializeDistance(buffer.data(), buffer.size(), position), std::invalid_argument);
+
+    // No rays at all, which is not a table to fill in later
+    corrupt = buffer;
+    std::fill(corrupt.begin() + 16, corrupt.begin() + 24, 0);
+    ASSERT_THROW(DeserializeRayTable(corrupt.data(), corrupt.size(), position), std::invalid_argument);
+    ASSERT_EQ(0u, position);
+    ASSERT_THROW(RayTable(camera, 16, {}, {}), std::invalid_argument);
+}
+
+}  // namespace found
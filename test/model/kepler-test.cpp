@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "src/model/kepler.hpp"
+#include "src/model/orbit.hpp"
+
+#include "test/common/constants/orbit-constants.hpp"
+
+namespace found {
+
+/**
+ * Checks that a position lies on the test orbit
+ *
+ * @param position The position
+ */
+static void ExpectOnTestOrbit(const PreciseVec3 &position) {
+    // r + e (P . r) = p on the ellipse, and r is in the plane
+    EXPECT_NEAR(kOrbitSemiLatusRectum, position.Magnitude() + kOrbitEccentricity * (orbitPeriapsis * position),
+                1e-6);
+    EXPECT_NEAR(0, orbitPeriapsis.CrossProduct(orbitAscending) * position, 1e-6);
+}
+
+/**
+ * Checks that two positions are equal
+ *
+ * @param expected,actual The positions
+ * @param tolerance The largest difference in each coordinate, in km
+ */
+static void ExpectPosition(const PreciseVec3 &expected, const PreciseVec3 &actual, preciseDecimal tolerance) {
+    EXPECT_NEAR(expected.x, actual.x, tolerance);
+    EXPECT_NEAR(expected.y, actual.y, tolerance);
+    EXPECT_NEAR(expected.z, actual.z, tolerance);
+}
+
+/**
+ * Tests solving Kepler's equation
+ */
+TEST(KeplerTest, TestSolveKepler) {
+    for (preciseDecimal e : {0.0, 0.12, 0.5, 0.95}) {
+        for (preciseDecimal m = 0; m < 2 * M_PI; m += 0.3) {
+            preciseDecimal anomaly = SolveKepler(m, e, e < 0.8 ? m : M_PI);
+            ASSERT_NEAR(m, anomaly - e * sin(anomaly), 1e-12);
+        }
+    }
+}
+
+/**
+ * Tests positions at periapsis, apoapsis and in between
+ */
+TEST(KeplerTest, TestPosition) {
+    KeplerOrbit orbit(MakeTestOrbit());
+    preciseDecimal a = kOrbitSemiLatusRectum / (1 - kOrbitEccentricity * kOrbitEccentricity);
+    ASSERT_NEAR(2 * M_PI * sqrt(a * a * a / kEarthGravitationalParameter), orbit.Period(), 1e-6);
+    ASSERT_NEAR(2 * M_PI / orbit.Period(), orbit.MeanMotion(), 1e-15);
+
+    ExpectPosition(orbitPeriapsis * (a * (1 - kOrbitEccentricity)), orbit.Position(0), 1e-6);
+    ExpectPosition(orbitPeriapsis * (-a * (1 + kOrbitEccentricity)), orbit.Position(orbit.Period() / 2), 1e-6);
+    // The satellite moves towards orbitAscending after periapsis
+    ASSERT_GT(orbit.Position(1) * orbitAscending, 0);
+    for (preciseDecimal t = 0; t < orbit.Period(); t += 317) ExpectOnTestOrbit(orbit.Position(t));
+
+    // The orbit repeats, including before t = 0
+    ExpectPosition(orbit.Position(1234), orbit.Position(1234 + 3 * orbit.Period()), 1e-6);
+    ExpectPosition(orbit.Position(-1234), orbit.Position(orbit.Period() - 1234), 1e-6);
+
+    // A mean anomaly at t = 0 shifts the orbit in time
+    KeplerOrbit shifted(MakeTestOrbit(M_PI));
+    ExpectPosition(orbit.Position(orbit.Period() / 2), shifted.Position(0), 1e-6);
+}
+
+/**
+ * Tests evaluating many positions at once, with and without a table
+ */
+TEST(KeplerTest, TestEvaluateMany) {
+    KeplerOrbit orbit(MakeTestOrbit(0.5));
+    std::vector<preciseDecimal> times;
+    for (int i = -50; i < 150; i++) times.push_back(97.5 * i);
+    std::vector<PreciseVec3> positions(times.size());
+
+    orbit.EvaluateMany(times.data(), times.size(), positions.data());
+    for (size_t i = 0; i < times.size(); i++) ExpectPosition(orbit.Position(times[i]), positions[i], 1e-9);
+
+    KeplerOrbit tabulated(MakeTestOrbit(0.5));
+    ASSERT_FALSE(tabulated.Tabulated());
+    tabulated.Tabulate(1024);
+    ASSERT_TRUE(tabulated.Tabulated());
+    std::vector<PreciseVec3> interpolated(times.size());
+    tabulated.EvaluateMany(times.data(), times.size(), interpolated.data());
+    for (size_t i = 0; i < times.size(); i++) {
+        ExpectPosition(positions[i], interpolated[i], 1e-6);
+        ExpectPosition(tabulated.Position(times[i]), interpolated[i], 1e-9);
+    }
+}
+
+/**
+ * Tests evaluating an orbit that was fit to positions
+ */
+TEST(KeplerTest, TestFitOrbit) {
+    EllipticalOrbitDerminationAlgorithm algorithm;
+    KeplerOrbit orbit(algorithm.Run(MakeOrbitPositions(40)));
+
+    ExpectPosition(orbitPeriapsis * (kOrbitSemiLatusRectum / (1 + kOrbitEccentricity)), orbit.Position(0), 1e-2);
+    ExpectPosition(orbit.Position(0), orbit.Position(orbit.Period()), 1e-6);
+}
+
+/**
+ * Tests orbits that are not ellipses
+ */
+TEST(KeplerTest, TestInvalid) {
+    OrbitParams orbit = MakeTestOrbit();
+    ASSERT_THROW(KeplerOrbit(orbit, 0), std::invalid_argument);
+    ASSERT_THROW(KeplerOrbit(orbit).Tabulate(1), std::invalid_argument);
+    orbit.eccentricity = 1;
+    ASSERT_THROW(KeplerOrbit{orbit}, std::invalid_argument);
+    orbit.eccentricity = -0.1;
+    ASSERT_THROW(KeplerOrbit{orbit}, std::invalid_argument);
+    orbit = MakeTestOrbit();
+    orbit.semiMajorAxis = 0;
+    ASSERT_THROW(KeplerOrbit{orbit}, std::invalid_argument);
+    orbit = MakeTestOrbit();
+    orbit.normal = orbit.periapsis;
+    ASSERT_THROW(KeplerOrbit{orbit}, std::invalid_argument);
+}
+
+}  // namespace found
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include <stdexcept>
+
+#include "src/model/kinematic.hpp"
+
+#include "test/common/constants/orbit-constants.hpp"
+
+namespace found {
+
+/**
+ * Checks that two vectors are equal
+ *
+ * @param expected,actual The vectors
+ * @param tolerance The largest difference in each coordinate
+ */
+static void ExpectVector(const PreciseVec3 &expected, const PreciseVec3 &actual, preciseDecimal tolerance) {
+    EXPECT_NEAR(expected.x, actual.x, tolerance);
+    EXPECT_NEAR(expected.y, actual.y, tolerance);
+    EXPECT_NEAR(expected.z, actual.z, tolerance);
+}
+
+/**
+ * Checks that an ephemeris follows an orbit
+ *
+ * @param orbit The orbit
+ * @param start,step The times of the ephemeris, in s
+ * @param ephemeris The ephemeris
+ */
+static void ExpectEphemeris(const KeplerOrbit &orbit, preciseDecimal start, preciseDecimal step,
+                            const Ephemeris &ephemeris) {
+    for (size_t i = 0; i < ephemeris.size(); i += 97) {
+        ExpectVector(orbit.Position(start + i * step), ephemeris.Position(i), 1e-6);
+        ExpectVector(orbit.Velocity(start + i * step), ephemeris.Velocity(i), 1e-9);
+    }
+}
+
+/**
+ * Tests the velocity against the vis-viva equation and the change in position
+ */
+TEST(KinematicTest, TestVelocity) {
+    KeplerOrbit orbit(MakeTestOrbit());
+    preciseDecimal a = MakeTestOrbit().semiMajorAxis;
+    for (preciseDecimal t = 0; t < orbit.Period(); t += 431) {
+        PreciseVec3 position = orbit.Position(t), velocity = orbit.Velocity(t);
+        EXPECT_NEAR(kEarthGravitationalParameter * (2 / position.Magnitude() - 1 / a), velocity.MagnitudeSq(),
+                    1e-9);
+        ExpectVector((orbit.Position(t + 1e-3) - orbit.Position(t - 1e-3)) * (1 / 2e-3), velocity, 1e-6);
+    }
+}
+
+/**
+ * Tests generating a dense ephemeris, on one and several threads
+ */
+TEST(KinematicTest, TestGenerate) {
+    OrbitParams params = MakeTestOrbit(1);
+    KeplerOrbit orbit(params);
+    Ephemeris single(20000);
+    Ephemeris parallel(20000);
+
+    KeplerKinematicProfilingAlgorithm(1).Generate(params, -500, 1, single);
+    KeplerKinematicProfilingAlgorithm(4).Generate(params, -500, 1, parallel);
+    KeplerKinematicProfilingAlgorithm(0).Generate(params, -500, 1, parallel);
+
+    ExpectEphemeris(orbit, -500, 1, single);
+    for (size_t i = 0; i < single.size(); i++) {
+        ASSERT_NEAR(single.x()[i], parallel.x()[i], 1e-9);
+        ASSERT_NEAR(single.vz()[i], parallel.vz()[i], 1e-12);
+    }
+
+    // Steps that span much of the orbit, on an eccentric one
+    params.eccentricity = 0.9;
+    KeplerOrbit eccentric(params);
+    Ephemeris sparse(50);
+    KeplerKinematicProfilingAlgorithm().Generate(params, 0, eccentric.Period() / 7.3, sparse);
+    ExpectEphemeris(eccentric, 0, eccentric.Period() / 7.3, sparse);
+}
+
+/**
+ * Tests the kinematic profile of Run
+ */
+TEST(KinematicTest, TestRun) {
+    KeplerKinematicProfilingAlgorithm algorithm;
+    KinematicPrediction prediction = algorithm.Run(MakeTestOrbit());
+    KeplerOrbit orbit(MakeTestOrbit());
+
+    ExpectVector(orbit.Position(600), PrecisionCast<preciseDecimal>(prediction.first(600)), 1e-2);
+    ExpectVector(orbit.Velocity(600), PrecisionCast<preciseDecimal>(prediction.second(600)), 1e-5);
+}
+
+/**
+ * Tests ephemerides that cannot be made
+ */
+TEST(KinematicTest, TestInvalid) {
+    KeplerOrbit orbit(MakeTestOrbit());
+    Ephemeris ephemeris(10);
+    ASSERT_THROW(orbit.EvaluateRange(0, 1, 5, 6, ephemeris), std::invalid_argument);
+    ASSERT_THROW(orbit.EvaluateRange(0, 1, 11, 0, ephemeris), std::invalid_argument);
+    orbit.EvaluateRange(0, 1, 10, 0, ephemeris);
+
+    OrbitParams hyperbola = MakeTestOrbit();
+    hyperbola.eccentricity = 1.5;
+    ASSERT_THROW(KeplerKinematicProfilingAlgorithm().Generate(hyperbola, 0, 1, ephemeris), std::invalid_argument);
+    ASSERT_THROW(KeplerKinematicProfilingAlgorithm().Run(hyperbola), std::invalid_argument);
+}
+
+}  // namespace found
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "src/model/orbit.hpp"
+
+#include "test/common/constants/orbit-constants.hpp"
+
+namespace found {
+
+/**
+ * Checks that an orbit fit found the test orbit
+ *
+ * @param algorithm The algorithm that fit the orbit
+ * @param orbit The orbit it found
+ */
+static void ExpectTestOrbit(const EllipticalOrbitDerminationAlgorithm &algorithm, const OrbitParams &orbit) {
+    PreciseVec3 normal = orbitPeriapsis.CrossProduct(orbitAscending);
+    EXPECT_NEAR(1, algorithm.Normal() * normal, 1e-9);
+    EXPECT_NEAR(kOrbitSemiLatusRectum, algorithm.SemiLatusRectum(), 1e-2);
+    PreciseVec3 eccentricity = algorithm.Eccentricity();
+    EXPECT_NEAR(kOrbitEccentricity * orbitPeriapsis.x, eccentricity.x, 1e-6);
+    EXPECT_NEAR(kOrbitEccentricity * orbitPeriapsis.y, eccentricity.y, 1e-6);
+    EXPECT_NEAR(kOrbitEccentricity * orbitPeriapsis.z, eccentricity.z, 1e-6);
+    EXPECT_NEAR(kOrbitSemiLatusRectum / (1 - kOrbitEccentricity * kOrbitEccentricity),
+                algorithm.SemiMajorAxis(), 1e-1);
+
+    PreciseVec3 periapsis = orbitPeriapsis * (kOrbitSemiLatusRectum / (1 + kOrbitEccentricity));
+    EXPECT_NEAR(periapsis.x, orbit.initialCondition.x, 1e-2);
+    EXPECT_NEAR(periapsis.y, orbit.initialCondition.y, 1e-2);
+    EXPECT_NEAR(periapsis.z, orbit.initialCondition.z, 1e-2);
+    EXPECT_NEAR(algorithm.SemiMajorAxis(), orbit.semiMajorAxis, 1e-9);
+    EXPECT_NEAR(kOrbitEccentricity, orbit.eccentricity, 1e-6);
+    EXPECT_NEAR(1, orbit.periapsis * orbitPeriapsis, 1e-9);
+    EXPECT_NEAR(1, orbit.normal * normal, 1e-9);
+    EXPECT_EQ(0, orbit.meanAnomaly);
+}
+
+/**
+ * Tests fitting an orbit to a whole position history
+ */
+TEST(OrbitTest, TestEllipticalOrbit) {
+    EllipticalOrbitDerminationAlgorithm algorithm;
+
+    OrbitParams orbit = algorithm.Run(MakeOrbitPositions(40));
+
+    ASSERT_EQ(40u, algorithm.Size());
+    ExpectTestOrbit(algorithm, orbit);
+}
+
+/**
+ * Tests that adding positions one at a time finds the same orbit, and that a
+ * window only keeps the latest positions
+ */
+TEST(OrbitTest, TestEllipticalOrbitWindow) {
+    const size_t window = 25;
+    EllipticalOrbitDerminationAlgorithm algorithm(window);
+    // Starts on another orbit, which leaves the window as the test orbit comes in
+    algorithm.Run(MakeOrbitPositions(9000, 0.3, orbitAscending, orbitPeriapsis * -1, 30, 0, 0.1));
+    ASSERT_NEAR(9000, algorithm.SemiLatusRectum(), 1e-2);
+
+    OrbitParams orbit;
+    // Several orbits, so that the sums are rebuilt many times
+    for (const Vec3 &position : MakeOrbitPositions(2000, 1, 0.05)) {
+        orbit = algorithm.Update(position);
+    }
+
+    ASSERT_EQ(window, algorithm.Size());
+    ExpectTestOrbit(algorithm, orbit);
+
+    EllipticalOrbitDerminationAlgorithm batch(window);
+    ExpectTestOrbit(batch, batch.Run(MakeOrbitPositions(2000, 1, 0.05)));
+    ASSERT_EQ(window, batch.Size());
+}
+
+/**
+ * Tests positions that do not determine an elliptical orbit
+ */
+TEST(OrbitTest, TestEllipticalOrbitInvalid) {
+    EllipticalOrbitDerminationAlgorithm algorithm;
+    std::vector<Vec3> positions = MakeOrbitPositions(2);
+    ASSERT_THROW(algorithm.Run(positions), std::invalid_argument);
+    // The positions are kept, so a third one is enough
+    algorithm.Update(MakeOrbitPositions(3)[2]);
+    ASSERT_EQ(3u, algorithm.Size());
+
+    // Along one line
+    std::vector<Vec3> line = {Vec3(7000, 0, 0), Vec3(8000, 0, 0), Vec3(9000, 0, 0)};
+    ASSERT_THROW(algorithm.Run(line), std::invalid_argument);
+
+    // A hyperbola
+    std::vector<Vec3> hyperbola = MakeOrbitPositions(7000, 1.5, orbitPeriapsis, orbitAscending, 20, -0.5, 0.05);
+    ASSERT_THROW(algorithm.Run(hyperbola), std::invalid_argument);
+
+    // In one plane, but all at one anomaly, which fits no conic
+    std::vector<Vec3> repeated = {Vec3(7000, 0, 0), Vec3(0, 7000, 0), Vec3(7000, 0, 0), Vec3(0, 7000, 0)};
+    ASSERT_THROW(algorithm.Run(repeated), std::invalid_argument);
+
+    algorithm.Reset();
+    ASSERT_EQ(0u, algorithm.Size());
+}
+
+}  // namespace found
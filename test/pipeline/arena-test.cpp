@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+#include "src/common/arena.hpp"
+#include "src/distance/distance.hpp"
+#include "src/distance/edge.hpp"
+#include "src/pipeline/pipeline.hpp"
+
+#include "test/common/constants/distance-constants.hpp"
+#include "test/common/constants/edge-constants.hpp"
+
+namespace found {
+
+/**
+ * A Stage that takes scratch memory from its arena, and remembers it
+ */
+class ScratchStage : public Stage<int, int> {
+ public:
+    int Run(const int &input) override {
+        last = &this->Scratch();
+        int *values = this->Scratch().Allocate<int>(input);
+        for (int i = 0; i < input; i++) values[i] = i;
+        used = this->Scratch().Used();
+        return values[input - 1] + 1;
+    }
+
+    /// The arena of the last run
+    Arena *last = nullptr;
+    /// The bytes in use in the arena at the end of the last run
+    size_t used = 0;
+};
+
+/**
+ * Tests allocating from an arena, and resetting it
+ */
+TEST(ArenaTest, TestAllocate) {
+    Arena arena(256);
+    ASSERT_EQ(256u, arena.Capacity());
+    ASSERT_EQ(1u, arena.HeapAllocations());
+
+    char *first = static_cast<char *>(arena.Allocate(3, 1));
+    char *second = static_cast<char *>(arena.Allocate(5, 1));
+    ASSERT_EQ(first + 3, second);
+    double *aligned = arena.Allocate<double>(4);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % kVectorAlignment);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(arena.Allocate(8, 128)) % 128);
+    ASSERT_LE(8u + 4 * sizeof(double), arena.Used());
+
+    arena.Reset();
+    ASSERT_EQ(0u, arena.Used());
+    // The same memory is handed out again, without calling the heap
+    ASSERT_EQ(first, arena.Allocate(3, 1));
+    ASSERT_EQ(1u, arena.HeapAllocations());
+}
+
+/**
+ * Tests that an arena grows once a frame outgrows it, and then stops calling the heap
+ */
+TEST(ArenaTest, TestGrowth) {
+    Arena arena;
+    ASSERT_EQ(0u, arena.Capacity());
+    for (int frame = 0; frame < 5; frame++) {
+        for (int i = 0; i < 10; i++) arena.Allocate<decimal>(100);
+        arena.Reset();
+    }
+    ASSERT_LE(10 * 100 * sizeof(decimal), arena.Capacity());
+    ASSERT_GE(arena.Capacity(), arena.HighWater());
+    // 10 overflows, then one block
+    ASSERT_EQ(11u, arena.HeapAllocations());
+
+    // Copies do not share memory
+    Arena copy(arena);
+    ASSERT_EQ(arena.Capacity(), copy.Capacity());
+    ASSERT_EQ(0u, copy.Used());
+    copy = arena;
+    ASSERT_EQ(0u, copy.Used());
+}
+
+/**
+ * Tests freeing what was allocated within a scope
+ */
+TEST(ArenaTest, TestScope) {
+    Arena arena(64);
+    arena.Allocate(16, 1);
+    {
+        ArenaScope scope(arena);
+        arena.Allocate(32, 1);
+        // Overflows, and is freed with the scope
+        arena.Allocate(1000, 1);
+        ASSERT_LT(1000u, arena.Used());
+    }
+    ASSERT_EQ(16u, arena.Used());
+    // The block only grows once the arena is empty
+    ASSERT_EQ(64u, arena.Capacity());
+    arena.Reset();
+    ASSERT_LE(1048u, arena.Capacity());
+}
+
+/**
+ * Tests containers whose storage comes from an arena
+ */
+TEST(ArenaTest, TestAllocator) {
+    Arena arena(1024);
+    ArenaAllocator<double> doubles(&arena);
+    ArenaAllocator<int> integers(doubles);
+    ASSERT_TRUE(doubles == integers);
+    ASSERT_TRUE(doubles != ArenaAllocator<int>());
+
+    std::vector<int, ArenaAllocator<int>> values(integers);
+    values.reserve(100);
+    for (int i = 0; i < 100; i++) values.push_back(i);
+    ASSERT_EQ(99, values.back());
+    ASSERT_EQ(1u, arena.HeapAllocations());
+    ASSERT_LE(100 * sizeof(int), arena.Used());
+}
+
+/**
+ * Tests that every stage of a pipeline (nested or not) takes scratch memory from the
+ * arena of the outermost pipeline, which is emptied after every run
+ */
+TEST(ArenaTest, TestPipelineArena) {
+    ScratchStage first, second, innerStage;
+    std::vector<std::reference_wrapper<Action>> innerStages;
+    Pipeline<int, int> inner(innerStages);
+    inner.Complete(innerStage);
+    std::vector<std::reference_wrapper<Action>> stages;
+    Pipeline<int, int> pipeline(stages);
+    pipeline.AddStage(first).AddStage(inner).Complete(second);
+
+    ASSERT_EQ(10, pipeline.Run(10));
+    ASSERT_EQ(first.last, second.last);
+    ASSERT_EQ(first.last, innerStage.last);
+    // The arena is shared, and emptied at the end of the run
+    ASSERT_LT(first.used, second.used);
+    ASSERT_EQ(0u, pipeline.GetArena().Used());
+    ASSERT_EQ(&pipeline.GetArena(), first.last);
+
+    // A stage run on its own uses its own arena
+    ScratchStage alone;
+    alone.Run(3);
+    ASSERT_NE(first.last, alone.last);
+}
+
+/**
+ * Tests that a pipeline stops calling the heap for scratch memory after its first frame
+ */
+TEST(ArenaTest, TestSteadyState) {
+    SimpleEdgeDetectionAlgorithm edges(128);
+    SphericalDistanceDeterminationAlgorithm distance(kEarthRadius, distanceCamera, RobustFitOptions());
+    std::vector<std::reference_wrapper<Action>> stages;
+    Pipeline<Image, distFromEarth> pipeline(stages);
+    pipeline.AddStage(edges).Complete(distance);
+
+    std::vector<unsigned char> pixels(256 * 256, 0);
+    for (int y = 0; y < 256; y++) {
+        for (int x = 0; x < 256; x++) {
+            if ((x - 128) * (x - 128) + (y - 128) * (y - 128) < 80 * 80) pixels[y * 256 + x] = 255;
+        }
+    }
+    Image image = {pixels.data(), {256, 256, 1}, 0, nullptr};
+
+    distFromEarth expected = pipeline.Run(image);
+    uint64_t heapAllocations = pipeline.GetArena().HeapAllocations();
+    ASSERT_LT(0u, pipeline.GetArena().HighWater());
+    for (int frame = 0; frame < 5; frame++) {
+        ASSERT_EQ(expected, pipeline.Run(image));
+    }
+    ASSERT_EQ(heapAllocations, pipeline.GetArena().HeapAllocations());
+    ASSERT_EQ(0u, pipeline.GetArena().Used());
+}
+
+}  // namespace found
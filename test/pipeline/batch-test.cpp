@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "src/pipeline/batch.hpp"
+
+namespace found {
+
+/**
+ * Tests that every frame is processed once, and that results come out in order
+ * even though frames take different amounts of time
+ */
+TEST(BatchTest, TestRunBatchInOrder) {
+    const size_t count = 40;
+    std::atomic<int> processors(0);
+    std::vector<std::atomic<int>> runs(count);
+    for (std::atomic<int> &run : runs) run = 0;
+
+    std::function<std::function<size_t(size_t)>()> makeProcessor = [&]() {
+        processors++;
+        return std::function<size_t(size_t)>([&](size_t index) {
+            runs[index]++;
+            // Makes the first share of the frames slow, so that they get stolen
+            if (index < count / 4) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            return index * index;
+        });
+    };
+    std::vector<size_t> emitted;
+    std::function<void(size_t, size_t &)> emit = [&](size_t index, size_t &result) {
+        ASSERT_EQ(emitted.size(), index);
+        emitted.push_back(result);
+    };
+
+    RunBatch<size_t>(count, 4, makeProcessor, emit);
+
+    ASSERT_EQ(4, processors);
+    ASSERT_EQ(count, emitted.size());
+    for (size_t i = 0; i < count; i++) {
+        ASSERT_EQ(1, runs[i]);
+        ASSERT_EQ(i * i, emitted[i]);
+    }
+}
+
+/**
+ * Tests batches with fewer frames than threads
+ */
+TEST(BatchTest, TestRunBatchSmall) {
+    std::atomic<int> processors(0);
+    std::function<std::function<int(size_t)>()> makeProcessor = [&]() {
+        processors++;
+        return std::function<int(size_t)>([](size_t index) { return static_cast<int>(index) + 1; });
+    };
+    int sum = 0;
+    std::function<void(size_t, int &)> emit = [&](size_t, int &result) { sum += result; };
+
+    RunBatch<int>(0, 8, makeProcessor, emit);
+    ASSERT_EQ(0, sum);
+    ASSERT_EQ(1, processors);
+
+    RunBatch<int>(2, 8, makeProcessor, emit);
+    ASSERT_EQ(3, sum);
+    ASSERT_EQ(3, processors);
+}
+
+/**
+ * Tests that failures of processors and of emit reach the caller
+ */
+TEST(BatchTest, TestRunBatchFailure) {
+    std::function<std::function<int(size_t)>()> makeProcessor = []() {
+        return std::function<int(size_t)>([](size_t index) {
+            if (index == 7) throw std::runtime_error("Bad frame");
+            return static_cast<int>(index);
+        });
+    };
+    std::function<void(size_t, int &)> ignore = [](size_t, int &) {};
+    ASSERT_THROW(RunBatch<int>(20, 3, makeProcessor, ignore), std::runtime_error);
+
+    std::function<void(size_t, int &)> fail = [](size_t index, int &) {
+        if (index == 2) throw std::invalid_argument("Bad output");
+    };
+    std::function<std::function<int(size_t)>()> makeIdentity = []() {
+        return std::function<int(size_t)>([](size_t index) { return static_cast<int>(index); });
+    };
+    ASSERT_THROW(RunBatch<int>(20, 3, makeIdentity, fail), std::invalid_argument);
+
+    std::function<std::function<int(size_t)>()> makeNothing = []() -> std::function<int(size_t)> {
+        throw std::runtime_error("No processor");
+    };
+    ASSERT_THROW(RunBatch<int>(20, 3, makeNothing, ignore), std::runtime_error);
+}
+
+}  // namespace found
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/pipeline/instrumentation.hpp"
+#include "src/pipeline/pipeline.hpp"
+
+namespace found {
+
+/**
+ * Makes the buckets of a histogram
+ *
+ * @param smallest,growth,buckets The fields of the HistogramOptions
+ *
+ * @return The HistogramOptions
+ */
+static HistogramOptions MakeHistogramOptions(double smallest, double growth, size_t buckets) {
+    HistogramOptions options;
+    options.smallest = smallest;
+    options.growth = growth;
+    options.buckets = buckets;
+    return options;
+}
+
+/**
+ * A Stage that makes a vector of as many items as its input
+ */
+class RepeatStage : public Stage<int, std::vector<int>> {
+ public:
+    std::vector<int> Run(const int &input) override {
+        return std::vector<int>(input, input);
+    }
+};
+
+/**
+ * A Stage that sums a vector, and counts its odd items
+ */
+class SumStage : public Stage<std::vector<int>, int> {
+ public:
+    int Run(const std::vector<int> &input) override {
+        this->odd = 0;
+        int sum = 0;
+        for (int item : input) {
+            sum += item;
+            if (item % 2 != 0) this->odd++;
+        }
+        return sum;
+    }
+
+    void Count(CounterSet &counters) const override {
+        counters.Record("odd", this->odd);
+    }
+
+    /// The number of odd items of the last input
+    int odd = 0;
+};
+
+/**
+ * Tests the summary statistics and quantiles of a Histogram
+ */
+TEST(InstrumentationTest, TestHistogram) {
+    HistogramOptions options = MakeHistogramOptions(1, 1.01, 2000);
+    Histogram histogram(options);
+    ASSERT_EQ(0, histogram.Quantile(0.5));
+    ASSERT_EQ(0, histogram.Min());
+
+    for (int i = 1; i <= 1000; i++) histogram.Record(i);
+    histogram.Record(0.5);
+    ASSERT_EQ(1001u, histogram.Count());
+    ASSERT_EQ(0.5, histogram.Min());
+    ASSERT_EQ(1000, histogram.Max());
+    ASSERT_NEAR(500500.5 / 1001, histogram.Mean(), 1e-9);
+    // Within one bucket (1%) of the exact quantiles
+    ASSERT_NEAR(500, histogram.Quantile(0.5), 5);
+    ASSERT_NEAR(990, histogram.Quantile(0.99), 10);
+    ASSERT_EQ(1000, histogram.Quantile(1));
+    ASSERT_EQ(0.5, histogram.Quantile(0));
+
+    // Values past the last bucket land in it
+    Histogram small(MakeHistogramOptions(1, 2, 4));
+    small.Record(1e6);
+    ASSERT_EQ(1e6, small.Quantile(0.5));
+
+    Histogram other(options);
+    other.Record(5000);
+    histogram.Merge(other);
+    ASSERT_EQ(1002u, histogram.Count());
+    ASSERT_EQ(5000, histogram.Max());
+    ASSERT_THROW(histogram.Merge(small), std::invalid_argument);
+    Histogram empty(options);
+    empty.Merge(other);
+    ASSERT_EQ(5000, empty.Min());
+    histogram.Reset();
+    ASSERT_EQ(0u, histogram.Count());
+
+    ASSERT_THROW(Histogram(MakeHistogramOptions(0, 2, 4)), std::invalid_argument);
+    ASSERT_THROW(Histogram(MakeHistogramOptions(1, 1, 4)), std::invalid_argument);
+    ASSERT_THROW(Histogram(MakeHistogramOptions(1, 2, 0)), std::invalid_argument);
+}
+
+/**
+ * Tests recording and merging counters
+ */
+TEST(InstrumentationTest, TestCounters) {
+    CounterSet counters;
+    counters.Record("points", 10);
+    counters.Record("iterations", 3);
+    counters.Record("points", 20);
+    ASSERT_EQ(2u, counters.All().size());
+    ASSERT_EQ(30u, counters.Find("points")->total);
+    ASSERT_EQ(20u, counters.Find("points")->last);
+    ASSERT_EQ(nullptr, counters.Find("missing"));
+
+    CounterSet other;
+    other.Record("points", 5);
+    other.Record("rejected", 1);
+    counters.Merge(other);
+    ASSERT_EQ(35u, counters.Find("points")->total);
+    ASSERT_EQ(1u, counters.Find("rejected")->total);
+    counters.Reset();
+    ASSERT_TRUE(counters.All().empty());
+}
+
+/**
+ * Tests merging profiles and writing them as JSON
+ */
+TEST(InstrumentationTest, TestProfile) {
+    PipelineProfile profile;
+    profile.AddStage("repeat \"edge\"");
+    profile.AddStage("sum");
+    profile.RecordStage(0, std::chrono::microseconds(3));
+    profile.RecordStage(1, std::chrono::microseconds(1));
+    profile.RecordFrame(std::chrono::microseconds(4));
+    profile.Counters(1).Record("odd", 7);
+
+    PipelineProfile other = profile;
+    profile.Merge(other);
+    ASSERT_EQ(2u, profile.Frames().Count());
+    ASSERT_EQ(14u, profile.FindStage("sum")->counters.Find("odd")->total);
+    ASSERT_EQ(3000, profile.Stages()[0].time.Max());
+    ASSERT_EQ(nullptr, profile.FindStage("missing"));
+
+    std::ostringstream json;
+    profile.WriteJson(json);
+    ASSERT_NE(std::string::npos, json.str().find("\"name\": \"repeat \\\"edge\\\"\""));
+    ASSERT_NE(std::string::npos, json.str().find("\"counters\": {\"odd\": 14}"));
+    ASSERT_NE(std::string::npos, json.str().find("\"frames\": {\"count\": 2, \"mean_ns\": 4000"));
+
+    PipelineProfile different;
+    different.AddStage("sum");
+    ASSERT_THROW(profile.Merge(different), std::invalid_argument);
+    different.AddStage("repeat");
+    ASSERT_THROW(profile.Merge(different), std::invalid_argument);
+
+    profile.Reset();
+    ASSERT_EQ(0u, profile.Frames().Count());
+    ASSERT_EQ(2u, profile.Stages().size());
+    profile.Configure(MakeHistogramOptions(1, 2, 8));
+    ASSERT_EQ(8u, profile.Frames().Options().buckets);
+    ASSERT_EQ(8u, profile.Stages()[1].time.Options().buckets);
+}
+
+/**
+ * Tests that a Pipeline profiles every run, iff instrumentation is compiled in
+ */
+TEST(InstrumentationTest, TestPipelineProfile) {
+    std::vector<std::reference_wrapper<Action>> stages;
+    Pipeline<int, int> pipeline(stages);
+    RepeatStage repeat;
+    SumStage sum;
+    pipeline.AddStage(repeat).Complete(sum, "sum");
+
+    ASSERT_EQ(9, pipeline.Run(3));
+    ASSERT_EQ(16, pipeline.Run(4));
+    const PipelineProfile &profile = pipeline.GetProfile();
+#ifdef FOUND_INSTRUMENTATION
+    ASSERT_TRUE(kInstrumentationEnabled);
+    ASSERT_EQ(2u, profile.Stages().size());
+    ASSERT_EQ("RepeatStage", profile.Stages()[0].name);
+    ASSERT_EQ(2u, profile.Frames().Count());
+    ASSERT_EQ(2u, profile.FindStage("sum")->time.Count());
+    ASSERT_EQ(7u, profile.Stages()[0].counters.Find("items")->total);
+    ASSERT_EQ(3u, profile.FindStage("sum")->counters.Find("odd")->total);
+    ASSERT_EQ(nullptr, profile.FindStage("sum")->counters.Find("items"));
+    ASSERT_GE(profile.Frames().Max(), profile.FindStage("sum")->time.Max());
+
+    pipeline.ResetProfile();
+    ASSERT_EQ(0u, pipeline.GetProfile().Frames().Count());
+    pipeline.SetHistogramOptions(MakeHistogramOptions(1, 2, 8));
+    pipeline.Run(1);
+    ASSERT_EQ(1u, pipeline.GetProfile().Frames().Count());
+    ASSERT_EQ(8u, pipeline.GetProfile().Frames().Options().buckets);
+#else
+    ASSERT_FALSE(kInstrumentationEnabled);
+    ASSERT_TRUE(profile.Stages().empty());
+    ASSERT_EQ(0u, profile.Frames().Count());
+#endif
+}
+
+/**
+ * Tests naming types
+ */
+TEST(InstrumentationTest, TestTypeName) {
+    ASSERT_EQ("SumStage", TypeName(typeid(SumStage).name()));
+    ASSERT_EQ("int", TypeName(typeid(int).name()));
+}
+
+}  // namespace found
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "src/pipeline/parallel.hpp"
+#include "src/distance/distance.hpp"
+
+#include "test/common/constants/distance-constants.hpp"
+
+namespace found {
+
+/**
+ * A Stage that scales its input, and remembers the thread it ran on
+ */
+class ScaleStage : public Stage<int, int> {
+ public:
+    explicit ScaleStage(int factor) : factor(factor) {}
+
+    int Run(const int &input) override {
+        this->thread = std::this_thread::get_id();
+        if (input < 0 && this->factor < 0) throw std::runtime_error("negative");
+        return input * this->factor;
+    }
+
+    /// The factor to scale by
+    int factor;
+    /// The thread of the last run
+    std::thread::id thread;
+};
+
+/**
+ * A Stage that waits until every branch of a run has started it
+ */
+class RendezvousStage : public Stage<int, int> {
+ public:
+    explicit RendezvousStage(std::atomic<int> &arrived) : arrived(arrived) {}
+
+    int Run(const int &expected) override {
+        this->arrived++;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (this->arrived.load() < expected) {
+            if (std::chrono::steady_clock::now() > deadline) return 0;
+            std::this_thread::yield();
+        }
+        return 1;
+    }
+
+    /// The number of branches that have started
+    std::atomic<int> &arrived;
+};
+
+/**
+ * A Stage that sums its inputs
+ */
+class AddStage : public Stage<std::vector<int>, int> {
+ public:
+    int Run(const std::vector<int> &inputs) override {
+        return std::accumulate(inputs.begin(), inputs.end(), 0);
+    }
+};
+
+/**
+ * A Stage that keeps its inputs
+ */
+class CollectStage : public Stage<std::vector<int>, std::vector<int>> {
+ public:
+    std::vector<int> Run(const std::vector<int> &inputs) override { return inputs; }
+};
+
+/**
+ * Tests that branches hand their outputs over in order
+ */
+TEST(ParallelStageTest, TestParallelStageOrder) {
+    CollectStage collect;
+    ScaleStage first(1), second(2), third(3);
+    ParallelStage<int, int, std::vector<int>> parallel(collect);
+    parallel.AddBranch(first).AddBranch(second).AddBranch(third);
+    ASSERT_EQ(3u, parallel.Branches());
+
+    for (int input = 1; input <= 20; input++) {
+        ASSERT_EQ((std::vector<int>{input, 2 * input, 3 * input}), parallel.Run(input));
+    }
+    // The first branch runs on the calling thread
+    ASSERT_EQ(std::this_thread::get_id(), first.thread);
+
+    std::vector<int> output;
+    parallel.RunInto(5, output);
+    ASSERT_EQ((std::vector<int>{5, 10, 15}), output);
+    ScaleStage fourth(4);
+    parallel.AddBranch(fourth);
+    ASSERT_EQ((std::vector<int>{1, 2, 3, 4}), parallel.Run(1));
+}
+
+/**
+ * Tests that every branch of a run is running at once
+ */
+TEST(ParallelStageTest, TestParallelStageConcurrent) {
+    std::atomic<int> arrived(0);
+    RendezvousStage first(arrived), second(arrived), third(arrived);
+    AddStage add;
+    // The calling thread waits in the first branch, so the others need a worker each
+    TaskScheduler scheduler(2);
+    ParallelStage<int, int, int> parallel(add, scheduler);
+    parallel.AddBranch(first).AddBranch(second).AddBranch(third);
+
+    ASSERT_EQ(3, parallel.Run(3));
+    ASSERT_EQ(3, parallel.Run(6));
+}
+
+/**
+ * Tests that a branch that throws fails the run, but not the next one
+ */
+TEST(ParallelStageTest, TestParallelStageThrows) {
+    AddStage add;
+    ParallelStage<int, int, int> empty(add);
+    ASSERT_THROW(empty.Run(1), std::invalid_argument);
+
+    ScaleStage first(1), second(-1);
+    ParallelStage<int, int, int> parallel(add);
+    parallel.AddBranch(first).AddBranch(second);
+    ASSERT_THROW(parallel.Run(-1), std::runtime_error);
+    ASSERT_EQ(0, parallel.Run(2));
+}
+
+/**
+ * Tests running distance algorithms side by side in a Pipeline, and fusing their distances
+ */
+TEST(ParallelStageTest, TestParallelDistances) {
+    Attitude attitude = LookAtEarth(ellipticPosition);
+    SphericalDistanceDeterminationAlgorithm spherical(kEquatorialRadius, distanceCamera);
+    EllipticDistanceDeterminationAlgorithm elliptic(kEquatorialRadius, kPolarRadius, distanceCamera, attitude);
+    DistanceFusionAlgorithm fusion({elliptic, spherical}, FusionMethod::kLowestResidual);
+    ParallelStage<Points, distFromEarth, distFromEarth> parallel(fusion);
+    parallel.AddBranch(elliptic).AddBranch(spherical);
+
+    std::vector<std::reference_wrapper<Action>> stages;
+    Pipeline<Points, distFromEarth> pipeline(stages);
+    pipeline.Complete(parallel);
+
+    Points points = MakeEllipsoidHorizonPoints(ellipticPosition, attitude, 500);
+    for (int frame = 0; frame < 3; frame++) {
+        ASSERT_NEAR(ellipticPosition.Magnitude(), pipeline.Run(points), ellipticPosition.Magnitude() * 1e-4);
+        ASSERT_EQ(0u, fusion.Chosen());
+    }
+    ASSERT_EQ(0u, pipeline.GetArena().Used());
+    // The first branch takes its rays from the arena of the Pipeline
+    ASSERT_LT(0u, pipeline.GetArena().HighWater());
+}
+
+}  // namespace found
@@ -11,6 +11,25 @@
 
 namespace found {
 
+/**
+ * A Stage that refills its output in place, and
+ * remembers where it wrote to
+ */
+class RefillStage : public Stage<int, std::vector<int>> {
+ public:
+    std::vector<int> Run(const int &input) override {
+        return std::vector<int>(input, input);
+    }
+
+    void RunInto(const int &input, std::vector<int> &output) override {
+        output.assign(input, input);
+        lastBuffer = output.data();
+    }
+
+    /// The storage the last output was placed in
+    const int *lastBuffer = nullptr;
+};
+
 class PipelineTest : public testing::Test {
  protected:
     // System dependencies
@@ -264,4 +283,56 @@ TEST_F(PipelineTest, TestPipelineEndPipelineInPipeline) {
     ASSERT_EQ(result, doubles[test_set]);
 }
 
+/**
+ * Tests running a pipeline on an input that is moved in
+ */
+TEST_F(PipelineTest, TestPipelineRunMovedInput) {
+    std::vector<std::reference_wrapper<Action>> stringStages;
+    INIT_PIPELINE(std::string, char, pipeline, stringStages);
+
+    int test_set = 2;
+
+    std::unique_ptr<MockStage<std::string, char>> stage1(new MockStage<std::string, char>());
+    EXPECT_CALL(*stage1, Run(strings[test_set]))
+        .WillOnce(testing::Return(characters[test_set]));
+
+    pipeline.Complete(*stage1);
+    char result = pipeline.Run(std::string(strings[test_set]));
+
+    ASSERT_EQ(characters[test_set], result);
+}
+
+/**
+ * Tests that running a pipeline into the same output
+ * reuses the storage of earlier outputs
+ */
+TEST_F(PipelineTest, TestPipelineRunIntoReusesOutput) {
+    std::vector<std::reference_wrapper<Action>> vectorStages;
+    INIT_PIPELINE(int, std::vector<int>, pipeline, vectorStages);
+
+    RefillStage stage1;
+    pipeline.Complete(stage1);
+
+    std::vector<int> output;
+    pipeline.RunInto(integers[0], output);
+    ASSERT_EQ(std::vector<int>(integers[0], integers[0]), output);
+    const int *firstBuffer = output.data();
+
+    pipeline.RunInto(integers[0], output);
+    pipeline.RunInto(integers[0] - 1, output);
+    ASSERT_EQ(std::vector<int>(integers[0] - 1, integers[0] - 1), output);
+    ASSERT_EQ(firstBuffer, output.data());
+    ASSERT_EQ(firstBuffer, stage1.lastBuffer);
+}
+
+/**
+ * Tests that RunInto fails on an incomplete pipeline
+ */
+TEST_F(PipelineTest, TestPipelineRunIntoOnEmpty) {
+    INIT_INT_TO_CHAR_PIPELINE(pipeline, stages);
+    char result;
+
+    ASSERT_THROW(pipeline.RunInto(integers[0], result), std::runtime_error);
+}
+
 }  // namespace found
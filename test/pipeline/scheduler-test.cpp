@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "src/pipeline/scheduler.hpp"
+
+namespace found {
+
+/**
+ * Tests that every task of a group runs once, spread over the workers
+ */
+TEST(SchedulerTest, TestRunEveryTask) {
+    TaskScheduler scheduler(4);
+    ASSERT_EQ(4u, scheduler.Workers());
+    std::vector<std::atomic<int>> runs(1000);
+    for (std::atomic<int> &run : runs) run = 0;
+    std::set<std::thread::id> threads;
+    std::mutex mutex;
+
+    TaskGroup group(scheduler);
+    for (size_t i = 0; i < runs.size(); i++) {
+        group.Run([&, i]() {
+            runs[i]++;
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        });
+    }
+    group.Wait();
+
+    for (std::atomic<int> &run : runs) ASSERT_EQ(1, run);
+    ASSERT_LE(threads.size(), 5u);
+    // Waiting again, with nothing left to run, returns at once
+    group.Wait();
+}
+
+/**
+ * Tests tasks that wait for tasks of their own, on fewer workers than tasks
+ */
+TEST(SchedulerTest, TestNestedGroups) {
+    TaskScheduler scheduler(2);
+    std::atomic<int> inner(0);
+    TaskGroup outer(scheduler);
+    for (int i = 0; i < 8; i++) {
+        outer.Run([&]() {
+            TaskGroup group(scheduler);
+            for (int j = 0; j < 8; j++) group.Run([&]() { inner++; });
+            group.Wait();
+        });
+    }
+    outer.Wait();
+    ASSERT_EQ(64, inner);
+}
+
+/**
+ * Tests that the failure of a task reaches the thread that waits, once every task is done
+ */
+TEST(SchedulerTest, TestFailure) {
+    TaskScheduler scheduler(3);
+    std::atomic<int> runs(0);
+    TaskGroup group(scheduler);
+    for (int i = 0; i < 20; i++) {
+        group.Run([&, i]() {
+            runs++;
+            if (i % 7 == 3) throw std::runtime_error("Bad task");
+        });
+    }
+    ASSERT_THROW(group.Wait(), std::runtime_error);
+    ASSERT_EQ(20, runs);
+
+    // The group can be used again
+    group.Run([&]() { runs++; });
+    group.Wait();
+    ASSERT_EQ(21, runs);
+}
+
+/**
+ * Tests changing the workers of a scheduler
+ */
+TEST(SchedulerTest, TestConfigure) {
+    TaskScheduler scheduler(1);
+    scheduler.Configure(3, true);
+    ASSERT_EQ(3u, scheduler.Workers());
+#ifdef __linux__
+    ASSERT_TRUE(scheduler.Pinned());
+#endif
+    scheduler.Configure(0, false);
+    ASSERT_EQ(std::max(std::thread::hardware_concurrency(), 1u), scheduler.Workers());
+    ASSERT_FALSE(scheduler.Pinned());
+
+    std::atomic<int> runs(0);
+    TaskGroup group(scheduler);
+    for (int i = 0; i < 10; i++) group.Run([&]() { runs++; });
+    group.Wait();
+    ASSERT_EQ(10, runs);
+    ASSERT_LT(0u, TaskScheduler::Default().Workers());
+}
+
+}  // namespace found
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/pipeline/static.hpp"
+
+#include "test/common/constants/pipeline-constants.hpp"
+#include "test/common/mocks/pipeline-mocks.hpp"
+
+namespace found {
+
+/**
+ * Tests the compile-time compatibility check of stages
+ */
+TEST(StaticPipelineTest, TestCompatibleStages) {
+    ASSERT_TRUE((CompatibleStages<MockStage<int, char>>::value));
+    ASSERT_TRUE((CompatibleStages<MockStage<int, std::string>, MockStage<std::string, char>>::value));
+    ASSERT_FALSE((CompatibleStages<MockStage<int, char>, MockStage<double, int>>::value));
+    ASSERT_FALSE((CompatibleStages<MockStage<char, int>,
+                                   MockStage<int, std::string>,
+                                   MockStage<float, double>>::value));
+}
+
+/**
+ * Tests a static pipeline with 1 stage
+ */
+TEST(StaticPipelineTest, TestStaticPipelineSingleStage) {
+    int test_set = 1;
+
+    MockStage<int, char> stage1;
+    EXPECT_CALL(stage1, Run(integers[test_set]))
+        .WillOnce(testing::Return(characters[test_set]));
+
+    StaticPipeline<MockStage<int, char>> pipeline(stage1);
+
+    ASSERT_EQ(characters[test_set], pipeline.Run(integers[test_set]));
+}
+
+/**
+ * Tests a static pipeline with 3 stages
+ */
+TEST(StaticPipelineTest, TestStaticPipelineThreeStage) {
+    int test_set = 2;
+
+    MockStage<char, int> stage1;
+    EXPECT_CALL(stage1, Run(characters[test_set]))
+        .WillOnce(testing::Return(integers[test_set]));
+    MockStage<int, std::string> stage2;
+    EXPECT_CALL(stage2, Run(integers[test_set]))
+        .WillOnce(testing::Return(strings[test_set]));
+    MockStage<std::string, double> stage3;
+    EXPECT_CALL(stage3, Run(strings[test_set]))
+        .WillOnce(testing::Return(doubles[test_set]));
+
+    auto pipeline = MakeStaticPipeline(stage1, stage2, stage3);
+
+    ASSERT_EQ(doubles[test_set], pipeline.Run(characters[test_set]));
+}
+
+/**
+ * Tests putting a static pipeline inside of a Pipeline
+ */
+TEST(StaticPipelineTest, TestStaticPipelineInPipeline) {
+    int test_set = 0;
+
+    MockStage<char, int> innerStage1;
+    EXPECT_CALL(innerStage1, Run(characters[test_set]))
+        .WillOnce(testing::Return(integers[test_set]));
+    MockStage<int, float> innerStage2;
+    EXPECT_CALL(innerStage2, Run(integers[test_set]))
+        .WillOnce(testing::Return(floats[test_set]));
+    StaticPipeline<MockStage<char, int>, MockStage<int, float>> innerPipeline(innerStage1, innerStage2);
+
+    MockStage<float, double> outerStage1;
+    EXPECT_CALL(outerStage1, Run(floats[test_set]))
+        .WillOnce(testing::Return(doubles[test_set]));
+
+    std::vector<std::reference_wrapper<Action>> stages;
+    INIT_CHAR_TO_DOUBLE_PIPELINE(outerPipeline, stages);
+    outerPipeline.AddStage(innerPipeline)
+                 .Complete(outerStage1);
+
+    ASSERT_EQ(doubles[test_set], outerPipeline.Run(characters[test_set]));
+}
+
+}  // namespace found
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <stdexcept>
+
+#include "src/pipeline/streaming.hpp"
+
+#include "test/common/constants/pipeline-constants.hpp"
+#include "test/common/mocks/pipeline-mocks.hpp"
+
+namespace found {
+
+/**
+ * Tests that a BoundedBuffer hands items out in order
+ */
+TEST(BoundedBufferTest, TestBoundedBufferOrder) {
+    BoundedBuffer<int> buffer(2);
+    int item;
+
+    ASSERT_FALSE(buffer.TryPop(item));
+    ASSERT_TRUE(buffer.Push(5));
+    ASSERT_TRUE(buffer.Push(6));
+    ASSERT_TRUE(buffer.TryPop(item));
+    ASSERT_EQ(5, item);
+    ASSERT_TRUE(buffer.Push(7));
+    ASSERT_TRUE(buffer.Pop(item));
+    ASSERT_EQ(6, item);
+    ASSERT_TRUE(buffer.Pop(item));
+    ASSERT_EQ(7, item);
+}
+
+/**
+ * Tests that a closed BoundedBuffer drains, but refuses new items
+ */
+TEST(BoundedBufferTest, TestBoundedBufferClose) {
+    BoundedBuffer<int> buffer(1);
+    int item;
+
+    ASSERT_TRUE(buffer.Push(5));
+    buffer.Close();
+    ASSERT_FALSE(buffer.Push(6));
+    ASSERT_TRUE(buffer.Pop(item));
+    ASSERT_EQ(5, item);
+    ASSERT_FALSE(buffer.Pop(item));
+}
+
+/**
+ * Tests that a BoundedBuffer must have space
+ */
+TEST(BoundedBufferTest, TestBoundedBufferZeroCapacity) {
+    ASSERT_THROW(BoundedBuffer<int> buffer(0), std::invalid_argument);
+}
+
+/**
+ * Tests using a streaming pipeline before it is complete
+ */
+TEST(StreamingPipelineTest, TestStreamingPipelineNotReady) {
+    StreamingPipeline<int, char> pipeline;
+    char result;
+
+    ASSERT_THROW(pipeline.Push(integers[0]), std::runtime_error);
+    ASSERT_THROW(pipeline.Poll(result), std::runtime_error);
+    ASSERT_THROW(pipeline.TryPoll(result), std::runtime_error);
+}
+
+/**
+ * Tests adding mismatched stages to a streaming pipeline
+ */
+TEST(StreamingPipelineTest, TestStreamingPipelineInvalidStages) {
+    StreamingPipeline<char, double> pipeline;
+
+    std::unique_ptr<MockStage<double, int>> badFirst(new MockStage<double, int>());
+    ASSERT_THROW(pipeline.AddStage(*badFirst), std::invalid_argument);
+
+    std::unique_ptr<MockStage<char, int>> stage1(new MockStage<char, int>());
+    std::unique_ptr<MockStage<float, double>> badSecond(new MockStage<float, double>());
+    pipeline.AddStage(*stage1);
+    ASSERT_THROW(pipeline.AddStage(*badSecond), std::invalid_argument);
+}
+
+/**
+ * Tests adding stages to a complete streaming pipeline
+ */
+TEST(StreamingPipelineTest, TestStreamingPipelineAddStageAfterComplete) {
+    StreamingPipeline<char, double> pipeline;
+
+    std::unique_ptr<MockStage<char, double>> stage1(new MockStage<char, double>());
+    std::unique_ptr<MockStage<double, double>> stage2(new MockStage<double, double>());
+
+    pipeline.Complete(*stage1);
+    ASSERT_THROW(pipeline.AddStage(*stage2), std::invalid_argument);
+}
+
+/**
+ * Tests streaming several frames through 3 stages, in order
+ */
+TEST(StreamingPipelineTest, TestStreamingPipelineThreeStage) {
+    StreamingPipeline<char, double> pipeline;
+
+    std::unique_ptr<MockStage<char, int>> stage1(new MockStage<char, int>());
+    std::unique_ptr<MockStage<int, std::string>> stage2(new MockStage<int, std::string>());
+    std::unique_ptr<MockStage<std::string, double>> stage3(new MockStage<std::string, double>());
+    for (int i = 0; i < 3; i++) {
+        EXPECT_CALL(*stage1, Run(characters[i])).WillOnce(testing::Return(integers[i]));
+        EXPECT_CALL(*stage2, Run(integers[i])).WillOnce(testing::Return(strings[i]));
+        EXPECT_CALL(*stage3, Run(strings[i])).WillOnce(testing::Return(doubles[i]));
+    }
+
+    pipeline.AddStage(*stage1)
+            .AddStage(*stage2)
+            .Complete(*stage3);
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(pipeline.Push(characters[i]));
+    }
+    pipeline.Finish();
+    ASSERT_FALSE(pipeline.Push(characters[0]));
+
+    double result;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(pipeline.Poll(result));
+        ASSERT_EQ(doubles[i], result);
+    }
+    ASSERT_FALSE(pipeline.Poll(result));
+    ASSERT_FALSE(pipeline.TryPoll(result));
+}
+
+/**
+ * Tests that a failing stage surfaces its exception through Poll
+ */
+TEST(StreamingPipelineTest, TestStreamingPipelineStageThrows) {
+    StreamingPipeline<int, char> pipeline;
+
+    std::unique_ptr<MockStage<int, char>> stage1(new MockStage<int, char>());
+    EXPECT_CALL(*stage1, Run(integers[0])).WillOnce(testing::Throw(std::logic_error("bad frame")));
+
+    pipeline.Complete(*stage1);
+    pipeline.Push(integers[0]);
+
+    char result;
+    ASSERT_THROW(pipeline.Poll(result), std::logic_error);
+}
+
+/**
+ * Tests stopping a streaming pipeline with frames in flight
+ */
+TEST(StreamingPipelineTest, TestStreamingPipelineStop) {
+    StreamingPipeline<int, char> pipeline(1);
+
+    std::unique_ptr<MockStage<int, char>> stage1(new MockStage<int, char>());
+    EXPECT_CALL(*stage1, Run(testing::_)).WillRepeatedly(testing::Return(characters[0]));
+
+    pipeline.Complete(*stage1);
+    pipeline.Push(integers[0]);
+    pipeline.Stop();
+    pipeline.Stop();
+
+    ASSERT_FALSE(pipeline.Push(integers[1]));
+}
+
+}  // namespace found
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include "src/spatial/attitude-utils.hpp"
+
+namespace found {
+
+/// The number of vectors rotated at once (not a multiple of the SIMD width)
+const size_t kRotationCount = 11;
+
+/**
+ * Makes the components of kRotationCount different vectors
+ *
+ * @param x,y,z The arrays to place the components in
+ */
+static void MakeVectors(decimal *x, decimal *y, decimal *z) {
+    for (size_t i = 0; i < kRotationCount; i++) {
+        x[i] = cos(0.7 * i) * (i + 1);
+        y[i] = sin(1.3 * i) - 0.5;
+        z[i] = 0.25 * i - 1;
+    }
+}
+
+/**
+ * Tests interpolating between rotations about one axis, which turns at a constant rate
+ */
+TEST(AttitudeUtilsTest, TestSlerp) {
+    Vec3 axis(0, 0, 1);
+    Quaternion from(axis, DegToRad(10));
+    Quaternion to(axis, DegToRad(70));
+    for (decimal t : {0.0, 0.25, 0.5, 1.0}) {
+        Quaternion expected(axis, DegToRad(10 + 60 * t));
+        Quaternion between = Slerp(from, to, t);
+        ASSERT_TRUE(between.IsUnit(1e-5));
+        ASSERT_NEAR(expected.real, between.real, 1e-5);
+        ASSERT_NEAR(expected.k, between.k, 1e-5);
+    }
+
+    // q and -q are the same rotation, so the shorter way round is taken
+    Quaternion flipped(-to.real, -to.i, -to.j, -to.k);
+    decimal middle = 0.5;
+    Quaternion half = Slerp(from, flipped, middle).Canonicalize();
+    Quaternion expected(axis, DegToRad(40));
+    ASSERT_NEAR(expected.real, half.real, 1e-5);
+    ASSERT_NEAR(expected.k, half.k, 1e-5);
+    // Rotations too close for their sine are still interpolated
+    Quaternion close(axis, DegToRad(10.001));
+    ASSERT_NEAR(from.k, Slerp(from, close, middle).k, 1e-5);
+}
+
+/**
+ * Tests that the rotation matrix of a Quaternion rotates like the Quaternion
+ */
+TEST(AttitudeUtilsTest, TestQuaternionToDCM) {
+    Quaternion quaternion = SphericalToQuaternion(DegToRad(30), DegToRad(-20), DegToRad(75));
+    Mat3 dcm = QuaternionToDCM(quaternion);
+    Vec3 axes[3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    for (int j = 0; j < 3; j++) {
+        Vec3 rotated = quaternion.Rotate(axes[j]);
+        ASSERT_NEAR(rotated.x, dcm.At(0, j), 1e-6);
+        ASSERT_NEAR(rotated.y, dcm.At(1, j), 1e-6);
+        ASSERT_NEAR(rotated.z, dcm.At(2, j), 1e-6);
+    }
+}
+
+/**
+ * Tests that rotating many vectors at once matches rotating them one at a time
+ */
+TEST(AttitudeUtilsTest, TestBatchRotation) {
+    Quaternion quaternion = SphericalToQuaternion(DegToRad(250), DegToRad(45), DegToRad(10));
+    Mat3 matrix = {1, 2, 3, 4, 5, 6, 7, 8, 10};
+    Attitude fromQuaternion(quaternion);
+    Attitude fromDCM(QuaternionToDCM(quaternion));
+
+    decimal x[kRotationCount], y[kRotationCount], z[kRotationCount];
+    decimal outX[kRotationCount], outY[kRotationCount], outZ[kRotationCount];
+    MakeVectors(x, y, z);
+
+    matrix.Multiply(x, y, z, kRotationCount, outX, outY, outZ);
+    for (size_t i = 0; i < kRotationCount; i++) {
+        Vec3 expected = matrix * Vec3(x[i], y[i], z[i]);
+        ASSERT_FLOAT_EQ(expected.x, outX[i]);
+        ASSERT_FLOAT_EQ(expected.y, outY[i]);
+        ASSERT_FLOAT_EQ(expected.z, outZ[i]);
+    }
+
+    quaternion.Rotate(x, y, z, kRotationCount, outX, outY, outZ);
+    for (size_t i = 0; i < kRotationCount; i++) {
+        Vec3 expected = quaternion.Rotate(Vec3(x[i], y[i], z[i]));
+        ASSERT_NEAR(expected.x, outX[i], 1e-5);
+        ASSERT_NEAR(expected.y, outY[i], 1e-5);
+        ASSERT_NEAR(expected.z, outZ[i], 1e-5);
+    }
+
+    fromDCM.Rotate(x, y, z, kRotationCount, outX, outY, outZ);
+    // In place
+    fromQuaternion.Rotate(x, y, z, kRotationCount, x, y, z);
+    for (size_t i = 0; i < kRotationCount; i++) {
+        ASSERT_NEAR(outX[i], x[i], 1e-5);
+        ASSERT_NEAR(outY[i], y[i], 1e-5);
+        ASSERT_NEAR(outZ[i], z[i], 1e-5);
+    }
+}
+
+/**
+ * Tests that an Attitude keeps the rotation matrix of its Quaternion
+ */
+TEST(AttitudeUtilsTest, TestAttitudeDCM) {
+    Quaternion quaternion = SphericalToQuaternion(DegToRad(200), DegToRad(5), DegToRad(320));
+    Attitude attitude(quaternion);
+    Mat3 dcm = attitude.GetDCM();
+    Mat3 expected = QuaternionToDCM(quaternion);
+    for (int k = 0; k < 9; k++) ASSERT_FLOAT_EQ(expected.x[k], dcm.x[k]);
+
+    Vec3 vector(3, -4, 12);
+    Vec3 rotated = attitude.Rotate(vector);
+    Vec3 reference = quaternion.Rotate(vector);
+    ASSERT_NEAR(reference.x, rotated.x, 1e-5);
+    ASSERT_NEAR(reference.y, rotated.y, 1e-5);
+    ASSERT_NEAR(reference.z, rotated.z, 1e-5);
+}
+
+/**
+ * Tests that angle conversions and the identity matrix fold at compile time
+ */
+TEST(AttitudeUtilsTest, TestConstexpr) {
+    static_assert(DegToRad(180) > 3.1415 && DegToRad(180) < 3.1417, "DegToRad must be constexpr");
+    static_assert(RadToArcSec(ArcSecToRad(36)) > 35.99, "Arcsecond conversions must be constexpr");
+    static_assert(kIdentityMat3.x[0] == 1 && kIdentityMat3.x[1] == 0, "kIdentityMat3 must be constexpr");
+
+    Vec3 vector(1, 2, 3);
+    Vec3 same = kIdentityMat3 * vector;
+    ASSERT_EQ(vector.x, same.x);
+    ASSERT_EQ(vector.y, same.y);
+    ASSERT_EQ(vector.z, same.z);
+}
+
+/**
+ * Tests double precision math, and converting between precisions
+ */
+TEST(AttitudeUtilsTest, TestPrecision) {
+    // A position in km that float cannot hold to the mm
+    PreciseVec3 position(42164.000001, -0.000002, 1);
+    PreciseVec3 step(0.000001, 0, 0);
+    PreciseVec3 moved = position + step;
+    ASSERT_DOUBLE_EQ(42164.000002, moved.x);
+    ASSERT_NEAR(0.000001, Distance(moved, position), 1e-9);
+
+    Vec3 single = PrecisionCast<decimal>(moved);
+    ASSERT_FLOAT_EQ(static_cast<decimal>(moved.x), single.x);
+    PreciseVec3 back = PrecisionCast<preciseDecimal>(single);
+    ASSERT_EQ(single.x, back.x);
+
+    PreciseQuaternion rotation(PreciseVec3(0, 0, 1), M_PI / 2);
+    PreciseVec3 rotated = rotation.Rotate(PreciseVec3(1, 0, 0));
+    ASSERT_NEAR(0, rotated.x, 1e-15);
+    ASSERT_NEAR(1, rotated.y, 1e-15);
+
+    PreciseMat3 dcm = QuaternionToDCM(rotation);
+    Mat3 singleDCM = PrecisionCast<decimal>(dcm);
+    Quaternion singleRotation = PrecisionCast<decimal>(rotation);
+    Mat3 expected = QuaternionToDCM(singleRotation);
+    for (int k = 0; k < 9; k++) ASSERT_NEAR(expected.x[k], singleDCM.x[k], 1e-6);
+    Vec2 flat = PrecisionCast<decimal>(PreciseVec2{0.5, 0.25});
+    ASSERT_EQ(0.5, flat.x);
+}
+
+/**
+ * Tests converting rotation matrices back to quaternions, for rotations where
+ * each of the components is the largest
+ */
+TEST(AttitudeUtilsTest, TestDCMToQuaternion) {
+    Quaternion rotations[] = {
+        Quaternion(Vec3(0, 0, 1), DegToRad(30)),
+        Quaternion(Vec3(1, 0, 0), DegToRad(170)),
+        Quaternion(Vec3(0, 1, 0), DegToRad(-175)),
+        Quaternion(Vec3(0, 0.6, 0.8), DegToRad(179)),
+        SphericalToQuaternion(DegToRad(123), DegToRad(-45), DegToRad(300)),
+    };
+    for (const Quaternion &rotation : rotations) {
+        Quaternion converted = DCMToQuaternion(QuaternionToDCM(rotation));
+        // q and -q are the same rotation
+        decimal sign = converted.real * rotation.real + converted.i * rotation.i +
+                       converted.j * rotation.j + converted.k * rotation.k < 0 ? -1 : 1;
+        ASSERT_NEAR(rotation.real, sign * converted.real, 1e-5);
+        ASSERT_NEAR(rotation.i, sign * converted.i, 1e-5);
+        ASSERT_NEAR(rotation.j, sign * converted.j, 1e-5);
+        ASSERT_NEAR(rotation.k, sign * converted.k, 1e-5);
+    }
+}
+
+/**
+ * Tests that an Attitude made from a rotation matrix keeps its quaternion
+ */
+TEST(AttitudeUtilsTest, TestAttitudeQuaternion) {
+    Quaternion quaternion = SphericalToQuaternion(DegToRad(80), DegToRad(20), DegToRad(10));
+    Attitude attitude(QuaternionToDCM(quaternion));
+
+    Quaternion converted = attitude.GetQuaternion();
+    ASSERT_NEAR(quaternion.real, converted.real, 1e-5);
+    ASSERT_NEAR(quaternion.i, converted.i, 1e-5);
+    ASSERT_NEAR(quaternion.j, converted.j, 1e-5);
+    ASSERT_NEAR(quaternion.k, converted.k, 1e-5);
+
+    EulerAngles angles = attitude.ToSpherical();
+    ASSERT_NEAR(DegToRad(80), angles.ra, 1e-4);
+    ASSERT_NEAR(DegToRad(20), angles.de, 1e-4);
+    ASSERT_NEAR(DegToRad(10), angles.roll, 1e-4);
+}
+
+/**
+ * Tests serializing a vector into an unaligned buffer
+ */
+TEST(AttitudeUtilsTest, TestSerializeVec3) {
+    unsigned char buffer[64];
+    ASSERT_EQ(static_cast<int64_t>(sizeof(decimal) * 3), SerializeLengthVec3());
+    SerializeVec3(Vec3(1.5, -2, 3), buffer + 1);
+    Vec3 vector = DeserializeVec3(buffer + 1);
+    ASSERT_EQ(1.5, vector.x);
+    ASSERT_EQ(-2, vector.y);
+    ASSERT_EQ(3, vector.z);
+}
+
+}  // namespace found
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "src/spatial/camera.hpp"
+
+#include "test/common/constants/distance-constants.hpp"
+
+namespace found {
+
+/// The number of random points the rays of a camera are compared at
+const size_t kRayCount = 1000;
+
+/**
+ * Makes a distorted copy of distanceCamera
+ *
+ * @return The camera, with kBarrelDistortion
+ */
+static Camera MakeDistortedCamera() {
+    Camera camera = distanceCamera;
+    camera.SetDistortion(kBarrelDistortion);
+    return camera;
+}
+
+/**
+ * Finds the largest angle between the rays of two cameras at random points on the sensor
+ *
+ * @param first,second The cameras
+ *
+ * @return The largest angle, in radians
+ */
+static decimal LargestRayError(const Camera &first, const Camera &second) {
+    std::mt19937 generator(kDistanceSeed);
+    std::uniform_real_distribution<decimal> xs(0, first.XResolution()), ys(0, first.YResolution());
+    std::vector<decimal> x(kRayCount), y(kRayCount);
+    for (size_t i = 0; i < kRayCount; i++) {
+        x[i] = xs(generator);
+        y[i] = ys(generator);
+    }
+    std::vector<decimal> x1(kRayCount), y1(kRayCount), z1(kRayCount), x2(kRayCount), y2(kRayCount), z2(kRayCount);
+    first.PixelsToRays(x.data(), y.data(), kRayCount, x1.data(), y1.data(), z1.data());
+    second.PixelsToRays(x.data(), y.data(), kRayCount, x2.data(), y2.data(), z2.data());
+    decimal largest = 0;
+    for (size_t i = 0; i < kRayCount; i++) {
+        Vec3 error = Vec3(x1[i], y1[i], z1[i]).CrossProduct(Vec3(x2[i], y2[i], z2[i]));
+        largest = std::max(largest, error.Magnitude());
+    }
+    return largest;
+}
+
+/**
+ * Tests that a distorted camera projects the rays of its pixels back onto them
+ */
+TEST(CameraTest, TestDistortionRoundTrip) {
+    Camera camera = MakeDistortedCamera();
+    ASSERT_TRUE(camera.Distorted());
+    ASSERT_FALSE(distanceCamera.Distorted());
+
+    for (int y = 0; y <= 1024; y += 64) {
+        for (int x = 0; x <= 1024; x += 64) {
+            Vec2 pixel = {static_cast<decimal>(x), static_cast<decimal>(y)};
+            Vec3 ray = camera.CameraToSpatial(pixel);
+            ASSERT_EQ(1, ray.x);
+            Vec2 back = camera.SpatialToCamera(ray);
+            ASSERT_NEAR(pixel.x, back.x, 1e-3);
+            ASSERT_NEAR(pixel.y, back.y, 1e-3);
+        }
+    }
+
+    // The principal point is not distorted, but the corners are
+    Vec2 center = camera.SpatialToCamera({1, 0, 0});
+    ASSERT_NEAR(512, center.x, 1e-4);
+    ASSERT_NEAR(512, center.y, 1e-4);
+    Vec3 corner = {1, 0.5, 0.5};
+    Vec2 ideal = distanceCamera.SpatialToCamera(corner);
+    Vec2 distorted = camera.SpatialToCamera(corner);
+    ASSERT_LT(ideal.x + 20, distorted.x);
+    ASSERT_LT(ideal.y + 20, distorted.y);
+}
+
+/**
+ * Tests that the rays looked up in a table are those of the camera
+ */
+TEST(CameraTest, TestRayTable) {
+    Camera exact = MakeDistortedCamera();
+    Camera full = exact, sparse = exact;
+    full.BuildRayTable();
+    sparse.BuildRayTable(8);
+    ASSERT_EQ(nullptr, exact.Table());
+    ASSERT_EQ(1025, full.Table()->Columns());
+    ASSERT_EQ(129, sparse.Table()->Columns());
+    ASSERT_EQ(129 * 129u, sparse.Table()->RayY().size());
+
+    // Both are within a hundredth of a pixel (1e-5 radians)
+    ASSERT_LT(LargestRayError(exact, full), 1e-6);
+    ASSERT_LT(LargestRayError(exact, sparse), 1e-5);
+    Vec3 ray = sparse.CameraToSpatial({100, 900});
+    Vec3 expected = exact.CameraToSpatial({100, 900});
+    ASSERT_EQ(1, ray.x);
+    ASSERT_NEAR(expected.y, ray.y, 1e-5);
+    ASSERT_NEAR(expected.z, ray.z, 1e-5);
+
+    // An ideal camera has a table too, whose rays are those it computes
+    Camera ideal = distanceCamera;
+    ideal.BuildRayTable(16);
+    ASSERT_LT(LargestRayError(distanceCamera, ideal), 1e-6);
+}
+
+/**
+ * Tests that a table of rays is only used by the camera it was made for
+ */
+TEST(CameraTest, TestRayTableOwnership) {
+    Camera camera = MakeDistortedCamera();
+    camera.BuildRayTable(32);
+    Camera copy = camera;
+    ASSERT_EQ(camera.Table(), copy.Table());
+    ASSERT_TRUE(camera.Table()->Matches(copy));
+    ASSERT_EQ(nullptr, camera.Table()->GetCamera().Table());
+
+    // Changing the camera drops its table
+    copy.SetFocalLength(900);
+    ASSERT_EQ(nullptr, copy.Table());
+    ASSERT_THROW(copy.SetRayTable(camera.Table()), std::invalid_argument);
+    Camera other = distanceCamera;
+    other.BuildRayTable(32);
+    other.SetDistortion(kBarrelDistortion);
+    ASSERT_EQ(nullptr, other.Table());
+    other.SetRayTable(camera.Table());
+    ASSERT_EQ(camera.Table(), other.Table());
+    other.SetRayTable(nullptr);
+    ASSERT_EQ(nullptr, other.Table());
+
+    ASSERT_THROW(camera.BuildRayTable(0), std::invalid_argument);
+    ASSERT_THROW(Camera(100, 0, 10).BuildRayTable(), std::invalid_argument);
+    ASSERT_THROW(RayTable(camera, 32, {1, 2}, {1, 2}), std::invalid_argument);
+}
+
+}  // namespace found
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "src/style/points.hpp"
+#include "src/style/style.hpp"
+#include "src/common/arena.hpp"
+#include "src/common/memory.hpp"
+
+namespace found {
+
+/**
+ * Tests adding and reading points
+ */
+TEST(PointsTest, TestPointSet) {
+    PointSet points = {{1, 2}, {3, 4}};
+    points.push_back(5, 6);
+    points.push_back({7, 8});
+
+    ASSERT_EQ(4, points.size());
+    ASSERT_FALSE(points.empty());
+    for (size_t i = 0; i < points.size(); i++) {
+        ASSERT_EQ(2 * i + 1, points[i].x);
+        ASSERT_EQ(2 * i + 2, points.at(i).y);
+        ASSERT_EQ(points[i].x, points.x()[i]);
+        ASSERT_EQ(points[i].y, points.y()[i]);
+    }
+    ASSERT_THROW(points.at(4), std::out_of_range);
+
+    decimal sum = 0;
+    for (const Vec2 &point : points) sum += point.x + point.y;
+    ASSERT_EQ(36, sum);
+
+    const PointSet &view = points;
+    ASSERT_EQ(points.x(), view.x());
+    ASSERT_EQ(points.y(), view.y());
+}
+
+/**
+ * Tests that the coordinates are aligned, and that clearing keeps the storage
+ */
+TEST(PointsTest, TestPointSetStorage) {
+    PointSet points;
+    points.reserve(100);
+    ASSERT_LE(100, points.capacity());
+    const decimal *x = points.x();
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(x) % kVectorAlignment);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(points.y()) % kVectorAlignment);
+
+    points.resize(100);
+    points.clear();
+    ASSERT_TRUE(points.empty());
+    points.push_back(1, 1);
+    ASSERT_EQ(x, points.x());
+
+    PointSet same = {{1, 1}};
+    PointSet other = {{1, 2}};
+    ASSERT_TRUE(points == same);
+    ASSERT_FALSE(points == other);
+}
+
+/**
+ * Tests aligned allocation in other containers
+ */
+TEST(PointsTest, TestAlignedAllocator) {
+    std::vector<double, AlignedAllocator<double, 64>> values(3, 1.0);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(values.data()) % 64);
+
+    AlignedAllocator<double, 64> doubles;
+    AlignedAllocator<int, 64> integers(doubles);
+    ASSERT_TRUE(doubles == integers);
+    ASSERT_FALSE(doubles != integers);
+    ASSERT_THROW(doubles.allocate(SIZE_MAX / 16), std::bad_alloc);
+}
+
+/**
+ * Tests points and vectors whose storage comes from an arena
+ */
+TEST(PointsTest, TestScratchPoints) {
+    Arena arena(1024);
+    ScratchPoints points{ArenaAllocator<decimal>(&arena)};
+    points.push_back(1, 2);
+    points.push_back(3, 4);
+    ASSERT_EQ(2u, points.size());
+    ASSERT_EQ(3, points[1].x);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(points.x()) % kVectorAlignment);
+    ASSERT_LT(0u, arena.Used());
+    ASSERT_EQ(1u, arena.HeapAllocations());
+
+    ScratchVector<int> values(10, 7, ArenaAllocator<int>(&arena));
+    ASSERT_EQ(7, values[9]);
+    ASSERT_EQ(1u, arena.HeapAllocations());
+
+    // Without an arena, storage comes from the heap
+    ScratchPoints heap;
+    heap.push_back(5, 6);
+    ASSERT_EQ(5, heap.at(0).x);
+}
+
+}  // namespace found